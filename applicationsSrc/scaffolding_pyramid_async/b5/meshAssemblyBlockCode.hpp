@@ -98,7 +98,7 @@ public:
     World *world;
     Lattice *lattice;
     Catoms3D::Catoms3DBlock *catom;
-    MeshCoating::MeshRuleMatcher *ruleMatcher;
+    static MeshCoating::MeshRuleMatcher *ruleMatcher; //!< Shared by all modules
 
     /** CONTINUOUS FEEDING **/
     bool moduleWaitingOnBranch[4] = { false, false, false, false};
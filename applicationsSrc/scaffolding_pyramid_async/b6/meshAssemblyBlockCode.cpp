@@ -4,8 +4,10 @@
 #include "catoms3DWorld.h"
 #include "scheduler.h"
 #include "events.h"
+#include "statsCollector.h"
 #include "trace.h"
 #include "tDefs.h"
+#include "snapshot.h"
 
 #include "teleportationEvents.h"
 #include "rotation3DEvents.h"
@@ -16,14 +18,18 @@
 using namespace Catoms3D;
 using namespace MeshCoating;
 
-Time MeshAssemblyBlockCode::t0 = 0;
-int MeshAssemblyBlockCode::nbCatomsInPlace = 0;
-int MeshAssemblyBlockCode::nbMessages = 0;
-bool MeshAssemblyBlockCode::sandboxInitialized = false;
-uint MeshAssemblyBlockCode::X_MAX;
-uint MeshAssemblyBlockCode::Y_MAX;
-uint MeshAssemblyBlockCode::Z_MAX;
-bool MeshAssemblyBlockCode::constructionOver = false;
+RunLocal<std::atomic<Time>> MeshAssemblyBlockCode::t0 { 0u };
+RunLocal<std::atomic<int>> MeshAssemblyBlockCode::nbCatomsInPlace { 0 };
+RunLocal<std::atomic<int>> MeshAssemblyBlockCode::nbModulesInShape { 0 };
+RunLocal<std::atomic<int>> MeshAssemblyBlockCode::nbMessages { 0 };
+std::mutex MeshAssemblyBlockCode::consoleMutex;
+RunLocal<std::atomic<bool>> MeshAssemblyBlockCode::sandboxInitialized { false };
+RunLocal<uint> MeshAssemblyBlockCode::X_MAX;
+RunLocal<uint> MeshAssemblyBlockCode::Y_MAX;
+RunLocal<uint> MeshAssemblyBlockCode::Z_MAX;
+RunLocal<const MeshRuleMatcher*> MeshAssemblyBlockCode::ruleMatcher;
+RunLocal<std::atomic<bool>> MeshAssemblyBlockCode::constructionOver { false };
+RunLocal<set<bID>> MeshAssemblyBlockCode::finalTargetReachedBreaks;
 constexpr std::array<Cell3DPosition, 6> MeshAssemblyBlockCode::incidentTipRelativePos;
 constexpr std::array<Cell3DPosition, 12> MeshAssemblyBlockCode::entryPointRelativePos;
 constexpr Cell3DPosition MeshAssemblyBlockCode::meshSeedPosition;
@@ -35,13 +41,29 @@ MeshAssemblyBlockCode::MeshAssemblyBlockCode(Catoms3DBlock *host):
     lattice = world->lattice;
     catom = host;
 
-    const Cell3DPosition& ub = lattice->getGridUpperBounds();
-    // Round down mesh dimensions to previous multiple of B
-    // TODO: Adapt to CSG
-    X_MAX = ub[0] - (B - ub[0] % B);
-    Y_MAX = ub[1] - (B - ub[1] % B);
-    Z_MAX = ub[2] - (B - ub[2] % B);
-    ruleMatcher = new MeshRuleMatcher(X_MAX, Y_MAX, Z_MAX, B);
+    // The rule matcher only depends on the dimensions of the lattice, hence is built once per simulation
+    if (not ruleMatcher) {
+        const Cell3DPosition& ub = lattice->getGridUpperBounds();
+        // Round down mesh dimensions to previous multiple of B
+        // TODO: Adapt to CSG
+        X_MAX = ub[0] - (B - ub[0] % B);
+        Y_MAX = ub[1] - (B - ub[1] % B);
+        Z_MAX = ub[2] - (B - ub[2] % B);
+        ruleMatcher = new MeshRuleMatcher(X_MAX, Y_MAX, Z_MAX, B);
+
+        // Messages that may be pending in a snapshot. PositionToSwapMessage carries an
+        // interface by value, and cannot be restored, TileNotReadyMessage is never sent.
+        Snapshot::registerMessage<RequestTargetCellMessage>();
+        Snapshot::registerMessage<ProvideTargetCellMessage>();
+        Snapshot::registerMessage<CoordinatorReadyMessage>();
+        Snapshot::registerMessage<TileInsertionReadyMessage>();
+        Snapshot::registerMessage<ReachBridgingPosition>();
+        Snapshot::registerMessage<HelperPositionReachedMessage>();
+        Snapshot::registerMessage<RequestAdditionalModule>();
+        Snapshot::registerMessage<ProbePivotLightStateMessage>();
+        Snapshot::registerMessage<GreenLightIsOnMessage>();
+        Snapshot::registerMessage<FinalTargetReachedMessage>();
+    }
 }
 
 MeshAssemblyBlockCode::~MeshAssemblyBlockCode() {
@@ -53,11 +75,88 @@ MeshAssemblyBlockCode::~MeshAssemblyBlockCode() {
     }
 }
 
+void MeshAssemblyBlockCode::parseUserElements(TiXmlDocument *config) {
+    TiXmlNode *faultsNode = config->FirstChild("world")->FirstChild("meshAssemblyFaults");
+    if (not faultsNode) return;
+
+    const char *attr = faultsNode->ToElement()->Attribute("finalTargetReachedBreaks");
+    if (not attr) return;
+
+    stringstream ids(attr);
+    string id;
+    while (getline(ids, id, ','))
+        if (not id.empty()) finalTargetReachedBreaks.get().insert(stoi(id));
+}
+
 void MeshAssemblyBlockCode::onAssertTriggered() {
     onBlockSelected();
     catom->setColor(BLACK);
 }
 
+bool MeshAssemblyBlockCode::saveState(SnapshotWriter &w) const {
+    w.write(brokenInterfaces, brokenInterfaceInBeam);
+    for (const P2PNetworkInterface *itf : bridgedInterfaces) w.writeInterface(itf);
+    w.writeInterface(helperSrc);
+    w.writeInterface(helperDst);
+    // Only looked up, the order of the identifiers does not matter
+    w.write(positionToSwap, swappedPositions, firstSwapDone, maxBitrate, rate, debugColorIndex,
+            moduleWaitingOnBranch, sentRequestToCoordinator,
+            set<bID>(processedRQId.begin(), processedRQId.end()));
+    for (const MeshAssemblyBlockCode *bc : EPLPivotBC) w.writeBlock(bc ? bc->catom : NULL);
+    w.write(matchingLocalRule, finalPositionForActuatedModule, pivotPosition, initialized,
+            constructionQueue, tileInsertionPending, notFindingPivot, notFindingPivotCount,
+            addNeighborToProcess, RModuleRequestedMotion, randomRotationTimeStart,
+            greenLightIsOn, moduleAwaitingGo, awaitingModulePos);
+    w.writeInterface(awaitingModuleProbeItf);
+    w.write(actuationTargetPos, stepTargetPos, rotating, branch, role, coordinatorPos,
+            targetPosition, destPosition, startTime, step, tileInsertionAckGiven, branchTipPos,
+            catomsSpawnedToVBranch, catomsReqByBranch, moduleReadyOnEPL, moduleAwaitingOnEPL,
+            sandboxResourcesRequirement);
+    return true;
+}
+
+void MeshAssemblyBlockCode::restoreState(SnapshotReader &r) {
+    r.read(brokenInterfaces, brokenInterfaceInBeam);
+    for (P2PNetworkInterface *&itf : bridgedInterfaces) itf = r.readInterface();
+    helperSrc = r.readInterface();
+    helperDst = r.readInterface();
+    set<bID> processed;
+    r.read(positionToSwap, swappedPositions, firstSwapDone, maxBitrate, rate, debugColorIndex,
+           moduleWaitingOnBranch, sentRequestToCoordinator, processed);
+    processedRQId = unordered_set<bID>(processed.begin(), processed.end());
+    for (MeshAssemblyBlockCode *&bc : EPLPivotBC) {
+        BuildingBlock *pivot = r.readBlock();
+        bc = pivot ? static_cast<MeshAssemblyBlockCode*>(pivot->blockCode) : NULL;
+    }
+    r.read(matchingLocalRule, finalPositionForActuatedModule, pivotPosition, initialized,
+           constructionQueue, tileInsertionPending, notFindingPivot, notFindingPivotCount,
+           addNeighborToProcess, RModuleRequestedMotion, randomRotationTimeStart,
+           greenLightIsOn, moduleAwaitingGo, awaitingModulePos);
+    awaitingModuleProbeItf = r.readInterface();
+    r.read(actuationTargetPos, stepTargetPos, rotating, branch, role, coordinatorPos,
+           targetPosition, destPosition, startTime, step, tileInsertionAckGiven, branchTipPos,
+           catomsSpawnedToVBranch, catomsReqByBranch, moduleReadyOnEPL, moduleAwaitingOnEPL,
+           sandboxResourcesRequirement);
+}
+
+void MeshAssemblyBlockCode::saveSharedState(SnapshotWriter &w) const {
+    w.write(nbCatomsInPlace.get().load(), nbModulesInShape.get().load(), nbMessages.get().load(),
+            t0.get().load(), constructionOver.get().load(), sandboxInitialized.get().load());
+}
+
+void MeshAssemblyBlockCode::restoreSharedState(SnapshotReader &r) {
+    int inPlace, inShape, messages;
+    Time start;
+    bool over, sandbox;
+    r.read(inPlace, inShape, messages, start, over, sandbox);
+    nbCatomsInPlace.get() = inPlace;
+    nbModulesInShape.get() = inShape;
+    nbMessages.get() = messages;
+    t0.get() = start;
+    constructionOver.get() = over;
+    sandboxInitialized.get() = sandbox;
+}
+
 void MeshAssemblyBlockCode::onBlockSelected() {
 
     int mc = ruleMatcher->getComponentForPosition(targetPosition - coordinatorPos);
@@ -78,7 +177,8 @@ void MeshAssemblyBlockCode::startup() {
     initialized = true;
     startTime = scheduler->now();
 
-    if (not sandboxInitialized)
+    // The first module to start initializes the sandbox
+    if (not sandboxInitialized.get().exchange(true))
         initializeSandbox();
 
     coordinatorPos =
@@ -187,6 +287,7 @@ void MeshAssemblyBlockCode::processReceivedMessage(MessagePtr msg,
     switch (msg->type) {
         // ALL MOVED TO HANDLEABLE MESSAGES
         default:
+            lock_guard<mutex> lock(consoleMutex);
             cout << "Unknown Generic Message Type" << endl;
             assert(false);
             break;
@@ -201,7 +302,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
     switch (pev->eventType) {
         case EVENT_RECEIVE_MESSAGE: {
             message =
-                (std::static_pointer_cast<NetworkInterfaceReceiveEvent>(pev))->message;
+                (static_pointer_cast<NetworkInterfaceReceiveEvent>(pev))->message;
 
             if (message->isMessageHandleable()) {
                 std::shared_ptr<HandleableMessage> hMsg =
@@ -222,7 +323,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
                             MSG_DELAY_MC, 0);
                     return;
                 }
-                hMsg->handle(this);
+                MessageTypeRegistry::handle(this, hMsg.get());
             } else {
                 P2PNetworkInterface * recv_interface = message->destinationInterface;
 
@@ -233,7 +334,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
 
         case EVENT_ADD_NEIGHBOR: {
             uint64_t face = Catoms3DWorld::getWorld()->lattice->
-                getOppositeDirection((std::static_pointer_cast<AddNeighborEvent>(pev))
+                getOppositeDirection((static_pointer_cast<AddNeighborEvent>(pev))
                                      ->face);
             const Cell3DPosition& pos = catom->getNeighborBlock(face)->position;
 
@@ -281,7 +382,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
         case EVENT_REMOVE_NEIGHBOR: {
             if (not rotating) {
                 if (role != FreeAgent) {
-                    uint64_t face = Catoms3DWorld::getWorld()->lattice->getOppositeDirection((std::static_pointer_cast<RemoveNeighborEvent>(pev))->face);
+                    uint64_t face = Catoms3DWorld::getWorld()->lattice->getOppositeDirection((static_pointer_cast<RemoveNeighborEvent>(pev))->face);
 
                     Cell3DPosition pos;
                     if (catom->getNeighborPos(face, pos)
@@ -297,7 +398,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
             break;
         }
         case EVENT_PIVOT_ACTUATION_START: {
-            std::shared_ptr<PivotActuationStartEvent> pase = std::static_pointer_cast
+            IntrusivePtr<PivotActuationStartEvent> pase = static_pointer_cast
                 <PivotActuationStartEvent>(pev);
 
             // A free agent module should never be used as pivot (for now)
@@ -315,7 +416,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
         } break;
 
         case EVENT_PIVOT_ACTUATION_END: {
-            // std::shared_ptr<PivotActuationEndEvent> paee = std::static_pointer_cast
+            // IntrusivePtr<PivotActuationEndEvent> paee = static_pointer_cast
             //     <PivotActuationEndEvent>(pev);
 
             // console << " finished actuating for module #" << paee->mobile->blockId << "\n";
@@ -356,6 +457,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
                 sendMessage(new HelperPositionReachedMessage(brokenInterfaceInBeam, targetPosition), 
                     catom->getInterface(pivotPosition), MSG_DELAY_MC, 0);
                    //PERLA............................//
+                    lock_guard<mutex> lock(consoleMutex);
                     cout<< "Helper target positionn: "<< targetPosition<< endl ; 
                     // it didn't work  
                     // if (role = FreeAgent){
@@ -366,8 +468,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
             }
 //........................................................................................../////////////////////////////////////
             if (catom->position == targetPosition and not isOnEntryPoint(catom->position)) {
-                       static int nbModulesInShape = 0;
-                nbModulesInShape++;
+                nbModulesInShape.get()++;
 
                 role = ruleMatcher->getRoleForPosition(norm(catom->position));
                 catom->setColor(ruleMatcher->getColorForPosition(norm(catom->position)));
@@ -409,19 +510,21 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
                     ruleMatcher->getComponentForPosition(
                         catom->position - coordinatorPos) == S_RevZ) {
                     int ts = round(getScheduler()->now() / getRoundDuration());
+                    lock_guard<mutex> lock(consoleMutex);
                     cerr << ruleMatcher->getPyramidDimension()
                          << "-PYRAMID CONSTRUCTION OVER AT TimeStep = "
                          << ts << " with " << lattice->nbModules << " modules" << endl;
                     OUTPUT << "main: " << ruleMatcher->getPyramidDimension() << "\t"
                            << ts << "\t"
                            << lattice->nbModules  << "\t"
-                           << nbModulesInShape << endl;
+                           << nbModulesInShape.get() << endl;
 
-                    constructionOver = true;
+                    constructionOver.get() = true;
+                    utils::StatsCollector::getInstance().notifyCompletion(getScheduler()->now());
                 }
 
                 // STAT EXPORT
-                OUTPUT << "nbCatomsInPlace:\t" << (int)round(scheduler->now() / getRoundDuration()) << "\t" << ++nbCatomsInPlace << endl;
+                OUTPUT << "nbCatomsInPlace:\t" << (int)round(scheduler->now() / getRoundDuration()) << "\t" << ++nbCatomsInPlace.get() << endl;
 
                 if (ruleMatcher->isVerticalBranchTip(norm(catom->position))) {
                     coordinatorPos =
@@ -520,8 +623,8 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
         } break;
 
         case EVENT_INTERRUPTION: {
-            std::shared_ptr<InterruptionEvent> itev =
-                std::static_pointer_cast<InterruptionEvent>(pev);
+            IntrusivePtr<InterruptionEvent> itev =
+                static_pointer_cast<InterruptionEvent>(pev);
 
             switch(itev->mode) {
 
@@ -530,7 +633,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
                     if (catom->position[2] == meshSeedPosition[2]) {
                         feedIncidentBranches();
 
-                        if (not constructionOver)
+                        if (not constructionOver.get())
                             getScheduler()->schedule(
                                 new InterruptionEvent(getScheduler()->now() +
                                                       (getRoundDuration()),
@@ -620,6 +723,7 @@ bool MeshAssemblyBlockCode::handleModuleInsertionToIncidentBranch(BranchIndex bi
         catomsSpawnedToVBranch[bid]++;
         return true;
     } else {
+        lock_guard<mutex> lock(consoleMutex);
         cout << entryPoint << endl;
         cout << lattice->isFree(entryPoint) << endl;
         cerr << "bid: " << bid << endl;
@@ -684,11 +788,13 @@ void MeshAssemblyBlockCode::scheduleRotationTo(const Cell3DPosition& pos,
         awaitKeyPressed();
 #endif
     } catch (const NoAvailableRotationPivotException& e_piv) {
+        lock_guard<mutex> lock(consoleMutex);
         cerr << e_piv.what();
         cerr << "target position: " << pos << endl;
         catom->setColor(MAGENTA);
         VS_ASSERT(false);
     } catch (std::exception const& e) {
+        lock_guard<mutex> lock(consoleMutex);
         cerr << "exception: " << e.what() << endl;
         VS_ASSERT(false);
     }
@@ -699,7 +805,7 @@ void MeshAssemblyBlockCode::initializeTileRoot() {
     role = Coordinator;
     coordinatorPos = catom->position;
 
-    if (norm(catom->position) == Cell3DPosition(0,0,0)) t0 = scheduler->now();
+    if (norm(catom->position) == Cell3DPosition(0,0,0)) t0.get() = scheduler->now();
     // OUTPUT << "root: " << (int)(round((scheduler->now() - t0) / getRoundDuration())) << "\t" << norm(catom->position) << endl;
 
     // Determine how many branches need to grow from here
@@ -877,14 +983,13 @@ void MeshAssemblyBlockCode::initializeSandbox() {
 
     }
 
-    sandboxInitialized = true;
     // cout << "round duration: " << getRoundDuration() << endl;
 }
 
 std::bitset<12> MeshAssemblyBlockCode::getMeshLocalNeighborhoodState() {
     bitset<12> bitset = {0};
-    const vector<Cell3DPosition> localNeighborhood =
-        Catoms3DWorld::getWorld()->lattice->getNeighborhood(catom->position);
+    CellNeighborhood localNeighborhood;
+    Catoms3DWorld::getWorld()->lattice->getNeighborhood(catom->position, localNeighborhood);
 
     for (const Cell3DPosition& nPos : localNeighborhood) {
         P2PNetworkInterface *itf = catom->getInterface(nPos);
@@ -907,7 +1012,10 @@ void MeshAssemblyBlockCode::matchRulesAndRotate() {
     } else {
         // Try matching rules again once neighborhood updates
         catom->setColor(GOLD);
-        cout << *catom << " is local rule matching" << endl;
+        {
+            lock_guard<mutex> lock(consoleMutex);
+            cout << *catom << " is local rule matching" << endl;
+        }
         matchingLocalRule = true;
     }
 }
@@ -949,7 +1057,9 @@ bool MeshAssemblyBlockCode::isAdjacentToPosition(const Cell3DPosition& pos) cons
 Catoms3DBlock* MeshAssemblyBlockCode::
 findTargetLightAmongNeighbors(const Cell3DPosition& targetPos,
                               const Cell3DPosition& srcPos) const {
-    for (const auto& cell : lattice->getActiveNeighborCells(catom->position)) {
+    CellNeighborhood activeCells;
+    lattice->getActiveNeighborCells(catom->position, activeCells);
+    for (const auto& cell : activeCells) {
         if (lattice->cellsAreAdjacent(cell, targetPos)
             and ruleMatcher->isInMesh(norm(cell))
             and cell != srcPos
@@ -1074,7 +1184,7 @@ void MeshAssemblyBlockCode::setGreenLight(bool onoff, int _line_) {
  ***********************************************************************/
 
 void MeshAssemblyBlockCode::updateMsgRate() {
-    Time t = (int)(round((scheduler->now() - t0) / getRoundDuration()));
+    Time t = (int)(round((scheduler->now() - t0.get()) / getRoundDuration()));
 
     if (rate.first != t) {
         rate.first = t;
@@ -1090,15 +1200,17 @@ void MeshAssemblyBlockCode::updateMsgRate() {
 }
 
 //PERLA..........................................................................///////////
-  static int nbModulesInShape = 0;
 int MeshAssemblyBlockCode::sendMessage(HandleableMessage *msg,P2PNetworkInterface *dest,
                                        Time t0,Time dt) {
-    OUTPUT << "nbMessages:\t" << round(scheduler->now() / getRoundDuration()) << "\t" << ++nbMessages << endl   ;
+    const int n = ++nbMessages.get();
+    if (TraceSink::isEnabled(TraceCategory::Log))
+        OUTPUT << "nbMessages:\t" << round(scheduler->now() / getRoundDuration()) << "\t" << n << endl;
     updateMsgRate();
     //if dest is broken
-     if(brokenInterfaces[catom->getInterfaceId(dest)] && dest->isConnected()) {
+     if(isBroken(dest) && dest->isConnected()) {
 
 
+         lock_guard<mutex> lock(consoleMutex);
          cout << catom->blockId <<": Trying to send a message on a broken interface(" << catom->getInterfaceId(dest) << ")" << endl;
         
     }
@@ -1116,19 +1228,31 @@ int MeshAssemblyBlockCode::sendMessage(HandleableMessage *msg,P2PNetworkInterfac
 // Fault tolerance PERLA
 int MeshAssemblyBlockCode::breakInterface(P2PNetworkInterface* interface){
         //destination id, the id of the module that cannot send a msg
+        lock_guard<mutex> lock(consoleMutex);
         cout << "Can't reach moduleID "<<interface->getConnectedBlockId() << endl;
         // this->sourceInterface = nullptr;
         brokenInterfaces[catom->getInterfaceId(interface)] = true;
+        catom->setColor(BLACK);
         cout << "broken interface: " << catom->getInterfaceId(interface) << endl;
        // module 66 can't send final message to the module 69 and the broken interface is 6   
     return 1;
 }
+
+bool MeshAssemblyBlockCode::isBroken(P2PNetworkInterface* interface) {
+    if (not brokenInterfaces[catom->getInterfaceId(interface)]
+        and interface->isLinkDown(scheduler->now()))
+        breakInterface(interface);
+
+    return brokenInterfaces[catom->getInterfaceId(interface)];
+}
 //.....................................................................................///////////////////////////////
 
 Cell3DPosition MeshAssemblyBlockCode::bridgingPosition(Cell3DPosition pos1, Cell3DPosition pos2){
     Cell3DPosition bridgePos, nextPos;
+    CellNeighborhood freeCells;
+    lattice->getFreeNeighborCells(catom->position, freeCells);
 
- for (const Cell3DPosition &p : lattice->getFreeNeighborCells(catom->position)) { 
+ for (const Cell3DPosition &p : freeCells) { 
         if ( lattice->cellsAreAdjacent(pos1, p) && lattice->cellsAreAdjacent(pos2, p) ) {
             bool matched = matchLocalRules(getMeshLocalNeighborhoodState(),
                                    catom->position,
@@ -1151,9 +1275,12 @@ int MeshAssemblyBlockCode::sendMessage(Message *msg,P2PNetworkInterface *dest,
                                        Time t0,Time dt) {  
  
     // if interface is broken and connected to a neighbor =>  FAULT
-    if(brokenInterfaces[catom->getInterfaceId(dest)] && dest->isConnected()) {
-        cout << catom->blockId << ": Trying to send a message on a broken interface("
-             << catom->getInterfaceId(dest) << ")" << endl;
+    if(isBroken(dest) && dest->isConnected()) {
+        {
+            lock_guard<mutex> lock(consoleMutex);
+            cout << catom->blockId << ": Trying to send a message on a broken interface("
+                 << catom->getInterfaceId(dest) << ")" << endl;
+        }
         if (bridgedInterfaces[catom->getInterfaceId(dest)]) {
             BlockCode::sendMessage(msg, bridgedInterfaces[catom->getInterfaceId(dest)],
                                    MSG_DELAY_MC, 0);
@@ -1172,7 +1299,9 @@ int MeshAssemblyBlockCode::sendMessage(Message *msg,P2PNetworkInterface *dest,
         //     mabc.catom->setColor(DARKORANGE);
         return -1;
     }                       
-    OUTPUT << "nbMessages:\t" << round(scheduler->now() / getRoundDuration()) << "\t" << ++nbMessages << endl;
+    const int n = ++nbMessages.get();
+    if (TraceSink::isEnabled(TraceCategory::Log))
+        OUTPUT << "nbMessages:\t" << round(scheduler->now() / getRoundDuration()) << "\t" << n << endl;
     updateMsgRate();
     return BlockCode::sendMessage(msg, dest, t0, dt);
 }
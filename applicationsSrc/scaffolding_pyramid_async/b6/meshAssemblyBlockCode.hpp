@@ -3,6 +3,8 @@
 
 #include <deque>
 #include <unordered_set>
+#include <atomic>
+#include <mutex>
 
 #include "catoms3DBlockCode.h"
 #include "catoms3DSimulator.h"
@@ -46,8 +48,20 @@ public:
     array<bool, 12>  brokenInterfaces = {0}; // represents brokenS
     array<P2PNetworkInterface*, 12> bridgedInterfaces = {nullptr}; // represents bridged interfaces
     int breakInterface(P2PNetworkInterface* interface); //function to break an interface
+    /**
+     * @brief Returns true if interface is broken. An interface breaks as soon as the link model
+     *  of the configuration file has an outage on it (see LinkModel), and remains broken.
+     */
+    bool isBroken(P2PNetworkInterface* interface);
+    /**
+     * @brief Modules breaking the interface on which they receive a FinalTargetReachedMessage,
+     *  from the finalTargetReachedBreaks attribute of the <meshAssemblyFaults> element of the
+     *  configuration file. Unlike link outages, which happen at a date, these faults are
+     *  triggered by the construction.
+     */
+    static RunLocal<set<bID>> finalTargetReachedBreaks;
     int brokenInterfaceInBeam = -1; //broken interface in beam if helper
-    P2PNetworkInterface *helperSrc, *helperDst;
+    P2PNetworkInterface *helperSrc = NULL, *helperDst = NULL;
 
     Cell3DPosition bridgingPosition( Cell3DPosition pos1, Cell3DPosition pos2); //funtion to bridge position
     deque<Cell3DPosition> positionToSwap;
@@ -59,11 +73,15 @@ public:
 
     ////////////////////////////////////
     static const uint B = B2; // defined in MeshLocalRules for convenience
-    static uint X_MAX, Y_MAX, Z_MAX; // const
+    static RunLocal<uint> X_MAX, Y_MAX, Z_MAX; // const
     static constexpr Cell3DPosition meshSeedPosition = Cell3DPosition(3,3,3);
-    static int nbCatomsInPlace;
-    static int nbMessages;
-    static Time t0;
+    // Shared by the modules, whose events may be processed concurrently (see ParallelScheduler),
+    // and specific to their simulation (see BatchRunner)
+    static RunLocal<std::atomic<int>> nbCatomsInPlace;
+    static RunLocal<std::atomic<int>> nbModulesInShape;
+    static RunLocal<std::atomic<int>> nbMessages;
+    static RunLocal<std::atomic<Time>> t0;
+    static std::mutex consoleMutex; //!< Serializes the console output of the modules
     inline static const bool NO_FLOODING = true;
 
     // For stats export
@@ -111,7 +129,7 @@ public:
     World *world;
     Lattice *lattice;
     Catoms3D::Catoms3DBlock *catom;
-    MeshCoating::MeshRuleMatcher *ruleMatcher;
+    static RunLocal<const MeshCoating::MeshRuleMatcher*> ruleMatcher; //!< Shared by all the modules of the simulation
 
     /** CONTINUOUS FEEDING **/
     bool moduleWaitingOnBranch[4] = { false, false, false, false};
@@ -243,7 +261,7 @@ public:
      * Use to limit interruption events after top level S_RevZ arrived
      *  so that the simulation ends nicely for stat export
      */
-    static bool constructionOver;
+    static RunLocal<std::atomic<bool>> constructionOver;
 
     /**
      * Used to ensure that only one module on the RevZBranch train can claim the R position.
@@ -321,10 +339,17 @@ y the module
     void processReceivedMessage(MessagePtr msg, P2PNetworkInterface* sender);
 
     void startup() override;
+    void parseUserElements(TiXmlDocument *config) override;
     void processLocalEvent(EventPtr pev) override;
     void onBlockSelected() override;
     void onAssertTriggered() override;
 
+    //!< Snapshots hold the whole state of the modules, and the counters they share (see Snapshot)
+    bool saveState(BaseSimulator::SnapshotWriter &w) const override;
+    void restoreState(BaseSimulator::SnapshotReader &r) override;
+    void saveSharedState(BaseSimulator::SnapshotWriter &w) const override;
+    void restoreSharedState(BaseSimulator::SnapshotReader &r) override;
+
     static BlockCode *buildNewBlockCode(BuildingBlock *host) {
         return (new MeshAssemblyBlockCode((Catoms3DBlock*)host));
     }
@@ -333,7 +358,7 @@ y the module
      * Add initial sandbox modules to the lattice
      */
     void initializeSandbox();
-    static bool sandboxInitialized;
+    static RunLocal<std::atomic<bool>> sandboxInitialized;
 
     /**
      * Transforms a shifted grid position into a mesh absolute position.
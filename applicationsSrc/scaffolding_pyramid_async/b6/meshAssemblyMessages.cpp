@@ -2,6 +2,7 @@
 #include <sstream>
 
 #include "utils.h"
+#include "snapshot.h"
 
 #include "teleportationEvents.h"
 #include "rotation3DEvents.h"
@@ -415,7 +416,7 @@ void ProbePivotLightStateMessage::handle(BaseSimulator::BlockCode* bc) {
 
           //PERLA FAULT TOLERANCE SOLUTION      ////////////////////////////////
 
-            if(mabc.brokenInterfaces[mabc.catom->getInterfaceId(tlitf)]
+            if(mabc.isBroken(tlitf)
                 and not mabc.bridgedInterfaces[mabc.catom->getInterfaceId(tlitf)]) {
                 
                 // if helper exist
@@ -430,8 +431,11 @@ void ProbePivotLightStateMessage::handle(BaseSimulator::BlockCode* bc) {
                     static_cast<MeshAssemblyBlockCode*>(sourceInterface->hostBlock->blockCode);
                 Cell3DPosition pos2;
                 mabc.catom->getNeighborPos(mabc.catom->getInterfaceId(tlitf), pos2);
-                cout << "bridgingPos: " << block->bridgingPosition(mabc.catom->position, pos2)
-                     << endl;
+                {
+                    lock_guard<mutex> lock(MeshAssemblyBlockCode::consoleMutex);
+                    cout << "bridgingPos: " << block->bridgingPosition(mabc.catom->position, pos2)
+                         << endl;
+                }
                 mabc.catom->setColor(MAGENTA);
                 mabc.sendMessage(new ReachBridgingPosition(mabc.catom->position, pos2,
                                                            mabc.catom->getInterfaceId(tlitf)),
@@ -620,20 +624,75 @@ void FinalTargetReachedMessage::handle(BaseSimulator::BlockCode* bc) {
     // get a pointer to the block that received the msg
     MeshAssemblyBlockCode& mabc = *static_cast<MeshAssemblyBlockCode*>(bc);
 
-    if(mabc.catom->blockId == 66 or mabc.catom->blockId == 94 or mabc.catom->blockId == 93 or mabc.catom->blockId == 110) {
-        // cout << this->sourceInterface->getConnectedBlockId() << endl;
-        // // this->sourceInterface = nullptr;
-        // int interfaceId = mabc.catom->getInterfaceId(this->destinationInterface);
-        // mabc.brokenInterfaces[interfaceId] = true;
-        // cout << "broken interface: " << mabc.catom->getInterfaceId(this->destinationInterface) << endl;
-        mabc.catom->setColor(BLACK);
+    if (MeshAssemblyBlockCode::finalTargetReachedBreaks.get().count(mabc.catom->blockId))
         mabc.breakInterface(this->destinationInterface);
-
-        //BaseSimulator::getScheduler()->toggle_pause();
-    }
+    else
+        mabc.isBroken(this->destinationInterface);
 
     VS_ASSERT(mabc.lattice->cellsAreAdjacent(mabc.catom->position, finalPos));
     if (not mabc.greenLightIsOn) {
         mabc.SET_GREEN_LIGHT(true);
     }
 }
+
+// Restoration of the messages pending in a snapshot, from their wire fields (see Snapshot)
+
+Message* RequestTargetCellMessage::restore(BaseSimulator::SnapshotReader &r) {
+    Cell3DPosition srcPos;
+    bID srcId;
+    r.read(srcPos, srcId);
+    return new RequestTargetCellMessage(srcPos, srcId);
+}
+
+Message* ProvideTargetCellMessage::restore(BaseSimulator::SnapshotReader &r) {
+    Cell3DPosition tPos, dstPos;
+    r.read(tPos, dstPos);
+    return new ProvideTargetCellMessage(tPos, dstPos);
+}
+
+Message* CoordinatorReadyMessage::restore(BaseSimulator::SnapshotReader &r) {
+    return new CoordinatorReadyMessage();
+}
+
+Message* TileInsertionReadyMessage::restore(BaseSimulator::SnapshotReader &r) {
+    return new TileInsertionReadyMessage();
+}
+
+Message* ReachBridgingPosition::restore(BaseSimulator::SnapshotReader &r) {
+    Cell3DPosition srcPos, dstPos;
+    int brokenInterfaceID;
+    r.read(srcPos, dstPos, brokenInterfaceID);
+    return new ReachBridgingPosition(srcPos, dstPos, brokenInterfaceID);
+}
+
+Message* HelperPositionReachedMessage::restore(BaseSimulator::SnapshotReader &r) {
+    int brokenInterfaceID;
+    Cell3DPosition targetPosition;
+    r.read(brokenInterfaceID, targetPosition);
+    return new HelperPositionReachedMessage(brokenInterfaceID, targetPosition);
+}
+
+Message* RequestAdditionalModule::restore(BaseSimulator::SnapshotReader &r) {
+    uint8_t epl;
+    r.read(epl);
+    return new RequestAdditionalModule((MeshComponent)epl);
+}
+
+Message* ProbePivotLightStateMessage::restore(BaseSimulator::SnapshotReader &r) {
+    Cell3DPosition srcPos, targetPos, finalTargetPos;
+    uint8_t finalComponent;
+    r.read(srcPos, targetPos, finalTargetPos, finalComponent);
+    return new ProbePivotLightStateMessage(srcPos, targetPos, (MeshComponent)finalComponent, finalTargetPos);
+}
+
+Message* GreenLightIsOnMessage::restore(BaseSimulator::SnapshotReader &r) {
+    Cell3DPosition srcPos, dstPos, newTargetPosition;
+    r.read(srcPos, dstPos, newTargetPosition);
+    return new GreenLightIsOnMessage(srcPos, dstPos, newTargetPosition);
+}
+
+Message* FinalTargetReachedMessage::restore(BaseSimulator::SnapshotReader &r) {
+    Cell3DPosition finalPos;
+    r.read(finalPos);
+    return new FinalTargetReachedMessage(finalPos);
+}
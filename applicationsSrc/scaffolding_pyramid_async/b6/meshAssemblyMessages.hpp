@@ -19,6 +19,8 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*) override;
     virtual Message* clone() const override { return new RequestTargetCellMessage(*this); }
+    static Message* restore(BaseSimulator::SnapshotReader &r);
+    MESSAGE_WIRE_FIELDS(srcPos, srcId)
     virtual string getName() const override { return "RequestTargetCell{" + srcPos.to_string()
             + ", " + to_string(srcId) + "}"; }
 };
@@ -33,6 +35,8 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*) override;
     virtual Message* clone() const override { return new ProvideTargetCellMessage(*this); }
+    static Message* restore(BaseSimulator::SnapshotReader &r);
+    MESSAGE_WIRE_FIELDS(tPos, dstPos)
     virtual string getName() const override { return "ProvideTargetCell{" + tPos.to_string()
             + ", " + dstPos.to_string() + "}"; }
 };
@@ -49,6 +53,8 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*) override;
     virtual Message* clone() const override { return new CoordinatorReadyMessage(*this); }
+    static Message* restore(BaseSimulator::SnapshotReader &r);
+    MESSAGE_WIRE_FIELDS()
     virtual string getName() const override { return "CoordinatorReady"; }
 };
 
@@ -61,6 +67,7 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*) override;
     virtual Message* clone() const override { return new TileNotReadyMessage(*this); }
+    MESSAGE_WIRE_FIELDS(dstPos)
     virtual string getName() const override { return "TileNotReady"; }
 };
 
@@ -71,6 +78,8 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*) override;
     virtual Message* clone() const override { return new TileInsertionReadyMessage(*this); }
+    static Message* restore(BaseSimulator::SnapshotReader &r);
+    MESSAGE_WIRE_FIELDS()
     virtual string getName() const override { return "TileInsertionReady"; }
 };
 
@@ -100,6 +109,8 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*) override;
     virtual Message* clone() const override { return new ReachBridgingPosition(*this); }
+    static Message* restore(BaseSimulator::SnapshotReader &r);
+    MESSAGE_WIRE_FIELDS(srcPos, dstPos, brokenInterfaceID)
     virtual string getName() const override { return "ReachBridgingPosition{" + srcPos.to_string()
             + ", " + dstPos.to_string() + "}"; }
 };
@@ -117,6 +128,8 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*) override;
     virtual Message* clone() const override { return new HelperPositionReachedMessage(*this); }
+    static Message* restore(BaseSimulator::SnapshotReader &r);
+    MESSAGE_WIRE_FIELDS(brokenInterfaceID, targetPosition)
     virtual string getName() const override { return "HelperPositionReached{" + targetPosition.to_string() +"}";
     }
 };
@@ -127,13 +140,15 @@ class RequestAdditionalModule : public HandleableMessage {
    MeshComponent epl;
 public:
     RequestAdditionalModule()
-        : HandleableMessage(){};
+        : HandleableMessage(), epl(R){};
     RequestAdditionalModule(MeshComponent _epl)
         : HandleableMessage(), epl(_epl){};
    
     virtual ~RequestAdditionalModule() {};
     virtual void handle(BaseSimulator::BlockCode*) override;
     virtual Message* clone() const override { return new RequestAdditionalModule(*this); }
+    static Message* restore(BaseSimulator::SnapshotReader &r);
+    MESSAGE_WIRE_FIELDS((uint8_t)epl)
     virtual string getName() const override { return "RequestAdditionalModule{}";};
 
 };
@@ -151,6 +166,7 @@ class PositionToSwapMessage: public HandleableMessage {
 
     virtual void handle(BaseSimulator::BlockCode*) override;
     virtual Message* clone() const override { return new PositionToSwapMessage(*this); }
+    MESSAGE_WIRE_FIELDS(targetPosition, srcPos, dstPos, (uint8_t)itf.localId)
     virtual string getName() const override { return "PositionToSwap{" + targetPosition.to_string() +"}";
     }
 
@@ -186,6 +202,8 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*) override;
     virtual Message* clone() const override { return new ProbePivotLightStateMessage(*this); }
+    static Message* restore(BaseSimulator::SnapshotReader &r);
+    MESSAGE_WIRE_FIELDS(srcPos, targetPos, finalTargetPos, (uint8_t)finalComponent)
     virtual string getName() const override { return "ProbePivotLightState{" + srcPos.to_string()
             + ", " + targetPos.to_string()
             +  ", " + finalTargetPos.to_string()
@@ -224,6 +242,8 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*) override;
     virtual Message* clone() const override { return new GreenLightIsOnMessage(*this); }
+    static Message* restore(BaseSimulator::SnapshotReader &r);
+    MESSAGE_WIRE_FIELDS(srcPos, dstPos, newTargetPosition)
     virtual string getName() const override { return "GreenLightIsOn{" + srcPos.to_string()
             + ", " + dstPos.to_string() + ", " + newTargetPosition.to_string() + "}";
     }
@@ -243,6 +263,8 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*) override;
     virtual Message* clone() const override { return new FinalTargetReachedMessage(*this); }
+    static Message* restore(BaseSimulator::SnapshotReader &r);
+    MESSAGE_WIRE_FIELDS(finalPos)
     virtual string getName() const override { return "FinalTargetReached{" + finalPos.to_string() +"}";
     }
 };
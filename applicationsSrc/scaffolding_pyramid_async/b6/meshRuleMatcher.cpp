@@ -1,5 +1,7 @@
 #include "meshRuleMatcher.hpp"
 
+#include <algorithm>
+
 #include "meshAssemblyLocalRules.hpp" // for B2
 
 #include "network.h"
@@ -133,11 +135,35 @@ Cell3DPosition MeshRuleMatcher::getPositionForComponent(MeshComponent comp) {
     return comp < 47 ? componentPosition[comp] : Cell3DPosition();
 }
 
+MeshRuleMatcher::ComponentLookup::ComponentLookup() {
+    Cell3DPosition max = componentPosition[0];
+    min = componentPosition[0];
+    for (const Cell3DPosition& cp : componentPosition) {
+        for (int i = 0; i < 3; i++) {
+            min.pt[i] = std::min(min[i], cp[i]);
+            max.pt[i] = std::max(max[i], cp[i]);
+        }
+    }
+
+    size = max - min + Cell3DPosition(1,1,1);
+    components.assign(size[0] * size[1] * size[2], -1);
+    // Iterated backwards so that the first component wins if two share a position
+    for (int i = RevZ_L_EPL; i >= 0; i--) {
+        const Cell3DPosition& rel = componentPosition[i] - min;
+        components[rel[0] + (rel[1] + rel[2] * size[1]) * size[0]] = i;
+    }
+}
+
 int MeshRuleMatcher::getComponentForPosition(const Cell3DPosition& pos) {
-    for (int i = 0; i <= RevZ_L_EPL; i++)
-        if (componentPosition[i] == pos) return i;
+    static const ComponentLookup lookup;
 
-    return -1;
+    const Cell3DPosition& rel = pos - lookup.min;
+    if (not (isInRange(rel[0], 0, lookup.size[0] - 1)
+             and isInRange(rel[1], 0, lookup.size[1] - 1)
+             and isInRange(rel[2], 0, lookup.size[2] - 1)))
+        return -1;
+
+    return lookup.components[rel[0] + (rel[1] + rel[2] * lookup.size[1]) * lookup.size[0]];
 }
 
 MeshComponent MeshRuleMatcher::getDefaultEPLComponentForBranch(BranchIndex bi) {
@@ -255,7 +281,34 @@ bool MeshRuleMatcher::isInGrid(const Cell3DPosition& pos) const {
         && isInRange(pos[2], 0, Z_MAX - 1);
 }
 
+MeshRuleMatcher::MeshRuleMatcher(const uint _X_MAX, const uint _Y_MAX, const uint _Z_MAX,
+                                 const uint _B) :
+    X_MAX(_X_MAX), Y_MAX(_Y_MAX), Z_MAX(_Z_MAX), B(_B) {
+    // Bounding box of isInGrid, which narrows down by one cell every two layers
+    gridMinXY = -std::max(Z_MAX - 1, 0) / 2 - 2;
+    gridSizeX = std::max(X_MAX + 1 - gridMinXY + 1, 0);
+    gridSizeY = std::max(Y_MAX + 1 - gridMinXY + 1, 0);
+    cellProperties.assign((size_t)gridSizeX * gridSizeY * std::max(Z_MAX, 0), 0);
+
+    for (int z = 0; z < Z_MAX; z++) {
+        for (int y = gridMinXY; y < gridMinXY + gridSizeY; y++) {
+            for (int x = gridMinXY; x < gridMinXY + gridSizeX; x++) {
+                const Cell3DPosition pos(x, y, z);
+                if (not computeIsInMesh(pos)) continue;
+
+                uint8_t& props = cellProperties[getCellIndex(pos)];
+                props = computeRoleForPosition(pos) | InMeshFlag;
+                if (computeIsInPyramid(pos)) props |= InPyramidFlag;
+            }
+        }
+    }
+}
+
 bool MeshRuleMatcher::isInMesh(const Cell3DPosition& pos) const {
+    return getCellProperties(pos) & InMeshFlag;
+}
+
+bool MeshRuleMatcher::computeIsInMesh(const Cell3DPosition& pos) const {
     return isInGrid(pos) and ((isOnXBranch(pos) or isOnYBranch(pos) or isOnZBranch(pos)
                                or isOnRevZBranch(pos) or isOnRZBranch(pos)
                                or isOnLZBranch(pos)
@@ -712,7 +765,11 @@ MeshRuleMatcher::getSupportPositionForPosition(const Cell3DPosition& pos) const
 }
 
 AgentRole MeshRuleMatcher::getRoleForPosition(const Cell3DPosition& pos) const {
-    if (not isInMesh(pos)) return AgentRole::FreeAgent;
+    return static_cast<AgentRole>(getCellProperties(pos) & RoleMask);
+}
+
+AgentRole MeshRuleMatcher::computeRoleForPosition(const Cell3DPosition& pos) const {
+    if (not computeIsInMesh(pos)) return AgentRole::FreeAgent;
     else {
         if (isTileRoot(pos)) return AgentRole::Coordinator;
         else if (isVerticalBranchTip(pos)) return AgentRole::ActiveBeamTip;
@@ -882,7 +939,11 @@ bool MeshRuleMatcher::isOnYOppPyramidBorder(const Cell3DPosition& pos) const {
 }
 
 bool MeshRuleMatcher::isInPyramid(const Cell3DPosition& pos) const {
-    return  isInMesh(pos) and isInRange(pos[0], 0, X_MAX - pos[2] - 2)
+    return getCellProperties(pos) & InPyramidFlag;
+}
+
+bool MeshRuleMatcher::computeIsInPyramid(const Cell3DPosition& pos) const {
+    return  computeIsInMesh(pos) and isInRange(pos[0], 0, X_MAX - pos[2] - 2)
         and isInRange(pos[1], 0, Y_MAX - pos[2] - 2);
 }
 
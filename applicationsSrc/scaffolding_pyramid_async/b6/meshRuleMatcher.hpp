@@ -2,6 +2,8 @@
 #define MESH_RULE_MATCHER_HPP_
 
 #include <array>
+#include <vector>
+#include <cstdint>
 
 #include "network.h"
 #include "cell3DPosition.h"
@@ -51,6 +53,52 @@ class MeshRuleMatcher {
      * Contains the insertion time of each meshComponent, indexed by their id
      */
     static std::array<int, 47> componentInsertionTime;
+
+    /**
+     * Inverse of componentPosition: id of the component at each position of the bounding box
+     *  of componentPosition, or -1
+     */
+    struct ComponentLookup {
+        Cell3DPosition min, size;
+        std::vector<int8_t> components;
+
+        ComponentLookup();
+    };
+
+    //!< Flags of the precomputed cell properties, the lowest bits holding the AgentRole
+    enum CellProperty : uint8_t { RoleMask = 0x07, InMeshFlag = 0x08, InPyramidFlag = 0x10 };
+
+    int gridMinXY;              //!< Lowest x and y of the grid (see isInGrid), reached at its top
+    int gridSizeX, gridSizeY;   //!< Extent of the bounding box of the grid along x and y
+
+    /**
+     * Role, mesh and pyramid membership of each cell of the bounding box of the grid,
+     *  indexed by getCellIndex. Filled by the constructor, never modified afterwards.
+     */
+    std::vector<uint8_t> cellProperties;
+
+    /**
+     * @param pos normalized position to evaluate
+     * @return index of pos in cellProperties, or -1 if pos is outside of the grid bounding box
+     */
+    inline int getCellIndex(const Cell3DPosition& pos) const {
+        const int x = pos[0] - gridMinXY, y = pos[1] - gridMinXY;
+        if (x < 0 or x >= gridSizeX or y < 0 or y >= gridSizeY or pos[2] < 0 or pos[2] >= Z_MAX)
+            return -1;
+
+        return x + (y + pos[2] * gridSizeY) * gridSizeX;
+    }
+
+    //!< Properties of pos, cells outside of the grid having none
+    inline uint8_t getCellProperties(const Cell3DPosition& pos) const {
+        const int i = getCellIndex(pos);
+        return i < 0 ? 0 : cellProperties[i];
+    }
+
+    // Rules from which cellProperties is computed
+    bool computeIsInMesh(const Cell3DPosition& pos) const;
+    bool computeIsInPyramid(const Cell3DPosition& pos) const;
+    AgentRole computeRoleForPosition(const Cell3DPosition& pos) const;
 public:
     bool isOnXBranch(const Cell3DPosition& pos) const;
     bool isOnXBorder(const Cell3DPosition& pos) const;
@@ -82,9 +130,12 @@ public:
     Cell3DPosition getOppositeBranchUnitOffset(int bi) const;
     BranchIndex getBranchIndexForNonRootPosition(const Cell3DPosition& pos) const;
 
+    /**
+     * Precomputes the properties of all the cells of the mesh. As the matcher only depends
+     *  on the mesh dimensions, a single instance is meant to be shared by all modules.
+     */
     MeshRuleMatcher(const uint _X_MAX, const uint _Y_MAX, const uint _Z_MAX,
-                                const uint _B) :
-        X_MAX(_X_MAX), Y_MAX(_Y_MAX), Z_MAX(_Z_MAX), B(_B) {};
+                                const uint _B);
     virtual ~MeshRuleMatcher() {};
 
     static string roleToString(AgentRole ar);
@@ -14,6 +14,7 @@
 #include "catoms3DWorld.h"
 #include "scheduler.h"
 #include "events.h"
+#include "statsCollector.h"
 #include "trace.h"
 #include "tDefs.h"
 
@@ -33,6 +34,7 @@ bool MeshAssemblyBlockCode::sandboxInitialized = false;
 uint MeshAssemblyBlockCode::X_MAX;
 uint MeshAssemblyBlockCode::Y_MAX;
 uint MeshAssemblyBlockCode::Z_MAX;
+MeshRuleMatcher *MeshAssemblyBlockCode::ruleMatcher = NULL;
 bool MeshAssemblyBlockCode::constructionOver = false;
 constexpr std::array<Cell3DPosition, 6> MeshAssemblyBlockCode::incidentTipRelativePos;
 constexpr std::array<Cell3DPosition, 12> MeshAssemblyBlockCode::entryPointRelativePos;
@@ -45,13 +47,16 @@ MeshAssemblyBlockCode::MeshAssemblyBlockCode(Catoms3DBlock *host):
     lattice = world->lattice;
     catom = host;
 
-    const Cell3DPosition& ub = lattice->getGridUpperBounds();
-    // Round down mesh dimensions to previous multiple of B
-    // TODO: Adapt to CSG
-    X_MAX = ub[0] - (B - ub[0] % B);
-    Y_MAX = ub[1] - (B - ub[1] % B);
-    Z_MAX = ub[2] - (B - ub[2] % B);
-    ruleMatcher = new MeshRuleMatcher(X_MAX, Y_MAX, Z_MAX, B);
+    // The rule matcher only depends on the dimensions of the lattice, hence is built once
+    if (not ruleMatcher) {
+        const Cell3DPosition& ub = lattice->getGridUpperBounds();
+        // Round down mesh dimensions to previous multiple of B
+        // TODO: Adapt to CSG
+        X_MAX = ub[0] - (B - ub[0] % B);
+        Y_MAX = ub[1] - (B - ub[1] % B);
+        Z_MAX = ub[2] - (B - ub[2] % B);
+        ruleMatcher = new MeshRuleMatcher(X_MAX, Y_MAX, Z_MAX, B);
+    }
 }
 
 MeshAssemblyBlockCode::~MeshAssemblyBlockCode() {
@@ -239,7 +244,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
     switch (pev->eventType) {
         case EVENT_RECEIVE_MESSAGE: {
             message =
-                (std::static_pointer_cast<NetworkInterfaceReceiveEvent>(pev))->message;
+                (static_pointer_cast<NetworkInterfaceReceiveEvent>(pev))->message;
 
             if (message->isMessageHandleable()) {
                 std::shared_ptr<HandleableMessage> hMsg =
@@ -248,7 +253,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
                 console << " received " << hMsg->getName() << " from "
                         << message->sourceInterface->hostBlock->blockId
                         << " at " << getScheduler()->now() << "\n";
-                hMsg->handle(this);
+                MessageTypeRegistry::handle(this, hMsg.get());
             } else {
                 P2PNetworkInterface * recv_interface = message->destinationInterface;
 
@@ -259,7 +264,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
 
         case EVENT_ADD_NEIGHBOR: {
             uint64_t face = Catoms3DWorld::getWorld()->lattice->
-                getOppositeDirection((std::static_pointer_cast<AddNeighborEvent>(pev))
+                getOppositeDirection((static_pointer_cast<AddNeighborEvent>(pev))
                                      ->face);
             const Cell3DPosition& pos = catom->getNeighborBlock(face)->position;
 
@@ -307,7 +312,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
         case EVENT_REMOVE_NEIGHBOR: {
             if (not rotating) {
                 if (role != FreeAgent) {
-                    uint64_t face = Catoms3DWorld::getWorld()->lattice->getOppositeDirection((std::static_pointer_cast<RemoveNeighborEvent>(pev))->face);
+                    uint64_t face = Catoms3DWorld::getWorld()->lattice->getOppositeDirection((static_pointer_cast<RemoveNeighborEvent>(pev))->face);
 
                     Cell3DPosition pos;
                     if (catom->getNeighborPos(face, pos)
@@ -323,7 +328,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
             break;
         }
         case EVENT_PIVOT_ACTUATION_START: {
-            std::shared_ptr<PivotActuationStartEvent> pase = std::static_pointer_cast
+            IntrusivePtr<PivotActuationStartEvent> pase = static_pointer_cast
                 <PivotActuationStartEvent>(pev);
 
             // A free agent module should never be used as pivot (for now)
@@ -341,7 +346,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
         } break;
 
         case EVENT_PIVOT_ACTUATION_END: {
-            // std::shared_ptr<PivotActuationEndEvent> paee = std::static_pointer_cast
+            // IntrusivePtr<PivotActuationEndEvent> paee = static_pointer_cast
             //     <PivotActuationEndEvent>(pev);
 
             // console << " finished actuating for module #" << paee->mobile->blockId << "\n";
@@ -404,6 +409,7 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
                          << "-PYRAMID CONSTRUCTION OVER AT TimeStep = "
                          << ts << " with " << lattice->nbModules << " modules" << endl;
                     constructionOver = true;
+                    utils::StatsCollector::getInstance().notifyCompletion(getScheduler()->now());
                 }
 
                 // STAT EXPORT
@@ -506,8 +512,8 @@ void MeshAssemblyBlockCode::processLocalEvent(EventPtr pev) {
         } break;
 
         case EVENT_INTERRUPTION: {
-            std::shared_ptr<InterruptionEvent> itev =
-                std::static_pointer_cast<InterruptionEvent>(pev);
+            IntrusivePtr<InterruptionEvent> itev =
+                static_pointer_cast<InterruptionEvent>(pev);
 
             switch(itev->mode) {
 
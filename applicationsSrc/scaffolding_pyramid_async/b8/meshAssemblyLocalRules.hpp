@@ -13,6 +13,7 @@
 #define MESHASSEMBLYLOCALRULES_HPP__
 
 #include "cell3DPosition.h"
+#include "../localRulesTable.hpp"
 
 #include <bitset>
 #include <utility>
@@ -22,36 +23,8 @@ using namespace std;
 
 #define B2 8 // This one is used to initialize BlockCode-wide constants
 
-class LRKeyTuple {
-    const std::bitset<12> lnBitset;
-    const Cell3DPosition tPos;
-    const short step;
-public:
-    constexpr LRKeyTuple(int ln, const Cell3DPosition& _tPos, const short _step)
-        : lnBitset(bitset<12>(ln)), tPos(_tPos), step(_step) {}
-
-    constexpr LRKeyTuple(const bitset<12>& _lnBitset, const Cell3DPosition& _tPos,
-                         const short _step)
-        : lnBitset(bitset<12>(_lnBitset)), tPos(_tPos), step(_step) {}
-
-    bool operator<(const LRKeyTuple &lrkt) const {
-        if (lnBitset.to_ulong() < lrkt.lnBitset.to_ulong()) return true;
-        else if (lnBitset.to_ulong() > lrkt.lnBitset.to_ulong()) return false;
-        else if (step < lrkt.step) return true;
-        else if (step > lrkt.step) return false;
-        else return tPos < lrkt.tPos;
-    }
-
-    bool operator==(const LRKeyTuple &lrkt) const {
-        return lnBitset.to_ulong() == lrkt.lnBitset.to_ulong()
-            and tPos == lrkt.tPos
-            and step == lrkt.step;
-    }
-};
-
-
 // CONTINUOUS FEEDING RULES
-static const std::map <const LRKeyTuple, const Cell3DPosition> localMotionRules =
+static constexpr LocalMotionRule localMotionRuleList[] =
 {
     // Corner XY Cases
     { LRKeyTuple(0x400, Cell3DPosition(-1, -1, 0), 3), Cell3DPosition(0, 1, -1) }, // S_RevZ 3
@@ -311,6 +284,10 @@ static const std::map <const LRKeyTuple, const Cell3DPosition> localMotionRules
 
 };
 
+// Compiled into a hash table keyed by the packed rule key (see localRulesTable.hpp)
+static constexpr auto localMotionRules = makeLocalRulesTable(localMotionRuleList);
+static_assert(localMotionRules.isValid(), "a local motion rule does not fit in a packed key");
+
 /**
  * Search for the next action among the local rules library
  * @param localNeighborhood a bitset representing the local neighborhood
@@ -327,12 +304,12 @@ inline static bool matchLocalRules(const std::bitset<12>& localNeighborhood,
                                    const Cell3DPosition& tileRootPos,
                                    const short step,
                                    Cell3DPosition& nextPos) {
-    auto match = localMotionRules.find(LRKeyTuple(localNeighborhood,
-                                                  tPos - tileRootPos, step));
+    const LocalMotionRule *match = localMotionRules.find(LRKeyTuple(localNeighborhood,
+                                                                    tPos - tileRootPos, step));
 
-    if (match != localMotionRules.end()) {
-        nextPos =  match->second + pos;
-        // cout << match->second << endl;
+    if (match) {
+        nextPos =  match->nextPos + pos;
+        // cout << match->nextPos << endl;
     } else {
         // cerr << "{ " << localNeighborhood << "("
         //      << int_to_hex_str((int)localNeighborhood.to_ulong(), 3) << ")"
@@ -340,7 +317,7 @@ inline static bool matchLocalRules(const std::bitset<12>& localNeighborhood,
         // cerr << "NO MATCH" << endl;
     }
 
-    return match != localMotionRules.end();
+    return match != NULL;
 }
 
 #endif /* MESHASSEMBLYLOCALRULES_HPP__ */
@@ -30,6 +30,7 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*);
     virtual Message* clone() const { return new RequestTargetCellMessage(*this); }
+    MESSAGE_WIRE_FIELDS(srcPos, srcId)
     virtual string getName() const { return "RequestTargetCell{" + srcPos.to_string()
             + ", " + to_string(srcId) + "}"; }
 };
@@ -44,6 +45,7 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*);
     virtual Message* clone() const { return new ProvideTargetCellMessage(*this); }
+    MESSAGE_WIRE_FIELDS(tPos, dstPos)
     virtual string getName() const { return "ProvideTargetCell{" + tPos.to_string()
             + ", " + dstPos.to_string() + "}"; }
 };
@@ -60,6 +62,7 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*);
     virtual Message* clone() const { return new CoordinatorReadyMessage(*this); }
+    MESSAGE_WIRE_FIELDS()
     virtual string getName() const { return "CoordinatorReady"; }
 };
 
@@ -72,6 +75,7 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*);
     virtual Message* clone() const { return new TileNotReadyMessage(*this); }
+    MESSAGE_WIRE_FIELDS(dstPos)
     virtual string getName() const { return "TileNotReady"; }
 };
 
@@ -82,6 +86,7 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*);
     virtual Message* clone() const { return new TileInsertionReadyMessage(*this); }
+    MESSAGE_WIRE_FIELDS()
     virtual string getName() const { return "TileInsertionReady"; }
 };
 
@@ -113,6 +118,7 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*);
     virtual Message* clone() const { return new ProbePivotLightStateMessage(*this); }
+    MESSAGE_WIRE_FIELDS(srcPos, targetPos, (uint8_t)finalComponent)
     virtual string getName() const { return "ProbePivotLightState{" + srcPos.to_string()
             + ", " + targetPos.to_string()
             + ", " + MeshRuleMatcher::component_to_string(finalComponent)
@@ -136,6 +142,7 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*);
     virtual Message* clone() const { return new GreenLightIsOnMessage(*this); }
+    MESSAGE_WIRE_FIELDS(srcPos, dstPos)
     virtual string getName() const { return "GreenLightIsOn{" + srcPos.to_string()
             + ", " + dstPos.to_string() + "}";
     }
@@ -155,6 +162,7 @@ public:
 
     virtual void handle(BaseSimulator::BlockCode*);
     virtual Message* clone() const { return new FinalTargetReachedMessage(*this); }
+    MESSAGE_WIRE_FIELDS(finalPos)
     virtual string getName() const { return "FinalTargetReached{" + finalPos.to_string() +"}";
     }
 };
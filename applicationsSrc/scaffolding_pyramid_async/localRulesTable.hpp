@@ -0,0 +1,156 @@
+/**
+ * @file   localRulesTable.hpp
+ * @brief  Compile-time lookup table of the local motion rules, shared by all B variants.
+ *
+ * Each variant lists its rules (meshAssemblyLocalRules.hpp) as an array of LocalMotionRule,
+ *  from which makeLocalRulesTable builds an open addressing hash table keyed by the packed
+ *  rule key. The table is built by the compiler, and is looked up in O(1) without any
+ *  allocation nor initialization at runtime.
+ */
+
+#ifndef LOCAL_RULES_TABLE_HPP__
+#define LOCAL_RULES_TABLE_HPP__
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+#include "cell3DPosition.h"
+
+/**
+ * Key of a local motion rule: local neighborhood of the matching module, target position
+ *  of the moving module relative to its tile root, and motion step. For lookups, it is
+ *  packed into a single 32 bits integer:
+ *  - bits 0-11: local neighborhood
+ *  - bits 12-26: relative target position, 5 bits per coordinate biased by coordBias
+ *  - bits 27-30: step
+ *  Keys that do not fit are packed as invalidKey, which matches no rule.
+ */
+class LRKeyTuple {
+    static constexpr int coordBits = 5;
+    static constexpr int coordBias = 1 << (coordBits - 1);
+    static constexpr int stepBits = 4;
+
+    unsigned long ln;
+    Cell3DPosition tPos;
+    short step;
+
+    static constexpr bool fits(int v, int bits) { return v >= 0 and v < (1 << bits); }
+public:
+    static constexpr uint32_t invalidKey = 1u << 31;
+
+    constexpr LRKeyTuple(int _ln, const Cell3DPosition& _tPos, const short _step)
+        : ln(_ln), tPos(_tPos), step(_step) {}
+
+    LRKeyTuple(const std::bitset<12>& _lnBitset, const Cell3DPosition& _tPos,
+               const short _step)
+        : ln(_lnBitset.to_ulong()), tPos(_tPos), step(_step) {}
+
+    constexpr unsigned long getNeighborhood() const { return ln; }
+    constexpr const Cell3DPosition& getTargetPosition() const { return tPos; }
+    constexpr short getStep() const { return step; }
+
+    //!< @return the packed key, or invalidKey if a field does not fit
+    constexpr uint32_t getKey() const {
+        const int x = tPos.pt[0] + coordBias, y = tPos.pt[1] + coordBias,
+            z = tPos.pt[2] + coordBias;
+
+        if (ln >= (1 << 12) or not fits(x, coordBits) or not fits(y, coordBits)
+            or not fits(z, coordBits) or not fits(step, stepBits))
+            return invalidKey;
+
+        return (uint32_t)ln
+            | (uint32_t)x << 12 | (uint32_t)y << (12 + coordBits)
+            | (uint32_t)z << (12 + 2 * coordBits) | (uint32_t)step << (12 + 3 * coordBits);
+    }
+
+    bool operator==(const LRKeyTuple &lrkt) const {
+        return ln == lrkt.ln and tPos == lrkt.tPos and step == lrkt.step;
+    }
+};
+
+/**
+ * A local motion rule: if the key matches, the moving module has to move to nextPos
+ */
+struct LocalMotionRule {
+    LRKeyTuple key;
+    Cell3DPosition nextPos; //!< next position of the moving module, relative to the matching module
+};
+
+/**
+ * Hash table of N local motion rules, linear probing with a load factor under 1/2.
+ *  As with the std::map it replaces, the first of several rules with the same key wins.
+ */
+template<std::size_t N>
+class LocalRulesTable {
+    static constexpr int computeSlotBits() {
+        int bits = 4;
+        while ((std::size_t(1) << bits) < 2 * N) bits++;
+        return bits;
+    }
+
+    static constexpr int slotBits = computeSlotBits();
+    static constexpr std::size_t nbSlots = std::size_t(1) << slotBits;
+    static constexpr std::size_t slotMask = nbSlots - 1;
+
+    const LocalMotionRule *rules;
+    uint32_t keys[nbSlots];     //!< packed key of each slot, LRKeyTuple::invalidKey if empty
+    uint16_t ruleIndex[nbSlots];  //!< index in rules of the rule in each slot
+    bool valid;                 //!< false if a rule key could not be packed
+
+    static constexpr std::size_t getHomeSlot(uint32_t key) {
+        // Fibonacci hashing, keeping the highest bits
+        return (uint32_t)(key * 2654435769u) >> (32 - slotBits);
+    }
+
+    constexpr std::size_t findSlot(uint32_t key) const {
+        std::size_t i = getHomeSlot(key);
+        while (keys[i] != key and keys[i] != LRKeyTuple::invalidKey)
+            i = (i + 1) & slotMask;
+
+        return i;
+    }
+public:
+    constexpr LocalRulesTable(const LocalMotionRule (&_rules)[N])
+        : rules(_rules), keys(), ruleIndex(), valid(true) {
+        for (std::size_t i = 0; i < nbSlots; i++) keys[i] = LRKeyTuple::invalidKey;
+
+        for (std::size_t r = 0; r < N; r++) {
+            const uint32_t key = rules[r].key.getKey();
+            if (key == LRKeyTuple::invalidKey) {
+                valid = false;
+                continue;
+            }
+
+            const std::size_t i = findSlot(key);
+            if (keys[i] == key) continue; // duplicate rule, first one kept
+            keys[i] = key;
+            ruleIndex[i] = r;
+        }
+    }
+
+    //!< @return true if all rule keys were packed successfully, to be checked by a static_assert
+    constexpr bool isValid() const { return valid; }
+
+    /**
+     * @param key key to search for
+     * @return the rule matching key, or NULL if there is none
+     */
+    const LocalMotionRule* find(const LRKeyTuple& key) const {
+        const uint32_t k = key.getKey();
+        if (k == LRKeyTuple::invalidKey) return NULL;
+
+        const std::size_t i = findSlot(k);
+        return keys[i] == k ? &rules[ruleIndex[i]] : NULL;
+    }
+};
+
+/**
+ * Builds the lookup table of a list of rules, to be called on a constexpr array
+ */
+template<std::size_t N>
+constexpr LocalRulesTable<N> makeLocalRulesTable(const LocalMotionRule (&rules)[N]) {
+    return LocalRulesTable<N>(rules);
+}
+
+#endif /* LOCAL_RULES_TABLE_HPP__ */
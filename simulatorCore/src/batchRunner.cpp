@@ -0,0 +1,206 @@
+/*! @file batchRunner.cpp
+ * @brief Batch mode, running a simulation per configuration file and seed of a batch file on
+ *  a pool of threads.
+ * @date 17/10/2026
+ */
+
+#include "batchRunner.h"
+
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include "commandLine.h"
+#include "simulator.h"
+#include "trace.h"
+#include "TinyXML/tinyxml.h"
+
+using namespace std;
+using namespace BaseSimulator::utils;
+
+namespace BaseSimulator {
+
+string BatchRunner::batchFile;
+int BatchRunner::nbThreads = 0;
+RunLocal<BatchRunner::Current> BatchRunner::current;
+
+namespace {
+
+//!< @brief Parses seeds, "first-last" or a single seed, appending them to seeds
+bool parseSeeds(const string &s, vector<int> &seeds) {
+    const size_t dash = s.find('-', 1);
+    try {
+        const int first = stoi(s.substr(0, dash));
+        const int last = dash == string::npos ? first : stoi(s.substr(dash + 1));
+        if (first < 0 or last < first) return false;
+        for (int seed = first; seed <= last; seed++) seeds.push_back(seed);
+    } catch (const std::logic_error&) {
+        return false;
+    }
+
+    return true;
+}
+
+//!< Discards the output of the simulations, from any thread
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+} // anonymous namespace
+
+bool BatchRunner::parse(const string &file, vector<Run> &runs, string &error) {
+    ifstream in(file);
+    if (not in) {
+        error = "cannot read batch file " + file;
+        return false;
+    }
+
+    map<string, TiXmlDocument*> documents;
+    string line;
+    int lineNumber = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        const size_t comment = line.find('#');
+        if (comment != string::npos) line.erase(comment);
+
+        stringstream ss(line);
+        string config, field;
+        if (not (ss >> config)) continue;
+
+        vector<int> seeds;
+        while (ss >> field) {
+            if (not parseSeeds(field, seeds)) {
+                error = file + ":" + to_string(lineNumber) + ": invalid seeds " + field
+                    + " (expected <seed> or <first>-<last>)";
+                return false;
+            }
+        }
+        if (seeds.empty()) {
+            error = file + ":" + to_string(lineNumber) + ": no seed for " + config;
+            return false;
+        }
+
+        // Ill-formed configuration files are reported now rather than by each of their simulations
+        TiXmlDocument *&document = documents[config];
+        if (not document) {
+            document = new TiXmlDocument(config.c_str());
+            if (not document->LoadFile() or not document->FirstChild("world")) {
+                error = file + ":" + to_string(lineNumber) + ": cannot load configuration file " + config;
+                return false;
+            }
+        }
+
+        for (int seed : seeds) runs.push_back({ config, seed, document });
+    }
+
+    if (runs.empty()) {
+        error = "no simulation in batch file " + file;
+        return false;
+    }
+
+    return true;
+}
+
+BatchRunner::Result BatchRunner::simulate(const Run &run, const CommandLine &cmdLine, int argc, char *argv[],
+                                          BlockCodeBuilder bcb, SimulatorBuilder build) {
+    RunContext context;
+    RunContext::adopt(&context);
+
+    CommandLine runCmdLine(cmdLine);
+    runCmdLine.setConfigFile(run.config);
+    runCmdLine.setSimulationSeed(run.seed);
+    current.get() = { &runCmdLine, run.document };
+
+    Result result;
+    try {
+        Simulator *simulator = build(argc, argv, bcb);
+        simulator->parseConfiguration(argc, argv);
+        simulator->startSimulation();
+        result.summary = ProcessPool::getSummary();
+        Simulator::deleteSimulator();
+    } catch (const std::exception&) {
+        result.failed = true;
+    }
+
+    RunContext::adopt(NULL);
+    return result;
+}
+
+void BatchRunner::run(const CommandLine &cmdLine, int argc, char *argv[],
+                      BlockCodeBuilder bcb, SimulatorBuilder build) {
+    vector<Run> runs;
+    string error;
+    if (not parse(batchFile, runs, error)) {
+        cerr << TermColor::ErrorColor << "error: " << error << TermColor::Reset << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    size_t nbWorkers = nbThreads > 0 ? nbThreads : max(1u, thread::hardware_concurrency());
+    nbWorkers = min(nbWorkers, runs.size());
+    cerr << "Running " << runs.size() << " simulations of " << batchFile << " on "
+         << nbWorkers << " thread(s)" << endl;
+
+    // The simulations are silent, and only their statistics are kept
+    Simulator::exportFinalConfiguration = false;
+    Simulator::regrTesting = false;
+    NullBuffer null;
+    streambuf *out = cout.rdbuf(&null);
+    streambuf *err = cerr.rdbuf(&null);
+
+    vector<Result> results(runs.size());
+    atomic<size_t> next { 0 };
+    vector<thread> workers;
+    for (size_t w = 0; w < nbWorkers; w++) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < runs.size(); i = next++)
+                results[i] = simulate(runs[i], cmdLine, argc, argv, bcb, build);
+        });
+    }
+    for (thread &t : workers) t.join();
+
+    cout.rdbuf(out);
+    cerr.rdbuf(err);
+
+    const size_t dot = batchFile.find_last_of('.');
+    const size_t slash = batchFile.find_last_of('/');
+    const string csvFile = (dot != string::npos and (slash == string::npos or dot > slash) ?
+                            batchFile.substr(0, dot) : batchFile) + ".csv";
+    ofstream csv(csvFile);
+    if (not csv) {
+        cerr << TermColor::ErrorColor << "error: cannot write " << csvFile << TermColor::Reset << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    csv << "config,seed,status,completionDate,nbMessages,endDate,nbEvents,realTime" << endl;
+    int nbCompleted = 0, nbFailed = 0;
+    for (size_t i = 0; i < runs.size(); i++) {
+        csv << runs[i].config << "," << runs[i].seed << ",";
+        if (results[i].failed) {
+            nbFailed++;
+            csv << "failed,,,,," << endl;
+            continue;
+        }
+
+        const ProcessPool::Summary &s = results[i].summary;
+        nbCompleted += s.completed;
+        csv << (s.completed ? "completed," : "incomplete,");
+        if (s.completed) csv << s.completionDate;
+        csv << "," << s.nbMessages << "," << s.endDate << "," << s.nbEvents << ","
+            << fixed << setprecision(0) << s.realTime << endl;
+    }
+
+    cout << runs.size() << " simulations: " << nbCompleted << " completed, "
+         << runs.size() - nbCompleted - nbFailed << " incomplete, " << nbFailed << " failed" << endl;
+    cout << "Results written to " << csvFile << endl;
+    exit(nbFailed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+} // BaseSimulator namespace
@@ -0,0 +1,114 @@
+/*! @file batchRunner.h
+ * @brief Batch mode, running a simulation per configuration file and seed of a batch file on
+ *  a pool of threads, each in its own context, and gathering their statistics into a CSV file.
+ * @date 17/10/2026
+ */
+
+#ifndef BATCHRUNNER_H_
+#define BATCHRUNNER_H_
+
+#include <string>
+#include <vector>
+
+#include "runContext.h"
+#include "processPool.h"
+
+class CommandLine;
+class TiXmlDocument;
+
+namespace BaseSimulator {
+
+class Simulator;
+class BlockCode;
+class BuildingBlock;
+typedef BlockCode *(*BlockCodeBuilder)(BuildingBlock*);
+typedef Simulator *(*SimulatorBuilder)(int argc, char *argv[], BlockCodeBuilder bcb);
+
+/**
+ * @brief Runs the simulations of a batch file, given with the -B command line option.
+ *
+ *  Each line of the batch file holds a configuration file and its seeds, a range or a list:
+ *  @code
+ *  # <config> <seeds>
+ *  config_3x3_cf_b6.xml 1-20
+ *  config_4x4_cf_b6.xml 1 5 9
+ *  @endcode
+ *  Relative paths are relative to the working directory. Each configuration file is parsed once,
+ *  and its document is shared by its simulations, which only read it. Every simulation shares the
+ *  other command line options.
+ *
+ *  The simulations are run by the threads of the process, each one with its own simulator, world
+ *  and scheduler, and its own instances of the run local variables (see RunContext). Block codes
+ *  keeping state in static variables must make them RunLocal for their simulations to be
+ *  independent. A simulation calling exit() or crashing ends the whole batch.
+ *  The statistics of the simulations are gathered into a CSV file named after the batch file, one
+ *  row per simulation, in batch order.
+ */
+class BatchRunner {
+    //!< Simulation of the batch
+    struct Run {
+        std::string config;
+        int seed;
+        TiXmlDocument *document;    //!< Configuration, shared by the runs of the same file
+    };
+
+    //!< Outcome of a simulation
+    struct Result {
+        bool failed = false;        //!< An exception was thrown by the simulation
+        ProcessPool::Summary summary;
+    };
+
+    //!< Simulation of the batch run by the calling thread, if any
+    struct Current {
+        const CommandLine *cmdLine = NULL;
+        TiXmlDocument *document = NULL;
+    };
+
+    static std::string batchFile;
+    static int nbThreads;       //!< Simulations run at once, 0 for the number of cores
+    static RunLocal<Current> current;
+
+    /**
+     * @brief Runs a simulation of the batch in a new context, on the calling thread
+     * @param run simulation to run
+     * @param cmdLine command line of the batch
+     * @return statistics of the simulation
+     */
+    static Result simulate(const Run &run, const CommandLine &cmdLine, int argc, char *argv[],
+                           BlockCodeBuilder bcb, SimulatorBuilder build);
+public:
+    static void setBatch(const std::string &file, int threads) {
+        batchFile = file;
+        nbThreads = threads;
+    }
+    static bool hasBatch() { return not batchFile.empty(); }
+
+    /**
+     * @brief Parses the batch file, and loads its configuration files
+     * @param runs filled with the simulations of the batch
+     * @param error set to the reason of the failure, if any
+     * @return false if the batch file cannot be read, is ill-formatted, or refers to a missing
+     *  or ill-formed configuration file
+     */
+    static bool parse(const std::string &file, std::vector<Run> &runs, std::string &error);
+
+    /**
+     * @brief Runs the simulations of the batch, writes their statistics and exits. Their standard
+     *  outputs are discarded, and they do not export their final configuration.
+     * @param cmdLine command line of the batch, shared by its simulations, which each set their
+     *  configuration file and seed
+     * @param bcb builder of the block codes
+     * @param build creates the simulator of a simulation
+     */
+    [[noreturn]] static void run(const CommandLine &cmdLine, int argc, char *argv[],
+                                 BlockCodeBuilder bcb, SimulatorBuilder build);
+
+    //!< @brief Returns the command line of the simulation run by the calling thread, NULL if none
+    static const CommandLine* getCommandLine() { return current.get().cmdLine; }
+    //!< @brief Returns the configuration of the simulation run by the calling thread, NULL if none
+    static TiXmlDocument* getDocument() { return current.get().document; }
+};
+
+} // BaseSimulator namespace
+
+#endif /* BATCHRUNNER_H_ */
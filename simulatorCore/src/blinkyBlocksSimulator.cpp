@@ -112,9 +112,9 @@ BlinkyBlocksSimulator::~BlinkyBlocksSimulator() {
 }
 
 void BlinkyBlocksSimulator::createSimulator(int argc, char *argv[], BlockCodeBuilder bcb) {
-    simulator =  new BlinkyBlocksSimulator(argc, argv, bcb);
-    simulator->parseConfiguration(argc, argv);
-    simulator->startSimulation();
+    Simulator::createSimulator(argc, argv, bcb, [](int argc, char *argv[], BlockCodeBuilder bcb) -> Simulator* {
+        return new BlinkyBlocksSimulator(argc, argv, bcb);
+    });
 }
 
 void BlinkyBlocksSimulator::loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
@@ -29,7 +29,7 @@ public:
 
     static BlinkyBlocksSimulator* getSimulator() {
     assert(simulator != NULL);
-    return((BlinkyBlocksSimulator*)simulator);
+    return((BlinkyBlocksSimulator*)simulator.get());
     }
 
     virtual void loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
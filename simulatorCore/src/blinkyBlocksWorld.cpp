@@ -45,12 +45,15 @@ BlinkyBlocksWorld::~BlinkyBlocksWorld() {
 }
 
 void BlinkyBlocksWorld::deleteWorld() {
-    delete((BlinkyBlocksWorld*)world);
+    delete((BlinkyBlocksWorld*)world.get());
 }
 
 void BlinkyBlocksWorld::addBlock(bID blockId, BlockCodeBuilder bcb,
                                  const Cell3DPosition &pos, const Color &col,
                                  short orientation, bool master) {
+    if (getScheduler()->deferWorldAction([=]() { addBlock(blockId, bcb, pos, col, orientation, master); }))
+        return;
+
     if (blockId > maxBlockId)
         maxBlockId = blockId;
     else if (blockId == 0)
@@ -78,7 +81,7 @@ void BlinkyBlocksWorld::addBlock(bID blockId, BlockCodeBuilder bcb,
 void BlinkyBlocksWorld::linkBlock(const Cell3DPosition &pos) {
     BlinkyBlocksBlock *ptrNeighbor;
     BlinkyBlocksBlock *ptrBlock = (BlinkyBlocksBlock*)lattice->getBlock(pos);
-    vector<Cell3DPosition> nRelCells = lattice->getRelativeConnectivity(pos);
+    const vector<Cell3DPosition> &nRelCells = lattice->getRelativeConnectivity(pos);
     Cell3DPosition nPos;
 
 
@@ -35,7 +35,7 @@ public:
     static void deleteWorld();
     static BlinkyBlocksWorld* getWorld() {
         assert(world != NULL);
-        return((BlinkyBlocksWorld*)world);
+        return((BlinkyBlocksWorld*)world.get());
     }
     void printInfo() {
         OUTPUT << "I'm a BlinkyBlocksWorld" << endl;
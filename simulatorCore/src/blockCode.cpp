@@ -17,7 +17,7 @@ using namespace std;
 
 namespace BaseSimulator {
 
-Target *BlockCode::target = NULL;
+RunLocal<Target*> BlockCode::target;
 
 BlockCode::InterfaceNotConnectedException::
 InterfaceNotConnectedException(BlockCode* bc, const Message* msg,
@@ -51,15 +51,18 @@ BlockCode::~BlockCode() {
         target = NULL;
     }
 
-    eventFuncMap.clear();
+    eventFuncs.clear();
 }
 
 void BlockCode::addMessageEventFunc(int type,eventFunc func) {
-    eventFuncMap.insert(pair<int,eventFunc>(type,func));
+    // As with the former multimap, the first handler of a type is the one called
+    if (type >= (int)eventFuncs.size()) eventFuncs.resize(type + 1);
+    if (not eventFuncs[type]) eventFuncs[type] = func;
 }
 
 void BlockCode::addMessageEventFunc2(int type, eventFunc2 func) {
-    eventFuncMap2.insert(pair<int,eventFunc2>(type,func));
+    if (type >= (int)eventFuncs2.size()) eventFuncs2.resize(type + 1);
+    if (not eventFuncs2[type]) eventFuncs2[type] = func;
 }
 
 int BlockCode::sendMessage(Message*msg,P2PNetworkInterface *dest,Time t0,Time dt) {
@@ -76,12 +79,14 @@ int BlockCode::sendMessage(HandleableMessage*msg,
         throw InterfaceNotConnectedException(this, msg, dest);
     }
 
-    console << " sends " << msg->getName() << " to "
-            << dest->getConnectedBlockId() << " at " << t1 << "\n";
+    if (TraceSink::isEnabled(TraceCategory::Console))
+        console << " sends " << msg->getName() << " to "
+                << dest->getConnectedBlockId() << " at " << t1 << "\n";
 #ifdef DEBUG_MESSAGES
-    OUTPUT << "#" << hostBlock->blockId << " " << hostBlock->position
-           << " sends " << msg->type << " to "
-           << dest->connectedInterface->hostBlock->blockId << " at " << t1 << endl;
+    if (TraceSink::isEnabled(TraceCategory::Message))
+        OUTPUT << "#" << hostBlock->blockId << " " << hostBlock->position
+               << " sends " << msg->type << " to "
+               << dest->connectedInterface->hostBlock->blockId << " at " << t1 << endl;
 #endif
 
     VS_ASSERT(dest->getConnectedBlockId() > 0);
@@ -100,16 +105,19 @@ int BlockCode::sendMessage(const char*msgString, Message*msg,
         throw InterfaceNotConnectedException(this, msg, dest);
     }
 
-    if (msgString)
-        console << " sends " << msgString << " to "
-                << dest->getConnectedBlockId() << " at " << t1 << "\n";
-    else if (msg->isMessageHandleable())
-        console << " sends " << msg->getMessageName() << " to "
-                << dest->getConnectedBlockId() << " at " << t1 << "\n";
+    if (TraceSink::isEnabled(TraceCategory::Console)) {
+        if (msgString)
+            console << " sends " << msgString << " to "
+                    << dest->getConnectedBlockId() << " at " << t1 << "\n";
+        else if (msg->isMessageHandleable())
+            console << " sends " << msg->getMessageName() << " to "
+                    << dest->getConnectedBlockId() << " at " << t1 << "\n";
+    }
 
 #ifdef DEBUG_MESSAGES
-    OUTPUT << hostBlock->blockId << " sends " << msg->type << " to "
-           << dest->connectedInterface->hostBlock->blockId << " at " << t1 << endl;
+    if (TraceSink::isEnabled(TraceCategory::Message))
+        OUTPUT << hostBlock->blockId << " sends " << msg->type << " to "
+               << dest->connectedInterface->hostBlock->blockId << " at " << t1 << endl;
 #endif
 
     scheduler->schedule(new NetworkInterfaceEnqueueOutgoingEvent(t1, msg, dest));
@@ -168,22 +176,23 @@ void BlockCode::processLocalEvent(EventPtr pev) {
     // cout << "event #" << pev->id << ":" << pev->eventType << endl;
     switch (pev->eventType) {
         case EVENT_NI_RECEIVE: {
-            message = (std::static_pointer_cast<NetworkInterfaceReceiveEvent>(pev))->message;
-            // search message id in eventFuncMap
-            multimap<int,eventFunc>::iterator im = eventFuncMap.find(message->type);
-            multimap<int,eventFunc2>::iterator im2 = eventFuncMap2.find(message->type);
-            if (im!=eventFuncMap.end()) {
-                P2PNetworkInterface *recv_interface = message->destinationInterface;
-                (*im).second(this,message,recv_interface);
-            } else if (im2 != eventFuncMap2.end()) {
-                P2PNetworkInterface *recv_interface = message->destinationInterface;
-                (*im2).second(message,recv_interface);
+            message = (static_pointer_cast<NetworkInterfaceReceiveEvent>(pev))->message;
+            P2PNetworkInterface *recv_interface = message->destinationInterface;
+            const unsigned int type = message->type;
+            if (message->isMessageHandleable()) {
+                MessageTypeRegistry::handle(this, static_cast<HandleableMessage*>(message.get()));
+            } else if (messageRegistry and messageRegistry->dispatch(this, message, recv_interface)) {
+                // Handled by the handler of the block code class
+            } else if (type < eventFuncs.size() and eventFuncs[type]) {
+                eventFuncs[type](this,message,recv_interface);
+            } else if (type < eventFuncs2.size() and eventFuncs2[type]) {
+                eventFuncs2[type](message,recv_interface);
             } else {
                 OUTPUT << "ERROR: message Id #"<< message->type << " unknown!" << endl;
             }
         } break;
         case EVENT_TAP: {
-            int face = (std::static_pointer_cast<TapEvent>(pev))->tappedFace;
+            int face = (static_pointer_cast<TapEvent>(pev))->tappedFace;
             onTap(face);
         } break;
         case EVENT_TELEPORTATION_END: {
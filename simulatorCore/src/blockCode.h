@@ -11,13 +11,16 @@
 #include <inttypes.h>
 #include <memory>
 #include <map>
+#include <vector>
 
 #include "trace.h"
 #include "target.h"
+#include "intrusivePtr.h"
+#include "messageRegistry.h"
 #include "TinyXML/tinyxml.h"
 
 class Event;
-typedef std::shared_ptr<Event> EventPtr;
+typedef BaseSimulator::IntrusivePtr<Event> EventPtr;
 class Message;
 class HandleableMessage;
 class P2PNetworkInterface;
@@ -28,8 +31,10 @@ class Scheduler;
 class Lattice;
 class BuildingBlock;
 class BlockCode;
+class SnapshotWriter;
+class SnapshotReader;
 
-typedef std::function<void (BlockCode*,std::shared_ptr<Message>,P2PNetworkInterface*)> eventFunc;
+typedef MessageHandler eventFunc;
 typedef std::function<void (std::shared_ptr<Message>,P2PNetworkInterface*)> eventFunc2;
 
 /**
@@ -48,13 +53,14 @@ private:
 public:
     BuildingBlock *hostBlock;   //!< The block to which this instance of the user program belongs
     Time availabilityDate = 0; //!< If the host is busy, the date at which it will be available
-    std::multimap<int,eventFunc> eventFuncMap; //!< container of function pointers to message handlers, indexed by message typeID
-    std::multimap<int,eventFunc2> eventFuncMap2; //!< container of function pointers to message handlers, indexed by message typeID
+    MessageTypeRegistry *messageRegistry = NULL; //!< Message handlers shared by all the instances of the block code class, see registerMessageHandler
+    std::vector<eventFunc> eventFuncs; //!< Message handlers of this instance, indexed by message typeID (addMessageEventFunc)
+    std::vector<eventFunc2> eventFuncs2; //!< Message handlers of this instance, indexed by message typeID (addMessageEventFunc2)
 
     Scheduler *scheduler; //!< pointer to the single instance of scheduler of the simulation
     Lattice *lattice;  //!< pointer to the single instance of lattice of the simulation
     ConsoleStream console;  //!< pointer to the single instance of ConsoleStream of the simulation
-    static Target *target; //!< pointer shared by all blockCodes to the current target configuration
+    static RunLocal<Target*> target; //!< pointer shared by all blockCodes to the current target configuration
 
     Cell3DPosition motionDest; //!< Only used for motion export for animations
 
@@ -122,6 +128,25 @@ public:
      */
     static bool loadNextTarget();
 
+    /**
+     * @brief Registers the handler of messages of type type for all the instances of block code
+     *  class BC. Only the first registration of a type is taken into account, hence it can be
+     *  done from the constructor of BC. Dispatch is then a vector lookup, see MessageTypeRegistry.
+     * @param type ID of the message for which a handler needs to be registered
+     * @param handler member function of BC handling the message
+     * @param name name of the message type in the statistics (-i)
+     * example: registerMessageHandler<SimpleColorCode>(BROADCAST_MSG, &SimpleColorCode::myBroadcastFunc); */
+    template<class BC>
+    void registerMessageHandler(int type, void (BC::*handler)(std::shared_ptr<Message>,P2PNetworkInterface*),
+                                const std::string &name = "") {
+        messageRegistry = &MessageTypeRegistry::get<BC>();
+        if (not messageRegistry->hasHandler(type))
+            messageRegistry->registerHandler(type, [handler](BlockCode *bc, std::shared_ptr<Message> msg,
+                                                             P2PNetworkInterface *itf) {
+                (static_cast<BC*>(bc)->*handler)(std::move(msg), itf);
+            }, name);
+    }
+
     /**
      * @brief Add a new message handler to the block code, for message with message type type
      * @param type ID of the message for which a handler needs to be registered
@@ -133,7 +158,8 @@ public:
      * @param type ID of the message for which a handler needs to be registered
      * @param eventFunc the message handling function as a std::function
      * @note see https://en.cppreference.com/w/cpp/utility/functional/function#Member_functions
-     * example: addMessageEventFunc2(BROADCAST_MSG, std::bind(&SimpleColorCode::myBroadcastFunc, this, std::placeholders::_1, std::placeholders::_2)); */
+     * example: addMessageEventFunc2(BROADCAST_MSG, std::bind(&SimpleColorCode::myBroadcastFunc, this, std::placeholders::_1, std::placeholders::_2));
+     * @note registerMessageHandler avoids storing a copy of the handler in every instance */
     void addMessageEventFunc2(int type,eventFunc2);
 
     /**
@@ -207,6 +233,29 @@ public:
      * @note call is made from World::GlDraw
      */
     virtual void onGlDraw() {};
+
+    /**
+     * @brief Writes the state of this instance of the block code to a snapshot (see Snapshot),
+     *  in the wire format of the messages. Block codes supporting snapshots override it
+     *  together with restoreState.
+     * @return false if the state of the block code cannot be saved (default)
+     */
+    virtual bool saveState(SnapshotWriter &w) const { return false; };
+
+    /**
+     * @brief Reads back the state written by saveState, in place of the initial state of the
+     *  instance, when resuming a snapshot
+     */
+    virtual void restoreState(SnapshotReader &r) {};
+
+    /**
+     * @brief Writes the state shared by all the instances of the block code class (static
+     *  members) to a snapshot. Called on a single instance, after saveState.
+     */
+    virtual void saveSharedState(SnapshotWriter &w) const {};
+
+    //!< @brief Reads back the state written by saveSharedState
+    virtual void restoreSharedState(SnapshotReader &r) {};
 };
 
 } // BaseSimulator namespace
@@ -6,19 +6,22 @@
  */
 
 #include <iostream>
+#include <sstream>
 
 #include "buildingBlock.h"
 #include "world.h"
 #include "simulator.h"
 #include "scheduler.h"
 #include "trace.h"
+#include "replayLog.h"
+#include "snapshot.h"
 
 using namespace std;
 
 namespace BaseSimulator {
 
-bID BuildingBlock::nextId = 0;
-bool BuildingBlock::userConfigHasBeenParsed = false;
+RunLocal<bID> BuildingBlock::nextId { 0 };
+RunLocal<bool> BuildingBlock::userConfigHasBeenParsed { false };
 
 //===========================================================================================================
 //
@@ -178,7 +181,7 @@ unsigned short BuildingBlock::getNbNeighbors() const {
 
 bool BuildingBlock::getNeighborPos(short connectorId,Cell3DPosition &pos) const {
   Lattice *lattice = getWorld()->lattice;
-	vector<Cell3DPosition> nCells = lattice->getRelativeConnectivity(position);
+	const vector<Cell3DPosition> &nCells = lattice->getRelativeConnectivity(position);
 	pos = position + nCells[connectorId];
 	return lattice->isInGrid(pos);
 }
@@ -252,7 +255,9 @@ void BuildingBlock::tap(Time date, int face) {
 }
 
 ruint BuildingBlock::getRandomUint() {
-    return generator();
+    const ruint v = generator();
+    if (ReplayLog::isEnabled()) ReplayLog::noteDraw(v);
+    return v;
 }
 
 void BuildingBlock::setClock(Clock *c) {
@@ -305,4 +310,41 @@ int BuildingBlock::getFaceForNeighborID(int nId) const {
 	return -1;
 }
 
+void BuildingBlock::save(SnapshotWriter &w) const {
+    if (not dynamic_cast<const PerfectClock*>(clock)) {
+        stringstream err;
+        err << "module " << blockId << " has a drifting clock, whose state cannot be saved";
+        throw SnapshotException(err.str());
+    }
+
+    // Local events first, restoring a SetColorEvent draws from the generator of the block
+    w.writeVarint(localEventsList.size());
+    for (const EventPtr &ev : localEventsList) w.writeEvent(ev);
+    w.write(generator, color.rgba, isMaster, motionsStuck, stats != NULL);
+    if (stats) stats->save(w);
+
+    w.writeVarint(P2PNetworkInterfaces.size());
+    for (const P2PNetworkInterface *itf : P2PNetworkInterfaces) itf->save(w);
+}
+
+void BuildingBlock::restore(SnapshotReader &r) {
+    localEventsList.clear();
+    for (size_t n = r.readCount(); n > 0; n--) localEventsList.push_back(r.readEvent());
+    Color c;
+    bool hasStats;
+    r.read(generator, c.rgba, isMaster, motionsStuck, hasStats);
+    setColor(c);
+    color = c;
+    if (hasStats != (stats != NULL))
+        throw SnapshotException("per module statistics (-i) must be enabled both when saving and resuming");
+    if (stats) stats->restore(r);
+
+    if (r.readVarint() != P2PNetworkInterfaces.size()) {
+        stringstream err;
+        err << "module " << blockId << " does not have the interfaces of the snapshot";
+        throw SnapshotException(err.str());
+    }
+    for (P2PNetworkInterface *itf : P2PNetworkInterfaces) itf->restore(r);
+}
+
 } // BaseSimulator namespace
@@ -14,6 +14,8 @@
 #include <memory>
 
 #include "tDefs.h"
+#include "runContext.h"
+#include "intrusivePtr.h"
 #include "glBlock.h"
 #include "blockCode.h"
 #include "clock.h"
@@ -22,7 +24,7 @@
 #include "random.h"
 
 class Event;
-typedef std::shared_ptr<Event> EventPtr;
+typedef BaseSimulator::IntrusivePtr<Event> EventPtr;
 
 using namespace std;
 
@@ -33,6 +35,9 @@ namespace BaseSimulator {
 class BlockCode;
 class BuildingBlock;
 class Clock;
+class Snapshot;
+class SnapshotWriter;
+class SnapshotReader;
 
 typedef BlockCode *(*BlockCodeBuilder)(BuildingBlock*);
 
@@ -55,8 +60,8 @@ private:
      */
     std::atomic<State> state;
 protected:
-    static bID nextId;
-    static bool userConfigHasBeenParsed; //!< Indicates if the user parsing as already been performed by blockCode->parseUserElements. Used to ensure that user configuration is parsed only once.
+    static RunLocal<bID> nextId;
+    static RunLocal<bool> userConfigHasBeenParsed; //!< Indicates if the user parsing as already been performed by blockCode->parseUserElements. Used to ensure that user configuration is parsed only once.
 
     vector<P2PNetworkInterface*> P2PNetworkInterfaces; //!< Vector of size equal to the number of interfaces of the block, contains pointers to the block's interfaces
 
@@ -72,6 +77,7 @@ public:
     GlBlock *ptrGlBlock; //!< ptr to the GL object corresponding to this block
     BlockCodeBuilder buildNewBlockCode; //!< function ptr to the block's blockCodeBuilder
     utils::StatsIndividual *stats = NULL; //!< Module stats collected during the simulation
+    bool motionsStuck = false; //!< Motions of the block never start anymore (see FaultInjector)
     /**
      * @brief BuildingBlock constructor
      * @param bId : the block id of the block to create
@@ -285,6 +291,20 @@ public:
      */
     int getFaceForNeighborID(int nId) const;
     void setBlinkMode(bool b) { ptrGlBlock->isHighlighted=b; };
+
+    /**
+     * @brief Writes the state of the block and of its interfaces to a snapshot (see Snapshot).
+     *  Its id, state and position are saved with the lattice, and its block code separately.
+     * @throw SnapshotException if part of the state cannot be saved, such as a drifting clock
+     */
+    virtual void save(SnapshotWriter &w) const;
+    /**
+     * @brief Reads back the state written by save, once all the blocks of the snapshot have
+     *  been placed in the lattice
+     */
+    virtual void restore(SnapshotReader &r);
+
+    friend class Snapshot;
 };
 
 } // BaseSimulator namespace
@@ -52,7 +52,7 @@ int Catoms2DBlock::getDirection(P2PNetworkInterface *p2p) const {
 // PTHY: TODO: Take rotation into account
 Cell3DPosition Catoms2DBlock::getPosition(HLattice::Direction d) const {
     World *wrl = getWorld();
-    vector<Cell3DPosition> nCells = wrl->lattice->getRelativeConnectivity(position);
+    const vector<Cell3DPosition> &nCells = wrl->lattice->getRelativeConnectivity(position);
     return position + nCells[d];
 }
 
@@ -145,10 +145,11 @@ namespace Catoms2D {
     wrld->setGridPtr(gridPos.pt[0],gridPos.pt[1],gridPos.pt[2],rb);
     
 
-    stringstream info;
-    info.str("");
-    info << "connect Block " << rb->blockId;
-    getScheduler()->trace(info.str(),rb->blockId,LIGHTBLUE);
+    if (TraceSink::isEnabled(TraceCategory::Motion)) {
+        stringstream info;
+        info << "connect Block " << rb->blockId;
+        getScheduler()->trace(info.str(),rb->blockId,LIGHTBLUE,TraceCategory::Motion);
+    }
     wrld->connectBlock(rb);
     Catoms2DScheduler *scheduler = Catoms2D::getScheduler();
     scheduler->schedule(new MotionEndEvent(scheduler->now() + ANIMATION_DELAY, rb));
@@ -37,9 +37,9 @@ Catoms2DSimulator::~Catoms2DSimulator() {
 }
 
 void Catoms2DSimulator::createSimulator(int argc, char *argv[], BlockCodeBuilder bcb) {
-    simulator =  new Catoms2DSimulator(argc, argv, bcb);
-    simulator->parseConfiguration(argc, argv);
-    simulator->startSimulation();
+    Simulator::createSimulator(argc, argv, bcb, [](int argc, char *argv[], BlockCodeBuilder bcb) -> Simulator* {
+        return new Catoms2DSimulator(argc, argv, bcb);
+    });
 }
 
 void Catoms2DSimulator::loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
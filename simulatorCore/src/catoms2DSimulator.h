@@ -30,7 +30,7 @@ public:
 
     static Catoms2DSimulator* getSimulator() {
     assert(simulator != NULL);
-    return((Catoms2DSimulator*)simulator);
+    return((Catoms2DSimulator*)simulator.get());
     }
 
     virtual void loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
@@ -49,11 +49,14 @@ Catoms2DWorld::~Catoms2DWorld() {
 }
 
 void Catoms2DWorld::deleteWorld() {
-    delete((Catoms2DWorld*)world);
+    delete((Catoms2DWorld*)world.get());
 }
 void Catoms2DWorld::addBlock(bID blockId, BlockCodeBuilder bcb,
                              const Cell3DPosition &pos, const Color &col,
                              short orientation, bool master) {
+    if (getScheduler()->deferWorldAction([=]() { addBlock(blockId, bcb, pos, col, orientation, master); }))
+        return;
+
     if (blockId > maxBlockId)
         maxBlockId = blockId;
     else if (blockId == 0)
@@ -87,7 +90,7 @@ void Catoms2DWorld::addBlock(bID blockId, BlockCodeBuilder bcb,
 void Catoms2DWorld::linkBlock(const Cell3DPosition &pos) {
     Catoms2DBlock *ptrNeighbor;
     Catoms2DBlock *ptrBlock = (Catoms2DBlock*)lattice->getBlock(pos);
-    vector<Cell3DPosition> nRelCells = lattice->getRelativeConnectivity(pos);
+    const vector<Cell3DPosition> &nRelCells = lattice->getRelativeConnectivity(pos);
     Cell3DPosition nPos;
 
     // Check neighbors for each interface
@@ -36,7 +36,7 @@ public:
     static void deleteWorld();
     static Catoms2DWorld* getWorld() {
     assert(world != NULL);
-    return((Catoms2DWorld*)world);
+    return((Catoms2DWorld*)world.get());
     }
 
     void printInfo() {
@@ -12,6 +12,7 @@
 #include "catoms3DSimulator.h"
 #include "trace.h"
 #include "catoms3DMotionEngine.h"
+#include "snapshot.h"
 
 using namespace std;
 
@@ -238,6 +239,20 @@ void Catoms3DBlock::removeNeighbor(P2PNetworkInterface *ni) {
 								getWorld()->lattice->getOppositeDirection(getDirection(ni))));
 }
 
+void Catoms3DBlock::save(SnapshotWriter &w) const {
+    BuildingBlock::save(w);
+    w.write(orientationCode);
+    w.writeBlock(pivot);
+}
+
+void Catoms3DBlock::restore(SnapshotReader &r) {
+    BuildingBlock::restore(r);
+    short code;
+    r.read(code);
+    pivot = static_cast<const Catoms3DBlock*>(r.readBlock());
+    setPositionAndOrientation(position, code);
+}
+
 Catoms3DBlock *Catoms3DBlock::getNeighborBlock(const Cell3DPosition& nPos) const {     
     return static_cast<Catoms3DBlock*>(getWorld()->lattice->getBlock(nPos));
 }
@@ -258,9 +273,9 @@ bool Catoms3DBlock::canRotateToPosition(const Cell3DPosition &pos,
 
 std::bitset<12> Catoms3DBlock::getLocalNeighborhoodState() const {
     bitset<12> bitset = {0};
-    const vector<Cell3DPosition> localNeighborhood =
-        Catoms3DWorld::getWorld()->lattice->getNeighborhood(position);
-        
+    CellNeighborhood localNeighborhood;
+    Catoms3DWorld::getWorld()->lattice->getNeighborhood(position, localNeighborhood);
+
     for (const Cell3DPosition& nPos : localNeighborhood) {
         P2PNetworkInterface *itf = getInterface(nPos);
         bitset.set(getAbsoluteDirection(nPos), itf->isConnected());
@@ -56,7 +56,7 @@ class Catoms3DBlock : public BaseSimulator::BuildingBlock {
 public :
     short orientationCode; //!< number of the connector that is along the x axis.
     int distanceToBorder; // for printing optimisation
-    const Catoms3DBlock *pivot; //!< if currently rotating, pivot a pointer to its motion pivot
+    const Catoms3DBlock *pivot = NULL; //!< if currently rotating, pivot a pointer to its motion pivot
 public:
     /**
        @brief Constructor
@@ -203,6 +203,15 @@ public:
      */
     virtual void removeNeighbor(P2PNetworkInterface *ni) override;
 
+    /**
+     * @copydoc BuildingBlock::save
+     * Adds the orientation of the module and its pivot
+     */
+    void save(BaseSimulator::SnapshotWriter &w) const override;
+    /**
+     * @copydoc BuildingBlock::restore
+     */
+    void restore(BaseSimulator::SnapshotReader &r) override;
 };
 
 std::ostream& operator<<(std::ostream &stream, Catoms3DBlock const& bb);
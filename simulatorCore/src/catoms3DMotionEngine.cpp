@@ -2,6 +2,7 @@
 
 #include "utils.h"
 #include <vector>
+#include <algorithm>
 
 const Catoms3DMotionRulesLink*
 Catoms3DMotionEngine::findConnectorLink(const Catoms3DBlock *module,
@@ -83,15 +84,15 @@ Catoms3DMotionEngine::findPivotLinkPairsForTargetCell(const Catoms3DBlock* m,
         Catoms3DWorld* world = Catoms3D::getWorld();
         Lattice* lattice = world->lattice;
 
-        vector<Cell3DPosition> mActiveCells = lattice->getActiveNeighborCells(m->position);
-        vector<Cell3DPosition> tPosActiveCells = lattice->getActiveNeighborCells(tPos);
-
-        const vector<Cell3DPosition>& adjacentCells =
-            utils::intersection(mActiveCells, tPosActiveCells);
+        // Occupied neighbors of m that are also adjacent to tPos, in increasing order
+        CellNeighborhood adjacentCells;
+        lattice->getActiveNeighborCells(m->position, adjacentCells);
+        std::sort(adjacentCells.begin(), adjacentCells.end());
 
         // Check for a pivot with a direct connector path between the two cells
         Catoms3DBlock* pivot = NULL;
         for (const Cell3DPosition& pPos : adjacentCells) {
+            if (not lattice->cellsAreAdjacent(tPos, pPos)) continue;
             pivot = static_cast<Catoms3DBlock*>(lattice->getBlock(pPos));
 
             // Do no allow rotating modules to actuate for others
@@ -159,8 +160,9 @@ Catoms3DMotionEngine::getAllRotationsForModule(const Catoms3DBlock* m) {
     vector<std::pair<const Catoms3DMotionRulesLink*, Rotations3D>> allRotations;
 
     if (m) {
-        for (const Cell3DPosition& nPos : World::getWorld()->lattice->
-                 getFreeNeighborCells(m->position)) {
+        CellNeighborhood freeCells;
+        World::getWorld()->lattice->getFreeNeighborCells(m->position, freeCells);
+        for (const Cell3DPosition& nPos : freeCells) {
             const vector<std::pair<Catoms3DBlock*, const Catoms3DMotionRulesLink*>>
                 pivotLinkPairs = findPivotLinkPairsForTargetCell(m, nPos);
 
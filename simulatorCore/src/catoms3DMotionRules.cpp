@@ -107,6 +107,28 @@ Catoms3DMotionRules::Catoms3DMotionRules() {
     addLinks4(7,5,0,9,right,-rup,-lup);
     addLinks4(2,5,4,3,left,lup,rup); // PTHA: CHECK
     addLinks4(8,9,10,11,left,lup,rup); // PTHA: CHECK
+
+    // indexing of the links, ordered by source connector
+    int n=0;
+    for (int i=0; i<12; i++) {
+        for (Catoms3DMotionRulesLink *lnk : tabConnectors[i]->tabLinks) {
+            assert(n < nbLinks);
+            lnk->index = n;
+            tabLinks[n++] = lnk;
+            linksFromConnector[i].set(lnk->index);
+            linksToConnector[lnk->getConToID()].set(lnk->index);
+        }
+    }
+    assert(n == nbLinks);
+
+    // valid surface links for each occupancy of the neighborhood
+    validLinksForOccupancy.resize(1 << 12);
+    for (unsigned short occupied=0; occupied < validLinksForOccupancy.size(); occupied++) {
+        for (int i=0; i<nbLinks; i++) {
+            if (isValidSurfaceLink(tabLinks[i], occupied, 0))
+                validLinksForOccupancy[occupied].set(i);
+        }
+    }
 }
 
 Catoms3DMotionRules::~Catoms3DMotionRules() {
@@ -313,55 +335,66 @@ bool Catoms3DMotionRules::getValidMotionList(const Catoms3DBlock* c3d,
     return notEmpty;
 }
 
-bool Catoms3DMotionRules::getValidSurfaceLinksOnCatom(const Catoms3DBlock* catom,
-                                                      vector<Catoms3DMotionRulesLink*>& links) {
+bool Catoms3DMotionRules::isValidSurfaceLink(const Catoms3DMotionRulesLink *link,
+                                             unsigned short occupied,
+                                             unsigned short unreachable) {
+    int from = link->getConFromID();
+    int conTo = link->getConToID();
+
+    // Destination must be in lattice and free
+    if ((occupied | unreachable) & (1 << conTo)) return false;
+
+    // list of cells that must be free
+    // We do not consider the source conector as blocking since their could be a moving module on there, but all the other ones are potentially blocking
+    const int *ptr;
+    int n;
+    if (link->isOctaFace()) {
+        ptr = findTab4(from,conTo);
+        n = 4;
+    } else { // isHexaFace
+        ptr = findTab3(from,conTo);
+        n = 3;
+    }
+
+    for (int i=0; i<n; i++) {
+        if (ptr[i]!=from && ptr[i]!=conTo && (occupied & (1 << ptr[i]))) return false;
+    }
+
+    return true;
+}
+
+void Catoms3DMotionRules::getConnectorsOccupancy(const Catoms3DBlock* catom,
+                                                 unsigned short &occupied,
+                                                 unsigned short &unreachable,
+                                                 unsigned short *oppositeOccupied) const {
     Lattice *lattice = Catoms3DWorld::getWorld()->lattice;
+    Cell3DPosition pos;
+
+    occupied = 0;
+    unreachable = 0;
+    if (oppositeOccupied) *oppositeOccupied = 0;
 
-    for (short from = 0; from < 12; from++) {
-        Catoms3DMotionRulesConnector *con = tabConnectors[from];
-        Cell3DPosition fromAdjPos;
-
-        // We do not consider the source conector as blocking since their could be a moving module on there, but all the other ones are potentially blocking
-        catom->getNeighborPos(from, fromAdjPos);
-
-        for (Catoms3DMotionRulesLink *link : con->tabLinks) {
-            int conTo = link->getConToID();
-            bool isOk = false;
-            Cell3DPosition pos;
-
-            // Destination must be in lattice and free
-            catom->getNeighborPos(conTo,pos);
-            isOk = lattice->isInGrid(pos) && !lattice->cellHasBlock(pos);
-
-            // list of cells that must be free
-            if (link->isOctaFace()) {
-                const int *ptr = findTab4(from,conTo);
-                int i=0;
-                while (isOk && i<4) {
-                    if (ptr[i]!=from && ptr[i]!=conTo) {
-                        catom->getNeighborPos(ptr[i],pos);
-                        isOk = !lattice->cellHasBlock(pos);
-                    }
-                    i++;
-                }
-            } else { // isHexaFace
-                const int *ptr = findTab3(from,conTo);
-                int i=0;
-                while (isOk && i<3) {
-                    if (ptr[i]!=from && ptr[i]!=conTo) {
-                        catom->getNeighborPos(ptr[i],pos);
-                        isOk = !lattice->cellHasBlock(pos);
-                    }
-                    i++;
-                }
-            }
-
-            if (isOk) {
-                links.push_back(link);
-                // OUTPUT << "ADD " << from << " -> " << conTo << endl;
-            }
+    for (short c = 0; c < 12; c++) {
+        if (!catom->getNeighborPos(c, pos) || !lattice->isInGrid(pos)) {
+            unreachable |= 1 << c;
+            continue;
         }
-    } // for
+
+        if (lattice->cellHasBlock(pos)) occupied |= 1 << c;
+        if (oppositeOccupied && lattice->cellHasBlock(2*pos - catom->position))
+            *oppositeOccupied |= 1 << c;
+    }
+}
+
+bool Catoms3DMotionRules::getValidSurfaceLinksOnCatom(const Catoms3DBlock* catom,
+                                                      vector<Catoms3DMotionRulesLink*>& links) {
+    unsigned short occupied, unreachable;
+    getConnectorsOccupancy(catom, occupied, unreachable);
+
+    const LinkSet valid = getValidSurfaceLinks(occupied, unreachable);
+    for (int i=0; i<nbLinks; i++) {
+        if (valid[i]) links.push_back(tabLinks[i]);
+    }
 
     return !links.empty();
 }
@@ -371,62 +404,27 @@ bool Catoms3DMotionRules::getValidMotionListFromPivot(const Catoms3DBlock* pivot
                                                       vector<Catoms3DMotionRulesLink*>&vec,
                                                       const FCCLattice *lattice,
                                                       const Target *target) {
-    Catoms3DMotionRulesConnector *conn = tabConnectors[from];
     bool notEmpty=false;
-    bool isOk;
     Cell3DPosition pos,pos2;
 
     // source must be free or is not in goal
     pivot->getNeighborPos(from,pos);
-//OUTPUT << "FROM pos=" << pos << endl;
     if (lattice->cellHasBlock(pos)
         && (target != NULL && target->isInTarget(pos)) ) return false;
     pos2 = pos + pos - pivot->position;
-//OUTPUT << "OPP FROM pos=" << pos2 << endl;
     if (lattice->cellHasBlock(pos2)) return false;
 
-    vector <Catoms3DMotionRulesLink*>::const_iterator ci=conn->tabLinks.begin();
-    while (ci!=conn->tabLinks.end()) {
-        int to = (*ci)->getConToID();
-        //OUTPUT << from << " -> " << to << ", ";
-        // destination must be in lattice and free
-        pivot->getNeighborPos(to,pos);
-//OUTPUT << "TO pos=" << pos << endl;
-        isOk = lattice->isInGrid(pos) && !lattice->cellHasBlock(pos);
-        // opposite cell must be free
-        pos2 = 2*pos - pivot->position;
-//OUTPUT << "OPP TO pos=" << pos2 << endl;
-        isOk = isOk && !lattice->cellHasBlock(pos2);
-
-        // list of cells that must be free
-        if ((*ci)->isOctaFace()) {
-            const int *ptr = findTab4(from,to);
-            int i=0;
-            while (isOk && i<4) {
-                if (ptr[i]!=from && ptr[i]!=to) {
-                    pivot->getNeighborPos(ptr[i],pos);
-                    isOk = !lattice->cellHasBlock(pos);
-                }
-                i++;
-            }
-        } else {
-            const int *ptr = findTab3(from,to);
-            int i=0;
-            while (isOk && i<3) {
-                if (ptr[i]!=from && ptr[i]!=to) {
-                    pivot->getNeighborPos(ptr[i],pos);
-                    isOk = !lattice->cellHasBlock(pos);
-                }
-                i++;
-            }
-        }
+    // destination must be in lattice and free, as well as the opposite cell
+    unsigned short occupied, unreachable, oppositeOccupied;
+    getConnectorsOccupancy(pivot, occupied, unreachable, &oppositeOccupied);
 
-        if (isOk) {
-            vec.push_back(*ci);
-            //OUTPUT << "ADD " << from << " -> " << to << endl;
+    const LinkSet valid = getValidSurfaceLinks(occupied, unreachable | oppositeOccupied)
+        & linksFromConnector[from];
+    for (int i=0; i<nbLinks; i++) {
+        if (valid[i]) {
+            vec.push_back(tabLinks[i]);
             notEmpty=true;
         }
-        ci++;
     }
 
     return notEmpty;
@@ -1,6 +1,8 @@
 #ifndef CATOMS3DMOTIONRULES_H
 #define CATOMS3DMOTIONRULES_H
 
+#include <bitset>
+
 #include "lattice.h"
 #include "catoms3DBlock.h"
 #include "rotation3DEvents.h"
@@ -35,6 +37,9 @@ class Catoms3DMotionRulesLink {
     Vector3D axis2; //!< second rotation axis
     vector <int> tabBlockingIDs; //!< array of blocking ID
     RotationLinkType MRLT;
+    unsigned short index = 0; //!< rank of the link in Catoms3DMotionRules, links being ordered by source connector
+
+    friend class Catoms3DMotionRules;
 public :
     Catoms3DMotionRulesLink(RotationLinkType m,
                             Catoms3DMotionRulesConnector *from,
@@ -55,6 +60,7 @@ public :
     inline bool isOctaFace() const { return MRLT==OctaFace; };
     inline bool isHexaFace() const { return MRLT==HexaFace; };
     inline RotationLinkType getMRLT() const { return MRLT; };
+    inline unsigned short getIndex() const { return index; };
 
     // inline Catoms3DLinkDirection getDirection() { return Catoms3DLinkDirection(axis1, axis2); };
 
@@ -133,7 +139,23 @@ public :
     \brief Define the graph of possible motions for a 3D Catom
 **/
 class Catoms3DMotionRules {
+public:
+    static const int nbLinks = 120; //!< 6 links per hexagonal face (8) and 12 per octagonal face (6)
+    typedef std::bitset<nbLinks> LinkSet; //!< set of links, bit i standing for the link of index i
+
+private:
     Catoms3DMotionRulesConnector *tabConnectors[12]; //!< array of connector rules
+    Catoms3DMotionRulesLink *tabLinks[nbLinks]; //!< all links, ordered by source connector
+    /**
+     * Links that a module could take on the surface of a catom, indexed by the occupancy
+     * mask of the 12 cells adjacent to its connectors (bit c for connector c).
+     * Computed once from the links definition, so that finding the valid links on the surface
+     * of a pivot only requires a single lookup instead of walking all the links of all connectors.
+     */
+    std::vector<LinkSet> validLinksForOccupancy;
+    LinkSet linksToConnector[12]; //!< links whose destination is connector c
+    LinkSet linksFromConnector[12]; //!< links whose source is connector c
+
 public:
     Catoms3DMotionRules();
     virtual ~Catoms3DMotionRules();
@@ -216,6 +238,47 @@ public:
     bool getValidSurfaceLinksOnCatom(const Catoms3DBlock* pivot,
                                      vector<Catoms3DMotionRulesLink*>& links);
 
+    /**
+     * @brief Computes the state of the cells adjacent to the connectors of catom
+     * @param catom the catom to consider
+     * @param occupied set to the mask of connectors whose adjacent cell holds a module
+     * @param unreachable set to the mask of connectors whose adjacent cell is not in the lattice
+     * @param oppositeOccupied if not NULL, set to the mask of connectors c such that the cell
+     *  next to the one adjacent to c, in the direction of c, holds a module
+     */
+    void getConnectorsOccupancy(const Catoms3DBlock* catom, unsigned short &occupied,
+                                unsigned short &unreachable,
+                                unsigned short *oppositeOccupied = NULL) const;
+
+    /**
+     * @brief Returns all the links that a module could take on the surface of a catom, given
+     *  the state of the cells adjacent to its connectors (see getConnectorsOccupancy)
+     * @param occupied mask of connectors whose adjacent cell holds a module
+     * @param unreachable mask of connectors whose adjacent cell cannot be a destination
+     * @return the set of valid links, as indices in getLink
+     */
+    inline LinkSet getValidSurfaceLinks(unsigned short occupied, unsigned short unreachable) const {
+        LinkSet links = validLinksForOccupancy[occupied];
+        for (short c = 0; unreachable; c++, unreachable >>= 1) {
+            if (unreachable & 1) links &= ~linksToConnector[c];
+        }
+        return links;
+    }
+
+    /**
+     * @brief Reference validity check of a single surface link, by walking the connectors of
+     *  the face it goes through. Used to build the lookup table of getValidSurfaceLinks.
+     * @param link the link to check
+     * @param occupied mask of connectors whose adjacent cell holds a module
+     * @param unreachable mask of connectors whose adjacent cell cannot be a destination
+     * @return true if the destination of link is free and reachable, and if all the other cells adjacent to its face are free
+     */
+    static bool isValidSurfaceLink(const Catoms3DMotionRulesLink *link,
+                                   unsigned short occupied, unsigned short unreachable);
+
+    //!< @brief Returns the link of index i
+    inline Catoms3DMotionRulesLink* getLink(int i) const { return tabLinks[i]; }
+
     /** 
      * Attempts to mtach a surface link from a pivot to a connector link for a connected 
      *  mobile module to follow
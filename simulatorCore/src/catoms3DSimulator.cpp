@@ -36,9 +36,9 @@ Catoms3DSimulator::~Catoms3DSimulator() {
 }
 
 void Catoms3DSimulator::createSimulator(int argc, char *argv[], BlockCodeBuilder bcb) {
-    simulator = new Catoms3DSimulator(argc, argv, bcb);
-    simulator->parseConfiguration(argc, argv);
-    simulator->startSimulation();
+    Simulator::createSimulator(argc, argv, bcb, [](int argc, char *argv[], BlockCodeBuilder bcb) -> Simulator* {
+        return new Catoms3DSimulator(argc, argv, bcb);
+    });
 }
 
 void Catoms3DSimulator::loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
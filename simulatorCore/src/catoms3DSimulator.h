@@ -30,7 +30,7 @@ public:
 
     static Catoms3DSimulator* getSimulator() {
     assert(simulator != NULL);
-    return((Catoms3DSimulator*)simulator);
+    return((Catoms3DSimulator*)simulator.get());
     }
 
     virtual void loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
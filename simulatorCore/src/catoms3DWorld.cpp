@@ -19,6 +19,7 @@
 #include "configExporter.h"
 #include "rotation3DEvents.h"
 #include "simulator.h"
+#include "snapshot.h"
 
 using namespace std;
 using namespace BaseSimulator::utils;
@@ -72,6 +73,12 @@ Catoms3DWorld::Catoms3DWorld(const Cell3DPosition &gridSize, const Vector3D &gri
 #endif
 
     motionRules = new Catoms3DMotionRules();
+
+    // Pending rotations can be saved in snapshots
+    Snapshot::registerEvent(EVENT_ROTATION3D_START, &Rotation3DStartEvent::restore);
+    Snapshot::registerEvent(EVENT_ROTATION3D_STEP, &Rotation3DStepEvent::restore);
+    Snapshot::registerEvent(EVENT_ROTATION3D_STOP, &Rotation3DStopEvent::restore);
+    Snapshot::registerEvent(EVENT_ROTATION3D_END, &Rotation3DEndEvent::restore);
 }
 
 Catoms3DWorld::~Catoms3DWorld() {
@@ -83,7 +90,7 @@ Catoms3DWorld::~Catoms3DWorld() {
 }
 
 void Catoms3DWorld::deleteWorld() {
-    delete((Catoms3DWorld*)world);
+    delete((Catoms3DWorld*)world.get());
 }
 
 void Catoms3DWorld::createPopupMenu(int ix, int iy) {
@@ -182,7 +189,7 @@ void Catoms3DWorld::menuChoice(int n) {
             GlutContext::popupSubMenu->show(false);
             GlutContext::popupMenu->show(false);
             if (bb->getNeighborPos(numSelectedFace,nPos)) {
-                int orient = rand()%24;
+                int orient = bb->getRandomUint() % 24;
                 addBlock(0, bb->buildNewBlockCode,nPos,bb->color,orient,false);
                 linkBlock(nPos);
                 linkNeighbors(nPos);
@@ -212,6 +219,9 @@ void Catoms3DWorld::menuChoice(int n) {
 
 void Catoms3DWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPosition &pos,
                              const Color &col, short orientation, bool master) {
+    if (getScheduler()->deferWorldAction([=]() { addBlock(blockId, bcb, pos, col, orientation, master); }))
+        return;
+
     if (blockId > maxBlockId)
         maxBlockId = blockId;
     else if (blockId == 0)
@@ -222,10 +232,7 @@ void Catoms3DWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPosi
                              (catom->blockId, (BaseSimulator::BuildingBlock*)catom));
 
     // FIXME: Adversarial start, randomly initiate start event
-    std::mt19937 rng;
-    rng.seed(Simulator::getSimulator()->getCmdLine().getSimulationSeed());
-    std::uniform_int_distribution<std::mt19937::result_type> u500(0,500);
-    // getScheduler()->schedule(new CodeStartEvent(getScheduler()->now() + u500(rng), catom));
+    // getScheduler()->schedule(new CodeStartEvent(getScheduler()->now() + catom->getRandomUint() % 501, catom));
     getScheduler()->schedule(new CodeStartEvent(getScheduler()->now(), catom));
 
     Catoms3DGlBlock *glBlock = new Catoms3DGlBlock(blockId);
@@ -148,7 +148,7 @@ public:
     static void deleteWorld();
     static Catoms3DWorld* getWorld() {
         assert(world != NULL);
-        return((Catoms3DWorld*)world);
+        return((Catoms3DWorld*)world.get());
     }
 
     void printInfo() {
@@ -42,10 +42,10 @@ clockNoise_t GClockNoise::getNoise(Time simTime) {
 //
 //==============================================================================
 
-vector<DClockNoise::noiseSignal_t> DClockNoise::noiseSignals;
+RunLocal<vector<DClockNoise::noiseSignal_t>> DClockNoise::noiseSignals;
 
 DClockNoise::DClockNoise(unsigned int _seed) {
-  id = _seed % noiseSignals.size();
+  id = _seed % noiseSignals.get().size();
 }
 
 DClockNoise::~DClockNoise() {}
@@ -54,7 +54,7 @@ void DClockNoise::loadData(vector<string> &files) {
   Time time;
   clockNoise_t noise;
 
-  noiseSignals.clear();
+  noiseSignals.get().clear();
   for (unsigned int i = 0; i < files.size(); i++) {
     ifstream file (files[i].c_str());
     noiseSignal_t signal;
@@ -64,7 +64,7 @@ void DClockNoise::loadData(vector<string> &files) {
 	signal.push_back(p);
       }
       file.close();
-      noiseSignals.push_back(signal);
+      noiseSignals.get().push_back(signal);
     } else {
       cerr << "Unable to open file" << endl;
     }
@@ -73,8 +73,8 @@ void DClockNoise::loadData(vector<string> &files) {
 
 void DClockNoise::print() {
   int i = 0;
-  for (vector<noiseSignal_t>::iterator it1 = noiseSignals.begin();
-       it1 != noiseSignals.end(); it1++) {
+  for (vector<noiseSignal_t>::iterator it1 = noiseSignals.get().begin();
+       it1 != noiseSignals.get().end(); it1++) {
     noiseSignal_t &signal = *it1;
     cout << "noise: " << i << endl;
     i++;
@@ -102,11 +102,11 @@ clockNoise_t DClockNoise::getNoise(Time simTime, referencePt_t p1, referencePt_t
 }
 
 clockNoise_t DClockNoise::getNoise(Time simTime) {
-  if (id >= noiseSignals.size()) {
+  if (id >= noiseSignals.get().size()) {
     cerr << "ERROR: wrong noise id (" << id << ")" << endl;
     return 0;
   }
-  noiseSignal_t &signal = noiseSignals[id];
+  noiseSignal_t &signal = noiseSignals.get()[id];
   // identify interval "time" belongs to.
 
   if (signal.size() == 0) {
@@ -6,6 +6,7 @@
 #include <string>
 
 #include "tDefs.h"
+#include "runContext.h"
 #include "random.h"
 
 using namespace std;
@@ -65,7 +66,7 @@ class DClockNoise : public ClockNoise {
   typedef pair<Time, clockNoise_t> referencePt_t;
   typedef vector<referencePt_t> noiseSignal_t;
  private:
-  static vector<noiseSignal_t> noiseSignals;//!< Noise signals
+  static RunLocal<vector<noiseSignal_t>> noiseSignals;//!< Noise signals
   unsigned int id;//!< Index of the noise in noiseSignals
 
   /**
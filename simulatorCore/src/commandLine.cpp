@@ -7,6 +7,12 @@
 #include "openglViewer.h"
 #include "simulator.h"
 #include "trace.h"
+#include "messageCodec.h"
+#include "faultInjector.h"
+#include "batchRunner.h"
+#include "replayLog.h"
+#include "schedulerProfiler.h"
+#include "snapshot.h"
 
 void CommandLine::help() const {
     cerr << TermColor::BWhite << "VisibleSim options:" << TermColor::Reset << endl;
@@ -30,14 +36,44 @@ void CommandLine::help() const {
          << "\tScheduler mode:\t(Default) Stop simulation when event list is empty\n"
          << "\t\t " << TermColor::BMagenta << "(maxDate)" << TermColor::Reset << "\tin microseconds, the scheduler will stop when the event list is empty, or when the maximum date has been reached\n"
          << "\t\t " << TermColor::BMagenta << "inf" << TermColor::Reset << "\t\tthe simulation will have an infinite duration and can only be stopped when the user presses the 'Q' key" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-q <queue>" << TermColor::Reset
+         << "\t\tScheduler event queue: map, heap, heap4 or calendar (Default)" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-M <fidelity>" << TermColor::Reset
+         << "\t\tMotion fidelity: animated (Default with GUI) or logical (Default in terminal mode, motions skip their animation steps)" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-j <threads>[,<minWindow>]" << TermColor::Reset
+         << "\tParallel scheduler (terminal mode, C++ block codes): number of threads, and minimum number of events of a window for it to be processed by several threads (Default: 64)" << endl;
     cerr << "\t " << TermColor::BMagenta << "-m <VMpath>:<VMport>" << TermColor::Reset
-         << "\tPath to the MeldVM directory and port" << endl;
+         << "\tPath to the MeldVM directory and port, or shm[:<nbVMs>] to exchange commands through shared memory, with VMs calling meldProcessShmClient.h (Default: 1024 VMs at most)" << endl;
     cerr << "\t " << TermColor::BMagenta << "-k " << TermColor::Reset
          << "\t\t\tModule type for generic Block Code execution. Options: {BB, RB, SB, C2D, C3D, MR}" << endl;
     cerr << "\t " << TermColor::BMagenta << "-g " << TermColor::Reset
          << "\t\t\tEnable regression testing (export terminal configuration)" << endl;
     cerr << "\t " << TermColor::BMagenta << "-l " << TermColor::Reset
          << "\t\t\tEnable printing of log information to file simulation.log" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-b <file>" << TermColor::Reset
+         << "\t\tWrite log information to a compact binary trace file instead, from a background thread (see utilities/traceDecoder)" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-T <categories>" << TermColor::Reset
+         << "\tTraced categories, comma separated: log, trace, motion, message, console, all (Default) or none" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-w <file>" << TermColor::Reset
+         << "\t\tCapture the messages sent on each link, as hexadecimal wire bytes" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-F <fault>" << TermColor::Reset
+         << "\t\tInject a fault: <type>@<date>[-<dateMax>][:<blockId>[:<interface>[:<count>]]], with type among interfaceBreak, moduleDeath, messageDrop, stuckMotion. A date range or a missing module makes it random" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-C <campaigns>[,<processes>]" << TermColor::Reset
+         << "\tRun fault injection campaigns (with -t -R -s <maxDate>): a reference simulation, then <campaigns> simulations per type of fault, <processes> at once (Default: number of cores)" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-K <date>" << TermColor::Reset
+         << "\t\tFork date of the campaigns (-C only): the fault free simulation runs once up to <date>, then the simulations of the campaigns are forked from its state in memory. Faults must not occur before <date>" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-S <date>,<file>" << TermColor::Reset
+         << "\tSave a binary snapshot of the simulation to <file> (with -R), right before the first event at or after <date>" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-U <file>" << TermColor::Reset
+         << "\t\tResume the simulation from a snapshot (-S) of the same configuration file. With -C, the simulations of the campaigns are forked from it" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-B <batch>[,<threads>]" << TermColor::Reset
+         << "\tRun the simulations of a batch file (with -t -R) in this process, one line per configuration file: <config> <seed>|<first>-<last>..., <threads> at once (Default: number of cores). Their statistics are written to <batch>.csv" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-L <file>" << TermColor::Reset
+         << "\t\tRecord a replay log of the processed events: date, type, module and random draws" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-V <file>" << TermColor::Reset
+         << "\t\tCheck the processed events against a replay log (-L) recorded with the same scheduler (-j), and report the first divergence" << endl;
+    cerr << "\t " << TermColor::BMagenta << "-P <file>[,<period>]" << TermColor::Reset
+         << "\tProfile the scheduler: time spent per event type and message handler, written as folded stacks (flamegraph.pl), and event queue depth over time. One event in <period> is timed (16 by default, 1 for all)" << endl;
     cerr << "\t " << TermColor::BMagenta << "-i " << TermColor::Reset
          << "\t\t\tEnable printing more detailed simulation stats" << endl;
     cerr << "\t " << TermColor::BMagenta << "-a <seed>" << TermColor::Reset
@@ -77,7 +113,16 @@ void CommandLine::read(int argc, char *argv[], BlockCodeBuilder bcb) {
                     std::getline(vm, vmPath, ':');
                     std::getline(vm, portStr, ':');
                     try {
-                        vmPort = stoi(portStr);
+                        if (portStr == "shm") {
+                            vmSharedMemory = true;
+                            string slotsStr;
+                            if (std::getline(vm, slotsStr, ':'))
+                                vmSharedMemorySlots = stoi(slotsStr);
+                            if (vmSharedMemorySlots <= 0)
+                                throw CLIParsingError("MeldVM number of shared memory slots must be positive!");
+                        } else {
+                            vmPort = stoi(portStr);
+                        }
                     } catch(std::invalid_argument&) {
                         throw CLIParsingError("MeldVM port must be a number!");
                     }
@@ -145,6 +190,65 @@ void CommandLine::read(int argc, char *argv[], BlockCodeBuilder bcb) {
                     argv++;
                 } break;
 
+                case 'q': {
+                    if (argc < 2)
+                        throw CLIParsingError("No event queue type provided after -q option");
+
+                    if (not EventQueue::parseType(argv[1], eventQueueType)) {
+                        stringstream err;
+                        err << "Unknown event queue type: " << argv[1]
+                            << " (Expected map, heap, heap4 or calendar)" << endl;
+                        throw CLIParsingError(err.str());
+                    }
+
+                    argc--;
+                    argv++;
+                } break;
+
+                case 'M': {
+                    if (argc < 2)
+                        throw CLIParsingError("No motion fidelity provided after -M option");
+
+                    if (strcmp(argv[1], "animated") == 0) {
+                        motionFidelity = Simulator::ANIMATED;
+                    } else if (strcmp(argv[1], "logical") == 0) {
+                        motionFidelity = Simulator::LOGICAL;
+                    } else {
+                        stringstream err;
+                        err << "Unknown motion fidelity: " << argv[1]
+                            << " (Expected animated or logical)" << endl;
+                        throw CLIParsingError(err.str());
+                    }
+
+                    argc--;
+                    argv++;
+                } break;
+
+                case 'j': {
+                    if (argc < 2)
+                        throw CLIParsingError("No number of threads provided after -j option");
+
+                    string arg(argv[1]);
+                    size_t comma = arg.find(',');
+                    try {
+                        nbThreads = stoi(arg.substr(0, comma));
+                        if (comma != string::npos)
+                            minParallelWindow = stoull(arg.substr(comma + 1));
+                    } catch(std::logic_error&) {
+                        nbThreads = 0;
+                    }
+
+                    if (nbThreads < 1) {
+                        stringstream err;
+                        err << "Invalid parallel scheduler settings: " << argv[1]
+                            << " (Expected <threads>[,<minWindow>], with at least one thread)" << endl;
+                        throw CLIParsingError(err.str());
+                    }
+
+                    argc--;
+                    argv++;
+                } break;
+
                 case 't': {
                     GlutContext::GUIisEnabled = false;
                 } break;
@@ -164,6 +268,224 @@ void CommandLine::read(int argc, char *argv[], BlockCodeBuilder bcb) {
                     log_file.open("simulation.log");
                 } break;
 
+                case 'b' : {
+                    if (argc < 2)
+                        throw CLIParsingError("No trace file provided after -b option");
+
+                    if (not TraceSink::open(argv[1])) {
+                        stringstream err;
+                        err << "Cannot open trace file: " << argv[1] << endl;
+                        throw CLIParsingError(err.str());
+                    }
+
+                    argc--;
+                    argv++;
+                } break;
+
+                case 'w' : {
+                    if (argc < 2)
+                        throw CLIParsingError("No capture file provided after -w option");
+
+                    if (not WireCapture::open(argv[1])) {
+                        stringstream err;
+                        err << "Cannot open capture file: " << argv[1] << endl;
+                        throw CLIParsingError(err.str());
+                    }
+
+                    argc--;
+                    argv++;
+                } break;
+
+                case 'T' : {
+                    if (argc < 2)
+                        throw CLIParsingError("No trace categories provided after -T option");
+
+                    uint32_t categories;
+                    if (not TraceSink::parseCategories(argv[1], categories)) {
+                        stringstream err;
+                        err << "Unknown trace category in: " << argv[1]
+                            << " (Expected a comma separated list of log, trace, motion, message, console, all, none)" << endl;
+                        throw CLIParsingError(err.str());
+                    }
+                    TraceSink::setCategories(categories, true);
+
+                    argc--;
+                    argv++;
+                } break;
+
+                case 'F' : {
+                    if (argc < 2)
+                        throw CLIParsingError("No fault provided after -F option");
+
+                    Fault fault;
+                    if (not FaultInjector::parse(argv[1], fault)) {
+                        stringstream err;
+                        err << "Invalid fault: " << argv[1]
+                            << " (Expected <type>@<date>[-<dateMax>][:<blockId>[:<interface>[:<count>]]])" << endl;
+                        throw CLIParsingError(err.str());
+                    }
+                    FaultInjector::add(fault);
+
+                    argc--;
+                    argv++;
+                } break;
+
+                case 'C' : {
+                    if (argc < 2)
+                        throw CLIParsingError("No number of campaigns provided after -C option");
+
+                    string arg(argv[1]);
+                    size_t comma = arg.find(',');
+                    int campaigns = 0, processes = 0;
+                    try {
+                        campaigns = stoi(arg.substr(0, comma));
+                        if (comma != string::npos)
+                            processes = stoi(arg.substr(comma + 1));
+                    } catch(std::logic_error&) {
+                        campaigns = 0;
+                    }
+
+                    if (campaigns < 1 or processes < 0) {
+                        stringstream err;
+                        err << "Invalid campaign settings: " << argv[1]
+                            << " (Expected <campaigns>[,<processes>], with at least one campaign)" << endl;
+                        throw CLIParsingError(err.str());
+                    }
+                    FaultInjector::setCampaigns(campaigns, processes);
+
+                    argc--;
+                    argv++;
+                } break;
+
+                case 'K' : {
+                    if (argc < 2)
+                        throw CLIParsingError("No fork date provided after -K option");
+
+                    Time date = 0;
+                    try {
+                        date = stoull(argv[1]);
+                    } catch(std::logic_error&) {
+                        date = 0;
+                    }
+
+                    if (date == 0) {
+                        stringstream err;
+                        err << "Invalid fork date: " << argv[1]
+                            << " (Expected a positive date, in microseconds)" << endl;
+                        throw CLIParsingError(err.str());
+                    }
+                    FaultInjector::setForkDate(date);
+
+                    argc--;
+                    argv++;
+                } break;
+
+                case 'S' : {
+                    if (argc < 2)
+                        throw CLIParsingError("No snapshot provided after -S option");
+
+                    string arg(argv[1]);
+                    size_t comma = arg.find(',');
+                    Time date = 0;
+                    try {
+                        if (comma != string::npos) date = stoull(arg.substr(0, comma));
+                    } catch(std::logic_error&) {
+                        date = 0;
+                    }
+
+                    if (date == 0 or comma + 1 >= arg.size()) {
+                        stringstream err;
+                        err << "Invalid snapshot settings: " << argv[1]
+                            << " (Expected <date>,<file>, with a positive date in microseconds)" << endl;
+                        throw CLIParsingError(err.str());
+                    }
+                    Snapshot::setSave(date, arg.substr(comma + 1));
+
+                    argc--;
+                    argv++;
+                } break;
+
+                case 'U' : {
+                    if (argc < 2)
+                        throw CLIParsingError("No snapshot provided after -U option");
+                    Snapshot::setResume(argv[1]);
+
+                    argc--;
+                    argv++;
+                } break;
+
+                case 'B' : {
+                    if (argc < 2)
+                        throw CLIParsingError("No batch file provided after -B option");
+
+                    string arg(argv[1]);
+                    size_t comma = arg.find(',');
+                    int threads = 0;
+                    try {
+                        if (comma != string::npos)
+                            threads = stoi(arg.substr(comma + 1));
+                    } catch(std::logic_error&) {
+                        threads = -1;
+                    }
+
+                    if (comma == 0 or threads < 0) {
+                        stringstream err;
+                        err << "Invalid batch settings: " << argv[1]
+                            << " (Expected <batch>[,<threads>])" << endl;
+                        throw CLIParsingError(err.str());
+                    }
+                    BatchRunner::setBatch(arg.substr(0, comma), threads);
+
+                    argc--;
+                    argv++;
+                } break;
+
+                case 'L' :
+                case 'V' : {
+                    if (argc < 2) {
+                        stringstream err;
+                        err << "No replay log provided after " << argv[0] << " option";
+                        throw CLIParsingError(err.str());
+                    }
+                    if (ReplayLog::isEnabled())
+                        throw CLIParsingError("Options -L and -V are exclusive");
+
+                    const bool check = argv[0][1] == 'V';
+                    if (not ReplayLog::open(argv[1], check ? ReplayLog::Mode::Check : ReplayLog::Mode::Record)) {
+                        stringstream err;
+                        err << "Cannot " << (check ? "read replay log " : "write replay log ") << argv[1] << endl;
+                        throw CLIParsingError(err.str());
+                    }
+
+                    argc--;
+                    argv++;
+                } break;
+
+                case 'P' : {
+                    if (argc < 2)
+                        throw CLIParsingError("No profile file provided after -P option");
+
+                    string arg(argv[1]);
+                    size_t comma = arg.find(',');
+                    int period = SchedulerProfiler::defaultSamplingPeriod;
+                    try {
+                        if (comma != string::npos)
+                            period = stoi(arg.substr(comma + 1));
+                    } catch(std::logic_error&) {
+                        period = 0;
+                    }
+
+                    if (comma == 0 or period < 1) {
+                        stringstream err;
+                        err << "Invalid profile settings: " << argv[1]
+                            << " (Expected <file>[,<period>], with period >= 1)" << endl;
+                        throw CLIParsingError(err.str());
+                    }
+                    SchedulerProfiler::enable(arg.substr(0, comma), period);
+                    argc--;
+                    argv++;
+                } break;
+
                 case 'g' : {
                     Simulator::regrTesting = true;
                 } break;
@@ -213,6 +535,72 @@ void CommandLine::read(int argc, char *argv[], BlockCodeBuilder bcb) {
             argc--;
             argv++;
         }
+
+        // Campaigns fork silent simulations, which cannot share trace or capture files
+        if (FaultInjector::hasCampaigns()) {
+            if (GlutContext::GUIisEnabled or schedulerMode != SCHEDULER_MODE_FASTEST)
+                throw CLIParsingError("-C option requires terminal mode (-t) and fastest mode (-R)");
+            // Faults may keep the modules busy forever
+            if (schedulerLength != SCHEDULER_LENGTH_BOUNDED)
+                throw CLIParsingError("-C option requires a maximum simulation date (-s <maxDate>)");
+            if (TraceSink::isOpen() or WireCapture::isOpen() or ReplayLog::isEnabled()
+                or SchedulerProfiler::isEnabled())
+                throw CLIParsingError("-C option cannot be combined with -b, -w, -L, -V or -P");
+        }
+
+        // The fork date forks the scheduler thread, the only one of the sequential scheduler
+        if (FaultInjector::getForkDate()) {
+            if (not FaultInjector::hasCampaigns())
+                throw CLIParsingError("-K option requires fault injection campaigns (-C)");
+            if (nbThreads > 1)
+                throw CLIParsingError("-K option cannot be combined with -j");
+        }
+
+        // Snapshots are taken by the scheduler thread of the sequential scheduler, between two events
+        if (Snapshot::isSaving()) {
+            if (schedulerMode != SCHEDULER_MODE_FASTEST)
+                throw CLIParsingError("-S option requires fastest mode (-R)");
+            if (FaultInjector::hasCampaigns())
+                throw CLIParsingError("-S option cannot be combined with -C");
+        }
+        if (Snapshot::isSaving() or Snapshot::isResuming()) {
+            if (nbThreads > 1 or BatchRunner::hasBatch())
+                throw CLIParsingError("-S and -U options cannot be combined with -j or -B");
+            if (FaultInjector::getForkDate())
+                throw CLIParsingError("-S and -U options cannot be combined with -K");
+        }
+
+        // The simulations of a batch, each with its own configuration file and seed, run at once
+        // in this process, and cannot share log, trace or capture files either
+        if (BatchRunner::hasBatch()) {
+            if (GlutContext::GUIisEnabled or schedulerMode != SCHEDULER_MODE_FASTEST)
+                throw CLIParsingError("-B option requires terminal mode (-t) and fastest mode (-R)");
+            if (FaultInjector::hasCampaigns())
+                throw CLIParsingError("-B option cannot be combined with -C");
+            if (ReplayLog::isEnabled() or SchedulerProfiler::isEnabled())
+                throw CLIParsingError("-B option cannot be combined with -L, -V or -P");
+            if (log_file.is_open() or TraceSink::isOpen() or WireCapture::isOpen())
+                throw CLIParsingError("-B option cannot be combined with -l, -b or -w");
+        }
+
+        // Logs only replay identically with the scheduler they were recorded with
+        if (ReplayLog::isEnabled()) {
+            const int threads = GlutContext::GUIisEnabled ? 1 : nbThreads;
+            stringstream scheduler;
+            if (threads > 1) scheduler << "parallel " << threads << " threads";
+            else scheduler << "sequential";
+            if (not ReplayLog::setScheduler(scheduler.str())) {
+                stringstream err;
+                err << "Replay log was recorded with the " << ReplayLog::getScheduler()
+                    << " scheduler, not the " << scheduler.str() << " one (-j)";
+                throw CLIParsingError(err.str());
+            }
+        }
+
+        // Nothing needs to be traced if traces are neither displayed nor written
+        TraceSink::setCategories(TraceSink::getCategoriesFilter(),
+                                 log_file.is_open() or TraceSink::isOpen()
+                                 or GlutContext::GUIisEnabled);
     } catch(CLIParsingError const& e) {
         cerr << e.what() << endl << endl;
         help();
@@ -220,6 +608,11 @@ void CommandLine::read(int argc, char *argv[], BlockCodeBuilder bcb) {
     }
 }
 
+void CommandLine::setConfigFile(const string &file) {
+    configFile = file;
+    Simulator::configFileName = file;
+}
+
 bool CommandLine::randomWorldRequested() const {
     return topology != CMD_LINE_UNDEFINED;
 }
@@ -30,12 +30,18 @@ private:
     int schedulerLength  = SCHEDULER_LENGTH_DEFAULT;
     bool schedulerAutoStop = false;
     Time maximumDate = 0;
+    EventQueueType eventQueueType = EventQueue::defaultType;
+    int motionFidelity = CMD_LINE_UNDEFINED; //!< Simulator::MotionFidelity, or undefined for automatic
+    int nbThreads = 1; //!< Number of threads of the parallel scheduler, 1 for the sequential scheduler
+    size_t minParallelWindow = 64; //!< Minimum number of events of a window for the parallel scheduler to use several threads
 
 
     bool meldDebugger = false;
     string programPath = "program.bb";
     string vmPath = "";
     int vmPort = 0;
+    bool vmSharedMemory = false; //!< Commands exchanged with the VMs through shared memory instead of TCP
+    int vmSharedMemorySlots = 1024; //!< Maximum number of VMs sharing the region
 
     bool stats = false;
     bool fullScreen = false;
@@ -62,6 +68,8 @@ public:
     string getProgramPath() const { return programPath; }
     string getVMPath() const { return vmPath; }
     int getVMPort() const { return vmPort; }
+    bool getVMSharedMemory() const { return vmSharedMemory; }
+    int getVMSharedMemorySlots() const { return vmSharedMemorySlots; }
     string getConfigFile() const { return configFile; }
     bool getStats() const { return stats; }
     bool getFullScreen() const { return fullScreen; }
@@ -69,10 +77,18 @@ public:
     int getSchedulerLength() const { return schedulerLength; }
     Time getMaximumDate() const { return maximumDate; }
     bool getSchedulerAutoStop() const { return schedulerAutoStop; }
+    EventQueueType getEventQueueType() const { return eventQueueType; }
+    int getMotionFidelity() const { return motionFidelity; }
+    int getNbThreads() const { return nbThreads; }
+    size_t getMinParallelWindow() const { return minParallelWindow; }
 
     bool isSimulationSeedSet() const { return simulationSeedSet; }
     int getSimulationSeed() const { return simulationSeed; }
 
+    //!< @brief Overrides the configuration file and the seed, used by the simulations of a batch (see BatchRunner)
+    void setConfigFile(const string &file);
+    void setSimulationSeed(int seed) { simulationSeed = seed; simulationSeedSet = true; }
+
     /**
      * @brief Search option -k in the command line arguments to deduce the target module type
      * @return ModuleType enum value (defined in tDefs.h) for target module type specified by -k option if present.
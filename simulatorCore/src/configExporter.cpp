@@ -68,15 +68,15 @@ ConfigExporter::ConfigExporter(World *_world) {
     config = new TiXmlDocument();
 
     string exportedConfigNameRoot;
-    if (Simulator::configFileName.empty()) {
+    if (Simulator::configFileName.get().empty()) {
         exportedConfigNameRoot = "export";
     } else {
-        size_t config_pos = Simulator::configFileName.find("config_");
+        size_t config_pos = Simulator::configFileName.get().find("config_");
         if (config_pos == string::npos) // no config_ pattern
-            exportedConfigNameRoot = string("export_").append(Simulator::configFileName);
+            exportedConfigNameRoot = string("export_").append(Simulator::configFileName.get());
         else
             exportedConfigNameRoot = string("export_")
-                .append(Simulator::configFileName.substr(config_pos + 7, string::npos));
+                .append(Simulator::configFileName.get().substr(config_pos + 7, string::npos));
 
         // trim extension
         exportedConfigNameRoot = exportedConfigNameRoot
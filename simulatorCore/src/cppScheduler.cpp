@@ -16,6 +16,9 @@
 #include "trace.h"
 #include "world.h"
 #include "simulator.h"
+#include "replayLog.h"
+#include "schedulerProfiler.h"
+#include "snapshot.h"
 
 using namespace std;
 using namespace BaseSimulator::utils;
@@ -42,10 +45,11 @@ void CPPScheduler::createScheduler() {
 }
 
 void CPPScheduler::deleteScheduler() {
-    delete((CPPScheduler*)scheduler);
+    delete((CPPScheduler*)scheduler.get());
 }
 
 void *CPPScheduler::startPaused(/*void *param*/) {
+    RunContext::adopt(runContext);
     cout << TermColor::SchedulerColor << "Scheduler Mode :" << schedulerMode << TermColor::Reset  << endl;
     cout << TermColor::SchedulerColor << "Scheduler Length :" << schedulerLength << TermColor::Reset  << endl;
     sem_schedulerStart->wait();
@@ -55,7 +59,6 @@ void *CPPScheduler::startPaused(/*void *param*/) {
 
         state = RUNNING;
 
-        multimap<Time, EventPtr>::iterator first;
         EventPtr pev;
 
         auto systemStartTime = get_time::now();
@@ -63,17 +66,7 @@ void *CPPScheduler::startPaused(/*void *param*/) {
 
         switch (schedulerMode) {
             case SCHEDULER_MODE_FASTEST:
-                while(!eventsMap.empty() || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
-                    //JUSTE POUR DEBUG
-                    //~ cout << endl << "Contenu du scheduler :" << endl;
-                    //~ first=eventsMap.begin();
-                    //~ do {
-                    //~ std::cout << (*first).first << " : Evennement de type " << (*first).second->eventType << " au temps " << (*first).second->date << endl;
-                    //~ first++;
-                    //~ } while( first != eventsMap.end());
-                    //~ cout << endl;
-                    //
-
+                while(!eventsQueue->empty() || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
                     // Check that we have not reached the maximum simulation date, if there is one
                     if (currentDate > maximumDate) {
                         cout << TermColor::SchedulerColor << "" << "Scheduler : maximum simulation date (" << maximumDate
@@ -81,15 +74,20 @@ void *CPPScheduler::startPaused(/*void *param*/) {
                         break;
                     }
 
-                    if (!eventsMap.empty()) {
-                        first=eventsMap.begin();
-                        pev = (*first).second;
+                    if (!eventsQueue->empty()) {
+                        // Between two events, the state of the simulation is complete
+                        if (Snapshot::isDue(eventsQueue->top()->date)) Snapshot::save();
+                        pev = eventsQueue->top();
                         currentDate = pev->date;
                         contextModule = pev->getConcernedBlock();
+                        if (ReplayLog::isEnabled()) ReplayLog::beginEvent();
+                        if (SchedulerProfiler::isEnabled()) SchedulerProfiler::beginEvent(currentDate, eventsMapSize);
                         pev->consume();
+                        if (SchedulerProfiler::isEnabled()) SchedulerProfiler::endEvent(pev.get());
+                        if (ReplayLog::isEnabled()) ReplayLog::append(ReplayLog::endEvent(currentDate, pev.get()));
                         contextModule = NULL;
                         StatsCollector::getInstance().incEventsCount();
-                        eventsMap.erase(first);
+                        eventsQueue->pop();
                         eventsMapSize--;
                     }
 
@@ -101,7 +99,7 @@ void *CPPScheduler::startPaused(/*void *param*/) {
             case SCHEDULER_MODE_REALTIME: {
                 cout << "Realtime mode scheduler\n";
                 auto globalPauseTime = get_time::now() - get_time::now();
-                while((state != ENDED && !eventsMap.empty())
+                while((state != ENDED && !eventsQueue->empty())
                       || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
 
                     //gettimeofday(&heureGlobaleActuelle,NULL);
@@ -109,10 +107,9 @@ void *CPPScheduler::startPaused(/*void *param*/) {
                     auto systemCurrentTime = get_time::now() - globalPauseTime;
                     auto systemCurrentTimeMax = systemCurrentTime - systemStartTime;
                     //ev = *(listeEvenements.begin());
-                    if (!eventsMap.empty()) {
-                        first=eventsMap.begin();
-                        pev = (*first).second;
-                        while (!eventsMap.empty() && pev->date <= static_cast<uint64_t>(chrono::duration_cast<us>(systemCurrentTimeMax).count())) {
+                    if (!eventsQueue->empty()) {
+                        pev = eventsQueue->top();
+                        while (!eventsQueue->empty() && pev->date <= static_cast<uint64_t>(chrono::duration_cast<us>(systemCurrentTimeMax).count())) {
 
                             auto prePauseTime = get_time::now();
                             std::unique_lock<std::mutex> lck(scheduler->pause_mtx);
@@ -122,27 +119,29 @@ void *CPPScheduler::startPaused(/*void *param*/) {
                             // cout << "PAUSED FOR: " << static_cast<uint64_t>(chrono::duration_cast<us>(pauseDuration).count()) << endl;
                             // cout << "globalPauseTime2: " << static_cast<uint64_t>(chrono::duration_cast<us>(globalPauseTime).count()) << endl;
 
-                            first=eventsMap.begin();
-                            pev = (*first).second;
+                            pev = eventsQueue->top();
                             currentDate = pev->date;
                             //lock();
                             contextModule = pev->getConcernedBlock();
+                            if (ReplayLog::isEnabled()) ReplayLog::beginEvent();
+                            if (SchedulerProfiler::isEnabled()) SchedulerProfiler::beginEvent(currentDate, eventsMapSize);
                             pev->consume();
+                            if (SchedulerProfiler::isEnabled()) SchedulerProfiler::endEvent(pev.get());
+                            if (ReplayLog::isEnabled()) ReplayLog::append(ReplayLog::endEvent(currentDate, pev.get()));
                             contextModule = NULL;
                             StatsCollector::getInstance().incEventsCount();
                             //unlock();
-                            eventsMap.erase(first);
+                            eventsQueue->pop();
                             eventsMapSize--;
                         }
                     }
 
-                    if (!eventsMap.empty()) {
+                    if (!eventsQueue->empty()) {
                         //ev = *(listeEvenements.begin());
-                        first=eventsMap.begin();
-                        pev = (*first).second;
+                        pev = eventsQueue->top();
                     }
 
-                    if (!eventsMap.empty() || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
+                    if (!eventsQueue->empty() || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
                         std::chrono::milliseconds timespan(5);
                         std::this_thread::sleep_for(timespan);
                     }
@@ -166,7 +165,11 @@ void *CPPScheduler::startPaused(/*void *param*/) {
 
         StatsCollector::getInstance().updateElapsedTime(currentDate, chrono::duration_cast<us>(elapsedTime).count());
         StatsCollector::getInstance().setLivingCounters(Event::getNbLivingEvents(), Message::getNbMessages());
-        StatsCollector::getInstance().setEndEventsQueueSize(eventsMap.size());
+        StatsCollector::getInstance().setEventPoolCounters(PoolAllocator::getNbSlabs(), PoolAllocator::getReservedBytes(),
+                                                            PoolAllocator::getNbLargeAllocations());
+        StatsCollector::getInstance().setEndEventsQueueSize(eventsQueue->size());
+        ReplayLog::close();
+        SchedulerProfiler::write();
 
         // if simulation is a regression testing run, export configuration before leaving
         if ((Simulator::regrTesting or Simulator::exportFinalConfiguration)
@@ -26,7 +26,7 @@ public:
     static void deleteScheduler();
     static CPPScheduler* getScheduler() {
         assert(scheduler != NULL);
-        return((CPPScheduler*)scheduler);
+        return((CPPScheduler*)scheduler.get());
     }
 
     void printInfo() override {
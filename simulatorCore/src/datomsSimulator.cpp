@@ -32,9 +32,9 @@ DatomsSimulator::~DatomsSimulator() {
 }
 
 void DatomsSimulator::createSimulator(int argc, char *argv[], BlockCodeBuilder bcb) {
-    simulator =  new DatomsSimulator(argc, argv, bcb);
-    simulator->parseConfiguration(argc, argv);
-    simulator->startSimulation();
+    Simulator::createSimulator(argc, argv, bcb, [](int argc, char *argv[], BlockCodeBuilder bcb) -> Simulator* {
+        return new DatomsSimulator(argc, argv, bcb);
+    });
 }
 
 void DatomsSimulator::loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
@@ -30,7 +30,7 @@ public:
 
     static DatomsSimulator* getSimulator() {
         assert(simulator != NULL);
-        return((DatomsSimulator*)simulator);
+        return((DatomsSimulator*)simulator.get());
     }
 
     virtual void loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
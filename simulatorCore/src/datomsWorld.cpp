@@ -55,7 +55,7 @@ DatomsWorld::~DatomsWorld() {
 }
 
 void DatomsWorld::deleteWorld() {
-    delete((DatomsWorld*)world);
+    delete((DatomsWorld*)world.get());
 }
 
 void DatomsWorld::createPopupMenu(int ix, int iy) {
@@ -155,7 +155,7 @@ void DatomsWorld::menuChoice(int n) {
             GlutContext::popupSubMenu->show(false);
             GlutContext::popupMenu->show(false);
             if (bb->getNeighborPos(numSelectedFace,nPos)) {
-                int orient = rand()%24;
+                int orient = bb->getRandomUint() % 24;
                 addBlock(0, bb->buildNewBlockCode,nPos,bb->color,orient,false);
                 linkBlock(nPos);
                 linkNeighbors(nPos);
@@ -184,6 +184,9 @@ void DatomsWorld::menuChoice(int n) {
 
 void DatomsWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPosition &pos, const Color &col,
                              short orientation, bool master) {
+    if (getScheduler()->deferWorldAction([=]() { addBlock(blockId, bcb, pos, col, orientation, master); }))
+        return;
+
     if (blockId > maxBlockId)
         maxBlockId = blockId;
     else if (blockId == 0)
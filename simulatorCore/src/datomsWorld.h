@@ -44,7 +44,7 @@ public:
     static void deleteWorld();
     static DatomsWorld* getWorld() {
         assert(world != NULL);
-        return((DatomsWorld*)world);
+        return((DatomsWorld*)world.get());
     }
 
     void printInfo() {
@@ -9,6 +9,7 @@
 
 #include "deformationEvents.h"
 #include "datomsWorld.h"
+#include "simulator.h"
 
 using namespace BaseSimulator::utils;
 
@@ -45,6 +46,13 @@ void DeformationStartEvent::consume() {
     cout << "Model="<< (int)deform.modelId << endl;
 //    datom->setColor(DARKGREY);
     deform.init(((DatomsGlBlock*)datom->ptrGlBlock)->mat);
+
+    if (Simulator::logicalMotions()) {
+        // Skip the animation steps: the stop comes one delay after the last of the nbSteps steps
+        scheduler->schedule(new DeformationStopEvent(scheduler->now() + (Deformation::nbSteps + 1) * ANIMATION_DELAY, datom, deform));
+        return;
+    }
+
     scheduler->schedule(new DeformationStepEvent(scheduler->now() + ANIMATION_DELAY,datom, deform));
 }
 
@@ -126,10 +134,11 @@ void DeformationStopEvent::consume() {
     DatomsWorld *wrld=DatomsWorld::getWorld();
 
     datom->setPositionAndOrientation(position,orientation);
-    stringstream info;
-    info.str("");
-    info << "connect Block " << datom->blockId;
-    getScheduler()->trace(info.str(),datom->blockId,LIGHTBLUE);
+    if (TraceSink::isEnabled(TraceCategory::Motion)) {
+        stringstream info;
+        info << "connect Block " << datom->blockId;
+        getScheduler()->trace(info.str(),datom->blockId,LIGHTBLUE,TraceCategory::Motion);
+    }
     wrld->connectBlock(datom, false);
     Scheduler *scheduler = getScheduler();
     scheduler->schedule(new DeformationEndEvent(scheduler->now() + ANIMATION_DELAY, datom));
@@ -29,6 +29,8 @@ public :
     Deformation (const DatomsBlock *mobile,const  DatomsBlock *fixe,const Vector3D &ax1,const Vector3D &ax2,uint8_t id);
     Deformation () {};
 
+    static const int nbSteps = 4*nbSteps_4; //!< Number of calls to nextStep until the end of the animation
+
     void init(const Matrix& m) {
         step=0;
         initialMatrix=m;
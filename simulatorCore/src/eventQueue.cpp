@@ -0,0 +1,281 @@
+/*! @file eventQueue.cpp
+ * @brief Pending event set implementations used by the discrete event scheduler.
+ * @date 17/10/2026
+ */
+
+#include "eventQueue.h"
+
+#include <algorithm>
+#include <fstream>
+
+using namespace std;
+
+namespace BaseSimulator {
+
+#ifdef EVENT_QUEUE_TRACE
+/**
+ * @brief Decorator recording every operation performed on an event queue into file eventQueue.trace,
+ *  one operation per line: "+ <date>" for an insertion, "-" for a removal of the earliest event.
+ *  The resulting trace can be replayed by utilities/benchmarks/eventQueueBench.
+ */
+class EventQueueRecorder : public EventQueue {
+    EventQueue *queue;
+    ofstream traceFile;
+public:
+    EventQueueRecorder(EventQueue *q) : queue(q), traceFile("eventQueue.trace") {}
+    ~EventQueueRecorder() { delete queue; }
+
+    void push(EventPtr ev) override {
+        traceFile << "+ " << ev->date << '\n';
+        queue->push(std::move(ev));
+    }
+    const EventPtr& top() override { return queue->top(); }
+    void pop() override {
+        traceFile << "-\n";
+        queue->pop();
+    }
+    size_t size() const override { return queue->size(); }
+    void forEach(const function<void(const EventPtr&)> &f) const override { queue->forEach(f); }
+    void removeIf(const function<bool(const EventPtr&)> &pred) override { queue->removeIf(pred); }
+    const string getName() const override { return queue->getName(); }
+};
+#endif
+
+EventQueue* EventQueue::create(EventQueueType type) {
+    EventQueue *queue = NULL;
+
+    switch (type) {
+        case EventQueueType::Multimap: queue = new MultimapEventQueue(); break;
+        case EventQueueType::BinaryHeap: queue = new DaryHeapEventQueue<2>(); break;
+        case EventQueueType::QuaternaryHeap: queue = new DaryHeapEventQueue<4>(); break;
+        case EventQueueType::Calendar: queue = new CalendarEventQueue(); break;
+    }
+
+#ifdef EVENT_QUEUE_TRACE
+    queue = new EventQueueRecorder(queue);
+#endif
+
+    return queue;
+}
+
+bool EventQueue::parseType(const string &name, EventQueueType &type) {
+    if (name == "map") type = EventQueueType::Multimap;
+    else if (name == "heap") type = EventQueueType::BinaryHeap;
+    else if (name == "heap4") type = EventQueueType::QuaternaryHeap;
+    else if (name == "calendar") type = EventQueueType::Calendar;
+    else return false;
+
+    return true;
+}
+
+//===========================================================================================================
+//
+//          MultimapEventQueue  (class)
+//
+//===========================================================================================================
+
+void MultimapEventQueue::forEach(const function<void(const EventPtr&)> &f) const {
+    for (const auto &pair : eventsMap) f(pair.second);
+}
+
+void MultimapEventQueue::removeIf(const function<bool(const EventPtr&)> &pred) {
+    auto it = eventsMap.begin();
+    while (it != eventsMap.end()) {
+        if (pred(it->second)) it = eventsMap.erase(it);
+        else it++;
+    }
+}
+
+//===========================================================================================================
+//
+//          CalendarEventQueue  (class)
+//
+//===========================================================================================================
+
+CalendarEventQueue::CalendarEventQueue() {
+    buckets.resize(minBuckets);
+}
+
+void CalendarEventQueue::setCursor(Time date) {
+    lastBucket = bucketIndex(date);
+    bucketTop = (date / width + 1) * width;
+}
+
+void CalendarEventQueue::Bucket::insert(EventQueueEntry &&e) {
+    // New entry goes after all the entries already scheduled for the same date (FIFO)
+    if (empty() || !(e < entries.back())) {
+        entries.push_back(std::move(e));
+    } else {
+        auto pos = upper_bound(entries.begin() + head, entries.end(), e);
+        entries.insert(pos, std::move(e));
+    }
+}
+
+void CalendarEventQueue::Bucket::popFront() {
+    entries[head++].ev.reset();
+
+    if (head == entries.size()) {
+        entries.clear();
+        head = 0;
+    } else if (head >= 32 && 2 * head >= entries.size()) {
+        // Reclaim the space of removed entries once they represent half of the bucket
+        entries.erase(entries.begin(), entries.begin() + head);
+        head = 0;
+    }
+}
+
+void CalendarEventQueue::insert(EventQueueEntry &&e) {
+    buckets[bucketIndex(e.date)].insert(std::move(e));
+}
+
+void CalendarEventQueue::findTop() {
+    size_t n = buckets.size();
+    size_t i = lastBucket;
+    Time top = bucketTop;
+
+    // Scan one year of buckets from the current one, looking for an event in the current year
+    for (size_t k = 0; k < n; k++) {
+        const Bucket &bucket = buckets[i];
+        if (!bucket.empty() && bucket.front().date < top) {
+            lastBucket = i;
+            bucketTop = top;
+            topBucket = i;
+            topValid = true;
+            return;
+        }
+
+        if (++i == n) i = 0;
+        top += width;
+    }
+
+    // Queue is sparse relative to the width of a year: direct search for the minimum
+    const EventQueueEntry *min = NULL;
+    for (size_t b = 0; b < n; b++) {
+        if (!buckets[b].empty() && (min == NULL || buckets[b].front() < *min)) {
+            min = &buckets[b].front();
+            topBucket = b;
+        }
+    }
+
+    setCursor(min->date);
+    topValid = true;
+}
+
+Time CalendarEventQueue::estimateWidth(vector<EventQueueEntry> &entries) const {
+    if (entries.size() < 2) return width;
+
+    vector<Time> dates;
+    dates.reserve(entries.size());
+    for (const EventQueueEntry &e : entries) dates.push_back(e.date);
+    sort(dates.begin(), dates.end());
+
+    // Separations between the earliest distinct dates. Many events usually share the same date
+    //  in VisibleSim, which would otherwise lead to a very small width and mostly empty buckets.
+    vector<Time> separations;
+    size_t nbSampled = 1;
+    for (; nbSampled < dates.size() && separations.size() < 25; nbSampled++) {
+        if (dates[nbSampled] != dates[nbSampled - 1])
+            separations.push_back(dates[nbSampled] - dates[nbSampled - 1]);
+    }
+    if (separations.empty()) return width;
+
+    // Average separation, ignoring outliers (more than twice the average)
+    double avg = 0;
+    Time minSep = TIME_MAX;
+    for (Time sep : separations) {
+        avg += sep;
+        minSep = min(minSep, sep);
+    }
+    avg /= separations.size();
+
+    double sum = 0;
+    size_t count = 0;
+    for (Time sep : separations) {
+        if (sep <= 2 * avg) {
+            sum += sep;
+            count++;
+        }
+    }
+
+    // Brown's width holds about 3 events per bucket. When several events share each date, the
+    //  width is reduced accordingly, but never below the smallest separation between two dates.
+    double eventsPerDate = (double)nbSampled / (separations.size() + 1);
+    Time w = (Time)(3 * (sum / count) / max(1.0, eventsPerDate));
+    return max(w, minSep);
+}
+
+void CalendarEventQueue::resize(size_t nbBuckets) {
+    vector<EventQueueEntry> entries;
+    entries.reserve(nbEvents);
+    for (Bucket &bucket : buckets) {
+        for (size_t i = bucket.head; i < bucket.entries.size(); i++)
+            entries.push_back(std::move(bucket.entries[i]));
+    }
+
+    width = estimateWidth(entries);
+    buckets.clear();
+    buckets.resize(nbBuckets);
+
+    const EventQueueEntry *min = NULL;
+    for (EventQueueEntry &e : entries) {
+        if (min == NULL || e < *min) min = &e;
+    }
+    if (min) setCursor(min->date);
+
+    for (EventQueueEntry &e : entries) insert(std::move(e));
+    topValid = false;
+}
+
+void CalendarEventQueue::push(EventPtr ev) {
+    Time date = ev->date;
+    EventQueueEntry e{date, nextSeq++, std::move(ev)};
+
+    // An event earlier than the current day moves the search cursor back
+    if (date + width < bucketTop) {
+        setCursor(date);
+        topValid = false;
+    }
+
+    if (topValid && e < buckets[topBucket].front()) {
+        topBucket = bucketIndex(date);
+        setCursor(date);
+    }
+
+    insert(std::move(e));
+    nbEvents++;
+
+    if (nbEvents > 2 * buckets.size()) resize(2 * buckets.size());
+}
+
+const EventPtr& CalendarEventQueue::top() {
+    if (!topValid) findTop();
+    return buckets[topBucket].front().ev;
+}
+
+void CalendarEventQueue::pop() {
+    if (!topValid) findTop();
+    buckets[topBucket].popFront();
+    nbEvents--;
+    topValid = false;
+
+    if (nbEvents < buckets.size() / 2 && buckets.size() > minBuckets) resize(buckets.size() / 2);
+}
+
+void CalendarEventQueue::forEach(const function<void(const EventPtr&)> &f) const {
+    for (const Bucket &bucket : buckets) {
+        for (size_t i = bucket.head; i < bucket.entries.size(); i++) f(bucket.entries[i].ev);
+    }
+}
+
+void CalendarEventQueue::removeIf(const function<bool(const EventPtr&)> &pred) {
+    for (Bucket &bucket : buckets) {
+        auto begin = bucket.entries.begin() + bucket.head;
+        auto end = remove_if(begin, bucket.entries.end(),
+                             [&pred](const EventQueueEntry &e) { return pred(e.ev); });
+        nbEvents -= bucket.entries.end() - end;
+        bucket.entries.erase(end, bucket.entries.end());
+    }
+    topValid = false;
+}
+
+} // BaseSimulator namespace
@@ -0,0 +1,255 @@
+/*! @file eventQueue.h
+ * @brief Pending event set implementations used by the discrete event scheduler.
+ *  All backends order events by date, and preserve insertion order (FIFO) among events
+ *  scheduled for the same date, like the original multimap<Time, EventPtr> did.
+ * @date 17/10/2026
+ */
+
+#ifndef EVENTQUEUE_H_
+#define EVENTQUEUE_H_
+
+#include <map>
+#include <vector>
+#include <string>
+#include <functional>
+
+#include "events.h"
+#include "tDefs.h"
+
+namespace BaseSimulator {
+
+//!< Available event queue backends, selectable from the command line (-q)
+enum class EventQueueType {
+    Multimap,                   //!< Legacy red-black tree (std::multimap), kept for reference
+    BinaryHeap,                 //!< Implicit binary heap over a contiguous array
+    QuaternaryHeap,             //!< Implicit 4-ary heap, shallower than the binary heap
+    Calendar                    //!< Calendar queue (R. Brown, 1988), O(1) average hold time
+};
+
+/**
+ * @brief A pending event along with its ordering key.
+ *  seq is a monotonically increasing insertion counter used to break ties between events
+ *  that share the same date, so that they are processed in the order they were scheduled.
+ */
+struct EventQueueEntry {
+    Time date;
+    uint64_t seq;
+    EventPtr ev;
+
+    inline bool operator<(const EventQueueEntry &e) const {
+        return date < e.date || (date == e.date && seq < e.seq);
+    }
+};
+
+/**
+ * @brief Abstract pending event set of the scheduler
+ * @attention Not thread-safe, all accesses must be done through the scheduler, which handles locking
+ */
+class EventQueue {
+protected:
+    uint64_t nextSeq = 0; //!< Insertion counter used for FIFO ordering of simultaneous events
+public:
+    //!< Backend used when none is specified on the command line
+    static constexpr EventQueueType defaultType = EventQueueType::Calendar;
+
+    virtual ~EventQueue() {};
+
+    //!< @brief Inserts event ev in the queue, after all pending events having the same date
+    virtual void push(EventPtr ev) = 0;
+    //!< @brief Returns the earliest event of the queue. Queue must not be empty.
+    virtual const EventPtr& top() = 0;
+    //!< @brief Removes the earliest event from the queue. Queue must not be empty.
+    virtual void pop() = 0;
+    //!< @brief Returns the number of pending events
+    virtual size_t size() const = 0;
+    //!< @brief Returns true if there is no pending event
+    inline bool empty() const { return size() == 0; }
+
+    //!< @brief Calls f on every pending event, in no particular order
+    virtual void forEach(const std::function<void(const EventPtr&)> &f) const = 0;
+    //!< @brief Removes all pending events for which pred returns true, preserving the order of the others
+    virtual void removeIf(const std::function<bool(const EventPtr&)> &pred) = 0;
+
+    //!< @brief Returns the name of the backend, as accepted by the -q command line option
+    virtual const std::string getName() const = 0;
+
+    /**
+     * @brief Instantiates a new, empty event queue of the requested type
+     * @param type backend to instantiate
+     * @return pointer to the new queue, to be deleted by the caller
+     */
+    static EventQueue* create(EventQueueType type);
+
+    /**
+     * @brief Converts a backend name into its EventQueueType
+     * @param name one of "map", "heap", "heap4", "calendar"
+     * @param type set to the corresponding type if name is valid
+     * @return true if name is valid, false otherwise
+     */
+    static bool parseType(const std::string &name, EventQueueType &type);
+};
+
+/**
+ * @brief Event queue backed by the legacy multimap<Time, EventPtr>.
+ *  One node allocation and a tree rebalancing per insertion. Kept for benchmarking purposes.
+ */
+class MultimapEventQueue : public EventQueue {
+    std::multimap<Time, EventPtr> eventsMap;
+public:
+    void push(EventPtr ev) override {
+        Time date = ev->date;
+        eventsMap.emplace_hint(eventsMap.end(), date, std::move(ev));
+    }
+    const EventPtr& top() override { return eventsMap.begin()->second; }
+    void pop() override { eventsMap.erase(eventsMap.begin()); }
+    size_t size() const override { return eventsMap.size(); }
+    void forEach(const std::function<void(const EventPtr&)> &f) const override;
+    void removeIf(const std::function<bool(const EventPtr&)> &pred) override;
+    const std::string getName() const override { return "map"; }
+};
+
+/**
+ * @brief Implicit D-ary min-heap of events, stored in a single contiguous array.
+ *  No allocation once the array has reached its working size. Larger arities reduce the
+ *  height of the heap (fewer cache misses on insertion) at the cost of more comparisons on removal.
+ */
+template<unsigned D>
+class DaryHeapEventQueue : public EventQueue {
+    static_assert(D >= 2, "heap arity must be at least 2");
+
+    std::vector<EventQueueEntry> heap;
+
+    //!< @brief Moves entry at index i up until heap property is restored
+    void siftUp(size_t i) {
+        EventQueueEntry e = std::move(heap[i]);
+        while (i > 0) {
+            size_t parent = (i - 1) / D;
+            if (!(e < heap[parent])) break;
+            heap[i] = std::move(heap[parent]);
+            i = parent;
+        }
+        heap[i] = std::move(e);
+    }
+
+    //!< @brief Moves entry at index i down until heap property is restored
+    void siftDown(size_t i) {
+        const size_t n = heap.size();
+        EventQueueEntry e = std::move(heap[i]);
+        for (;;) {
+            size_t first = D * i + 1;
+            if (first >= n) break;
+            size_t last = first + D < n ? first + D : n;
+            size_t smallest = first;
+            for (size_t c = first + 1; c < last; c++) {
+                if (heap[c] < heap[smallest]) smallest = c;
+            }
+            if (!(heap[smallest] < e)) break;
+            heap[i] = std::move(heap[smallest]);
+            i = smallest;
+        }
+        heap[i] = std::move(e);
+    }
+
+public:
+    void push(EventPtr ev) override {
+        Time date = ev->date;
+        heap.push_back(EventQueueEntry{date, nextSeq++, std::move(ev)});
+        siftUp(heap.size() - 1);
+    }
+
+    const EventPtr& top() override { return heap.front().ev; }
+
+    void pop() override {
+        if (heap.size() > 1) {
+            heap.front() = std::move(heap.back());
+            heap.pop_back();
+            siftDown(0);
+        } else {
+            heap.pop_back();
+        }
+    }
+
+    size_t size() const override { return heap.size(); }
+
+    void forEach(const std::function<void(const EventPtr&)> &f) const override {
+        for (const EventQueueEntry &e : heap) f(e.ev);
+    }
+
+    void removeIf(const std::function<bool(const EventPtr&)> &pred) override {
+        size_t j = 0;
+        for (size_t i = 0; i < heap.size(); i++) {
+            if (!pred(heap[i].ev)) {
+                if (i != j) heap[j] = std::move(heap[i]);
+                j++;
+            }
+        }
+        heap.resize(j);
+        // Rebuild heap bottom-up
+        for (size_t i = heap.size() / D + 1; i-- > 0;) {
+            if (i < heap.size()) siftDown(i);
+        }
+    }
+
+    const std::string getName() const override { return D == 2 ? "heap" : "heap" + std::to_string(D); }
+};
+
+/**
+ * @brief Calendar queue, after R. Brown, "Calendar Queues: A Fast O(1) Priority Queue
+ *  Implementation for the Simulation Event Set Problem", CACM 31(10), 1988.
+ *
+ *  Events are hashed by date into an array of buckets (days) of a given width, the whole
+ *  array covering one year. Dequeuing scans the buckets from the current day on, taking
+ *  the first event that belongs to the current year. The number of buckets and their width
+ *  are adapted to the population of the queue, so that each bucket holds a few events.
+ *  Each bucket is kept sorted in increasing order. As many events usually share the same date,
+ *  insertions mostly append at the end of a bucket, and removals only advance its head.
+ */
+class CalendarEventQueue : public EventQueue {
+    //!< A day of the calendar: sorted entries, of which the first head ones have already been removed
+    struct Bucket {
+        std::vector<EventQueueEntry> entries;
+        size_t head = 0;
+
+        inline bool empty() const { return head == entries.size(); }
+        inline const EventQueueEntry& front() const { return entries[head]; }
+        void insert(EventQueueEntry &&e);
+        void popFront();
+    };
+
+    std::vector<Bucket> buckets;
+    Time width = 1;                 //!< Duration covered by each bucket (us)
+    size_t nbEvents = 0;            //!< Number of pending events
+    size_t lastBucket = 0;          //!< Bucket from which the next search starts
+    Time bucketTop = 1;             //!< Exclusive upper date bound of lastBucket in the current year
+    bool topValid = false;          //!< Is topBucket pointing at the bucket holding the earliest event?
+    size_t topBucket = 0;           //!< Bucket holding the earliest event, valid if topValid
+
+    static const size_t minBuckets = 2;
+
+    inline size_t bucketIndex(Time date) const { return (date / width) % buckets.size(); }
+    //!< @brief Sets the search cursor on the bucket (and year) containing date
+    void setCursor(Time date);
+    //!< @brief Locates the bucket holding the earliest event and updates topBucket
+    void findTop();
+    //!< @brief Inserts an entry in its bucket, without any resize
+    void insert(EventQueueEntry &&e);
+    //!< @brief Estimates a bucket width from the separation between the earliest events
+    Time estimateWidth(std::vector<EventQueueEntry> &entries) const;
+    //!< @brief Redistributes all events into nbBuckets buckets with a freshly estimated width
+    void resize(size_t nbBuckets);
+
+public:
+    CalendarEventQueue();
+
+    void push(EventPtr ev) override;
+    const EventPtr& top() override;
+    void pop() override;
+    size_t size() const override { return nbEvents; }
+    void forEach(const std::function<void(const EventPtr&)> &f) const override;
+    void removeIf(const std::function<bool(const EventPtr&)> &pred) override;
+    const std::string getName() const override { return "calendar"; }
+};
+
+} // BaseSimulator namespace
+
+#endif /* EVENTQUEUE_H_ */
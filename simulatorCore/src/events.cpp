@@ -12,9 +12,10 @@
 #include "scheduler.h"
 #include "blockCode.h"
 #include "statsIndividual.h"
+#include "snapshot.h"
 
-int Event::nextId = 0;
-unsigned int Event::nbLivingEvents = 0;
+BaseSimulator::RunLocal<std::atomic<int>> Event::nextId { 0 };
+BaseSimulator::RunLocal<std::atomic<unsigned int>> Event::nbLivingEvents { 0u };
 
 using namespace std;
 using namespace BaseSimulator;
@@ -26,9 +27,8 @@ using namespace BaseSimulator;
 //===========================================================================================================
 
 Event::Event(Time t) {
-	id = nextId;
-	nextId++;
-	nbLivingEvents++;
+	id = nextId.get()++;
+	nbLivingEvents.get()++;
 	date = t;
 	eventType = EVENT_GENERIC;
 	randomNumber = 0;
@@ -36,9 +36,8 @@ Event::Event(Time t) {
 }
 
 Event::Event(Event *ev) {
-	id = nextId;
-	nextId++;
-	nbLivingEvents++;
+	id = nextId.get()++;
+	nbLivingEvents.get()++;
 	date = ev->date;
 	eventType = ev->eventType;
 	randomNumber = 0;
@@ -47,19 +46,26 @@ Event::Event(Event *ev) {
 
 Event::~Event() {
 	EVENT_DESTRUCTOR_INFO();
-	nbLivingEvents--;
+	nbLivingEvents.get()--;
 }
 
 const string Event::getEventName() {
 	return("Generic Event");
 }
 
+bool Event::isGlobal() {
+	// Motion events (rotations, translations, okteen motions, teleportations and deformations)
+	//  update the lattice and the neighborhood of the moving block
+	return getOwnerBlock() == NULL
+		|| (eventType >= EVENT_ROTATION2D_START && eventType <= EVENT_DEFORMATION_END);
+}
+
 unsigned int Event::getNextId() {
-	return(nextId);
+	return(nextId.get());
 }
 
 unsigned int Event::getNbLivingEvents() {
-	return(nbLivingEvents);
+	return(nbLivingEvents.get());
 }
 
 //===========================================================================================================
@@ -87,6 +93,11 @@ const string BlockEvent::getEventName() {
 	return("Generic BlockEvent");
 }
 
+bool BlockEvent::save(SnapshotWriter &w) const {
+	w.writeBlock(concernedBlock);
+	return true;
+}
+
 //===========================================================================================================
 //
 //          CodeStartEvent  (class)
@@ -110,6 +121,10 @@ const string CodeStartEvent::getEventName() {
 	return("CodeStart Event");
 }
 
+Event* CodeStartEvent::restore(SnapshotReader &r, Time date) {
+	return new CodeStartEvent(date, r.readBlock());
+}
+
 //===========================================================================================================
 //
 //          CodeEndSimulationEvent  (class)
@@ -134,6 +149,14 @@ const string CodeEndSimulationEvent::getEventName() {
 	return("CodeEndSimulation Event");
 }
 
+bool CodeEndSimulationEvent::save(SnapshotWriter &w) const {
+	return true;
+}
+
+Event* CodeEndSimulationEvent::restore(SnapshotReader &r, Time date) {
+	return new CodeEndSimulationEvent(date);
+}
+
 
 //===========================================================================================================
 //
@@ -158,6 +181,10 @@ const string ProcessLocalEvent::getEventName() {
 	return("ProcessLocal Event");
 }
 
+Event* ProcessLocalEvent::restore(SnapshotReader &r, Time date) {
+	return new ProcessLocalEvent(date, r.readBlock());
+}
+
 //===========================================================================================================
 //
 //          NetworkInterfaceStartTransmittingEvent  (class)
@@ -178,19 +205,33 @@ void NetworkInterfaceStartTransmittingEvent::consume() {
 	interface->send();
 }
 
+BaseSimulator::BuildingBlock* NetworkInterfaceStartTransmittingEvent::getOwnerBlock() {
+	return interface->hostBlock;
+}
+
 const string NetworkInterfaceStartTransmittingEvent::getEventName() {
 	return("NetworkInterfaceStartTransmitting Event");
 }
 
+bool NetworkInterfaceStartTransmittingEvent::save(SnapshotWriter &w) const {
+	w.writeInterface(interface);
+	return true;
+}
+
+Event* NetworkInterfaceStartTransmittingEvent::restore(SnapshotReader &r, Time date) {
+	return new NetworkInterfaceStartTransmittingEvent(date, r.readInterface());
+}
+
 //===========================================================================================================
 //
 //          NetworkInterfaceStopTransmittingEvent  (class)
 //
 //===========================================================================================================
 
-NetworkInterfaceStopTransmittingEvent::NetworkInterfaceStopTransmittingEvent(Time t, P2PNetworkInterface *ni):Event(t) {
+NetworkInterfaceStopTransmittingEvent::NetworkInterfaceStopTransmittingEvent(Time t, P2PNetworkInterface *ni, bool deliverMessage):Event(t) {
 	eventType = EVENT_NI_STOP_TRANSMITTING;
 	interface = ni;
+	deliver = deliverMessage;
 	EVENT_CONSTRUCTOR_INFO();
 }
 NetworkInterfaceStopTransmittingEvent::~NetworkInterfaceStopTransmittingEvent() {
@@ -199,7 +240,9 @@ NetworkInterfaceStopTransmittingEvent::~NetworkInterfaceStopTransmittingEvent()
 
 void NetworkInterfaceStopTransmittingEvent::consume() {
 	EVENT_CONSUME_INFO();
-	if (!interface->connectedInterface) {
+	if (!deliver) {
+	  // Message has already been handed to the receiving block by a NetworkInterfaceDeliverEvent
+	} else if (!interface->connectedInterface) {
 	  ERRPUT << "Warning: connection loss, untransmitted message!" << endl;
 	} else {
 	  BaseSimulator::BuildingBlock *receivingBlock = interface->connectedInterface->hostBlock;
@@ -212,15 +255,86 @@ void NetworkInterfaceStopTransmittingEvent::consume() {
 	interface->availabilityDate = BaseSimulator::getScheduler()->now();
 	
 	if (interface->outgoingQueue.size() > 0) {
-		//cout << "one more to send !!" << endl;
-		interface->send();
+		// Next message of the burst, whose completion date is already known
+		interface->sendNext(this);
 	}
 }
 
+BaseSimulator::BuildingBlock* NetworkInterfaceStopTransmittingEvent::getOwnerBlock() {
+	return interface->hostBlock;
+}
+
 const string NetworkInterfaceStopTransmittingEvent::getEventName() {
 	return("NetworkInterfaceStopTransmitting Event");
 }
 
+bool NetworkInterfaceStopTransmittingEvent::save(SnapshotWriter &w) const {
+	w.writeInterface(interface);
+	w.write(deliver);
+	return true;
+}
+
+Event* NetworkInterfaceStopTransmittingEvent::restore(SnapshotReader &r, Time date) {
+	P2PNetworkInterface *ni = r.readInterface();
+	bool deliverMessage;
+	r.read(deliverMessage);
+	return new NetworkInterfaceStopTransmittingEvent(date, ni, deliverMessage);
+}
+
+//===========================================================================================================
+//
+//          NetworkInterfaceDeliverEvent  (class)
+//
+//===========================================================================================================
+
+NetworkInterfaceDeliverEvent::NetworkInterfaceDeliverEvent(Time t, P2PNetworkInterface *ni, MessagePtr mes):Event(t) {
+	eventType = EVENT_NI_DELIVER;
+	interface = ni;
+	message = mes;
+	EVENT_CONSTRUCTOR_INFO();
+}
+
+NetworkInterfaceDeliverEvent::~NetworkInterfaceDeliverEvent() {
+	message.reset();
+	EVENT_DESTRUCTOR_INFO();
+}
+
+void NetworkInterfaceDeliverEvent::consume() {
+	EVENT_CONSUME_INFO();
+	if (!interface->connectedInterface) {
+	  ERRPUT << "Warning: connection loss, untransmitted message!" << endl;
+	} else {
+	  BaseSimulator::BuildingBlock *receivingBlock = interface->connectedInterface->hostBlock;
+	  receivingBlock->scheduleLocalEvent(EventPtr(new NetworkInterfaceReceiveEvent(BaseSimulator::getScheduler()->now(), interface->connectedInterface, message)));
+	  BaseSimulator::utils::StatsIndividual::incReceivedMessageCount(receivingBlock->stats);
+	  BaseSimulator::utils::StatsIndividual::incIncommingMessageQueueSize(receivingBlock->stats);
+	}
+}
+
+BaseSimulator::BuildingBlock* NetworkInterfaceDeliverEvent::getOwnerBlock() {
+	// The receiving block, unless the connection has been lost meanwhile
+	return interface->connectedInterface ? interface->connectedInterface->hostBlock : interface->hostBlock;
+}
+
+const string NetworkInterfaceDeliverEvent::getEventName() {
+	return("NetworkInterfaceDeliver Event");
+}
+
+bool NetworkInterfaceDeliverEvent::save(SnapshotWriter &w) const {
+	w.writeInterface(interface);
+	w.writeMessage(message);
+	w.write(parallelOnly);
+	return true;
+}
+
+Event* NetworkInterfaceDeliverEvent::restore(SnapshotReader &r, Time date) {
+	P2PNetworkInterface *ni = r.readInterface();
+	MessagePtr mes = r.readMessage();
+	NetworkInterfaceDeliverEvent *ev = new NetworkInterfaceDeliverEvent(date, ni, mes);
+	r.read(ev->parallelOnly);
+	return ev;
+}
+
 //===========================================================================================================
 //
 //          NetworkInterfaceReceiveEvent  (class)
@@ -243,10 +357,26 @@ void NetworkInterfaceReceiveEvent::consume() {
 	EVENT_CONSUME_INFO();
 }
 
+BaseSimulator::BuildingBlock* NetworkInterfaceReceiveEvent::getOwnerBlock() {
+	return interface->hostBlock;
+}
+
 const string NetworkInterfaceReceiveEvent::getEventName() {
 	return("NetworkInterfaceReceiveEvent Event");
 }
 
+bool NetworkInterfaceReceiveEvent::save(SnapshotWriter &w) const {
+	w.writeInterface(interface);
+	w.writeMessage(message);
+	return true;
+}
+
+Event* NetworkInterfaceReceiveEvent::restore(SnapshotReader &r, Time date) {
+	P2PNetworkInterface *ni = r.readInterface();
+	MessagePtr mes = r.readMessage();
+	return new NetworkInterfaceReceiveEvent(date, ni, mes);
+}
+
 //===========================================================================================================
 //
 //          NetworkInterfaceEnqueueOutgoingEvent  (class)
@@ -277,10 +407,26 @@ void NetworkInterfaceEnqueueOutgoingEvent::consume() {
 	sourceInterface->addToOutgoingBuffer(message);
 }
 
+BaseSimulator::BuildingBlock* NetworkInterfaceEnqueueOutgoingEvent::getOwnerBlock() {
+	return sourceInterface->hostBlock;
+}
+
 const string NetworkInterfaceEnqueueOutgoingEvent::getEventName() {
 	return("NetworkInterfaceEnqueueOutgoingEvent Event");
 }
 
+bool NetworkInterfaceEnqueueOutgoingEvent::save(SnapshotWriter &w) const {
+	w.writeMessage(message);
+	w.writeInterface(sourceInterface);
+	return true;
+}
+
+Event* NetworkInterfaceEnqueueOutgoingEvent::restore(SnapshotReader &r, Time date) {
+	MessagePtr mes = r.readMessage();
+	P2PNetworkInterface *ni = r.readInterface();
+	return new NetworkInterfaceEnqueueOutgoingEvent(date, mes, ni);
+}
+
 
 //===========================================================================================================
 //
@@ -321,6 +467,20 @@ const string SetColorEvent::getEventName() {
 	return("SetColor Event");
 }
 
+bool SetColorEvent::save(SnapshotWriter &w) const {
+	BlockEvent::save(w);
+	w.write(color.rgba);
+	return true;
+}
+
+Event* SetColorEvent::restore(SnapshotReader &r, Time date) {
+	BuildingBlock *bb = r.readBlock();
+	Color c;
+	r.read(c.rgba);
+	// Draws from the generator of the block, whose state is restored afterwards
+	return new SetColorEvent(date, bb, c);
+}
+
 //===========================================================================================================
 //
 //          AddNeighborEvent  (class)
@@ -353,6 +513,19 @@ const string AddNeighborEvent::getEventName() {
 	return("AddNeighbor Event");
 }
 
+bool AddNeighborEvent::save(SnapshotWriter &w) const {
+	BlockEvent::save(w);
+	w.write(face, target);
+	return true;
+}
+
+Event* AddNeighborEvent::restore(SnapshotReader &r, Time date) {
+	BuildingBlock *bb = r.readBlock();
+	uint64_t f, ta;
+	r.read(f, ta);
+	return new AddNeighborEvent(date, bb, f, ta);
+}
+
 //===========================================================================================================
 //
 //          RemoveNeighborEvent  (class)
@@ -383,6 +556,19 @@ const string RemoveNeighborEvent::getEventName() {
 	return("RemoveNeighbor Event");
 }
 
+bool RemoveNeighborEvent::save(SnapshotWriter &w) const {
+	BlockEvent::save(w);
+	w.write(face);
+	return true;
+}
+
+Event* RemoveNeighborEvent::restore(SnapshotReader &r, Time date) {
+	BuildingBlock *bb = r.readBlock();
+	uint64_t f;
+	r.read(f);
+	return new RemoveNeighborEvent(date, bb, f);
+}
+
 //===========================================================================================================
 //
 //          TapEvent  (class)
@@ -412,6 +598,19 @@ const string TapEvent::getEventName() {
 	return("Tap Event");
 }
 
+bool TapEvent::save(SnapshotWriter &w) const {
+	BlockEvent::save(w);
+	w.write(tappedFace);
+	return true;
+}
+
+Event* TapEvent::restore(SnapshotReader &r, Time date) {
+	BuildingBlock *bb = r.readBlock();
+	int face;
+	r.read(face);
+	return new TapEvent(date, bb, face);
+}
+
 //===========================================================================================================
 //
 //          AccelEvent  (class)
@@ -446,6 +645,19 @@ const string AccelEvent::getEventName() {
 	return("Accel Event");
 }
 
+bool AccelEvent::save(SnapshotWriter &w) const {
+	BlockEvent::save(w);
+	w.write(x, y, z);
+	return true;
+}
+
+Event* AccelEvent::restore(SnapshotReader &r, Time date) {
+	BuildingBlock *bb = r.readBlock();
+	uint64_t xx, yy, zz;
+	r.read(xx, yy, zz);
+	return new AccelEvent(date, bb, xx, yy, zz);
+}
+
 //===========================================================================================================
 //
 //          ShakeEvent  (class)
@@ -476,6 +688,19 @@ const string ShakeEvent::getEventName() {
 	return("Shake Event");
 }
 
+bool ShakeEvent::save(SnapshotWriter &w) const {
+	BlockEvent::save(w);
+	w.write(force);
+	return true;
+}
+
+Event* ShakeEvent::restore(SnapshotReader &r, Time date) {
+	BuildingBlock *bb = r.readBlock();
+	uint64_t f;
+	r.read(f);
+	return new ShakeEvent(date, bb, f);
+}
+
 //===========================================================================================================
 //
 //          InterruptionEvent  (class)
@@ -506,6 +731,19 @@ const string InterruptionEvent::getEventName() {
 	return("Interruption Event");
 }
 
+bool InterruptionEvent::save(SnapshotWriter &w) const {
+	BlockEvent::save(w);
+	w.write(mode);
+	return true;
+}
+
+Event* InterruptionEvent::restore(SnapshotReader &r, Time date) {
+	BuildingBlock *bb = r.readBlock();
+	uint64_t m;
+	r.read(m);
+	return new InterruptionEvent(date, bb, m);
+}
+
 //===========================================================================================================
 //
 //          PivotActuationStartEvent  (class)
@@ -545,6 +783,21 @@ const string PivotActuationStartEvent::getEventName() {
 	return("PivotActuationStart Event");
 }
 
+bool PivotActuationStartEvent::save(SnapshotWriter &w) const {
+	BlockEvent::save(w);
+	w.writeBlock(mobile);
+	w.write(fromConP, toConP);
+	return true;
+}
+
+Event* PivotActuationStartEvent::restore(SnapshotReader &r, Time date) {
+	BuildingBlock *bb = r.readBlock();
+	const BuildingBlock *mobile = r.readBlock();
+	short from, to;
+	r.read(from, to);
+	return new PivotActuationStartEvent(date, bb, mobile, from, to);
+}
+
 //===========================================================================================================
 //
 //          PivotActuationEndEvent  (class)
@@ -583,3 +836,18 @@ void PivotActuationEndEvent::consumeBlockEvent() {
 const string PivotActuationEndEvent::getEventName() {
 	return("PivotActuationEnd Event");
 }
+
+bool PivotActuationEndEvent::save(SnapshotWriter &w) const {
+	BlockEvent::save(w);
+	w.writeBlock(mobile);
+	w.write(fromConP, toConP);
+	return true;
+}
+
+Event* PivotActuationEndEvent::restore(SnapshotReader &r, Time date) {
+	BuildingBlock *bb = r.readBlock();
+	const BuildingBlock *mobile = r.readBlock();
+	short from, to;
+	r.read(from, to);
+	return new PivotActuationEndEvent(date, bb, mobile, from, to);
+}
@@ -12,19 +12,28 @@
 
 #include <inttypes.h>
 #include <string>
+#include <atomic>
 #include "buildingBlock.h"
 #include "uniqueEventsId.h"
 #include "network.h"
 #include "color.h"
 #include "tDefs.h"
 #include "random.h"
+#include "intrusivePtr.h"
+#include "poolAllocator.h"
 
 using namespace std;
 using namespace BaseSimulator;
 
+namespace BaseSimulator {
+class Snapshot;
+class SnapshotWriter;
+class SnapshotReader;
+}
+
 class Event;
 
-typedef std::shared_ptr<Event> EventPtr;
+typedef BaseSimulator::IntrusivePtr<Event> EventPtr;
 
 #ifdef DEBUG_EVENTS
 #define EVENT_CONSTRUCTOR_INFO()			(OUTPUT << getEventName() << " constructor (" << id << ")" << endl)
@@ -48,8 +57,13 @@ typedef std::shared_ptr<Event> EventPtr;
 
 class Event {
 protected:
-    static int nextId;
-    static unsigned int nbLivingEvents;
+    static BaseSimulator::RunLocal<std::atomic<int>> nextId;
+    static BaseSimulator::RunLocal<std::atomic<unsigned int>> nbLivingEvents;
+
+    //!< Number of EventPtr referencing this event. Not atomic: an event is only shared by the
+    //!<  thread that schedules it and the scheduler thread, under the scheduler lock. With the
+    //!<  parallel scheduler, it is handled by a single worker at a time, and changes hands at window barriers.
+    unsigned int refCount = 0;
 
 public:
     int id;				//!< unique ID of the event (mainly for debugging purpose)
@@ -67,6 +81,33 @@ public:
     static unsigned int getNextId();
     static unsigned int getNbLivingEvents();
     virtual BaseSimulator::BuildingBlock* getConcernedBlock() { return NULL; };
+    /**
+     * @brief Returns the module whose state is read and modified by consuming the event, hence
+     *  the logical process in charge of it with the parallel scheduler. Network events have no
+     *  concerned block, but are owned by the module of their interface.
+     * @return the concerned block by default
+     */
+    virtual BaseSimulator::BuildingBlock* getOwnerBlock() { return getConcernedBlock(); };
+    /**
+     * @brief Tells whether consuming the event may act on other modules than its owner block,
+     *  e.g. by moving it in the lattice. The parallel scheduler processes such events alone.
+     * @return true for motion events and events that are not owned by a particular block
+     */
+    virtual bool isGlobal();
+    /**
+     * @brief Writes the fields of the pending event to a snapshot, read back by the restore
+     *  function registered for its type (see Snapshot::registerEvent)
+     * @return false if the event cannot be saved (default)
+     */
+    virtual bool save(BaseSimulator::SnapshotWriter &w) const { return false; };
+
+    //!< Events of all types are allocated from size-class slabs, and recycled without going through malloc
+    static void* operator new(size_t size) { return BaseSimulator::utils::PoolAllocator::allocate(size); }
+    static void operator delete(void *p, size_t size) { BaseSimulator::utils::PoolAllocator::deallocate(p, size); }
+
+    friend class BaseSimulator::Snapshot;
+    friend inline void intrusive_ptr_add_ref(Event *ev) { ev->refCount++; }
+    friend inline void intrusive_ptr_release(Event *ev) { if (--ev->refCount == 0) delete ev; }
 };
 
 //===========================================================================================================
@@ -86,6 +127,8 @@ protected:
 
 public:
     BaseSimulator::BuildingBlock* getConcernedBlock() override { return concernedBlock;};
+    //!< @brief Writes the concerned block, the first field of all the block events
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
     virtual void consumeBlockEvent() = 0;
     virtual void consume() override {
         if (concernedBlock->getState() >= BaseSimulator::BuildingBlock::ALIVE) {
@@ -107,6 +150,7 @@ public:
     ~CodeStartEvent();
     void consumeBlockEvent() override;
     const virtual string getEventName() override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -122,6 +166,8 @@ public:
     ~CodeEndSimulationEvent();
     void consume() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -137,6 +183,7 @@ public:
     ~ProcessLocalEvent();
     void consumeBlockEvent() override;
     const virtual string getEventName() override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -152,7 +199,10 @@ public:
     NetworkInterfaceStartTransmittingEvent(Time, P2PNetworkInterface *ni);
     ~NetworkInterfaceStartTransmittingEvent();
     void consume() override;
+    BaseSimulator::BuildingBlock* getOwnerBlock() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -164,11 +214,40 @@ public:
 class NetworkInterfaceStopTransmittingEvent : public Event {
 public:
     P2PNetworkInterface *interface;
+    bool deliver; //!< Hands the message to the receiving block, unless a NetworkInterfaceDeliverEvent does it
 
-    NetworkInterfaceStopTransmittingEvent(Time, P2PNetworkInterface *ni);
+    NetworkInterfaceStopTransmittingEvent(Time, P2PNetworkInterface *ni, bool deliverMessage = true);
     ~NetworkInterfaceStopTransmittingEvent();
     void consume() override;
+    BaseSimulator::BuildingBlock* getOwnerBlock() override;
+    const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
+};
+
+//===========================================================================================================
+//
+//          NetworkInterfaceDeliverEvent  (class)
+//
+//===========================================================================================================
+
+/**
+ * @brief Receiving side of a NetworkInterfaceStopTransmittingEvent, processed just before it.
+ *  Used by the parallel scheduler, so that the receiving block is only modified by an event it owns.
+ */
+class NetworkInterfaceDeliverEvent : public Event {
+public:
+    P2PNetworkInterface *interface; //!< Sending interface
+    MessagePtr message;
+    bool parallelOnly = false; //!< Delivered with the end of transmission by sequential schedulers, hence not counted
+
+    NetworkInterfaceDeliverEvent(Time, P2PNetworkInterface *ni, MessagePtr mes);
+    ~NetworkInterfaceDeliverEvent();
+    void consume() override;
+    BaseSimulator::BuildingBlock* getOwnerBlock() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -184,7 +263,10 @@ public:
     NetworkInterfaceReceiveEvent(Time,P2PNetworkInterface *ni, MessagePtr mes);
     ~NetworkInterfaceReceiveEvent();
     void consume() override;
+    BaseSimulator::BuildingBlock* getOwnerBlock() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -202,7 +284,10 @@ public:
     NetworkInterfaceEnqueueOutgoingEvent(Time, MessagePtr mes, P2PNetworkInterface *ni);
     ~NetworkInterfaceEnqueueOutgoingEvent();
     void consume() override;
+    BaseSimulator::BuildingBlock* getOwnerBlock() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 
@@ -222,6 +307,8 @@ public:
     ~SetColorEvent();
     void consumeBlockEvent() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 
@@ -241,6 +328,8 @@ public:
     ~AddNeighborEvent();
     void consumeBlockEvent() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -258,6 +347,8 @@ public:
     ~RemoveNeighborEvent();
     void consumeBlockEvent() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -275,6 +366,8 @@ public:
     ~TapEvent();
     void consumeBlockEvent() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 
@@ -295,6 +388,8 @@ public:
     ~AccelEvent();
     void consumeBlockEvent() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -312,6 +407,8 @@ public:
     ~ShakeEvent();
     void consumeBlockEvent() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -332,6 +429,8 @@ public:
     ~InterruptionEvent();
     void consumeBlockEvent() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -352,6 +451,8 @@ public:
     ~PivotActuationStartEvent();
     void consumeBlockEvent() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -372,6 +473,8 @@ public:
     ~PivotActuationEndEvent();
     void consumeBlockEvent() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 #endif /* EVENTS_H_ */
@@ -0,0 +1,380 @@
+/*! @file faultInjector.cpp
+ * @brief Injection of faults at exact simulated dates, and campaigns of randomized faults.
+ * @date 17/10/2026
+ */
+
+#include "faultInjector.h"
+
+#include <map>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+
+#include "world.h"
+#include "scheduler.h"
+#include "simulator.h"
+#include "network.h"
+#include "linkModel.h"
+#include "statsCollector.h"
+#include "snapshot.h"
+#include "processPool.h"
+#include "trace.h"
+#include "traceSink.h"
+
+using namespace std;
+using namespace BaseSimulator::utils;
+
+namespace BaseSimulator {
+
+RunLocal<vector<Fault>> FaultInjector::faults;
+RunLocal<ruint> FaultInjector::seed { 0u };
+int FaultInjector::nbCampaigns = 0;
+int FaultInjector::nbProcesses = 0;
+Time FaultInjector::forkDate = 0;
+
+namespace {
+
+const char *typeNames[] = { "interfaceBreak", "moduleDeath", "messageDrop", "stuckMotion" };
+
+RunLocal<uintRNG> generator; //!< Random dates and modules of the faults
+
+//!< Simulation of a campaign
+struct Run {
+    int type;                   //!< Type of the injected faults, -1 for the reference simulation
+    bool reported = false;      //!< False if the process died before writing its result
+    ProcessPool::Summary result;
+};
+
+//!< @brief Returns a value of the generator in [min, max]
+template<class T>
+T draw(T min, T max) {
+    return uniform_int_distribution<T>(min, max)(generator.get());
+}
+
+void printSummary(const vector<Run> &runs) {
+    const Run &ref = runs[0];
+    const bool refCompleted = ref.reported and ref.result.completed;
+
+    cout << TermColor::BWhite << "=== FAULT INJECTION CAMPAIGNS ===" << TermColor::Reset << endl;
+    if (refCompleted)
+        cout << "Reference: completed at " << ref.result.completionDate << " us, "
+             << ref.result.nbMessages << " messages" << endl;
+    else
+        cout << "Reference: not completed" << endl;
+
+    cout << left << setw(16) << "fault" << right << setw(6) << "runs" << setw(10) << "failures"
+         << setw(18) << "completion (us)" << setw(12) << "messages" << setw(10) << "overhead" << endl;
+
+    for (int t = 0; t < (int)FaultType::NbFaultTypes; t++) {
+        int nbRuns = 0, nbCompleted = 0;
+        double date = 0, messages = 0;
+        for (const Run &r : runs) {
+            if (r.type != t) continue;
+            nbRuns++;
+            if (r.reported and r.result.completed) {
+                nbCompleted++;
+                date += r.result.completionDate;
+                messages += r.result.nbMessages;
+            }
+        }
+        if (nbRuns == 0) continue;
+
+        stringstream failures, overhead;
+        failures << fixed << setprecision(1) << 100.0 * (nbRuns - nbCompleted) / nbRuns << "%";
+        cout << left << setw(16) << typeNames[t] << right << setw(6) << nbRuns
+             << setw(10) << failures.str();
+        if (nbCompleted == 0) {
+            cout << setw(18) << "-" << setw(12) << "-" << setw(10) << "-" << endl;
+            continue;
+        }
+
+        date /= nbCompleted;
+        messages /= nbCompleted;
+        if (refCompleted and ref.result.nbMessages)
+            overhead << showpos << fixed << setprecision(1)
+                     << 100.0 * (messages / ref.result.nbMessages - 1) << "%";
+        else
+            overhead << "-";
+        cout << fixed << setprecision(0) << setw(18) << date << setw(12) << messages
+             << setw(10) << overhead.str() << endl;
+    }
+}
+
+} // anonymous namespace
+
+bool FaultInjector::parseType(const string &name, FaultType &type) {
+    for (int t = 0; t < (int)FaultType::NbFaultTypes; t++) {
+        if (name == typeNames[t]) {
+            type = (FaultType)t;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const char* FaultInjector::getTypeName(FaultType type) {
+    return typeNames[(int)type];
+}
+
+bool FaultInjector::parseDate(const string &s, Fault &f) {
+    const size_t dash = s.find('-');
+    try {
+        f.date = stoull(s.substr(0, dash));
+        f.dateMax = dash == string::npos ? f.date : stoull(s.substr(dash + 1));
+    } catch (const std::logic_error&) {
+        return false;
+    }
+
+    return f.dateMax >= f.date;
+}
+
+bool FaultInjector::parse(const string &spec, Fault &f) {
+    const size_t at = spec.find('@');
+    if (at == string::npos or not parseType(spec.substr(0, at), f.type)) return false;
+
+    vector<string> fields;
+    stringstream ss(spec.substr(at + 1));
+    string field;
+    while (getline(ss, field, ':')) fields.push_back(field);
+    if (fields.empty() or fields.size() > 4 or not parseDate(fields[0], f)) return false;
+
+    try {
+        // Empty fields keep their default value
+        if (fields.size() > 1 and not fields[1].empty()) f.blockId = stoul(fields[1]);
+        if (fields.size() > 2 and not fields[2].empty()) f.interface = stoi(fields[2]);
+        if (fields.size() > 3 and not fields[3].empty()) f.count = stoul(fields[3]);
+    } catch (const std::logic_error&) {
+        return false;
+    }
+
+    return true;
+}
+
+void FaultInjector::setCampaigns(int campaigns, int processes) {
+    nbCampaigns = campaigns;
+    nbProcesses = processes > 0 ? processes : max(1u, thread::hardware_concurrency());
+}
+
+void FaultInjector::checkDates(Time date, const string &name) {
+    for (const Fault &f : faults.get()) {
+        if (f.date < date) {
+            cerr << TermColor::ErrorColor << "error: fault " << getTypeName(f.type) << " at " << f.date
+                 << " occurs before " << name << " (" << date << ")" << TermColor::Reset << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void FaultInjector::runCampaigns() {
+    // A resumed simulation, and the campaigns forked from it, start at the snapshot date
+    if (Snapshot::isResuming()) checkDates(Snapshot::getResumeDate(), "the snapshot date");
+    if (nbCampaigns == 0) return;
+    if (faults.get().empty()) {
+        cerr << "warning: no fault to inject, running a single simulation" << endl;
+        nbCampaigns = 0;
+        return;
+    }
+
+    if (forkDate == 0) {
+        forkCampaigns();
+        return;
+    }
+
+    // Simulations are forked at the fork date (see schedule), their faults cannot occur before
+    checkDates(forkDate, "the fork date");
+}
+
+void FaultInjector::forkCampaigns() {
+    // The reference simulation, then the campaigns of each type of fault of the schedule
+    vector<Run> runs(1);
+    runs[0].type = -1;
+    for (int t = 0; t < (int)FaultType::NbFaultTypes; t++) {
+        if (none_of(faults.get().begin(), faults.get().end(),
+                    [t](const Fault &f) { return (int)f.type == t; })) continue;
+        for (int i = 0; i < nbCampaigns; i++) {
+            runs.emplace_back();
+            runs.back().type = t;
+        }
+    }
+
+    cerr << "Running " << runs.size() << " simulations, " << nbProcesses << " at once" << endl;
+
+    vector<ProcessPool::Outcome> outcomes;
+    const long next = ProcessPool::run(runs.size(), nbProcesses, outcomes);
+    if (next >= 0) {
+        // Simulation of run next
+        vector<Fault> selected;
+        for (const Fault &f : faults.get())
+            if ((int)f.type == runs[next].type) selected.push_back(f);
+        faults.get().swap(selected);
+        seed.get() += (ruint)next * 2654435761u;
+        nbCampaigns = 0;
+        atexit(writeResult);
+        return;
+    }
+
+    for (size_t i = 0; i < runs.size(); i++) {
+        runs[i].reported = outcomes[i].data.size() == sizeof(ProcessPool::Summary);
+        if (runs[i].reported) memcpy(&runs[i].result, outcomes[i].data.data(), sizeof(ProcessPool::Summary));
+    }
+
+    printSummary(runs);
+    exit(EXIT_SUCCESS);
+}
+
+void FaultInjector::writeResult() {
+    const ProcessPool::Summary s = ProcessPool::getSummary();
+    ProcessPool::report(&s, sizeof(s));
+}
+
+void FaultInjector::schedule() {
+    if (hasCampaigns()) {
+        // Campaigns share the fault free simulation up to the fork date
+        getScheduler()->schedule(new CampaignForkEvent(forkDate));
+        return;
+    }
+
+    generator.get().seed(seed);
+    for (const Fault &f : faults.get()) {
+        const Time date = f.dateMax > f.date ? draw<Time>(f.date, f.dateMax - 1) : f.date;
+        getScheduler()->schedule(new FaultEvent(date, f));
+    }
+}
+
+void FaultInjector::inject(Fault f) {
+    const Time now = getScheduler()->now();
+    map<bID, BuildingBlock*> &blocks = getWorld()->getMap();
+    BuildingBlock *bb = NULL;
+    stringstream info;
+
+    if (f.blockId == 0) {
+        vector<BuildingBlock*> living;
+        for (auto &p : blocks)
+            if (p.second->getState() >= BuildingBlock::ALIVE) living.push_back(p.second);
+        if (not living.empty()) bb = living[draw<size_t>(0, living.size() - 1)];
+    } else {
+        auto it = blocks.find(f.blockId);
+        if (it != blocks.end() and it->second->getState() >= BuildingBlock::ALIVE) bb = it->second;
+    }
+
+    if (not bb) {
+        info << "fault " << getTypeName(f.type) << ": no living module " << f.blockId;
+        getScheduler()->trace(info.str(), f.blockId, RED);
+        return;
+    }
+
+    switch (f.type) {
+        case FaultType::InterfaceBreak: {
+            P2PNetworkInterface *itf = NULL;
+            if (f.interface < 0) {
+                vector<P2PNetworkInterface*> connected;
+                for (P2PNetworkInterface *i : bb->getP2PNetworkInterfaces())
+                    if (i->isConnected()) connected.push_back(i);
+                if (not connected.empty()) itf = connected[draw<size_t>(0, connected.size() - 1)];
+            } else if (f.interface < bb->getNbInterfaces()) {
+                itf = bb->getInterface(f.interface);
+            }
+
+            if (not itf) {
+                info << "fault " << getTypeName(f.type) << ": no interface to break";
+                break;
+            }
+
+            // The link is down for good from now on, other properties of its model are kept
+            LinkModel *model = itf->getLinkModel() ? new LinkModel(*itf->getLinkModel()) : new LinkModel();
+            vector<LinkModel::Outage> &outages = model->outages;
+            while (not outages.empty() and outages.back().start >= now) outages.pop_back();
+            if (not outages.empty() and outages.back().end >= now)
+                outages.back().end = numeric_limits<Time>::max();
+            else
+                outages.push_back({ now, numeric_limits<Time>::max() });
+            model->name = string(getTypeName(f.type)) + "#" + to_string(bb->blockId) + ":"
+                + to_string(itf->localId);
+            LinkModel::add(model);
+            itf->setLinkModel(model);
+
+            info << "fault: interface " << itf->localId << " breaks";
+        } break;
+
+        case FaultType::ModuleDeath:
+            bb->setColor(DARKGREY);
+            bb->setState(BuildingBlock::STOPPED);
+            info << "fault: module dies";
+            break;
+
+        case FaultType::MessageDrop:
+            for (P2PNetworkInterface *itf : bb->getP2PNetworkInterfaces())
+                if (f.interface < 0 or itf->localId == (bID)f.interface)
+                    itf->nbMessagesToDrop += f.count;
+            info << "fault: drops its next " << f.count << " message(s)";
+            break;
+
+        case FaultType::StuckMotion:
+            bb->motionsStuck = true;
+            info << "fault: motions are stuck";
+            break;
+
+        default: break;
+    }
+
+    if (TraceSink::isEnabled(TraceCategory::Trace))
+        getScheduler()->trace(info.str(), bb->blockId, RED);
+}
+
+//===========================================================================================================
+//
+//          FaultEvent  (class)
+//
+//===========================================================================================================
+
+FaultEvent::FaultEvent(Time t, const Fault &f) : Event(t), fault(f) {
+	eventType = EVENT_FAULT;
+	EVENT_CONSTRUCTOR_INFO();
+}
+
+FaultEvent::~FaultEvent() {
+	EVENT_DESTRUCTOR_INFO();
+}
+
+void FaultEvent::consume() {
+	EVENT_CONSUME_INFO();
+	FaultInjector::inject(fault);
+}
+
+const string FaultEvent::getEventName() {
+	return("Fault Event");
+}
+
+//===========================================================================================================
+//
+//          CampaignForkEvent  (class)
+//
+//===========================================================================================================
+
+CampaignForkEvent::CampaignForkEvent(Time t) : Event(t) {
+	eventType = EVENT_CAMPAIGN_FORK;
+	EVENT_CONSTRUCTOR_INFO();
+}
+
+CampaignForkEvent::~CampaignForkEvent() {
+	EVENT_DESTRUCTOR_INFO();
+}
+
+void CampaignForkEvent::consume() {
+	EVENT_CONSUME_INFO();
+	// Only returns in the simulations of the campaigns, which then schedule their own faults
+	FaultInjector::forkCampaigns();
+	FaultInjector::schedule();
+}
+
+const string CampaignForkEvent::getEventName() {
+	return("Campaign Fork Event");
+}
+
+} // BaseSimulator namespace
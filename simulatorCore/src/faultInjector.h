@@ -0,0 +1,155 @@
+/*! @file faultInjector.h
+ * @brief Injection of faults at exact simulated dates (interface breaks, module deaths, message
+ *  drops, stuck motions), and campaigns of randomized faults run over a pool of processes.
+ * @date 17/10/2026
+ */
+
+#ifndef FAULTINJECTOR_H_
+#define FAULTINJECTOR_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "tDefs.h"
+#include "runContext.h"
+#include "random.h"
+#include "events.h"
+
+namespace BaseSimulator {
+
+enum class FaultType : uint8_t {
+    InterfaceBreak,             //!< An interface of a module stops transmitting, for good
+    ModuleDeath,                //!< A module stops, its events are not processed anymore
+    MessageDrop,                //!< The next messages sent by a module are lost
+    StuckMotion,                //!< The motions of a module never start anymore
+    NbFaultTypes
+};
+
+//!< A fault of the schedule. Faults without a module, or with a date range, are randomized.
+struct Fault {
+    FaultType type = FaultType::ModuleDeath;
+    Time date = 0;              //!< Date, or lower bound of the date if dateMax > date
+    Time dateMax = 0;           //!< Upper bound (excluded) of a random date, date otherwise
+    bID blockId = 0;            //!< 0 for a module drawn among the living ones at the fault date
+    int interface = -1;         //!< -1 for a random connected interface (InterfaceBreak), or for all of them (MessageDrop)
+    unsigned int count = 1;     //!< MessageDrop: number of messages dropped per interface
+
+    bool isRandom() const { return blockId == 0 or dateMax > date; }
+};
+
+/**
+ * @brief Schedule of the faults, declared in the <faults> element of the configuration file,
+ *  or with the -F command line option.
+ *
+ *  Configuration file:
+ *  @code
+ *  <faults seed="7">
+ *    <fault type="interfaceBreak" date="50000" blockId="20" interface="1"/>
+ *    <fault type="moduleDeath" date="100000-400000"/>           <!-- random date and module -->
+ *    <fault type="messageDrop" date="80000" blockId="12" count="3"/>
+ *    <fault type="stuckMotion" date="120000" blockId="35"/>
+ *  </faults>
+ *  @endcode
+ *
+ *  Without campaigns, all the faults are injected in the simulation. With campaigns (-C command
+ *  line option), a fault free reference simulation is run, then, for each type of fault of the
+ *  schedule, a number of simulations injecting the faults of this type only, whose random dates
+ *  and modules are drawn again for each simulation. Each simulation runs in a child process,
+ *  which discards its faulty state when it exits (see ProcessPool). Block codes report the
+ *  completion of their task to the StatsCollector, from which completion dates, message
+ *  overheads and failure rates are computed per type of fault.
+ */
+class FaultInjector {
+    static RunLocal<std::vector<Fault>> faults;
+    static RunLocal<ruint> seed;
+    static int nbCampaigns;     //!< Campaigns per type of fault, 0 to inject all the faults once
+    static int nbProcesses;     //!< Simulations run at once
+    static Time forkDate;       //!< Date the simulations of the campaigns are forked at, 0 to fork before the world is built
+
+    //!< @brief Reports the result of the simulation to the campaign runner, at exit
+    static void writeResult();
+    //!< @brief Exits if a fault occurs before date, the date the simulation starts from
+    static void checkDates(Time date, const std::string &name);
+public:
+    static bool parseType(const std::string &name, FaultType &type);
+    static const char* getTypeName(FaultType type);
+
+    /**
+     * @brief Parses a date, "date" or "min-max" for a random date
+     * @return false if the date is ill-formatted
+     */
+    static bool parseDate(const std::string &s, Fault &f);
+
+    /**
+     * @brief Parses a fault from the command line: <type>@<date>[:<blockId>[:<interface>[:<count>]]],
+     *  such as moduleDeath@100000-400000, interfaceBreak@50000:20:1 or messageDrop@80000::-1:3.
+     *  Empty fields keep their default value.
+     * @return false if the fault is ill-formatted
+     */
+    static bool parse(const std::string &spec, Fault &f);
+
+    static void add(const Fault &f) { faults.get().push_back(f); }
+    static bool isEmpty() { return faults.get().empty(); }
+    static void setSeed(ruint s) { seed = s; }
+
+    /**
+     * @brief Runs campaigns instead of a single simulation
+     * @param campaigns number of simulations per type of fault
+     * @param processes number of simulations run at once, 0 for the number of cores
+     */
+    static void setCampaigns(int campaigns, int processes);
+    static bool hasCampaigns() { return nbCampaigns > 0; }
+
+    /**
+     * @brief Forks the simulations of the campaigns at date, from the state of the fault free
+     *  simulation then. The state is only shared through fork, see Snapshot to save and resume it.
+     */
+    static void setForkDate(Time date) { forkDate = date; }
+    static Time getForkDate() { return forkDate; }
+
+    /**
+     * @brief Forks the simulations of the campaigns before the world is built, unless they
+     *  have a fork date, see forkCampaigns.
+     *  Must be called before any thread is started.
+     */
+    static void runCampaigns();
+
+    /**
+     * @brief Forks the simulations of the campaigns, and prints their summary. Only returns in
+     *  the child processes, with the faults of their simulation.
+     */
+    static void forkCampaigns();
+
+    /**
+     * @brief Schedules the faults of the simulation, whose random dates are drawn, or the
+     *  fork of the campaigns at their fork date
+     */
+    static void schedule();
+
+    //!< @brief Applies fault f, at the current date
+    static void inject(Fault f);
+};
+
+//!< Injects a fault at its date, processed as a global event, since its module may be drawn then
+class FaultEvent : public Event {
+    Fault fault;
+public:
+    FaultEvent(Time t, const Fault &f);
+    ~FaultEvent();
+    void consume() override;
+    const virtual string getEventName() override;
+};
+
+//!< Forks the simulations of the campaigns, processed as a global event so that no other event is in progress
+class CampaignForkEvent : public Event {
+public:
+    CampaignForkEvent(Time t);
+    ~CampaignForkEvent();
+    void consume() override;
+    const virtual string getEventName() override;
+};
+
+} // BaseSimulator namespace
+
+#endif /* FAULTINJECTOR_H_ */
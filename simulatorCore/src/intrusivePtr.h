@@ -0,0 +1,82 @@
+/*! @file intrusivePtr.h
+ * @brief Smart pointer to objects that hold their own reference counter (in the spirit of
+ *  boost::intrusive_ptr). Unlike std::shared_ptr, it needs no separate control block and
+ *  copying it does not involve any atomic operation.
+ *
+ *  For a pointed type T, the two following functions must be reachable through
+ *  argument-dependent lookup where the pointer is copied or destroyed:
+ *    void intrusive_ptr_add_ref(T *p);  // increments the reference counter of p
+ *    void intrusive_ptr_release(T *p);  // decrements it, and deletes p when it reaches 0
+ * @date 17/10/2026
+ */
+
+#ifndef INTRUSIVEPTR_H_
+#define INTRUSIVEPTR_H_
+
+#include <cstddef>
+#include <utility>
+
+namespace BaseSimulator {
+
+template<typename T>
+class IntrusivePtr {
+    template<typename U> friend class IntrusivePtr;
+
+    T *px = NULL;
+
+public:
+    IntrusivePtr() {};
+    IntrusivePtr(std::nullptr_t) {};
+
+    //!< @brief Takes a new reference on p
+    IntrusivePtr(T *p) : px(p) { if (px) intrusive_ptr_add_ref(px); }
+
+    IntrusivePtr(const IntrusivePtr &p) : px(p.px) { if (px) intrusive_ptr_add_ref(px); }
+    IntrusivePtr(IntrusivePtr &&p) : px(p.px) { p.px = NULL; }
+
+    template<typename U>
+    IntrusivePtr(const IntrusivePtr<U> &p) : px(p.px) { if (px) intrusive_ptr_add_ref(px); }
+    template<typename U>
+    IntrusivePtr(IntrusivePtr<U> &&p) : px(p.px) { p.px = NULL; }
+
+    ~IntrusivePtr() { if (px) intrusive_ptr_release(px); }
+
+    IntrusivePtr& operator=(const IntrusivePtr &p) { IntrusivePtr(p).swap(*this); return *this; }
+    IntrusivePtr& operator=(IntrusivePtr &&p) { IntrusivePtr(std::move(p)).swap(*this); return *this; }
+    IntrusivePtr& operator=(T *p) { IntrusivePtr(p).swap(*this); return *this; }
+
+    //!< @brief Releases the reference held by this pointer, if any
+    void reset() { IntrusivePtr().swap(*this); }
+    void reset(T *p) { IntrusivePtr(p).swap(*this); }
+    void swap(IntrusivePtr &p) { std::swap(px, p.px); }
+
+    inline T* get() const { return px; }
+    inline T& operator*() const { return *px; }
+    inline T* operator->() const { return px; }
+    inline explicit operator bool() const { return px != NULL; }
+};
+
+template<typename T, typename U>
+inline bool operator==(const IntrusivePtr<T> &a, const IntrusivePtr<U> &b) { return a.get() == b.get(); }
+template<typename T, typename U>
+inline bool operator!=(const IntrusivePtr<T> &a, const IntrusivePtr<U> &b) { return a.get() != b.get(); }
+template<typename T>
+inline bool operator==(const IntrusivePtr<T> &a, std::nullptr_t) { return a.get() == NULL; }
+template<typename T>
+inline bool operator!=(const IntrusivePtr<T> &a, std::nullptr_t) { return a.get() != NULL; }
+
+//!< @brief Equivalent of std::static_pointer_cast for IntrusivePtr
+template<typename T, typename U>
+inline IntrusivePtr<T> static_pointer_cast(const IntrusivePtr<U> &p) {
+    return IntrusivePtr<T>(static_cast<T*>(p.get()));
+}
+
+//!< @brief Equivalent of std::dynamic_pointer_cast for IntrusivePtr
+template<typename T, typename U>
+inline IntrusivePtr<T> dynamic_pointer_cast(const IntrusivePtr<U> &p) {
+    return IntrusivePtr<T>(dynamic_cast<T*>(p.get()));
+}
+
+} // BaseSimulator namespace
+
+#endif /* INTRUSIVEPTR_H_ */
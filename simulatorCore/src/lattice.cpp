@@ -13,6 +13,7 @@ using namespace std;
 /********************* Lattice *********************/
 
 const string Lattice::directionName[] = {};
+RunLocal<LatticeStorageType> Lattice::storageType { LatticeStorage::defaultType };
 
 Lattice::Lattice() {
     grid = NULL;
@@ -27,22 +28,16 @@ Lattice::Lattice(const Cell3DPosition &gsz, const Vector3D &gsc) {
         throw InvalidDimensionsException(gsz);
     }
 
-    grid = new BuildingBlock*[gridSize[0] * gridSize[1] * gridSize[2]];
-    // Initializes grid to NULL
-    BuildingBlock **ptr = grid;
-    int i=gridSize[0] * gridSize[1] * gridSize[2];
-    while (i--) {
-        *ptr=NULL;
-        ptr++;
-    }
+    grid = LatticeStorage::create(storageType, gridSize);
 
 #ifdef LATTICE_LOG
-    cerr << "l.new(gridSize = " << gridSize << ", gridScale = " << gridScale << ")" << endl;
+    cerr << "l.new(gridSize = " << gridSize << ", gridScale = " << gridScale
+         << ", storage = " << grid->getName() << ")" << endl;
 #endif
 }
 
 Lattice::~Lattice() {
-    delete [] grid;
+    delete grid;
 }
 
 unsigned int Lattice::getIndex(const Cell3DPosition &p) const {
@@ -68,13 +63,12 @@ Cell3DPosition Lattice::getGridUpperBounds(int z) const {
 
 void Lattice::insert(BuildingBlock* bb, const Cell3DPosition &p, bool count) {
     // try {
-        int index = getIndex(p);
         if (not isInGrid(p))
             throw OutOfLatticeInsertionException(p);
         else if (not isFree(p))
             throw DoubleInsertionException(p);
         else {
-            grid[index] = bb;
+            grid->set(getStoragePosition(p), bb);
             if (p[2] >= 3) nbModules++; // FIXME: remove 'and p[2] >= 3'
         }
     // } catch (DoubleInsertionException const& e) {
@@ -88,14 +82,10 @@ void Lattice::insert(BuildingBlock* bb, const Cell3DPosition &p, bool count) {
 }
 
 void Lattice::remove(const Cell3DPosition &p, bool count) {
-    grid[getIndex(p)] = NULL;
+    grid->set(getStoragePosition(p), NULL);
     if (p[2] >= 3) nbModules--; // FIXME: remove and p[2] >= 3
 }
 
-BuildingBlock* Lattice::getBlock(const Cell3DPosition &p) const {
-    return isInGrid(p) ? grid[getIndex(p)] : NULL;
-}
-
 bool Lattice::isFree(const Cell3DPosition &p) const {
     if (!isInGrid(p))
         return false;
@@ -128,9 +118,10 @@ Lattice::getCellDistance(const Cell3DPosition &p1, const Cell3DPosition &p2) con
 vector<Cell3DPosition> Lattice::getActiveNeighborCells(const Cell3DPosition &pos) const {
     vector<Cell3DPosition> activeNeighborCells;
 
-    for (const Cell3DPosition &p : getNeighborhood(pos)) { // Check if each neighbor cell has an active node on it
-        if (!isFree(p)) {
-            activeNeighborCells.push_back(p);         // Add its position to the result
+    for (const Cell3DPosition &p : getRelativeConnectivity(pos)) { // Check if each neighbor cell has an active node on it
+        Cell3DPosition v = pos + p;
+        if (cellHasBlock(v)) {
+            activeNeighborCells.push_back(v);         // Add its position to the result
         }
     }
 
@@ -146,9 +137,10 @@ Vector3D Lattice::gridToWorldPosition(const Cell3DPosition &pos) const {
 vector<Cell3DPosition> Lattice::getFreeNeighborCells(const Cell3DPosition &pos) const {
     vector<Cell3DPosition> freeNeighborCells;
 
-    for (const Cell3DPosition &p : getNeighborhood(pos)) { // Check if each neighbor cell has an active node on it
-        if (isFree(p)) {
-            freeNeighborCells.push_back(p);         // Add its position to the result
+    for (const Cell3DPosition &p : getRelativeConnectivity(pos)) { // Check if each neighbor cell is free
+        Cell3DPosition v = pos + p;
+        if (isFree(v)) {
+            freeNeighborCells.push_back(v);         // Add its position to the result
         }
     }
 
@@ -170,18 +162,47 @@ vector<Cell3DPosition> Lattice::getNeighborhood(const Cell3DPosition &pos) const
     return neighborhood;
 }
 
+void Lattice::getActiveNeighborCells(const Cell3DPosition &pos, CellNeighborhood &res) const {
+    res.clear();
+    for (const Cell3DPosition &p : getRelativeConnectivity(pos)) {
+        Cell3DPosition v = pos + p;
+        if (cellHasBlock(v)) res.push_back(v);
+    }
+}
+
+void Lattice::getFreeNeighborCells(const Cell3DPosition &pos, CellNeighborhood &res) const {
+    res.clear();
+    for (const Cell3DPosition &p : getRelativeConnectivity(pos)) {
+        Cell3DPosition v = pos + p;
+        if (isFree(v)) res.push_back(v);
+    }
+}
+
+void Lattice::getNeighborhood(const Cell3DPosition &pos, CellNeighborhood &res) const {
+    res.clear();
+    for (const Cell3DPosition &p : getRelativeConnectivity(pos)) {
+        Cell3DPosition v = pos + p;
+        if (isInGrid(v)) res.push_back(v);
+    }
+}
+
 short Lattice::getDirection(const Cell3DPosition &p, const Cell3DPosition &neighbor) const {
-    auto neighborhood = getNeighborhood(p);
-    for (unsigned short i = 0; i < neighborhood.size(); i++) {
-        if (neighbor == neighborhood[i]) return i;
+    // Index of neighbor among the neighbors of p that are in the grid
+    short i = 0;
+    for (const Cell3DPosition &rel : getRelativeConnectivity(p)) {
+        Cell3DPosition v = p + rel;
+        if (!isInGrid(v)) continue;
+        if (v == neighbor) return i;
+        i++;
     }
 
     return -1;
 }
 
 bool Lattice::cellsAreAdjacent(const Cell3DPosition &p1, const Cell3DPosition &p2) const {
-    for (const Cell3DPosition pos : getNeighborhood(p1))
-        if (p2 == pos) return true;
+    const Cell3DPosition d = p2 - p1;
+    for (const Cell3DPosition &rel : getRelativeConnectivity(p1))
+        if (rel == d) return isInGrid(p2);
 
     return false;
 }
@@ -317,7 +338,7 @@ Cell3DPosition HLattice::worldToGridPosition(const Vector3D &pos) const {
     return res;
 }
 
-vector<Cell3DPosition> HLattice::getRelativeConnectivity(const Cell3DPosition &p) const {
+const vector<Cell3DPosition>& HLattice::getRelativeConnectivity(const Cell3DPosition &p) const {
     return IS_EVEN(p[2]) ? nCellsEven : nCellsOdd;
 }
 
@@ -369,7 +390,7 @@ SLattice::SLattice() : Lattice2D() {}
 SLattice::SLattice(const Cell3DPosition &gsz, const Vector3D &gsc) : Lattice2D(gsz,gsc) {}
 SLattice::~SLattice() {}
 
-vector<Cell3DPosition> SLattice::getRelativeConnectivity(const Cell3DPosition &p) const {
+const vector<Cell3DPosition>& SLattice::getRelativeConnectivity(const Cell3DPosition &p) const {
     return nCells;
 }
 
@@ -429,27 +450,15 @@ FCCLattice::FCCLattice() : Lattice3D() {
 }
 
 FCCLattice::FCCLattice(const Cell3DPosition &gsz, const Vector3D &gsc) : Lattice3D(gsz,gsc) {
-    tabLockedCells = new bool[gridSize[0] * gridSize[1] * gridSize[2]]();
-    // FIXME:
-    /*bool *ptr=tabLockedCells;
-    int i=gridSize[0] * gridSize[1] * gridSize[2];
-    while (--i) {
-        *ptr++=false;
-    }*/
-    // OUTPUT << "init Lattice" << endl;
-    // for (int i=0; i<gridSize[0] * gridSize[1] * gridSize[2];i++) { OUTPUT << tabLockedCells[i] << " "; }
-    // OUTPUT << endl;
-
     tabDistances=NULL;
 }
 
 
 FCCLattice::~FCCLattice() {
-    delete [] tabLockedCells;
     delete [] tabDistances;
 }
 
-vector<Cell3DPosition> FCCLattice::getRelativeConnectivity(const Cell3DPosition &p) const {
+const vector<Cell3DPosition>& FCCLattice::getRelativeConnectivity(const Cell3DPosition &p) const {
     return IS_EVEN(p[2]) ? nCellsEven : nCellsOdd;
 }
 
@@ -555,6 +564,17 @@ Cell3DPosition FCCLattice::getCellInDirection(const Cell3DPosition &pRef, int di
     return pRef + getRelativeConnectivity(pRef)[direction];
 }
 
+std::bitset<12> FCCLattice::getNeighborhoodOccupancy(const Cell3DPosition &pos) const {
+    std::bitset<12> occupancy;
+    const vector<Cell3DPosition> &relativeNCells = getRelativeConnectivity(pos);
+
+    for (int d = 0; d < 12; d++) {
+        if (cellHasBlock(pos + relativeNCells[d])) occupancy.set(d);
+    }
+
+    return occupancy;
+}
+
 void FCCLattice::glDraw() const {
 static const float pts[24][3]={{2.928,0,4.996},{0,2.928,4.996},{-2.928,0,4.996},{0,-2.928,4.996},{4.996,2.069,2.069},{2.069,4.996,2.069},{-2.069,4.996,2.069},{-4.996,2.069,2.069},{-4.996,-2.069,2.069},{-2.069,-4.996,2.069},{2.069,-4.996,2.069},{4.996,-2.069,2.069},{4.996,2.069,-2.069},{2.069,4.996,-2.069},{-2.069,4.996,-2.069},{-4.996,2.069,-2.069},{-4.996,-2.069,-2.069},{-2.069,-4.996,-2.069},{2.069,-4.996,-2.069},{4.996,-2.069,-2.069},{2.928,0,-4.996},{0,2.928,-4.996},{-2.928,0,-4.996},{0,-2.928,-4.996}};
 static const uint8_t quads[72]={0,1,2,3,0,4,5,1,1,6,7,2,2,8,9,3,3,10,11,0,4,12,13,5,5,13,14,6,6,14,15,7,7,15,16,8,8,16,17,9,9,17,18,10,10,18,19,11,11,19,12,4,12,20,21,13,14,21,22,15,16,22,23,17,18,23,20,19,23,22,21,20};
@@ -567,7 +587,6 @@ static const GLfloat white[]={0.8f,0.8f,0.8f,1.0f},
         Cell3DPosition gp;
         Vector3D v;
         unsigned short *ptrDistance = tabDistances;
-        bool *ptr = tabLockedCells;
 
         glMaterialfv(GL_FRONT,GL_AMBIENT,gray);
         glMaterialfv(GL_FRONT,GL_DIFFUSE,white);
@@ -577,9 +596,9 @@ static const GLfloat white[]={0.8f,0.8f,0.8f,1.0f},
         for (iz=0; iz<gridSize[2]; iz++) {
             for (iy=0; iy<gridSize[1]; iy++) {
                 for (ix=0; ix<gridSize[0]; ix++) {
-                    if (*ptr) {
+                    gp.set(ix,iy,iz);
+                    if (lockedCells.get(gp)) {
                         glPushMatrix();
-                        gp.set(ix,iy,iz);
                         v = gridToWorldPosition(gp);
                         glTranslatef(v[0],v[1],v[2]);
                         glutSolidSphere(0.065*gridScale[0],6,6);
@@ -596,7 +615,6 @@ static const GLfloat white[]={0.8f,0.8f,0.8f,1.0f},
                         glPopMatrix();
 
                     }
-                    ptr++;
                     ptrDistance++;
                 }
             }
@@ -642,20 +660,22 @@ bool FCCLattice::lockCell(const Cell3DPosition &pos) {
     if (!isInGrid(pos)) return true;
 
     int ind = getIndex(pos);
-    OUTPUT << "ind=" << ind << " / pos=" << pos << " / state=" << tabLockedCells[ind] << " / bb=" << (grid[ind]==NULL?0:1) << endl;
-    if (tabLockedCells[ind] || grid[ind]!=NULL) {
+    const Cell3DPosition sp = getStoragePosition(pos);
+    BuildingBlock *bb = getBlock(pos);
+    OUTPUT << "ind=" << ind << " / pos=" << pos << " / state=" << lockedCells.get(sp) << " / bb=" << (bb==NULL?0:1) << endl;
+    if (lockedCells.get(sp) || bb!=NULL) {
         return false;
     }
-    tabLockedCells[ind] = true;
+    lockedCells.set(sp, true);
     return true;
 }
 
 bool FCCLattice::unlockCell(const Cell3DPosition &pos) {
     if (!isInGrid(pos)) return true;
 
-    int ind = getIndex(pos);
-    bool prev = tabLockedCells[ind];
-    tabLockedCells[ind] = false;
+    const Cell3DPosition sp = getStoragePosition(pos);
+    bool prev = lockedCells.get(sp);
+    lockedCells.set(sp, false);
     return prev;
 }
 
@@ -782,8 +802,8 @@ bool FCCLattice::isPositionBlocked(const Cell3DPosition &pos,
 }
 
 /********************* SkewFCCLattice *********************/
-SkewFCCLattice::SkewFCCLattice() : FCCLattice() {}
-SkewFCCLattice::SkewFCCLattice(const Cell3DPosition &gsz, const Vector3D &gsc) : FCCLattice(gsz,gsc) {}
+SkewFCCLattice::SkewFCCLattice() : FCCLattice() { skewedStorage = true; }
+SkewFCCLattice::SkewFCCLattice(const Cell3DPosition &gsz, const Vector3D &gsc) : FCCLattice(gsz,gsc) { skewedStorage = true; }
 SkewFCCLattice::~SkewFCCLattice() {}
 
 unsigned int SkewFCCLattice::getIndex(const Cell3DPosition &p) const {
@@ -806,7 +826,7 @@ Cell3DPosition SkewFCCLattice::getGridUpperBounds(int z) const {
 }
 
 
-vector<Cell3DPosition> SkewFCCLattice::getRelativeConnectivity(const Cell3DPosition &p) const {
+const vector<Cell3DPosition>& SkewFCCLattice::getRelativeConnectivity(const Cell3DPosition &p) const {
     return nCells;
 }
 
@@ -857,12 +877,11 @@ SkewFCCLattice::getCellDistance(const Cell3DPosition &p1, const Cell3DPosition &
 }
 
 bool SkewFCCLattice::cellIsBlocked(const Cell3DPosition& pos) const {
-    Cell3DPosition p1,p2;
+    const std::bitset<12> occupancy = getNeighborhoodOccupancy(pos);
     for (int i = 0; i < 6; i++) {
-        p1 = getCellInDirection(pos, i);
-        p2 = getCellInDirection(pos, getOppositeDirection(i));
-
-        if (cellHasBlock(p1) and cellHasBlock(p2)) {
+        if (occupancy[i] and occupancy[getOppositeDirection(i)]) {
+            Cell3DPosition p1 = getCellInDirection(pos, i);
+            Cell3DPosition p2 = getCellInDirection(pos, getOppositeDirection(i));
             cerr << "cells " << p1 << " and " << p2 << " are blocking " << pos << endl;
             return true;
         }
@@ -886,7 +905,7 @@ SCLattice::SCLattice() : Lattice3D() {}
 SCLattice::SCLattice(const Cell3DPosition &gsz, const Vector3D &gsc) : Lattice3D(gsz,gsc) {}
 SCLattice::~SCLattice() {}
 
-vector<Cell3DPosition> SCLattice::getRelativeConnectivity(const Cell3DPosition &p) const {
+const vector<Cell3DPosition>& SCLattice::getRelativeConnectivity(const Cell3DPosition &p) const {
     return nCells;
 }
 
@@ -951,8 +970,8 @@ BCLattice::BCLattice() : Lattice3D() {}
 BCLattice::BCLattice(const Cell3DPosition &gsz, const Vector3D &gsc) : Lattice3D(gsz,gsc) {}
 BCLattice::~BCLattice() {}
 
-vector<Cell3DPosition> BCLattice::getRelativeConnectivity(const Cell3DPosition &p) const {
-    return vector<Cell3DPosition>();
+const vector<Cell3DPosition>& BCLattice::getRelativeConnectivity(const Cell3DPosition &p) const {
+    return nCells;
 }
 
 Vector3D BCLattice::gridToUnscaledWorldPosition(const Cell3DPosition &pos) const {
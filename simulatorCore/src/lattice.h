@@ -11,15 +11,46 @@
 
 #include <string>
 #include <vector>
+#include <bitset>
 
 #include "utils.h"
 #include "exceptions.h"
 #include "buildingBlock.h"
 #include "vector3D.h"
 #include "cell3DPosition.h"
+#include "latticeStorage.h"
 
 namespace BaseSimulator {
 
+/*! @brief Fixed-capacity list of cells, stored inline, used to return the neighborhood of a
+ *  cell without any heap allocation. It can be iterated like a vector.
+ */
+class CellNeighborhood {
+public:
+    static const int capacity = 12; //!< Number of neighbors of a cell in the largest neighborhood (FCC)
+private:
+    Cell3DPosition cells[capacity];
+    unsigned char nbCells = 0;
+public:
+    inline void push_back(const Cell3DPosition &p) { assert(nbCells < capacity); cells[nbCells++] = p; }
+    inline void clear() { nbCells = 0; }
+
+    inline Cell3DPosition* begin() { return cells; }
+    inline Cell3DPosition* end() { return cells + nbCells; }
+    inline const Cell3DPosition* begin() const { return cells; }
+    inline const Cell3DPosition* end() const { return cells + nbCells; }
+    inline size_t size() const { return nbCells; }
+    inline bool empty() const { return nbCells == 0; }
+    inline const Cell3DPosition& operator[](size_t i) const { return cells[i]; }
+
+    //!< @brief Returns true if p is one of the cells of the list
+    bool contains(const Cell3DPosition &p) const {
+        for (unsigned char i = 0; i < nbCells; i++)
+            if (cells[i] == p) return true;
+        return false;
+    }
+};
+
 /*! @brief Abstract class Lattice
  *
  */
@@ -52,7 +83,9 @@ public:
 
     Cell3DPosition gridSize; //!< The size of the 3D grid
     Vector3D gridScale; //!< The real size of a cell in the simulated world (Dimensions of a block)
-    BuildingBlock **grid; //!< The grid as a 1-Dimensional array of BuildingBlock pointers
+    LatticeStorage *grid; //!< The blocks on the cells of the grid
+    bool skewedStorage = false; //!< Cells at height z are stored z/2 cells further along x and y (SkewFCCLattice)
+    static RunLocal<LatticeStorageType> storageType; //!< Storage backend of the lattices created from now on
     unsigned int nbModules = 0; //!< The number of modules currently part of the lattice
 
     /**
@@ -80,7 +113,7 @@ public:
      */
     Lattice(const Cell3DPosition &gsz, const Vector3D &gsc);
     /**
-     * @brief Abstract Lattice destructor. Responsible for deleting the grid array.
+     * @brief Abstract Lattice destructor. Responsible for deleting the grid storage.
      */
     virtual ~Lattice();
 
@@ -109,6 +142,15 @@ public:
      * @return The index of the cell in the lattice's 1D array of cells
      */
     virtual unsigned int getIndex(const Cell3DPosition &p) const;
+    /**
+     * @brief Returns the coordinates of grid position p in the storage of the grid, where each
+     *  coordinate ranges from 0 to gridSize - 1
+     * @param p The position of a cell in the grid
+     * @return The position of the cell in the storage of the grid
+     */
+    inline Cell3DPosition getStoragePosition(const Cell3DPosition &p) const {
+        return skewedStorage ? Cell3DPosition(p[0] + p[2] / 2, p[1] + p[2] / 2, p[2]) : p;
+    }
     /**
      * @brief Indicates if cell at position p has a block on it
      * @param p The position of the cell to test
@@ -126,7 +168,9 @@ public:
      * @param p The position of the block to get
      * @return A pointer to the block on cell p or NULL if p is not in grid or empty
      */
-    BuildingBlock *getBlock(const Cell3DPosition &p) const;
+    inline BuildingBlock *getBlock(const Cell3DPosition &p) const {
+        return isInGrid(p) ? grid->get(getStoragePosition(p)) : NULL;
+    }
     /**
      * @brief Returns the location of all alive neighbors for cell pos
      * @param pos The cell to consider
@@ -145,6 +189,14 @@ public:
      * @return A vector containing the position of all cells (empty and full) around pos
      */
     std::vector<Cell3DPosition> getNeighborhood(const Cell3DPosition &pos) const;
+    /**
+     * @brief Allocation-free versions of getActiveNeighborCells, getFreeNeighborCells and getNeighborhood
+     * @param pos The cell to consider
+     * @param res Set to the requested neighbor cells of pos, in the same order as the vector versions
+     */
+    void getActiveNeighborCells(const Cell3DPosition &pos, CellNeighborhood &res) const;
+    void getFreeNeighborCells(const Cell3DPosition &pos, CellNeighborhood &res) const;
+    void getNeighborhood(const Cell3DPosition &pos, CellNeighborhood &res) const;
     /**
      * @brief Indicates whether cells in argument are adjacent to each other
      * @param p1 the first cell
@@ -189,9 +241,9 @@ public:
     /**
      * @brief Returns the relative position of all cells around cell p
      * @param p The position of the cell to consider
-     * @return A vector containing all relative position of neighbor cells
+     * @return A reference to the precomputed relative positions of neighbor cells, indexed by direction
      */
-    virtual std::vector<Cell3DPosition> getRelativeConnectivity(const Cell3DPosition &p) const = 0;
+    virtual const std::vector<Cell3DPosition>& getRelativeConnectivity(const Cell3DPosition &p) const = 0;
     /**
      * @brief Overriden getter to get the maximum number of neighbor a lattice cell can have
      * @return the maximum number of neighbor for the callee lattice
@@ -313,7 +365,7 @@ public:
     /**
      * @copydoc Lattice::getRelativeConnectivity
      */
-    virtual std::vector<Cell3DPosition> getRelativeConnectivity(const Cell3DPosition &p) const override = 0;
+    virtual const std::vector<Cell3DPosition>& getRelativeConnectivity(const Cell3DPosition &p) const override = 0;
     /**
      * @copydoc Lattice::getMaxNumNeighbors
      */
@@ -365,7 +417,7 @@ public:
     /**
      * @copydoc Lattice::getRelativeConnectivity
      */
-    virtual std::vector<Cell3DPosition> getRelativeConnectivity(const Cell3DPosition &p) const override = 0;
+    virtual const std::vector<Cell3DPosition>& getRelativeConnectivity(const Cell3DPosition &p) const override = 0;
     /**
      * @copydoc Lattice::getMaxNumNeighbors
      */
@@ -429,7 +481,7 @@ public:
     /**
      * @copydoc Lattice::getRelativeConnectivity
      */
-    virtual std::vector<Cell3DPosition> getRelativeConnectivity(const Cell3DPosition &p) const override;
+    virtual const std::vector<Cell3DPosition>& getRelativeConnectivity(const Cell3DPosition &p) const override;
     /**
      * @copydoc Lattice::getMaxNumNeighbors
      */
@@ -508,7 +560,7 @@ public:
     /**
      * @copydoc Lattice::getRelativeConnectivity
      */
-    virtual std::vector<Cell3DPosition> getRelativeConnectivity(const Cell3DPosition &p) const override;
+    virtual const std::vector<Cell3DPosition>& getRelativeConnectivity(const Cell3DPosition &p) const override;
     /**
      * @copydoc Lattice::getMaxNumNeighbors
      */
@@ -597,7 +649,7 @@ class FCCLattice : public Lattice3D {
                                 Cell3DPosition(0,-1,0), Cell3DPosition(0,1,0) };
 
     static const string directionName[];
-    bool *tabLockedCells;
+    SparseBrickGrid<bool> lockedCells; //!< Cells locked by lockCell, by storage position
     unsigned short *tabDistances;
 
     // NEIGHBORDHOOD RESTRICTIONS
@@ -665,7 +717,7 @@ public:
     /**
      * @copydoc Lattice::getRelativeConnectivity
      */
-    virtual std::vector<Cell3DPosition> getRelativeConnectivity(const Cell3DPosition &p) const override;
+    virtual const std::vector<Cell3DPosition>& getRelativeConnectivity(const Cell3DPosition &p) const override;
     /**
      * @copydoc Lattice::getMaxNumNeighbors
      */
@@ -676,6 +728,12 @@ public:
      */
     virtual Cell3DPosition getCellInDirection(const Cell3DPosition &pRef,
                                               int direction) const override;
+    /**
+     * @brief Returns the occupancy of the 12 neighbor cells of pos, without any allocation
+     * @param pos The cell to consider
+     * @return a mask whose bit d is set if the cell in direction d of pos holds a block
+     */
+    std::bitset<12> getNeighborhoodOccupancy(const Cell3DPosition &pos) const;
 
     // NEIGHBORHOOD RESTRICTIONS
     bool isPositionBlocked(const Cell3DPosition &pos) const;
@@ -761,7 +819,7 @@ public:
     /**
      * @copydoc Lattice::getRelativeConnectivity
      */
-    virtual std::vector<Cell3DPosition> getRelativeConnectivity(const Cell3DPosition &p) const override;
+    virtual const std::vector<Cell3DPosition>& getRelativeConnectivity(const Cell3DPosition &p) const override;
 
     /**
      * @copydoc Lattice::getCellInDirection
@@ -835,7 +893,7 @@ public:
     /**
      * @copydoc Lattice::getRelativeConnectivity
      */
-    virtual std::vector<Cell3DPosition> getRelativeConnectivity(const Cell3DPosition &p) const override;
+    virtual const std::vector<Cell3DPosition>& getRelativeConnectivity(const Cell3DPosition &p) const override;
     /**
      * @copydoc Lattice::getMaxNumNeighbors
      */
@@ -867,6 +925,7 @@ public:
     virtual string getDirectionString(short d) const override;
 
     list<BuildingBlock*> connected; //!< contains all cells with a block on it
+    const std::vector<Cell3DPosition> nCells; //!< Mobile robots have no fixed neighborhood
 
     /**
      * @brief BCLattice constructor.
@@ -898,7 +957,7 @@ public:
     /**
      * @copydoc Lattice::getRelativeConnectivity
      */
-    virtual std::vector<Cell3DPosition> getRelativeConnectivity(const Cell3DPosition &p) const override;
+    virtual const std::vector<Cell3DPosition>& getRelativeConnectivity(const Cell3DPosition &p) const override;
     /**
      * @copydoc Lattice::getMaxNumNeighbors
      */
@@ -0,0 +1,48 @@
+/*! @file latticeStorage.cpp
+ * @brief Storage of the blocks occupying the cells of a lattice.
+ * @date 17/10/2026
+ */
+
+#include "latticeStorage.h"
+
+using namespace std;
+
+namespace BaseSimulator {
+
+LatticeStorage* LatticeStorage::create(LatticeStorageType type, const Cell3DPosition &sz) {
+    switch (type) {
+        case LatticeStorageType::Dense: return new DenseLatticeStorage(sz);
+        case LatticeStorageType::Sparse: return new SparseLatticeStorage(sz);
+    }
+
+    return NULL;
+}
+
+bool LatticeStorage::parseType(const string &name, LatticeStorageType &type) {
+    if (name == "dense") type = LatticeStorageType::Dense;
+    else if (name == "sparse") type = LatticeStorageType::Sparse;
+    else return false;
+
+    return true;
+}
+
+//===========================================================================================================
+//
+//          DenseLatticeStorage  (class)
+//
+//===========================================================================================================
+
+DenseLatticeStorage::DenseLatticeStorage(const Cell3DPosition &sz) : LatticeStorage(sz) {
+    // Initializes grid to NULL
+    cells = new BuildingBlock*[(size_t)size[0] * size[1] * size[2]]();
+}
+
+DenseLatticeStorage::~DenseLatticeStorage() {
+    delete [] cells;
+}
+
+size_t DenseLatticeStorage::getMemoryUsage() const {
+    return (size_t)size[0] * size[1] * size[2] * sizeof(BuildingBlock*);
+}
+
+} // BaseSimulator namespace
@@ -0,0 +1,265 @@
+/*! @file latticeStorage.h
+ * @brief Storage of the blocks occupying the cells of a lattice.
+ *  Cells are addressed by their storage position, in [0,gridSize) along each axis
+ *  (see Lattice::getStoragePosition). Both backends offer O(1) access to a cell.
+ * @date 17/10/2026
+ */
+
+#ifndef LATTICESTORAGE_H_
+#define LATTICESTORAGE_H_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "cell3DPosition.h"
+
+namespace BaseSimulator {
+
+class BuildingBlock;
+
+//!< Available lattice storage backends, selectable for each world in the configuration file (latticeStorage attribute)
+enum class LatticeStorageType {
+    Dense,                      //!< One pointer per cell of the grid, allocated upfront
+    Sparse                      //!< Bricks of cells allocated on demand, memory proportional to the occupied volume
+};
+
+/**
+ * @brief Cells of a grid grouped into bricks of 8x8x8 cells, for large and mostly empty grids.
+ *  Only bricks holding at least one non empty cell (a value other than T()) are allocated, and
+ *  are found through an open addressing hash table (linear probing) keyed by their brick
+ *  coordinates. Bricks are released as soon as they become empty.
+ *  Coordinates must be in [0,2^21) along each axis.
+ */
+template <typename T>
+class SparseBrickGrid {
+    static const int brickBits = 3;                     //!< log2 of the brick edge
+    static const int brickEdge = 1 << brickBits;
+    static const int brickMask = brickEdge - 1;
+    static const uint64_t emptyKey = UINT64_MAX;
+    static const size_t minSlots = 64;
+
+    struct Brick {
+        T cells[brickEdge * brickEdge * brickEdge] = {};
+        unsigned int nbCells = 0;                       //!< Number of non empty cells
+    };
+
+    struct Slot {
+        uint64_t key = emptyKey;
+        Brick *brick = NULL;
+    };
+
+    std::vector<Slot> slots;                            //!< Hash table, its size is a power of two
+    size_t nbBricks = 0;
+
+    inline static uint64_t getKey(const Cell3DPosition &c) {
+        return (uint64_t)(c[0] >> brickBits)
+            | ((uint64_t)(c[1] >> brickBits) << 21)
+            | ((uint64_t)(c[2] >> brickBits) << 42);
+    }
+
+    inline static unsigned int getCellIndex(const Cell3DPosition &c) {
+        return (c[0] & brickMask)
+            | ((c[1] & brickMask) << brickBits)
+            | ((c[2] & brickMask) << (2 * brickBits));
+    }
+
+    inline size_t getHomeSlot(uint64_t key) const {
+        // Fibonacci hashing, keeping the highest bits
+        return (key * 0x9E3779B97F4A7C15ULL) >> (64 - __builtin_ctzll(slots.size()));
+    }
+
+    //!< @brief Returns the slot holding key, or the empty slot where it would be inserted
+    size_t findSlot(uint64_t key) const;
+    //!< @brief Empties slot i and moves back the entries of its cluster (backward shift deletion)
+    void eraseSlot(size_t i);
+    //!< @brief Reallocates the table with nbSlots slots and reinserts all the bricks
+    void rehash(size_t nbSlots);
+
+public:
+    SparseBrickGrid() : slots(minSlots) {};
+    ~SparseBrickGrid() { for (Slot &s : slots) delete s.brick; };
+    SparseBrickGrid(const SparseBrickGrid&) = delete;
+    SparseBrickGrid& operator=(const SparseBrickGrid&) = delete;
+
+    //!< @brief Returns the value of the cell at c, T() if it is empty
+    T get(const Cell3DPosition &c) const;
+    //!< @brief Sets the value of the cell at c, T() to empty it
+    void set(const Cell3DPosition &c, T v);
+    //!< @brief Returns the number of bytes currently allocated
+    size_t getMemoryUsage() const { return slots.size() * sizeof(Slot) + nbBricks * sizeof(Brick); }
+};
+
+/**
+ * @brief Abstract storage of the block pointers of a lattice.
+ *  The dense backend is accessed without virtual call, other backends through getCell and setCell.
+ * @attention Writes must not be concurrent with any other access. Concurrent reads are safe.
+ */
+class LatticeStorage {
+protected:
+    Cell3DPosition size; //!< Number of cells along each axis
+    BuildingBlock **cells = NULL; //!< Cells of the dense backend, NULL for other backends
+
+    inline size_t getDenseIndex(const Cell3DPosition &c) const {
+        return c[0] + (c[1] + (size_t)c[2] * size[1]) * size[0];
+    }
+
+    //!< @brief Returns the block on the cell at storage position c, for backends other than the dense one
+    virtual BuildingBlock* getCell(const Cell3DPosition &c) const = 0;
+    //!< @brief Sets the block on the cell at storage position c, for backends other than the dense one
+    virtual void setCell(const Cell3DPosition &c, BuildingBlock *bb) = 0;
+public:
+    //!< Backend used when the configuration file does not specify any
+    static constexpr LatticeStorageType defaultType = LatticeStorageType::Dense;
+
+    LatticeStorage(const Cell3DPosition &sz) : size(sz) {};
+    virtual ~LatticeStorage() {};
+
+    //!< @brief Returns the block on the cell at storage position c, or NULL if it is empty
+    inline BuildingBlock* get(const Cell3DPosition &c) const {
+        return cells ? cells[getDenseIndex(c)] : getCell(c);
+    }
+    //!< @brief Sets the block on the cell at storage position c, NULL to empty it
+    inline void set(const Cell3DPosition &c, BuildingBlock *bb) {
+        if (cells) cells[getDenseIndex(c)] = bb;
+        else setCell(c, bb);
+    }
+    //!< @brief Returns the number of bytes currently allocated for the cells
+    virtual size_t getMemoryUsage() const = 0;
+
+    //!< @brief Returns the name of the backend, as accepted in the configuration file
+    virtual const std::string getName() const = 0;
+
+    /**
+     * @brief Instantiates a new storage of the requested type, with all cells empty
+     * @param type backend to instantiate
+     * @param sz number of cells along each axis
+     * @return pointer to the new storage, to be deleted by the caller
+     */
+    static LatticeStorage* create(LatticeStorageType type, const Cell3DPosition &sz);
+
+    /**
+     * @brief Converts a backend name into its LatticeStorageType
+     * @param name one of "dense", "sparse"
+     * @param type set to the corresponding type if name is valid
+     * @return true if name is valid, false otherwise
+     */
+    static bool parseType(const std::string &name, LatticeStorageType &type);
+};
+
+/**
+ * @brief Original storage: a one-dimensional array of gridSize[0]*gridSize[1]*gridSize[2] pointers
+ */
+class DenseLatticeStorage : public LatticeStorage {
+protected:
+    BuildingBlock* getCell(const Cell3DPosition &c) const override { return cells[getDenseIndex(c)]; }
+    void setCell(const Cell3DPosition &c, BuildingBlock *bb) override { cells[getDenseIndex(c)] = bb; }
+public:
+    DenseLatticeStorage(const Cell3DPosition &sz);
+    ~DenseLatticeStorage();
+
+    size_t getMemoryUsage() const override;
+    const std::string getName() const override { return "dense"; }
+};
+
+/**
+ * @brief Sparse storage for large and mostly empty grids, see SparseBrickGrid
+ */
+class SparseLatticeStorage : public LatticeStorage {
+    SparseBrickGrid<BuildingBlock*> bricks;
+protected:
+    BuildingBlock* getCell(const Cell3DPosition &c) const override { return bricks.get(c); }
+    void setCell(const Cell3DPosition &c, BuildingBlock *bb) override { bricks.set(c, bb); }
+public:
+    SparseLatticeStorage(const Cell3DPosition &sz) : LatticeStorage(sz) {};
+
+    size_t getMemoryUsage() const override { return bricks.getMemoryUsage(); }
+    const std::string getName() const override { return "sparse"; }
+};
+
+//===========================================================================================================
+//
+//          SparseBrickGrid  (class)
+//
+//===========================================================================================================
+
+template <typename T>
+size_t SparseBrickGrid<T>::findSlot(uint64_t key) const {
+    const size_t mask = slots.size() - 1;
+    size_t i = getHomeSlot(key);
+
+    while (slots[i].key != key && slots[i].key != emptyKey)
+        i = (i + 1) & mask;
+
+    return i;
+}
+
+template <typename T>
+T SparseBrickGrid<T>::get(const Cell3DPosition &c) const {
+    const Slot &s = slots[findSlot(getKey(c))];
+    return s.brick ? s.brick->cells[getCellIndex(c)] : T();
+}
+
+template <typename T>
+void SparseBrickGrid<T>::set(const Cell3DPosition &c, T v) {
+    uint64_t key = getKey(c);
+    size_t i = findSlot(key);
+    Brick *brick = slots[i].brick;
+
+    if (!brick) {
+        if (v == T()) return;
+        // Keeps the load factor under 1/2
+        if (2 * (nbBricks + 1) > slots.size()) {
+            rehash(2 * slots.size());
+            i = findSlot(key);
+        }
+        brick = new Brick();
+        slots[i].key = key;
+        slots[i].brick = brick;
+        nbBricks++;
+    }
+
+    T &cell = brick->cells[getCellIndex(c)];
+    if (cell == T() && v != T()) brick->nbCells++;
+    else if (cell != T() && v == T()) brick->nbCells--;
+    cell = v;
+
+    if (brick->nbCells == 0) {
+        delete brick;
+        eraseSlot(i);
+        nbBricks--;
+    }
+}
+
+template <typename T>
+void SparseBrickGrid<T>::eraseSlot(size_t i) {
+    const size_t mask = slots.size() - 1;
+    size_t j = i;
+
+    for (;;) {
+        j = (j + 1) & mask;
+        if (slots[j].key == emptyKey) break;
+        // Entry j may fill the hole at i only if its home slot is not cyclically in (i, j]
+        size_t home = getHomeSlot(slots[j].key);
+        if ((j > i && (home <= i || home > j)) || (j < i && (home <= i && home > j))) {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+
+    slots[i] = Slot();
+}
+
+template <typename T>
+void SparseBrickGrid<T>::rehash(size_t nbSlots) {
+    std::vector<Slot> old(nbSlots);
+    old.swap(slots);
+
+    for (const Slot &s : old) {
+        if (s.brick) slots[findSlot(s.key)] = s;
+    }
+}
+
+} // BaseSimulator namespace
+
+#endif /* LATTICESTORAGE_H_ */
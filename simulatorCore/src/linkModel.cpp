@@ -0,0 +1,127 @@
+/*! @file linkModel.cpp
+ * @brief Per interface models of the links between modules.
+ * @date 17/10/2026
+ */
+
+#include "linkModel.h"
+
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "snapshot.h"
+
+using namespace std;
+
+namespace BaseSimulator {
+
+RunLocal<ruint> LinkModel::seed { 0u };
+RunLocal<vector<LinkModel*>> LinkModel::models;
+RunLocal<const LinkModel*> LinkModel::defaultModel;
+RunLocal<map<pair<bID,int>, const LinkModel*>> LinkModel::assignments;
+
+bool LinkModel::isDown(Time date) const {
+    if (outages.empty()) return false;
+
+    // Last outage starting at or before date
+    auto it = upper_bound(outages.begin(), outages.end(), date,
+                          [](Time d, const Outage &o) { return d < o.start; });
+    return it != outages.begin() and date < prev(it)->end;
+}
+
+bool LinkModel::parseOutages(const string &list) {
+    vector<Outage> parsed;
+    stringstream ss(list);
+    string item;
+
+    while (getline(ss, item, ';')) {
+        if (item.empty()) continue;
+        const size_t dash = item.find('-');
+        if (dash == string::npos) return false;
+
+        Outage o;
+        try {
+            o.start = stoull(item.substr(0, dash));
+            const string end = item.substr(dash + 1);
+            o.end = end.empty() ? numeric_limits<Time>::max() : stoull(end);
+        } catch (const std::logic_error&) {
+            return false;
+        }
+        if (o.end <= o.start) return false;
+        parsed.push_back(o);
+    }
+
+    sort(parsed.begin(), parsed.end(),
+         [](const Outage &a, const Outage &b) { return a.start < b.start; });
+    for (size_t i = 1; i < parsed.size(); i++)
+        if (parsed[i].start < parsed[i - 1].end) return false;
+
+    outages.swap(parsed);
+    return true;
+}
+
+bool LinkModel::parseLossType(const string &name, LinkLossType &type) {
+    if (name == "none") type = LinkLossType::None;
+    else if (name == "gilbertElliott") type = LinkLossType::GilbertElliott;
+    else return false;
+    return true;
+}
+
+void LinkModel::add(LinkModel *model) {
+    models.get().push_back(model);
+}
+
+const LinkModel* LinkModel::find(const string &name) {
+    for (const LinkModel *m : models.get())
+        if (m->name == name) return m;
+    return NULL;
+}
+
+void LinkModel::assign(const LinkModel *model, bID blockId, int interface) {
+    if (blockId == 0) defaultModel = model;
+    else assignments.get()[make_pair(blockId, interface)] = model;
+}
+
+const LinkModel* LinkModel::get(bID blockId, int interface) {
+    const map<pair<bID,int>, const LinkModel*> &modelOf = assignments;
+    if (modelOf.empty()) return defaultModel;
+
+    auto it = modelOf.find(make_pair(blockId, interface));
+    if (it == modelOf.end()) it = modelOf.find(make_pair(blockId, -1));
+    return it != modelOf.end() ? it->second : defaultModel.get();
+}
+
+bool LinkState::isLost(Time date) {
+    if (model->isDown(date)) return true;
+
+    if (model->lossType == LinkLossType::GilbertElliott) {
+        uniform_real_distribution<double> uniform(0.0, 1.0);
+        if (uniform(generator) < (bad ? model->pBadToGood : model->pGoodToBad)) bad = not bad;
+        return uniform(generator) < (bad ? model->lossBad : model->lossGood);
+    }
+
+    return false;
+}
+
+Time LinkState::getDeliveryDate(Time completionDate) {
+    Time date = completionDate + model->latency;
+    if (model->latencyStdDev > 0) {
+        normal_distribution<double> normal((double)model->latency, model->latencyStdDev);
+        date = completionDate + (Time)max(0.0, round(normal(generator)));
+    }
+
+    if (date < lastDeliveryDate) date = lastDeliveryDate;
+    lastDeliveryDate = date;
+    return date;
+}
+
+void LinkState::save(SnapshotWriter &w) const {
+    w.write(generator, bad, lastDeliveryDate);
+}
+
+void LinkState::restore(SnapshotReader &r) {
+    r.read(generator, bad, lastDeliveryDate);
+}
+
+} // BaseSimulator namespace
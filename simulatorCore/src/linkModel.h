@@ -0,0 +1,154 @@
+/*! @file linkModel.h
+ * @brief Per interface models of the links between modules: data rate, latency, loss and
+ *  scheduled outages, declared in the <links> element of the configuration file.
+ * @date 17/10/2026
+ */
+
+#ifndef LINKMODEL_H_
+#define LINKMODEL_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+
+#include "tDefs.h"
+#include "runContext.h"
+#include "random.h"
+
+namespace BaseSimulator {
+
+class SnapshotWriter;
+class SnapshotReader;
+
+enum class LinkLossType {
+    None,                       //!< Messages are only lost during outages
+    GilbertElliott              //!< Two states Markov chain, with a loss probability per state
+};
+
+/**
+ * @brief Parameters of a link model, shared by all the interfaces using it.
+ *  The data rate and the latency are either constant, or drawn from a Gaussian distribution
+ *  for each message when their standard deviation is not null.
+ *
+ *  Models apply to the messages sent by an interface, hence a link between two modules can
+ *  behave differently in each direction.
+ *
+ *  Configuration file:
+ *  @code
+ *  <links seed="42">
+ *    <linkModel name="lossy" dataRate="1000000" latency="100" latencyStdDev="20"
+ *               loss="gilbertElliott" pGoodToBad="0.01" pBadToGood="0.3" lossGood="0" lossBad="0.8"/>
+ *    <linkModel name="faulty" outages="200000-300000;500000-"/>
+ *    <link model="lossy"/>                               <!-- all the interfaces -->
+ *    <link model="faulty" blockId="66"/>                 <!-- all the interfaces of module 66 -->
+ *    <link model="faulty" blockId="93" interface="6"/>   <!-- interface 6 of module 93 -->
+ *  </links>
+ *  @endcode
+ */
+class LinkModel {
+public:
+    //!< Link down from start (included) to end (excluded), in us
+    struct Outage {
+        Time start;
+        Time end;
+    };
+
+    std::string name;
+    double dataRate = 0;        //!< bit/s, 0 to keep the data rate of the interface
+    double dataRateStdDev = 0;  //!< bit/s
+    Time latency = 0;           //!< Delay between the end of a transmission and the delivery, us
+    double latencyStdDev = 0;   //!< us
+    LinkLossType lossType = LinkLossType::None;
+    double pGoodToBad = 0;      //!< Probability to enter the bad state, per message
+    double pBadToGood = 1;      //!< Probability to leave the bad state, per message
+    double lossGood = 0;        //!< Loss probability in the good state
+    double lossBad = 1;         //!< Loss probability in the bad state
+    std::vector<Outage> outages; //!< Sorted by start date, disjoint
+
+    /**
+     * @brief Returns true if the delivery date of any message only depends on its end of
+     *  transmission date, so that no per message work is needed.
+     */
+    bool isConstant() const {
+        return latencyStdDev == 0 and lossType == LinkLossType::None and outages.empty();
+    }
+
+    //!< @brief Returns true if the link is down at date, during one of its outages
+    bool isDown(Time date) const;
+
+    /**
+     * @brief Parses a list of outages, "start-end;start-end", in us. A missing end means that
+     *  the link never recovers.
+     * @return false if the list is ill-formatted, or if outages overlap
+     */
+    bool parseOutages(const std::string &list);
+
+    static bool parseLossType(const std::string &name, LinkLossType &type);
+
+    //!< @brief Takes ownership of model, which can then be assigned to interfaces
+    static void add(LinkModel *model);
+    //!< @brief Returns the model named name, or NULL if there is none
+    static const LinkModel* find(const std::string &name);
+
+    /**
+     * @brief Assigns a model to interfaces
+     * @param blockId module, or 0 for all the modules
+     * @param interface interface of the module, or -1 for all the interfaces
+     */
+    static void assign(const LinkModel *model, bID blockId = 0, int interface = -1);
+
+    /**
+     * @brief Returns the model of an interface: the one assigned to the interface, else to its
+     *  module, else to all the modules, or NULL if no model applies
+     */
+    static const LinkModel* get(bID blockId, int interface);
+
+    //!< @brief Seed of the random draws of the links, combined with the ids of the interfaces
+    static void setSeed(ruint s) { seed = s; }
+    static ruint getSeed() { return seed; }
+    //!< @brief Returns the models of the configuration, in their order of declaration
+    static const std::vector<LinkModel*>& getModels() { return models.get(); }
+private:
+    static RunLocal<ruint> seed;
+    static RunLocal<std::vector<LinkModel*>> models;
+    static RunLocal<const LinkModel*> defaultModel;
+    static RunLocal<std::map<std::pair<bID,int>, const LinkModel*>> assignments;
+};
+
+/**
+ * @brief State of the link model of an interface.
+ *  Only created for interfaces whose model is not constant, see LinkModel::isConstant.
+ */
+class LinkState {
+    const LinkModel *model;
+    uintRNG generator;
+    bool bad = false;           //!< Gilbert-Elliott state
+    Time lastDeliveryDate = 0;
+public:
+    LinkState(const LinkModel *m, ruint seed) : model(m), generator(seed) {};
+
+    const LinkModel* getModel() const { return model; }
+
+    /**
+     * @brief Returns true if a message whose transmission starts at date is lost, because of
+     *  an outage or of the loss model
+     */
+    bool isLost(Time date);
+
+    /**
+     * @brief Returns the delivery date of a message transmitted at completionDate.
+     *  Messages are delivered in the order of their transmission, whatever their latency.
+     */
+    Time getDeliveryDate(Time completionDate);
+
+    //!< @brief Writes the random generator and the loss state of the link to a snapshot
+    void save(SnapshotWriter &w) const;
+    //!< @brief Reads back the state written by save
+    void restore(SnapshotReader &r);
+};
+
+} // BaseSimulator namespace
+
+#endif /* LINKMODEL_H_ */
@@ -0,0 +1,59 @@
+/*! @file meldInterpretArena.cpp
+ * @brief Size-class slab arena of a Meld interpreter VM.
+ * @date 18/10/2026
+ */
+
+#include "meldInterpretArena.h"
+
+#include <new>
+#include <algorithm>
+#include <cstdlib>
+
+namespace MeldInterpret {
+
+TupleArena::Stats& TupleArena::Stats::operator+=(const Stats &s) {
+    nbAllocations += s.nbAllocations;
+    nbDeallocations += s.nbDeallocations;
+    nbLargeAllocations += s.nbLargeAllocations;
+    nbLargeBlocks += s.nbLargeBlocks;
+    liveBytes += s.liveBytes;
+    peakLiveBytes += s.peakLiveBytes;
+    nbSlabs += s.nbSlabs;
+    reservedBytes += s.reservedBytes;
+    return *this;
+}
+
+void TupleArena::refill(size_t cls) {
+    const size_t blockSize = (cls + 1) * granularity;
+    SizeClass &c = classes[cls];
+
+    // First slabs hold a few blocks only, most VMs of a large world derive few tuples
+    const size_t slabSize = c.nextSlabSize ? c.nextSlabSize : 8 * blockSize;
+    c.nextSlabSize = std::min(2 * slabSize, maxSlabSize - maxSlabSize % blockSize);
+
+    unsigned char *slab = static_cast<unsigned char*>(malloc(slabSize));
+    if (slab == NULL) throw std::bad_alloc();
+    slabs.push_back(slab);
+    stats.nbSlabs++;
+    stats.reservedBytes += slabSize;
+
+    c.cursor = slab;
+    c.end = slab + slabSize;
+}
+
+void TupleArena::release() {
+    for (void *slab : slabs) free(slab);
+    slabs.clear();
+    while (largeBlocks) {
+        LargeBlock *next = largeBlocks->next;
+        free(largeBlocks);
+        largeBlocks = next;
+    }
+    stats.nbLargeBlocks = 0;
+    for (SizeClass &c : classes) c = SizeClass();
+    stats.liveBytes = 0;
+    stats.reservedBytes = 0;
+    stats.nbSlabs = 0;
+}
+
+} // MeldInterpret namespace
@@ -0,0 +1,153 @@
+/*! @file meldInterpretArena.h
+ * @brief Size-class slab arena of a Meld interpreter VM, from which its tuples and the entries
+ *  of its tuple queues are allocated. All the memory of an arena, large blocks included, is
+ *  released at once when the VM is destroyed.
+ * @date 18/10/2026
+ */
+
+#ifndef MELDINTERPRETARENA_H_
+#define MELDINTERPRETARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace MeldInterpret {
+
+/**
+ * @brief Per VM slab allocator. Unlike utils::PoolAllocator, slabs are owned by the arena and
+ *  freed with it, hence blocks must not outlive the arena nor be released to another one.
+ * @attention Not thread-safe, an arena is only used by the VM owning it.
+ */
+class TupleArena {
+public:
+    static const size_t granularity = 8; //!< Sizes are rounded up to a multiple of granularity
+    static const size_t maxPooledSize = 256; //!< Larger blocks are allocated with malloc, and tracked (tuple sizes fit in a byte)
+    static const size_t maxSlabSize = 16 * 1024; //!< Slabs start small and double up to this size, VMs are numerous
+
+    //!< Allocation statistics of an arena, or of several (see operator+=)
+    struct Stats {
+        uint64_t nbAllocations = 0;
+        uint64_t nbDeallocations = 0;
+        uint64_t nbLargeAllocations = 0; //!< Larger than maxPooledSize
+        uint64_t nbLargeBlocks = 0;      //!< Large blocks currently allocated
+        uint64_t liveBytes = 0;          //!< Bytes currently allocated, rounded to their size class
+        uint64_t peakLiveBytes = 0;
+        uint64_t nbSlabs = 0;
+        uint64_t reservedBytes = 0;      //!< Bytes reserved by the slabs
+
+        Stats& operator+=(const Stats &s);
+    };
+
+private:
+    //!< A free block, linked to the next free block of the same size class
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    //!< Header of a large block, linking the large blocks of the arena so that release frees them
+    struct alignas(16) LargeBlock {
+        LargeBlock *prev;
+        LargeBlock *next;
+    };
+
+    //!< Blocks of a size class, recycled ones first, then carved from the current slab
+    struct SizeClass {
+        FreeBlock *freeList = NULL;
+        unsigned char *cursor = NULL;
+        unsigned char *end = NULL;
+        size_t nextSlabSize = 0;
+    };
+
+    static const size_t nbSizeClasses = maxPooledSize / granularity;
+
+    SizeClass classes[nbSizeClasses];
+    std::vector<void*> slabs;
+    LargeBlock *largeBlocks = NULL;
+    Stats stats;
+
+    static size_t sizeClass(size_t size) { return (size ? size + granularity - 1 : granularity) / granularity - 1; }
+    void refill(size_t cls);
+public:
+    TupleArena() {};
+    TupleArena(const TupleArena&) = delete;
+    TupleArena& operator=(const TupleArena&) = delete;
+    ~TupleArena() { release(); };
+
+    /**
+     * @brief Allocates a block of at least size bytes
+     * @param size requested size
+     * @return pointer to the block, aligned on granularity
+     */
+    void* allocate(size_t size);
+
+    /**
+     * @brief Returns a block to the arena
+     * @param p block previously returned by allocate
+     * @param size the size that was given to allocate
+     */
+    void deallocate(void *p, size_t size);
+
+    //!< @brief Frees all the slabs and large blocks at once, invalidating every block allocated from the arena
+    void release();
+
+    const Stats& getStats() const { return stats; };
+};
+
+inline void* TupleArena::allocate(size_t size) {
+    stats.nbAllocations++;
+    if (size > maxPooledSize) {
+        LargeBlock *l = static_cast<LargeBlock*>(malloc(sizeof(LargeBlock) + size));
+        if (l == NULL) throw std::bad_alloc();
+        l->prev = NULL;
+        l->next = largeBlocks;
+        if (largeBlocks) largeBlocks->prev = l;
+        largeBlocks = l;
+        stats.nbLargeAllocations++;
+        stats.nbLargeBlocks++;
+        return l + 1;
+    }
+
+    const size_t cls = sizeClass(size);
+    SizeClass &c = classes[cls];
+    stats.liveBytes += (cls + 1) * granularity;
+    if (stats.liveBytes > stats.peakLiveBytes) stats.peakLiveBytes = stats.liveBytes;
+
+    if (c.freeList) {
+        FreeBlock *b = c.freeList;
+        c.freeList = b->next;
+        return b;
+    }
+
+    if (c.cursor == c.end) refill(cls);
+    void *b = c.cursor;
+    c.cursor += (cls + 1) * granularity;
+    return b;
+}
+
+inline void TupleArena::deallocate(void *p, size_t size) {
+    if (p == NULL) return;
+    stats.nbDeallocations++;
+
+    if (size > maxPooledSize) {
+        LargeBlock *l = static_cast<LargeBlock*>(p) - 1;
+        if (l->prev) l->prev->next = l->next;
+        else largeBlocks = l->next;
+        if (l->next) l->next->prev = l->prev;
+        stats.nbLargeBlocks--;
+        free(l);
+        return;
+    }
+
+    const size_t cls = sizeClass(size);
+    stats.liveBytes -= (cls + 1) * granularity;
+    FreeBlock *b = static_cast<FreeBlock*>(p);
+    b->next = classes[cls].freeList;
+    classes[cls].freeList = b;
+}
+
+} // MeldInterpret namespace
+
+#endif // MELDINTERPRETARENA_H_
@@ -1,14 +1,26 @@
 #include "meldInterpretMessages.h"
+
+#include <cassert>
+#include <cstring>
+
 #include "meldInterpretVM.h"
 
 namespace MeldInterpret{
 
-AddTupleMessage::AddTupleMessage(tuple_t tpl, unsigned int s) : Message(){
-      tuple = tpl;
+AddTupleMessage::AddTupleMessage(tuple_t tpl, size_t tupleSize, unsigned int s) : Message(){
+      assert(tupleSize <= MELD_MESSAGE_DEFAULT_SIZE);
+      memcpy(data, tpl, tupleSize);
+      tuple = data;
       messageSize = s;
       type = ADD_TUPLE_MSG_ID;
 }
 
+AddTupleMessage::AddTupleMessage(const AddTupleMessage &m) : Message(m){
+      memcpy(data, m.data, sizeof(data));
+      tuple = data;
+      messageSize = m.messageSize;
+}
+
 unsigned int AddTupleMessage::size() const {
       return messageSize;
 }
@@ -17,12 +29,20 @@ string AddTupleMessage::getMessageName() const {
       return "Add Tuple Message";
 }
 
-RemoveTupleMessage::RemoveTupleMessage(tuple_t tpl, unsigned int s) : Message(){
-      tuple = tpl;
+RemoveTupleMessage::RemoveTupleMessage(tuple_t tpl, size_t tupleSize, unsigned int s) : Message(){
+      assert(tupleSize <= MELD_MESSAGE_DEFAULT_SIZE);
+      memcpy(data, tpl, tupleSize);
+      tuple = data;
       messageSize = s;
       type = REMOVE_TUPLE_MSG_ID;
 }
 
+RemoveTupleMessage::RemoveTupleMessage(const RemoveTupleMessage &m) : Message(m){
+      memcpy(data, m.data, sizeof(data));
+      tuple = data;
+      messageSize = m.messageSize;
+}
+
 unsigned int RemoveTupleMessage::size() const {
       return messageSize;
 }
@@ -29,22 +29,26 @@
 namespace MeldInterpret{
 
 class AddTupleMessage : public Message{
+    unsigned char data[MELD_MESSAGE_DEFAULT_SIZE]; //!< Copy of the tuple, sent tuples are released by their VM
 public:
     tuple_t tuple;
     unsigned int messageSize;
 
-    AddTupleMessage(tuple_t tpl, unsigned int s);
+    AddTupleMessage(tuple_t tpl, size_t tupleSize, unsigned int s);
+    AddTupleMessage(const AddTupleMessage &m);
     virtual unsigned int size() const override;
     virtual string getMessageName() const override;
     virtual Message* clone() const override { return new AddTupleMessage(*this); }
 };
 
 class RemoveTupleMessage : public Message{
+    unsigned char data[MELD_MESSAGE_DEFAULT_SIZE]; //!< Copy of the tuple, sent tuples are released by their VM
 public:
     tuple_t tuple;
     unsigned int messageSize;
 
-    RemoveTupleMessage(tuple_t tpl, unsigned int s);
+    RemoveTupleMessage(tuple_t tpl, size_t tupleSize, unsigned int s);
+    RemoveTupleMessage(const RemoveTupleMessage &m);
     virtual unsigned int size() const override;
     virtual string getMessageName() const override;
     virtual Message* clone() const override { return new RemoveTupleMessage(*this); }
@@ -44,7 +44,7 @@ void MeldInterpretScheduler::createScheduler() {
 }
 
 void MeldInterpretScheduler::deleteScheduler() {
-    delete((MeldInterpretScheduler*)scheduler);
+    delete((MeldInterpretScheduler*)scheduler.get());
 }
 
 
@@ -62,6 +62,7 @@ void MeldInterpretScheduler::SemWaitOrReadDebugMessage() {
 }
 
 void *MeldInterpretScheduler::startPaused(/*void *param*/) {
+    RunContext::adopt(runContext);
 
     int seed = 500;
     srand (seed);
@@ -87,7 +88,6 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
 #endif
     state = RUNNING;
     //checkForReceivedVMCommands();
-    multimap<Time, EventPtr>::iterator first, tmp;
     EventPtr pev;
     auto systemStartTime = get_time::now();
     auto pausedTime = systemStartTime - systemStartTime; // zero by default
@@ -99,15 +99,14 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
         //MeldInterpretDebugger::print("Simulation starts in deterministic mode");
         while (state != ENDED) {
             do {
-                  while (!eventsMap.empty()  || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
+                  while (!eventsQueue->empty()  || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
                         hasProcessed = true;
                         // lock();
-                        first = eventsMap.begin();
-                        pev = (*first).second;
+                        pev = eventsQueue->top();
                         currentDate = pev->date;
                         pev->consume();
                         StatsCollector::getInstance().incEventsCount();
-                        eventsMap.erase(first);
+                        eventsQueue->pop();
                         eventsMapSize--;
                         // unlock();
                         if (state == PAUSED) {
@@ -131,7 +130,7 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
                   OUTPUT << "EventMap is empty" << endl;
                   // PTHY: Equilibrium doesn't seem to be working, use SCHEDULER_LENGTH_INFINITE
                   //       to keep looping
-                  if (eventsMap.empty() && schedulerLength != SCHEDULER_LENGTH_INFINITE) {
+                  if (eventsQueue->empty() && schedulerLength != SCHEDULER_LENGTH_INFINITE) {
                       state = ENDED;
                       break;
                   }
@@ -140,7 +139,7 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
                       break;
                   }
                 //checkForReceivedVMCommands();
-            } while (!MeldInterpretVM::equilibrium() || !eventsMap.empty());
+            } while (!MeldInterpretVM::equilibrium() || !eventsQueue->empty());
 
             if(hasProcessed) {
                 hasProcessed = false;
@@ -168,7 +167,7 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
     case SCHEDULER_MODE_REALTIME:
         OUTPUT << "Realtime mode scheduler\n" << endl;
         //MeldInterpretDebugger::print("Simulation starts in real time mode");
-        while((state != ENDED && !eventsMap.empty()) || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
+        while((state != ENDED && !eventsQueue->empty()) || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
             auto systemCurrentTime = get_time::now() - pausedTime;
             auto systemCurrentTimeMax = systemCurrentTime - systemStartTime;
             // currentDate = systemCurrentTimeMax;
@@ -179,19 +178,18 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
             //     // (previously the graphic interface was doing
             //     // it).
             //     lock();
-            //     if (eventsMap.empty()) {
+            //     if (eventsQueue->empty()) {
             //         unlock();
             //         break;
             //     }
-            //     first=eventsMap.begin();
-            //     pev = (*first).second;
+            //     pev = eventsQueue->top();
             //     if(pev->date > systemCurrentTimeMax) {
             //         unlock();
             //         break;
             //     }
             //     currentDate = pev->date;
             //     pev->consume();
-            //     eventsMap.erase(first);
+            //     eventsQueue->pop();
             //     eventsMapSize--;
             //     unlock();
             //     //cout << "check to send" << endl;
@@ -199,26 +197,23 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
             //     //cout << "ok" << endl;
             // }
 
-            if (!eventsMap.empty()) {
-                first=eventsMap.begin();
-                pev = (*first).second;
-                while (!eventsMap.empty() && pev->date <= static_cast<uint64_t>(chrono::duration_cast<us>(systemCurrentTimeMax).count())) {
-                    first=eventsMap.begin();
-                    pev = (*first).second;
+            if (!eventsQueue->empty()) {
+                pev = eventsQueue->top();
+                while (!eventsQueue->empty() && pev->date <= static_cast<uint64_t>(chrono::duration_cast<us>(systemCurrentTimeMax).count())) {
+                    pev = eventsQueue->top();
                     currentDate = pev->date;
                     //lock();
                     pev->consume();
                     StatsCollector::getInstance().incEventsCount();
                     //unlock();
-                    eventsMap.erase(first);
+                    eventsQueue->pop();
                     eventsMapSize--;
                 }
             }
 
-            if (!eventsMap.empty()) {
+            if (!eventsQueue->empty()) {
                 //ev = *(listeEvenements.begin());
-                first=eventsMap.begin();
-                pev = (*first).second;
+                pev = eventsQueue->top();
             }
 
             if (state == PAUSED) {
@@ -229,7 +224,7 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
                 pausedTime = get_time::now() - pauseBeginning;
             }
 
-            if (!eventsMap.empty() || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
+            if (!eventsQueue->empty() || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
                 std::chrono::milliseconds timespan(5);
                 std::this_thread::sleep_for(timespan);
             }
@@ -253,7 +248,9 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
 
     StatsCollector::getInstance().updateElapsedTime(currentDate, chrono::duration_cast<us>(elapsedTime).count());
     StatsCollector::getInstance().setLivingCounters(Event::getNbLivingEvents(), Message::getNbMessages());
-    StatsCollector::getInstance().setEndEventsQueueSize(eventsMap.size());
+    StatsCollector::getInstance().setEventPoolCounters(PoolAllocator::getNbSlabs(), PoolAllocator::getReservedBytes(),
+                                                        PoolAllocator::getNbLargeAllocations());
+    StatsCollector::getInstance().setEndEventsQueueSize(eventsQueue->size());
 
     // if simulation is a regression testing run, export configuration before leaving
     if (Simulator::regrTesting && !terminate.load())
@@ -264,6 +261,7 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
         glutLeaveMainLoop();
 
     printStats();
+    cout << MeldInterpretVM::getRuleStats();
 
     terminate.store(true);
 
@@ -275,7 +273,7 @@ void MeldInterpretScheduler::pause(Time date) {
 }
 
 void MeldInterpretScheduler::unPause() {
-    MeldInterpretScheduler* sbs = (MeldInterpretScheduler*)scheduler;
+    MeldInterpretScheduler* sbs = (MeldInterpretScheduler*)scheduler.get();
     if (state != RUNNING) {
         sbs->sem_schedulerStart->signal();
     }
@@ -27,7 +27,7 @@ public:
     static void deleteScheduler();
     static MeldInterpretScheduler* getScheduler() {
         assert(scheduler != NULL);
-        return((MeldInterpretScheduler*)scheduler);
+        return((MeldInterpretScheduler*)scheduler.get());
     }
 
     void printInfo() override {
@@ -1,7 +1,9 @@
 #include "meldInterpretVM.h"
 
 #include <iostream>
+#include <sstream>
 #include <cassert>
+#include <algorithm>
 
 #include "meldInterpretEvents.h"
 #include "meldInterpretMessages.h"
@@ -23,8 +25,18 @@ char** MeldInterpretVM::tuple_names;
 char* rule_names_load[] = {(char*)("_init -o node-axioms."), };
 char** MeldInterpretVM::rule_names = rule_names_load;
 
-map<int, MeldInterpretVM*> MeldInterpretVM::vmMap;
+vector<MeldInterpretVM*> MeldInterpretVM::vmMap;
+vector<MeldInterpretVM*> MeldInterpretVM::busyVMs;
+std::atomic<size_t> MeldInterpretVM::nbBusyVMs(0);
+TupleArena::Stats MeldInterpretVM::retiredArenaStats;
+vector<vector<meld_byte>> MeldInterpretVM::rulesOfPredicate;
+vector<uint64_t> MeldInterpretVM::nbRuleExecutions;
+uint64_t MeldInterpretVM::nbRuleStateUpdates = 0;
+uint64_t MeldInterpretVM::nbIdleSteps = 0;
 bool MeldInterpretVM::configured = false;
+vector<MeldInterpretVM::ThreadedInstr> MeldInterpretVM::threadedProg;
+vector<int> MeldInterpretVM::threadedIndex;
+bool MeldInterpretVM::threadedDispatch = true;
 bool MeldInterpretVM::debugging = false;
 unsigned char * MeldInterpretVM::arguments = NULL;
 
@@ -52,8 +64,10 @@ MeldInterpretVM::MeldInterpretVM(BaseSimulator::BuildingBlock *b){
 
     vm_alloc();
     vm_init();
+    initRuleStates();
 
-    hasWork = true;
+    hasWork = false;
+    setHasWork(true);
     polling = false;
     deterministicSet = false;
     firstStart = true;
@@ -67,7 +81,8 @@ MeldInterpretVM::MeldInterpretVM(BaseSimulator::BuildingBlock *b){
     enqueue_count(numNeighbors, 1);
     neighbors = (NodeID*)malloc(b->getNbInterfaces() * sizeof(NodeID));
 
-    vmMap.insert(std::pair<int, MeldInterpretVM*>(blockId,this));
+    if (blockId >= vmMap.size()) vmMap.resize(blockId + 1, NULL);
+    vmMap[blockId] = this;
 }
 
 MeldInterpretVM::~MeldInterpretVM(){
@@ -83,6 +98,10 @@ MeldInterpretVM::~MeldInterpretVM(){
       tupleEntry = tupleNextEntry;
       }
       }*/
+    setHasWork(false);
+    if (getVM(blockId) == this) vmMap[blockId] = NULL;
+    /** Tuples and queue entries are released with the arena */
+    retiredArenaStats += arena.getStats();
     free(delayedTuples);
     free(tuples);
     free(newStratTuples);
@@ -134,6 +153,7 @@ NodeID MeldInterpretVM::get_neighbor_ID(int face){
 void MeldInterpretVM::enqueueNewTuple(tuple_t tuple, record_type isNew){
     assert (TUPLE_TYPE(tuple) < NUM_TYPES);
 
+    setHasWork(true);
     if (TYPE_IS_STRATIFIED(TUPLE_TYPE(tuple))) {
         p_enqueue(newStratTuples, TYPE_STRATIFICATION_ROUND(TUPLE_TYPE(tuple)), tuple, 0, isNew);
     }
@@ -268,14 +288,14 @@ void MeldInterpretVM::processOneRule(void) {
         tuple_pentry *entry = p_dequeue(delayedTuples);
 
         tuple_send(entry->tuple, entry->rt, 0, entry->records.count);
-        free(entry);
+        arena.deallocate(entry, sizeof(tuple_pentry));
         waiting = 1;
         //Else if there are new stratified tuple
     } else if (!(p_empty(newStratTuples))) {
         tuple_pentry *entry = p_dequeue(newStratTuples);
         tuple_handle(entry->tuple, entry->records.count, reg);
 
-        free(entry);
+        arena.deallocate(entry, sizeof(tuple_pentry));
         //Else if there are no tuple to process
         waiting = 1;
     } else {
@@ -283,26 +303,27 @@ void MeldInterpretVM::processOneRule(void) {
         if (!p_empty(delayedTuples)) {
             waiting = 1;
         }
-        /** If all tuples have been processed
-         * update rule state and process them if they are ready */
-        for (int i = 0; i < NUM_RULES; ++i) {
-            //If a rule has all its predicate (considered ACTIVE)
-            if (updateRuleState(i)) {
-                waiting = 1;
+        /** If all tuples have been processed, process the first rule that is ready
+         * (considered ACTIVE, see updatePredicateState). Rule states are only updated
+         * when the predicates they include appear in or disappear from the database. */
+        nbIdleSteps++;
+        if (nbActiveRules > 0) {
+            waiting = 1;
+            /** Don't process persistent rules (which is useless)
+             * as they all have only a RETURN instruction.
+             */
+            for (size_t w = 0; w < activeRules.size(); w++) {
+                if (activeRules[w] == 0) continue;
+                int i = w * 64 + __builtin_ctzll(activeRules[w]);
+                nbRuleExecutions[i]++;
                 /** Set state byte used by DEBUG */
                 meld_byte processState = PROCESS_RULE | (i << 4);
-                /** Don't process persistent rules (which is useless)
-                 * as they all have only a RETURN instruction.
-                 */
-                if (!RULE_ISPERSISTENT(i)) {
-                    /** Trigger execution */
-                    process_bytecode (NULL, RULE_START(i), 1, NOT_LINEAR, reg, processState);
+                /** Trigger execution */
+                process_bytecode (NULL, RULE_START(i), 1, NOT_LINEAR, reg, processState);
 
-                    /** After one rule is executed we set the VM on waiting until next call of scheduler*/
-                    i = NUM_RULES;
-                }
+                /** After one rule is executed we set the VM on waiting until next call of scheduler*/
+                break;
             }
-            /** else: Rule not ready yet, set status to not waiting until new fact appear */
         }
     }
 
@@ -341,6 +362,9 @@ void MeldInterpretVM::processOneRule(void) {
         neighbors[i] = neighbor;
         enqueue_face(neighbors[i], i, 1);
     }
+
+    /** Idle until a new tuple is enqueued, or a neighbor changes (see isWaiting) */
+    setHasWork(waiting > 0);
 }
 
 bool MeldInterpretVM::isWaiting(){
@@ -364,7 +388,7 @@ void MeldInterpretVM::receive_tuple(int isNew, tuple_t tpl, meld_byte face) {
         //tuple_queue *queue = receivedTuples + face;
         tuple_queue *queue = &(receivedTuples[face]);
         if(isNew > 0) {
-            tuple = malloc(tuple_size);
+            tuple = ALLOC_TUPLE(tuple_size);
             memcpy(tuple, rcvdTuple, tuple_size);
             queue_enqueue(queue, tuple, (record_type)isNew);
         } else {
@@ -379,7 +403,7 @@ void MeldInterpretVM::receive_tuple(int isNew, tuple_t tpl, meld_byte face) {
         }
     }
 
-    tuple = malloc(tuple_size);
+    tuple = ALLOC_TUPLE(tuple_size);
     memcpy(tuple, rcvdTuple, tuple_size);
     enqueueNewTuple(tuple, (record_type)isNew);
 }
@@ -404,10 +428,10 @@ void MeldInterpretVM::tuple_send(tuple_t tuple, NodeID rt, meld_int delay, int i
             assert(TYPE_SIZE(TUPLE_TYPE(tuple)) <= MELD_MESSAGE_DEFAULT_SIZE);
             MessagePtr ptr;
             if (isNew > 0) {
-           ptr = (MessagePtr)(new AddTupleMessage(tuple, MELD_MESSAGE_DEFAULT_SIZE));
+           ptr = (MessagePtr)(new AddTupleMessage(tuple, TYPE_SIZE(TUPLE_TYPE(tuple)), MELD_MESSAGE_DEFAULT_SIZE));
             }
             else {
-                ptr = (MessagePtr)(new RemoveTupleMessage(tuple, MELD_MESSAGE_DEFAULT_SIZE));
+                ptr = (MessagePtr)(new RemoveTupleMessage(tuple, TYPE_SIZE(TUPLE_TYPE(tuple)), MELD_MESSAGE_DEFAULT_SIZE));
             }
             P2PNetworkInterface *p2p = host->getP2PNetworkInterfaceByDestBlockId(get_neighbor_ID(face));
             /**Prepare message*/
@@ -423,10 +447,10 @@ void MeldInterpretVM::tuple_send(tuple_t tuple, NodeID rt, meld_int delay, int i
                 assert(TUPLE_TYPE(tuple) < NUM_TYPES);
                 MessagePtr ptr;
                 if (isNew > 0) {
-                    ptr = (MessagePtr)(new AddTupleMessage(tuple, MELD_MESSAGE_DEFAULT_SIZE));
+                    ptr = (MessagePtr)(new AddTupleMessage(tuple, TYPE_SIZE(TUPLE_TYPE(tuple)), MELD_MESSAGE_DEFAULT_SIZE));
                 }
                 else {
-                    ptr = (MessagePtr)(new RemoveTupleMessage(tuple, MELD_MESSAGE_DEFAULT_SIZE));
+                    ptr = (MessagePtr)(new RemoveTupleMessage(tuple, TYPE_SIZE(TUPLE_TYPE(tuple)), MELD_MESSAGE_DEFAULT_SIZE));
                 }
 
                 BuildingBlock* toblock = NULL;
@@ -450,6 +474,9 @@ void MeldInterpretVM::tuple_send(tuple_t tuple, NodeID rt, meld_int delay, int i
                 //exit(EXIT_FAILURE);
             }
         }
+
+        /** Messages carry a copy of the tuple */
+        FREE_TUPLE(tuple);
     }
 }
 
@@ -467,6 +494,395 @@ meld_byte MeldInterpretVM::updateRuleState(meld_byte rid) {
     return ACTIVE_RULE;
 }
 
+/** Size of the instructions that are followed by the next one, as process_bytecode
+ * moves past them, 0 for those that are not implemented */
+size_t MeldInterpretVM::instructionSize(meld_byte op) {
+    switch (op) {
+    case ADDRNOTEQUAL_INSTR:
+    case ADDREQUAL_INSTR:
+    case INTMINUS_INSTR:
+    case INTEQUAL_INSTR:
+    case INTNOTEQUAL_INSTR:
+    case INTPLUS_INSTR:
+    case INTLESSER_INSTR:
+    case INTGREATEREQUAL_INSTR:
+    case BOOLOR_INSTR:
+    case INTLESSEREQUAL_INSTR:
+    case INTGREATER_INSTR:
+    case INTMUL_INSTR:
+    case INTDIV_INSTR:
+    case FLOATPLUS_INSTR:
+    case FLOATMINUS_INSTR:
+    case FLOATMUL_INSTR:
+    case FLOATDIV_INSTR:
+    case FLOATEQUAL_INSTR:
+    case FLOATNOTEQUAL_INSTR:
+    case FLOATLESSER_INSTR:
+    case FLOATLESSEREQUAL_INSTR:
+    case FLOATGREATER_INSTR:
+    case FLOATGREATEREQUAL_INSTR:
+    case BOOLEQUAL_INSTR:
+    case BOOLNOTEQUAL_INSTR:
+    case INTMOD_INSTR:
+        return OP_BASE;
+    case NOT_INSTR: return NOT_BASE;
+    case SEND_INSTR: return SEND_BASE;
+    case RULE_INSTR: return RULE_BASE;
+    case RULE_DONE_INSTR: return RULE_DONE_BASE;
+    case SEND_DELAY_INSTR: return SEND_DELAY_BASE;
+    case MVINTFIELD_INSTR: return MVINTFIELD_BASE;
+    case MVINTREG_INSTR: return MVINTREG_BASE;
+    case MVFIELDFIELD_INSTR: return MVFIELDFIELD_BASE;
+    case MVFIELDREG_INSTR: return MVFIELDREG_BASE;
+    case MVPTRREG_INSTR: return MVPTRREG_BASE;
+    case MVFIELDFIELDR_INSTR: return MVFIELDFIELD_BASE;
+    case MVREGFIELD_INSTR: return MVREGFIELD_BASE;
+    case MVHOSTFIELD_INSTR: return MVHOSTFIELD_BASE;
+    case MVFLOATFIELD_INSTR: return MVFLOATFIELD_BASE;
+    case MVFLOATREG_INSTR: return MVFLOATREG_BASE;
+    case MVHOSTREG_INSTR: return MVHOSTREG_BASE;
+    case ALLOC_INSTR: return ALLOC_BASE;
+    case MVREGREG_INSTR: return MVREGREG_BASE;
+    case CALL1_INSTR: return CALL1_BASE;
+    case ADDLINEAR_INSTR: return ADDLINEAR_BASE;
+    case ADDPERS_INSTR: return ADDPERS_BASE;
+    case RUNACTION_INSTR: return RUNACTION_BASE;
+    case UPDATE_INSTR: return UPDATE_BASE;
+    case REMOVE_INSTR: return REMOVE_BASE;
+    default: return 0;
+    }
+}
+
+/** Walks through the byte code reachable from each predicate and rule once the program
+ * is loaded, so that unimplemented instructions and jumps out of the program are reported
+ * upfront rather than when a block first executes them. Returns the offsets of the
+ * instructions reached, in order, for buildThreadedCode. */
+vector<size_t> MeldInterpretVM::validateProgram(size_t size) {
+    vector<bool> visited(size, false);
+    vector<size_t> pending;
+    vector<size_t> instructions;
+    for (int type = 0; type < NUM_TYPES; ++type) pending.push_back(TYPE_START(type) - meld_prog);
+    for (int rid = 0; rid < NUM_RULES; ++rid) pending.push_back(RULE_START(rid) - meld_prog);
+
+    size_t nbInstructions = 0;
+    while (!pending.empty()) {
+        size_t offset = pending.back();
+        pending.pop_back();
+
+        while (offset < size && !visited[offset]) {
+            visited[offset] = true;
+            nbInstructions++;
+            const unsigned char *pc = meld_prog + offset;
+            const meld_byte op = FETCH(pc);
+            size_t length = 0;
+
+            switch (op) {
+            case RETURN_INSTR: case NEXT_INSTR: case END_LINEAR_INSTR:
+            case RETURN_LINEAR_INSTR: case RETURN_DERIVED_INSTR:
+                instructions.push_back(offset);
+                offset = size;
+                continue;
+            case PERS_ITER_INSTR: case LINEAR_ITER_INSTR:
+                length = PERS_ITER_BASE;
+                break;
+            case RESET_LINEAR_INSTR:
+                length = RESET_LINEAR_BASE;
+                break;
+            case IF_INSTR:
+                length = IF_BASE;
+                break;
+            case IF_ELSE_INSTR:
+                length = IF_ELSE_BASE;
+                break;
+            case JUMP_INSTR:
+                length = JUMP_BASE;
+                break;
+            default:
+                length = instructionSize(op);
+                if (length == 0) {
+                    cerr << "warning: Meld program uses unimplemented instruction " << hex << showbase
+                         << (int)op << dec << noshowbase << " at offset " << offset << endl;
+                    instructions.push_back(offset);
+                    offset = size;
+                    continue;
+                }
+            }
+
+            if (offset + length > size) {
+                cerr << "warning: Meld instruction at offset " << offset << " is truncated" << endl;
+                break;
+            }
+            instructions.push_back(offset);
+
+            /** Successors, as process_bytecode and execute_iter compute them */
+            switch (op) {
+            case PERS_ITER_INSTR: case LINEAR_ITER_INSTR:
+                pending.push_back(offset + ITER_INNER_JUMP(pc));
+                offset += ITER_OUTER_JUMP(pc);
+                break;
+            case RESET_LINEAR_INSTR:
+                pending.push_back(offset + RESET_LINEAR_BASE);
+                offset += RESET_LINEAR_JUMP(pc);
+                break;
+            case IF_INSTR: case IF_ELSE_INSTR:
+                pending.push_back(offset + IF_JUMP(pc + 2));
+                offset += length;
+                break;
+            case JUMP_INSTR:
+                offset += 1 + JUMP_BASE + IF_JUMP(pc + 1);
+                break;
+            default:
+                offset += length;
+            }
+
+            if (offset > size) {
+                cerr << "warning: Meld instruction at offset " << pc - meld_prog << " jumps out of the program" << endl;
+            }
+        }
+    }
+
+    OUTPUT << "Meld program: " << nbInstructions << " instructions checked" << endl;
+    sort(instructions.begin(), instructions.end());
+    return instructions;
+}
+
+/** Code of process_bytecode executing each kind of threaded instruction, in the order of
+ * the handlers of process_bytecode */
+enum ThreadedKind : meld_byte {
+    T_SWITCH,           /* Executed by the switch: unimplemented, or a successor has no threaded form */
+    T_RETURN, T_NEXT, T_RETURN_LINEAR, T_RETURN_DERIVED,
+    T_ITER, T_RESET_LINEAR, T_SKIP, T_IF, T_JUMP,
+    T_MVCONSTREG, T_MVREGREG, T_MVFIELDREG, T_MVREGFIELD, T_MVFIELDFIELD, T_NOT,
+    T_ADDRNOTEQUAL, T_ADDREQUAL, T_INTMINUS, T_INTEQUAL, T_INTNOTEQUAL, T_INTPLUS, T_INTLESSER,
+    T_INTGREATEREQUAL, T_BOOLOR, T_INTLESSEREQUAL, T_INTGREATER, T_INTMUL, T_INTDIV, T_INTMOD,
+    T_FLOATPLUS, T_FLOATMINUS, T_FLOATMUL, T_FLOATDIV, T_FLOATEQUAL, T_FLOATNOTEQUAL,
+    T_FLOATLESSER, T_FLOATLESSEREQUAL, T_FLOATGREATER, T_FLOATGREATEREQUAL,
+    T_BOOLEQUAL, T_BOOLNOTEQUAL,
+    T_SEND, T_SEND_DELAY, T_MVINTFIELD, T_MVHOSTFIELD, T_MVFLOATFIELD, T_MVHOSTREG,
+    T_ALLOC, T_CALL1, T_ADDTUPLE, T_RUNACTION, T_UPDATE, T_REMOVE,
+    NB_THREADED_KINDS
+};
+
+/** Kind of the threaded form of the instructions of opcode op */
+static meld_byte threadedKind(meld_byte op) {
+    switch (op) {
+    case RETURN_INSTR: return T_RETURN;
+    case NEXT_INSTR: return T_NEXT;
+    case END_LINEAR_INSTR: case RETURN_LINEAR_INSTR: return T_RETURN_LINEAR;
+    case RETURN_DERIVED_INSTR: return T_RETURN_DERIVED;
+    case PERS_ITER_INSTR: case LINEAR_ITER_INSTR: return T_ITER;
+    case RESET_LINEAR_INSTR: return T_RESET_LINEAR;
+    case RULE_INSTR: case RULE_DONE_INSTR: case MVPTRREG_INSTR: return T_SKIP;
+    case IF_INSTR: case IF_ELSE_INSTR: return T_IF;
+    case JUMP_INSTR: return T_JUMP;
+    case MVINTREG_INSTR: case MVFLOATREG_INSTR: return T_MVCONSTREG;
+    case MVREGREG_INSTR: return T_MVREGREG;
+    case MVFIELDREG_INSTR: return T_MVFIELDREG;
+    case MVREGFIELD_INSTR: return T_MVREGFIELD;
+    case MVFIELDFIELD_INSTR: case MVFIELDFIELDR_INSTR: return T_MVFIELDFIELD;
+    case NOT_INSTR: return T_NOT;
+    case ADDRNOTEQUAL_INSTR: return T_ADDRNOTEQUAL;
+    case ADDREQUAL_INSTR: return T_ADDREQUAL;
+    case INTMINUS_INSTR: return T_INTMINUS;
+    case INTEQUAL_INSTR: return T_INTEQUAL;
+    case INTNOTEQUAL_INSTR: return T_INTNOTEQUAL;
+    case INTPLUS_INSTR: return T_INTPLUS;
+    case INTLESSER_INSTR: return T_INTLESSER;
+    case INTGREATEREQUAL_INSTR: return T_INTGREATEREQUAL;
+    case BOOLOR_INSTR: return T_BOOLOR;
+    case INTLESSEREQUAL_INSTR: return T_INTLESSEREQUAL;
+    case INTGREATER_INSTR: return T_INTGREATER;
+    case INTMUL_INSTR: return T_INTMUL;
+    case INTDIV_INSTR: return T_INTDIV;
+    case INTMOD_INSTR: return T_INTMOD;
+    case FLOATPLUS_INSTR: return T_FLOATPLUS;
+    case FLOATMINUS_INSTR: return T_FLOATMINUS;
+    case FLOATMUL_INSTR: return T_FLOATMUL;
+    case FLOATDIV_INSTR: return T_FLOATDIV;
+    case FLOATEQUAL_INSTR: return T_FLOATEQUAL;
+    case FLOATNOTEQUAL_INSTR: return T_FLOATNOTEQUAL;
+    case FLOATLESSER_INSTR: return T_FLOATLESSER;
+    case FLOATLESSEREQUAL_INSTR: return T_FLOATLESSEREQUAL;
+    case FLOATGREATER_INSTR: return T_FLOATGREATER;
+    case FLOATGREATEREQUAL_INSTR: return T_FLOATGREATEREQUAL;
+    case BOOLEQUAL_INSTR: return T_BOOLEQUAL;
+    case BOOLNOTEQUAL_INSTR: return T_BOOLNOTEQUAL;
+    case SEND_INSTR: return T_SEND;
+    case SEND_DELAY_INSTR: return T_SEND_DELAY;
+    case MVINTFIELD_INSTR: return T_MVINTFIELD;
+    case MVHOSTFIELD_INSTR: return T_MVHOSTFIELD;
+    case MVFLOATFIELD_INSTR: return T_MVFLOATFIELD;
+    case MVHOSTREG_INSTR: return T_MVHOSTREG;
+    case ALLOC_INSTR: return T_ALLOC;
+    case CALL1_INSTR: return T_CALL1;
+    case ADDLINEAR_INSTR: case ADDPERS_INSTR: return T_ADDTUPLE;
+    case RUNACTION_INSTR: return T_RUNACTION;
+    case UPDATE_INSTR: return T_UPDATE;
+    case REMOVE_INSTR: return T_REMOVE;
+    default: return T_SWITCH;
+    }
+}
+
+/** Pre-decodes the instructions reachable in the program into its threaded form, shared by
+ * all VMs: operands are read once, registers masked as eval_reg does, and the successors of
+ * each instruction resolved as process_bytecode computes them. Instructions whose successor
+ * has no threaded form, or does not follow them, are left to the switch of process_bytecode. */
+void MeldInterpretVM::buildThreadedCode(size_t size, const vector<size_t> &instructions) {
+    threadedProg.assign(instructions.size(), ThreadedInstr());
+    threadedIndex.assign(size, -1);
+    vector<size_t> nextOffset(instructions.size(), size), targetOffset(instructions.size(), size);
+
+    for (size_t i = 0; i < instructions.size(); i++) {
+        const size_t offset = instructions[i];
+        const unsigned char *pc = meld_prog + offset;
+        const meld_byte op = FETCH(pc);
+        ThreadedInstr &t = threadedProg[i];
+        threadedIndex[offset] = i;
+        t.handler = NULL;
+        t.kind = threadedKind(op);
+        t.src = t.src2 = t.dst = t.srcField = t.dstField = 0;
+        t.value = 0;
+        t.pc = pc;
+        t.target = NULL;
+
+        switch (t.kind) {
+        case T_SWITCH: case T_RETURN: case T_NEXT: case T_RETURN_LINEAR: case T_RETURN_DERIVED:
+            break;
+        case T_ITER:
+            targetOffset[i] = offset + ITER_OUTER_JUMP(pc);
+            break;
+        case T_RESET_LINEAR:
+            targetOffset[i] = offset + RESET_LINEAR_JUMP(pc);
+            break;
+        case T_IF:
+            t.src = VAL_REG(pc[1]);
+            nextOffset[i] = offset + (op == IF_INSTR ? IF_BASE : IF_ELSE_BASE);
+            targetOffset[i] = offset + IF_JUMP(pc + 2);
+            break;
+        case T_JUMP:
+            targetOffset[i] = offset + 1 + JUMP_BASE + IF_JUMP(pc + 1);
+            break;
+        case T_MVCONSTREG:
+            /** execute_mvintreg copies a whole register from the byte code, past the int */
+            if (offset + 1 + sizeof(Register) > size) {
+                t.kind = T_SWITCH;
+                break;
+            }
+            memcpy(&t.value, pc + 1, sizeof(Register));
+            t.dst = VAL_REG(op == MVINTREG_INSTR ? pc[1 + sizeof(meld_int)] : pc[1 + sizeof(meld_float)]);
+            nextOffset[i] = offset + instructionSize(op);
+            break;
+        case T_MVREGREG:
+            t.src = VAL_REG(pc[1]);
+            t.dst = VAL_REG(pc[2]);
+            nextOffset[i] = offset + instructionSize(op);
+            break;
+        /** Registers of tuples are not masked by eval_field */
+        case T_MVFIELDREG:
+            t.srcField = pc[1];
+            t.src = pc[2];
+            t.dst = VAL_REG(pc[3]);
+            nextOffset[i] = offset + instructionSize(op);
+            break;
+        case T_MVREGFIELD:
+            t.src = VAL_REG(pc[1]);
+            t.dstField = pc[2];
+            t.dst = pc[3];
+            nextOffset[i] = offset + instructionSize(op);
+            break;
+        case T_MVFIELDFIELD:
+            t.srcField = pc[1];
+            t.src = pc[2];
+            t.dstField = pc[3];
+            t.dst = pc[4];
+            nextOffset[i] = offset + instructionSize(op);
+            break;
+        case T_NOT:
+            t.src = VAL_REG(pc[1]);
+            t.dst = VAL_REG(pc[2]);
+            nextOffset[i] = offset + instructionSize(op);
+            break;
+        default:
+            if (instructionSize(op) == OP_BASE) {
+                t.src = VAL_REG(pc[1]);
+                t.src2 = VAL_REG(pc[2]);
+                t.dst = VAL_REG(pc[3]);
+            }
+            /** Other operands are decoded by the execute_* functions */
+            nextOffset[i] = offset + instructionSize(op);
+        }
+    }
+
+    size_t nbSwitched = 0;
+    for (size_t i = 0; i < instructions.size(); i++) {
+        ThreadedInstr &t = threadedProg[i];
+        if (targetOffset[i] < size && threadedIndex[targetOffset[i]] >= 0)
+            t.target = &threadedProg[threadedIndex[targetOffset[i]]];
+        const bool nextFollows = nextOffset[i] < size && threadedIndex[nextOffset[i]] == (int)i + 1;
+        if ((nextOffset[i] != size && !nextFollows) || (targetOffset[i] != size && !t.target))
+            t.kind = T_SWITCH;
+        if (t.kind == T_SWITCH) nbSwitched++;
+    }
+
+    OUTPUT << "Meld program: " << threadedProg.size() << " instructions threaded, "
+           << nbSwitched << " left to the switch" << endl;
+}
+
+/** Sets the handler of the threaded instructions, once process_bytecode knows their address */
+bool MeldInterpretVM::bindThreadedCode(const void *const *handlers) {
+    for (ThreadedInstr &t : threadedProg) t.handler = handlers[t.kind];
+    return true;
+}
+
+/** Builds the index of the rules including each predicate, once the program is loaded */
+void MeldInterpretVM::buildRuleIndex() {
+    rulesOfPredicate.assign(NUM_TYPES, vector<meld_byte>());
+    for (int rid = 0; rid < NUM_RULES; ++rid) {
+        for (int i = 0; i < RULE_NUM_INCLPREDS(rid); ++i) {
+            rulesOfPredicate[RULE_INCLPRED_ID(rid, i)].push_back(rid);
+        }
+    }
+    nbRuleExecutions.assign(NUM_RULES, 0);
+}
+
+/** The database is empty: only rules including no predicate are ready */
+void MeldInterpretVM::initRuleStates() {
+    predicateIsEmpty.assign(NUM_TYPES, true);
+    nbMissingPredicates.assign(NUM_RULES, 0);
+    activeRules.assign((NUM_RULES + 63) / 64, 0);
+    nbActiveRules = 0;
+
+    for (int rid = 0; rid < NUM_RULES; ++rid) {
+        nbMissingPredicates[rid] = RULE_NUM_INCLPREDS(rid);
+        if (nbMissingPredicates[rid] == 0) setRuleActive(rid, true);
+    }
+}
+
+void MeldInterpretVM::setRuleActive(meld_byte rid, bool active) {
+    nbActiveRules += active ? 1 : -1;
+    if (!RULE_ISPERSISTENT(rid)) {
+        if (active) activeRules[rid / 64] |= 1ull << (rid % 64);
+        else activeRules[rid / 64] &= ~(1ull << (rid % 64));
+    }
+}
+
+/** Updates the state of the rules including predicate type if it appeared in
+ * or disappeared from the database, as updateRuleState would see it */
+void MeldInterpretVM::updatePredicateState(tuple_type type) {
+    const bool empty = TUPLES[type].length == 0;
+    if (empty == predicateIsEmpty[type]) return;
+    predicateIsEmpty[type] = empty;
+
+    for (meld_byte rid : rulesOfPredicate[type]) {
+        nbRuleStateUpdates++;
+        if (empty) {
+            if (nbMissingPredicates[rid]++ == 0) setRuleActive(rid, false);
+        } else {
+            if (--nbMissingPredicates[rid] == 0) setRuleActive(rid, true);
+        }
+    }
+}
+
 /** Simply calls tuple_do_handle located in core.c to handle tuple  */
 void MeldInterpretVM::tuple_handle(tuple_t tuple, int isNew, Register *registers) {
     tuple_type type = TUPLE_TYPE(tuple);
@@ -549,15 +965,52 @@ void MeldInterpretVM::moveTo(meld_int x, meld_int y, meld_int z) {
                                                                       host, Vector3D(x, y, z)));
 }
 
+void MeldInterpretVM::setHasWork(bool w) {
+    if (w == hasWork) return;
+    hasWork = w;
+
+    if (w) {
+        busyIndex = busyVMs.size();
+        busyVMs.push_back(this);
+    } else {
+        // Swap with the last busy VM
+        MeldInterpretVM *last = busyVMs.back();
+        busyVMs[busyIndex] = last;
+        last->busyIndex = busyIndex;
+        busyVMs.pop_back();
+    }
+    nbBusyVMs.store(busyVMs.size(), std::memory_order_release);
+}
+
+TupleArena::Stats MeldInterpretVM::getTotalArenaStats() {
+    TupleArena::Stats stats = retiredArenaStats;
+    for (MeldInterpretVM *vm : vmMap) {
+        if (vm) stats += vm->getArenaStats();
+    }
+    return stats;
+}
+
+string MeldInterpretVM::getRuleStats() {
+    if (!configured) return "";
+
+    ostringstream out;
+    uint64_t total = 0;
+    for (uint64_t n : nbRuleExecutions) total += n;
+    out << "Meld rules: " << total << " executions in " << nbIdleSteps << " idle steps, "
+        << nbRuleStateUpdates << " rule state updates (" << nbIdleSteps * NUM_RULES
+        << " when scanning every rule)" << endl;
+    for (size_t rid = 0; rid < nbRuleExecutions.size(); rid++) {
+        if (nbRuleExecutions[rid]) out << "\trule " << rid << ": " << nbRuleExecutions[rid] << endl;
+    }
+    return out.str();
+}
+
 bool MeldInterpretVM::equilibrium() {
-    map<int, MeldInterpretVM*>::iterator it;
-    for(it = vmMap.begin(); it != vmMap.end(); it++) {
-        MeldInterpretVM *vm = it->second;
-        BaseSimulator::BuildingBlock *buildb = vm->host;
-        if (buildb->getState() < BaseSimulator::BuildingBlock::ALIVE) {
-            continue;
-        }
-        if (vm->hasWork) {
+    if (nbBusyVMs.load(std::memory_order_acquire) == 0) return true;
+
+    // VMs of blocks that are not alive do not prevent equilibrium
+    for (MeldInterpretVM *vm : busyVMs) {
+        if (vm->host->getState() >= BaseSimulator::BuildingBlock::ALIVE) {
             return false;
         }
     }
@@ -629,6 +1082,7 @@ void MeldInterpretVM::readProgram(string path){
         multi = 1;
     }
     meld_prog = outProg;
+    const size_t progSize = byteCount + 1;
 
     //Reading tuple_names
     int countingTuple = characterCount(tupleString, ',');
@@ -643,6 +1097,9 @@ void MeldInterpretVM::readProgram(string path){
     }
     tuple_names = outTuple;
 
+    buildThreadedCode(progSize, validateProgram(progSize));
+    buildRuleIndex();
+
     OUTPUT << "Program has been loaded" << endl;
 }
 
@@ -1043,7 +1500,7 @@ inline void MeldInterpretVM::execute_remove (const unsigned char *pc, Register *
                 getBlockId(), reg_remove, tuple_names[type], size);
 #endif
 
-        tuple_handle(memcpy(malloc(size),MELD_CONVERT_REG_TO_PTR(reg[reg_remove]), size), -1, reg);
+        tuple_handle(memcpy(ALLOC_TUPLE(size),MELD_CONVERT_REG_TO_PTR(reg[reg_remove]), size), -1, reg);
         reg[REMOVE_REG(pc)] = 0;
     }
 }
@@ -1800,18 +2257,20 @@ tuple_t MeldInterpretVM::queue_dequeue_pos(tuple_queue *_queue, tuple_entry **po
     *pos = next;
 
     tuple_t tuple = entry->tuple;
-    free(entry);
+    arena.deallocate(entry, sizeof(tuple_entry));
+    queueChanged(_queue);
 
     return tuple;
 }
 
 tuple_entry* MeldInterpretVM::queue_enqueue(tuple_queue *_queue, tuple_t tuple, record_type isNew) {
-    tuple_entry *entry = (tuple_entry*)malloc(sizeof(tuple_entry));
+    tuple_entry *entry = (tuple_entry*)arena.allocate(sizeof(tuple_entry));
     entry->tuple = tuple;
     entry->records = isNew;
     entry->next = NULL;
     queue_push_tuple(_queue, entry);
     _queue->length++;
+    queueChanged(_queue);
     return entry;
 }
 
@@ -1824,7 +2283,8 @@ tuple_t MeldInterpretVM::queue_dequeue(tuple_queue *queue, int *isNew) {
     if(isNew)
         *isNew = entry->records.count;
 
-    free(entry);
+    arena.deallocate(entry, sizeof(tuple_entry));
+    queueChanged(queue);
 
     return tuple;
 }
@@ -1840,7 +2300,7 @@ tuple_pentry* MeldInterpretVM::p_dequeue(tuple_pqueue *q) {
 
 void MeldInterpretVM::p_enqueue(tuple_pqueue *queue, Time priority, tuple_t tuple,
                                 NodeID rt, record_type isNew) {
-    tuple_pentry *entry = (tuple_pentry*)malloc(sizeof(tuple_pentry));
+    tuple_pentry *entry = (tuple_pentry*)arena.allocate(sizeof(tuple_pentry));
 
     entry->tuple = tuple;
     entry->records = isNew;
@@ -2093,7 +2553,7 @@ inline void MeldInterpretVM::aggregate_recalc(tuple_entry *agg, Register *reg, b
 
     /** make copy */
     size_t size = TYPE_ARG_SIZE(type, agg_field);
-    void* accumulator = malloc(size);
+    void* accumulator = arena.allocate(size);
 
     aggregate_seed(agg_type, accumulator, start, agg_list->records.count, size);
 
@@ -2124,7 +2584,7 @@ inline void MeldInterpretVM::aggregate_recalc(tuple_entry *agg, Register *reg, b
         process_bytecode(agg->tuple, TYPE_START(type), 1, NOT_LINEAR, reg, PROCESS_TUPLE);
     }
 
-    free(accumulator);
+    arena.deallocate(accumulator, size);
 }
 
 /** ************* PROCESSING FUNCTIONS ************* */
@@ -2263,7 +2723,7 @@ void MeldInterpretVM::tuple_do_handle(tuple_type type, tuple_t tuple, int isNew,
                         void *aggTuple = queue_dequeue_pos(queue, current);
 
                         /** delete queue */
-                        free(agg_queue);
+                        arena.deallocate(agg_queue, sizeof(tuple_queue));
 
                         process_bytecode(aggTuple, TYPE_START(TUPLE_TYPE(aggTuple)),
                                          -1, NOT_LINEAR, reg, PROCESS_TUPLE);
@@ -2313,7 +2773,7 @@ void MeldInterpretVM::tuple_do_handle(tuple_type type, tuple_t tuple, int isNew,
     memcpy(tuple_cpy, tuple, TYPE_SIZE(type));
 
     /** create aggregate queue */
-    tuple_queue *agg_queue = (tuple_queue*)malloc(sizeof(tuple_queue));
+    tuple_queue *agg_queue = (tuple_queue*)arena.allocate(sizeof(tuple_queue));
 
     queue_init(agg_queue);
 
@@ -2520,6 +2980,12 @@ MeldInterpretVM::print_bytecode(const unsigned char *pc) {
 }
 #endif
 
+/** Instructions are executed from the threaded form of the program with GCC and Clang, which
+ * support label addresses, or through the switch, which also traces them, with DEBUG_INSTRS */
+#if defined(__GNUC__) && !defined(DEBUG_INSTRS)
+#define MELD_THREADED_DISPATCH
+#endif
+
 int MeldInterpretVM::process_bytecode (tuple_t tuple, const unsigned char *pc, int isNew, int isLinear,
                                        Register *reg, meld_byte state) {
 #ifdef DEBUG_INSTRS
@@ -2559,6 +3025,149 @@ int MeldInterpretVM::process_bytecode (tuple_t tuple, const unsigned char *pc, i
     /** Only if process_bytecode not called by iter, */
     /** because otherwise the tuple is already in a register */
 
+#ifdef MELD_THREADED_DISPATCH
+    if (threadedDispatch) {
+        const ThreadedInstr *ip = getThreadedInstr(pc);
+        if (ip) {
+            /** Handlers of the kinds of threaded instructions, in their order (see ThreadedKind) */
+            static const void *const handlers[NB_THREADED_KINDS] = {
+                &&t_SWITCH,
+                &&t_RETURN, &&t_NEXT, &&t_RETURN_LINEAR, &&t_RETURN_DERIVED,
+                &&t_ITER, &&t_RESET_LINEAR, &&t_SKIP, &&t_IF, &&t_JUMP,
+                &&t_MVCONSTREG, &&t_MVREGREG, &&t_MVFIELDREG, &&t_MVREGFIELD, &&t_MVFIELDFIELD, &&t_NOT,
+                &&t_ADDRNOTEQUAL, &&t_ADDREQUAL, &&t_INTMINUS, &&t_INTEQUAL, &&t_INTNOTEQUAL, &&t_INTPLUS, &&t_INTLESSER,
+                &&t_INTGREATEREQUAL, &&t_BOOLOR, &&t_INTLESSEREQUAL, &&t_INTGREATER, &&t_INTMUL, &&t_INTDIV, &&t_INTMOD,
+                &&t_FLOATPLUS, &&t_FLOATMINUS, &&t_FLOATMUL, &&t_FLOATDIV, &&t_FLOATEQUAL, &&t_FLOATNOTEQUAL,
+                &&t_FLOATLESSER, &&t_FLOATLESSEREQUAL, &&t_FLOATGREATER, &&t_FLOATGREATEREQUAL,
+                &&t_BOOLEQUAL, &&t_BOOLNOTEQUAL,
+                &&t_SEND, &&t_SEND_DELAY, &&t_MVINTFIELD, &&t_MVHOSTFIELD, &&t_MVFLOATFIELD, &&t_MVHOSTREG,
+                &&t_ALLOC, &&t_CALL1, &&t_ADDTUPLE, &&t_RUNACTION, &&t_UPDATE, &&t_REMOVE
+            };
+            static const bool bound = bindThreadedCode(handlers);
+            (void)bound;
+
+            /** Each handler jumps to the handler of the next instruction, with operands
+             * already decoded, as the byte code cases of the switch below do */
+#define THREADED_NEXT(i) do { ip = (i); goto *ip->handler; } while (0)
+#define THREADED_OP(kind, expr)                                         \
+            t_##kind: {                                                 \
+                Register *arg1 = &reg[ip->src];                         \
+                Register *arg2 = &reg[ip->src2];                        \
+                Register *dest = &reg[ip->dst];                         \
+                *dest = (expr);                                         \
+                THREADED_NEXT(ip + 1);                                \
+            }
+#define THREADED_CALL(kind, call)                                       \
+            t_##kind:                                                   \
+                call;                                                   \
+                THREADED_NEXT(ip + 1);
+
+            goto *ip->handler;
+
+        t_SWITCH:
+            pc = ip->pc;
+            goto eval_loop;
+        t_RETURN:
+            return RET_RET;
+        t_NEXT:
+            return RET_NEXT;
+        t_RETURN_LINEAR:
+            return RET_LINEAR;
+        t_RETURN_DERIVED:
+            return RET_DERIVED;
+        t_ITER: {
+            const int ret = execute_iter (ip->pc, reg, isNew, isLinear);
+            if(ret == RET_LINEAR)
+                return RET_LINEAR;
+            if(ret == RET_DERIVED && isLinear)
+                return RET_DERIVED;
+            if(ret == RET_RET)
+                return RET_RET;
+            THREADED_NEXT(ip->target);
+        }
+        t_RESET_LINEAR:
+            process_bytecode(tuple, ip->pc + RESET_LINEAR_BASE, isNew, NOT_LINEAR, reg, PROCESS_ITER);
+            THREADED_NEXT(ip->target);
+        t_SKIP:
+            THREADED_NEXT(ip + 1);
+        t_IF:
+            if (!(unsigned char)reg[ip->src]) THREADED_NEXT(ip->target);
+            THREADED_NEXT(ip + 1);
+        t_JUMP:
+            THREADED_NEXT(ip->target);
+        t_MVCONSTREG:
+            reg[ip->dst] = ip->value;
+            THREADED_NEXT(ip + 1);
+        t_MVREGREG:
+            reg[ip->dst] = reg[ip->src];
+            THREADED_NEXT(ip + 1);
+        t_MVFIELDREG: {
+            tuple_t tpl = (tuple_t)reg[ip->src];
+            memcpy(&reg[ip->dst], GET_TUPLE_FIELD(tpl, ip->srcField), TYPE_ARG_SIZE(TUPLE_TYPE(tpl), ip->srcField));
+            THREADED_NEXT(ip + 1);
+        }
+        t_MVREGFIELD: {
+            tuple_t tpl = (tuple_t)reg[ip->dst];
+            memcpy(GET_TUPLE_FIELD(tpl, ip->dstField), &reg[ip->src], TYPE_ARG_SIZE(TUPLE_TYPE(tpl), ip->dstField));
+            THREADED_NEXT(ip + 1);
+        }
+        t_MVFIELDFIELD: {
+            tuple_t srcTpl = (tuple_t)reg[ip->src];
+            tuple_t dstTpl = (tuple_t)reg[ip->dst];
+            memcpy(GET_TUPLE_FIELD(dstTpl, ip->dstField), GET_TUPLE_FIELD(srcTpl, ip->srcField),
+                   TYPE_ARG_SIZE(TUPLE_TYPE(dstTpl), ip->dstField));
+            THREADED_NEXT(ip + 1);
+        }
+        t_NOT:
+            reg[ip->dst] = MELD_BOOL(&reg[ip->src]) > 0 ? 0 : 1;
+            THREADED_NEXT(ip + 1);
+
+            THREADED_OP(ADDRNOTEQUAL, MELD_NODE_ID(arg1) != MELD_NODE_ID(arg2))
+            THREADED_OP(ADDREQUAL, MELD_NODE_ID(arg1) == MELD_NODE_ID(arg2))
+            THREADED_OP(INTMINUS, MELD_INT(arg1) - MELD_INT(arg2))
+            THREADED_OP(INTEQUAL, MELD_INT(arg1) == MELD_INT(arg2))
+            THREADED_OP(INTNOTEQUAL, MELD_INT(arg1) != MELD_INT(arg2))
+            THREADED_OP(INTPLUS, MELD_INT(arg1) + MELD_INT(arg2))
+            THREADED_OP(INTLESSER, MELD_INT(arg1) < MELD_INT(arg2))
+            THREADED_OP(INTGREATEREQUAL, MELD_INT(arg1) >= MELD_INT(arg2))
+            THREADED_OP(BOOLOR, MELD_BOOL(arg1) | MELD_BOOL(arg2))
+            THREADED_OP(INTLESSEREQUAL, MELD_INT(arg1) <= MELD_INT(arg2))
+            THREADED_OP(INTGREATER, MELD_INT(arg1) > MELD_INT(arg2))
+            THREADED_OP(INTMUL, MELD_INT(arg1) * MELD_INT(arg2))
+            THREADED_OP(INTDIV, MELD_INT(arg1) / MELD_INT(arg2))
+            THREADED_OP(INTMOD, MELD_INT(arg1) % MELD_INT(arg2))
+            THREADED_OP(FLOATPLUS, MELD_FLOAT(arg1) + MELD_FLOAT(arg2))
+            THREADED_OP(FLOATMINUS, MELD_FLOAT(arg1) - MELD_FLOAT(arg2))
+            THREADED_OP(FLOATMUL, MELD_FLOAT(arg1) * MELD_FLOAT(arg2))
+            THREADED_OP(FLOATDIV, MELD_FLOAT(arg1) / MELD_FLOAT(arg2))
+            THREADED_OP(FLOATEQUAL, MELD_FLOAT(arg1) == MELD_FLOAT(arg2))
+            THREADED_OP(FLOATNOTEQUAL, MELD_FLOAT(arg1) != MELD_FLOAT(arg2))
+            THREADED_OP(FLOATLESSER, MELD_FLOAT(arg1) < MELD_FLOAT(arg2))
+            THREADED_OP(FLOATLESSEREQUAL, MELD_FLOAT(arg1) <= MELD_FLOAT(arg2))
+            THREADED_OP(FLOATGREATER, MELD_FLOAT(arg1) > MELD_FLOAT(arg2))
+            THREADED_OP(FLOATGREATEREQUAL, MELD_FLOAT(arg1) >= MELD_FLOAT(arg2))
+            THREADED_OP(BOOLEQUAL, MELD_BOOL(arg1) == MELD_BOOL(arg2))
+            THREADED_OP(BOOLNOTEQUAL, MELD_BOOL(arg1) != MELD_BOOL(arg2))
+
+            THREADED_CALL(SEND, execute_send (ip->pc, reg, isNew))
+            THREADED_CALL(SEND_DELAY, execute_send_delay (ip->pc, reg, isNew))
+            THREADED_CALL(MVINTFIELD, execute_mvintfield (ip->pc, reg))
+            THREADED_CALL(MVHOSTFIELD, execute_mvhostfield (ip->pc, reg))
+            THREADED_CALL(MVFLOATFIELD, execute_mvfloatfield (ip->pc, reg))
+            THREADED_CALL(MVHOSTREG, execute_mvhostreg (ip->pc, reg))
+            THREADED_CALL(ALLOC, execute_alloc (ip->pc, reg))
+            THREADED_CALL(CALL1, execute_call1 (ip->pc, reg))
+            THREADED_CALL(ADDTUPLE, execute_addtuple (ip->pc, reg, isNew))
+            THREADED_CALL(RUNACTION, execute_run_action (ip->pc, reg, isNew))
+            THREADED_CALL(UPDATE, if (PROCESS_TYPE(state) == PROCESS_ITER) execute_update (ip->pc, reg))
+            THREADED_CALL(REMOVE, execute_remove (ip->pc, reg, isNew))
+#undef THREADED_NEXT
+#undef THREADED_OP
+#undef THREADED_CALL
+        }
+    }
+#endif
+
     for (;;) {
     eval_loop:
 #ifdef DEBUG_INSTRS
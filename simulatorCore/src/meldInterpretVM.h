@@ -9,9 +9,12 @@
 #include <sys/timeb.h>
 #include <memory>
 #include <map>
+#include <vector>
+#include <atomic>
 
 #include "color.h"
 #include "buildingBlock.h"
+#include "meldInterpretArena.h"
 
 #include <sys/timeb.h>
 
@@ -19,9 +22,9 @@
 Definitions of all the data structures and types used by the VM.
 *******************************************************************************/
 
-/* allocation for tuples */
-#define ALLOC_TUPLE(x) malloc(x)
-#define FREE_TUPLE(x) free(x)
+/* allocation for tuples, from the arena of the VM (only usable in MeldInterpretVM) */
+#define ALLOC_TUPLE(x) arena.allocate(x)
+#define FREE_TUPLE(x) freeTuple(x)
 
 /* Meld Types */
 typedef void* tuple_t;
@@ -628,14 +631,86 @@ private:
     static bool configured;
     bool firstStart;
 
+    /* Whether this VM has tuples or rules left to process, see setHasWork */
+    bool hasWork;
+    /* Position of this VM in busyVMs while it has work */
+    size_t busyIndex;
+    /* VMs having work, so that equilibrium does not scan every VM */
+    static vector<MeldInterpretVM*> busyVMs;
+    /* Size of busyVMs, readable from any thread */
+    static std::atomic<size_t> nbBusyVMs;
+
+    /* Tuples, queue entries and aggregate queues of this VM, released with it */
+    TupleArena arena;
+    /* Allocation statistics of the arenas of the destroyed VMs */
+    static TupleArena::Stats retiredArenaStats;
+
+    /* Rules including each predicate, once per occurrence, built by readProgram */
+    static vector<vector<meld_byte>> rulesOfPredicate;
+    /* Number of times each rule was processed, and rule states updated, by all the VMs */
+    static vector<uint64_t> nbRuleExecutions;
+    static uint64_t nbRuleStateUpdates;
+    static uint64_t nbIdleSteps;
+
+    /* Whether the database holds no tuple of each predicate, as seen by the rules */
+    vector<bool> predicateIsEmpty;
+    /* Number of included predicates missing from the database, for each rule */
+    vector<meld_byte> nbMissingPredicates;
+    /* Non persistent rules whose included predicates are all in the database, as a bitmask */
+    vector<uint64_t> activeRules;
+    /* Number of such rules, persistent ones included */
+    int nbActiveRules;
+
+    /* Pre-decoded form of an instruction, executed by process_bytecode without reading the byte code.
+     * Operands are resolved when the program is loaded: registers, fields, constants and successors. */
+    struct ThreadedInstr {
+        const void *handler;            /* Code of process_bytecode executing the instruction */
+        meld_byte kind;                 /* Index of that code, see bindThreadedCode */
+        meld_byte src, src2, dst;       /* Registers: source(s) and destination, or registers of the tuples */
+        meld_byte srcField, dstField;   /* Fields read and written, in the tuples of src and dst */
+        Register value;                 /* Constant moved to dst */
+        const unsigned char *pc;        /* Instruction in the byte code, for those decoded by execute_* */
+        const ThreadedInstr *target;    /* Instruction jumped to, or processed when the condition fails */
+    };
+    /* Threaded form of the program, shared by all VMs, built by readProgram. Instructions are in
+     * the order of the byte code, so that each one is followed by the one processed next. */
+    static vector<ThreadedInstr> threadedProg;
+    /* Index in threadedProg of the instruction at each offset of meld_prog, -1 for none */
+    static vector<int> threadedIndex;
+    /* Whether process_bytecode executes the threaded form, or the byte code through its switch */
+    static bool threadedDispatch;
+
+    static void buildRuleIndex();
+    static size_t instructionSize(meld_byte op);
+    static vector<size_t> validateProgram(size_t size);
+    static void buildThreadedCode(size_t size, const vector<size_t> &instructions);
+    static bool bindThreadedCode(const void *const *handlers);
+    /* Returns the threaded form of the instruction at pc, NULL if it has none */
+    static inline const ThreadedInstr* getThreadedInstr(const unsigned char *pc) {
+        const size_t offset = pc - meld_prog;
+        if (offset >= threadedIndex.size() || threadedIndex[offset] < 0) return NULL;
+        return &threadedProg[threadedIndex[offset]];
+    };
+    void initRuleStates();
+    void setRuleActive(meld_byte rid, bool active);
+    void updatePredicateState(tuple_type type);
+    /* Called whenever a queue changes, only the queues of the database matter */
+    inline void queueChanged(tuple_queue *queue) {
+        if (queue >= tuples && queue < tuples + NUM_TYPES) updatePredicateState(queue - tuples);
+    };
+
+    void setHasWork(bool w);
+    inline void freeTuple(tuple_t tuple) { arena.deallocate(tuple, TYPE_SIZE(TUPLE_TYPE(tuple))); };
+
 public:
-    static map<int, MeldInterpretVM*> vmMap;
+    //!< VMs indexed by the id of their block, NULL for ids without VM
+    static vector<MeldInterpretVM*> vmMap;
     static const unsigned char * meld_prog;
     static char **tuple_names;
     static char **rule_names;
 
     Time currentLocalDate;
-    bool hasWork, polling, deterministicSet;
+    bool polling, deterministicSet;
     NodeID *neighbors;
     tuple_type TYPE_INIT;
     tuple_type TYPE_EDGE;
@@ -655,10 +730,22 @@ public:
     ~MeldInterpretVM();
     void processOneRule();
     bool isWaiting();
+    bool getHasWork() const { return hasWork; };
+    static MeldInterpretVM* getVM(NodeID id) { return id < vmMap.size() ? vmMap[id] : NULL; };
+    //!< @brief Allocation statistics of the tuple arena of this VM
+    const TupleArena::Stats& getArenaStats() const { return arena.getStats(); };
+    //!< @brief Allocation statistics of the tuple arenas of all the VMs, destroyed ones included
+    static TupleArena::Stats getTotalArenaStats();
+    //!< @brief True when no VM of an alive block has work left, O(1) unless some has
     static bool equilibrium();
+    //!< @brief Number of times each rule was processed and rule states updated, empty if no program is loaded
+    static string getRuleStats();
     inline static bool isInDebuggingMode() { return debugging; };
     static void setConfiguration(string path, bool d);
     static void readProgram(string path);
+    /* Executes the byte code through the switch of process_bytecode rather than its threaded
+     * form, e.g. to compare both (see utilities/benchmarks/meldDispatchBench) */
+    static void setThreadedDispatch(bool enabled) { threadedDispatch = enabled; };
     static int characterCount(string in, char character);
 
     meld_byte updateRuleState(meld_byte rid);
@@ -308,4 +308,42 @@ bool MeldProcessScheduler::schedule(Event *ev) {
     return(true);
 }
 
+void MeldProcessScheduler::removeEventsToBlock(BuildingBlock *bb) {
+    lock();
+    multimap<Time, EventPtr>::iterator it = eventsMap.begin();
+    while (it != eventsMap.end()) {
+        if (it->second->getConcernedBlock() == bb) {
+            it = eventsMap.erase(it);
+        } else {
+            it++;
+        }
+    }
+    eventsMapSize = eventsMap.size();
+    unlock();
+}
+
+int MeldProcessScheduler::getNbEventsById(int id) {
+    lock();
+    int count = 0;
+    for (const pair<const Time, EventPtr> &p : eventsMap) {
+        if (p.second->eventType == id)
+            count++;
+    }
+    unlock();
+    return count;
+}
+
+bool MeldProcessScheduler::hasEvent(int id, unsigned long blockId) {
+    lock();
+    bool found = false;
+    for (const pair<const Time, EventPtr> &p : eventsMap) {
+        if (p.second->eventType == id && p.second->getConcernedBlock()->blockId == blockId) {
+            found = true;
+            break;
+        }
+    }
+    unlock();
+    return found;
+}
+
 } // MeldProcess namespace
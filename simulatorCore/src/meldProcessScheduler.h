@@ -19,6 +19,11 @@ namespace MeldProcess {
 
 class MeldProcessScheduler : public BaseSimulator::Scheduler {
 protected:
+	// In fastest mode, simultaneous events are ordered by random number and block id for
+	//  determinism with the external VMs, hence this scheduler keeps its own ordered event list
+	//  instead of the generic Scheduler::eventsQueue.
+	multimap<Time,EventPtr> eventsMap;
+
 	MeldProcessScheduler();
 	virtual ~MeldProcessScheduler();
 	void* startPaused(/*void *param */);
@@ -56,6 +61,10 @@ public:
 	}
 	
 	bool schedule(Event *ev);
+	// Operate on eventsMap instead of Scheduler::eventsQueue
+	void removeEventsToBlock(BuildingBlock *bb);
+	int getNbEventsById(int id);
+	bool hasEvent(int id, unsigned long blockId);
 	
 	void SemWaitOrReadDebugMessage();
 	
@@ -0,0 +1,218 @@
+/*! @file meldProcessShm.cpp
+ * @brief Shared memory transport of the VM commands between the simulator and the MeldProcess VMs.
+ * @date 18/10/2026
+ */
+
+#include "meldProcessShm.h"
+
+#include <new>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace std;
+
+namespace MeldProcess {
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "atomics of the shared region must be lock-free");
+static_assert((ShmRing::capacity & (ShmRing::capacity - 1)) == 0, "ring capacity must be a power of two");
+static_assert(ShmRing::maxCommandWords <= ShmRing::capacity, "a command must fit in a ring");
+
+//===========================================================================================================
+//
+//          ShmRing  (struct)
+//
+//===========================================================================================================
+
+void ShmRing::futexWait(atomic<uint32_t> *word, uint32_t value, int timeoutMs) {
+#ifdef __linux__
+	// Shared futex: the word is mapped by several processes
+	struct timespec ts = { timeoutMs / 1000, (timeoutMs % 1000) * 1000000L };
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, value,
+			timeoutMs >= 0 ? &ts : NULL, NULL, 0);
+#else
+	if (word->load(memory_order_acquire) == value) usleep(50);
+#endif
+}
+
+void ShmRing::futexWake(atomic<uint32_t> *word) {
+#ifdef __linux__
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+#else
+	(void)word;
+#endif
+}
+
+bool ShmRing::tryPush(const uint64_t *command) {
+	const uint32_t nbWords = getNbWords(command[0]);
+	if (nbWords > maxCommandWords) return false;
+
+	const uint32_t t = tail.load(memory_order_relaxed);
+	if (capacity - (t - head.load(memory_order_acquire)) < nbWords) return false;
+
+	for (uint32_t i = 0; i < nbWords; i++) data[(t + i) & (capacity - 1)] = command[i];
+	tail.store(t + nbWords, memory_order_release);
+
+	// Orders the publication before the check of the consumer flag (see waitForCommand)
+	atomic_thread_fence(memory_order_seq_cst);
+	if (consumerWaiting.load(memory_order_relaxed)) futexWake(&tail);
+	return true;
+}
+
+bool ShmRing::tryPop(uint64_t *buffer) {
+	const uint32_t h = head.load(memory_order_relaxed);
+	if (tail.load(memory_order_acquire) == h) return false;
+
+	const uint32_t nbWords = getNbWords(data[h & (capacity - 1)]);
+	for (uint32_t i = 0; i < nbWords; i++) buffer[i] = data[(h + i) & (capacity - 1)];
+	head.store(h + nbWords, memory_order_release);
+
+	atomic_thread_fence(memory_order_seq_cst);
+	if (producerWaiting.load(memory_order_relaxed)) futexWake(&head);
+	return true;
+}
+
+void ShmRing::waitForCommand(int timeoutMs) {
+	const uint32_t t = tail.load(memory_order_acquire);
+	if (t != head.load(memory_order_relaxed)) return;
+	consumerWaiting.store(1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	// The futex does not sleep if tail has changed since it was read
+	if (tail.load(memory_order_relaxed) == t) futexWait(&tail, t, timeoutMs);
+	consumerWaiting.store(0, memory_order_relaxed);
+}
+
+void ShmRing::waitForSpace(int timeoutMs) {
+	const uint32_t h = head.load(memory_order_acquire);
+	if (tail.load(memory_order_relaxed) - h <= capacity - maxCommandWords) return;
+	producerWaiting.store(1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	if (head.load(memory_order_relaxed) == h) futexWait(&head, h, timeoutMs);
+	producerWaiting.store(0, memory_order_relaxed);
+}
+
+//===========================================================================================================
+//
+//          ShmRegion  (class)
+//
+//===========================================================================================================
+
+static size_t alignUp(size_t n, size_t a) { return (n + a - 1) / a * a; }
+
+size_t ShmRegion::getReadyOffset() {
+	return alignUp(sizeof(Header), alignof(ShmSlot));
+}
+
+size_t ShmRegion::getSlotsOffset(uint32_t nbSlots) {
+	return alignUp(getReadyOffset() + (nbSlots + 63) / 64 * sizeof(uint64_t), alignof(ShmSlot));
+}
+
+ShmRegion::ShmRegion(const string &n, bool o, void *b, size_t s) : name(n), owner(o), base(b), size(s) {
+	header = static_cast<Header*>(base);
+	ready = reinterpret_cast<atomic<uint64_t>*>(static_cast<char*>(base) + getReadyOffset());
+	slots = reinterpret_cast<ShmSlot*>(static_cast<char*>(base) + getSlotsOffset(header->nbSlots));
+}
+
+ShmRegion::~ShmRegion() {
+	munmap(base, size);
+	if (owner) shm_unlink(name.c_str());
+}
+
+ShmRegion* ShmRegion::create(uint32_t nbSlots) {
+	const string name = "/visiblesim-" + to_string(getpid());
+	const size_t size = getSlotsOffset(nbSlots) + nbSlots * sizeof(ShmSlot);
+
+	int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	if (fd == -1) return NULL;
+	// Pages are zero-filled, hence all the positions and flags are 0, and only the pages of the
+	// rings actually used are allocated
+	void *base = MAP_FAILED;
+	if (ftruncate(fd, size) == 0)
+		base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED) {
+		shm_unlink(name.c_str());
+		return NULL;
+	}
+
+	Header *header = static_cast<Header*>(base);
+	header->nbSlots = nbSlots;
+	header->ringCapacity = ShmRing::capacity;
+	header->version = version;
+	header->magic = magic;
+	return new ShmRegion(name, true, base, size);
+}
+
+ShmRegion* ShmRegion::attach(const string &name) {
+	int fd = shm_open(name.c_str(), O_RDWR, 0);
+	if (fd == -1) return NULL;
+	struct stat st;
+	void *base = MAP_FAILED;
+	if (fstat(fd, &st) == 0 and (size_t)st.st_size >= sizeof(Header))
+		base = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED) return NULL;
+
+	const Header *header = static_cast<const Header*>(base);
+	if (header->magic != magic or header->version != version or header->ringCapacity != ShmRing::capacity
+		or (size_t)st.st_size < getSlotsOffset(header->nbSlots) + header->nbSlots * sizeof(ShmSlot)) {
+		munmap(base, st.st_size);
+		return NULL;
+	}
+	return new ShmRegion(name, false, base, st.st_size);
+}
+
+bool ShmRegion::hasReadySlots() const {
+	for (uint32_t w = 0; w < (header->nbSlots + 63) / 64; w++)
+		if (ready[w].load(memory_order_relaxed)) return true;
+	return false;
+}
+
+void ShmRegion::getReadySlots(vector<uint32_t> &readySlots) {
+	for (uint32_t w = 0; w < (header->nbSlots + 63) / 64; w++) {
+		if (ready[w].load(memory_order_relaxed) == 0) continue;
+		uint64_t bits = ready[w].exchange(0, memory_order_acquire);
+		while (bits) {
+			readySlots.push_back(w * 64 + __builtin_ctzll(bits));
+			bits &= bits - 1;
+		}
+	}
+}
+
+void ShmRegion::waitForVMs(int timeoutMs) {
+	const uint32_t d = header->doorbell.load(memory_order_acquire);
+	if (hasReadySlots()) return;
+	header->simulatorWaiting.store(1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	if (not hasReadySlots()) ShmRing::futexWait(&header->doorbell, d, timeoutMs);
+	header->simulatorWaiting.store(0, memory_order_relaxed);
+}
+
+bool ShmRegion::trySendToSimulator(uint32_t slot, const uint64_t *command) {
+	if (not slots[slot].toSimulator.tryPush(command)) return false;
+
+	// The flag is set after the command is pushed: the simulator clears it before draining the ring
+	ready[slot / 64].fetch_or(1ull << (slot % 64), memory_order_release);
+	header->doorbell.fetch_add(1, memory_order_seq_cst);
+	if (header->simulatorWaiting.load(memory_order_seq_cst)) ShmRing::futexWake(&header->doorbell);
+	return true;
+}
+
+void ShmRegion::sendToSimulator(uint32_t slot, const uint64_t *command) {
+	while (not trySendToSimulator(slot, command))
+		slots[slot].toSimulator.waitForSpace(-1);
+}
+
+void ShmRegion::receiveFromSimulator(uint32_t slot, uint64_t *buffer) {
+	while (not slots[slot].toVM.tryPop(buffer))
+		slots[slot].toVM.waitForCommand(-1);
+}
+
+} // MeldProcess namespace
@@ -0,0 +1,162 @@
+/*! @file meldProcessShm.h
+ * @brief Shared memory transport of the VM commands between the simulator and the MeldProcess
+ *  VMs, alternative to a TCP connection per VM (see MeldProcessVM).
+ *
+ *  The simulator creates a single region, mapped by itself and by every VM process, holding a
+ *  pair of single-producer single-consumer rings per VM: one to the VM, one to the simulator.
+ *  A VM sending a command flags its slot in a bitmap of the region and rings a doorbell, so that
+ *  the simulator only drains the rings of the VMs having sent commands. Processes waiting for a
+ *  command, or for space in a full ring, sleep on a futex (Linux, polling elsewhere).
+ *
+ *  A VM finds the name of the region and its slot in the VISIBLESIM_SHM and VISIBLESIM_SHM_SLOT
+ *  environment variables, attaches with ShmRegion::attach and sets the attached flag of its slot,
+ *  which meldShmAttach does (see meldProcessShmClient.h). This header only depends on the
+ *  standard library, so that the VM can include it.
+ * @date 18/10/2026
+ */
+
+#ifndef MELDPROCESSSHM_H_
+#define MELDPROCESSSHM_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace MeldProcess {
+
+/**
+ * @brief Ring of VM commands, written by a single process and read by a single other one.
+ *  Commands are stored as they are sent on a socket: words of 64 bits, the first one being the
+ *  size of the content in bytes (see VMCommand).
+ *  Positions count the words written and read since the creation, modulo 2^32.
+ */
+struct ShmRing {
+	static const uint32_t capacity = 1024; //!< Words, a power of two
+	static const uint32_t maxCommandWords = 544 / sizeof(uint64_t); //!< VM_COMMAND_MAX_LENGHT
+
+	alignas(64) std::atomic<uint32_t> tail; //!< Words written, futex of a waiting consumer
+	std::atomic<uint32_t> consumerWaiting;
+	alignas(64) std::atomic<uint32_t> head; //!< Words read, futex of a waiting producer
+	std::atomic<uint32_t> producerWaiting;
+	alignas(64) uint64_t data[capacity];
+
+	//!< @brief Number of words of a command, from its first word
+	static uint32_t getNbWords(uint64_t contentSize) { return 1 + (uint32_t)((contentSize + sizeof(uint64_t) - 1) / sizeof(uint64_t)); }
+
+	/**
+	 * @brief Appends a command, unless the ring is full. Producer only.
+	 * @param command command, of at most maxCommandWords words
+	 * @return true if the command was appended
+	 */
+	bool tryPush(const uint64_t *command);
+
+	/**
+	 * @brief Removes the first command, if any. Consumer only.
+	 * @param buffer receives the command, of maxCommandWords words at least
+	 * @return true if a command was removed
+	 */
+	bool tryPop(uint64_t *buffer);
+
+	bool isEmpty() const { return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire); }
+
+	//!< @brief Sleeps until a command is pushed, at most timeoutMs (-1 for no limit). Consumer only.
+	void waitForCommand(int timeoutMs);
+	//!< @brief Sleeps until a command is popped, at most timeoutMs (-1 for no limit). Producer only.
+	void waitForSpace(int timeoutMs);
+
+	static void futexWait(std::atomic<uint32_t> *word, uint32_t value, int timeoutMs);
+	static void futexWake(std::atomic<uint32_t> *word);
+};
+
+//!< Rings of a VM
+struct ShmSlot {
+	std::atomic<uint32_t> attached; //!< Set by the VM once it has attached the region
+	ShmRing toVM;
+	ShmRing toSimulator;
+};
+
+/**
+ * @brief Region shared by the simulator and the VMs, one slot per VM
+ */
+class ShmRegion {
+public:
+	static constexpr const char *nameVariable = "VISIBLESIM_SHM";
+	static constexpr const char *slotVariable = "VISIBLESIM_SHM_SLOT";
+	static const uint32_t magic = 0x4d454c44; //!< "MELD"
+	static const uint32_t version = 1;
+
+private:
+	//!< Beginning of the region, followed by the bitmap of the ready slots, then by the slots
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t nbSlots;
+		uint32_t ringCapacity;
+		alignas(64) std::atomic<uint32_t> doorbell; //!< Incremented by the VMs sending a command, futex of the simulator
+		std::atomic<uint32_t> simulatorWaiting;
+	};
+
+	std::string name;
+	bool owner; //!< Created by this process, which unlinks the region
+	void *base;
+	size_t size;
+	Header *header;
+	std::atomic<uint64_t> *ready; //!< Bit i set when slot i has commands for the simulator
+	ShmSlot *slots;
+
+	ShmRegion(const std::string &n, bool o, void *b, size_t s);
+	static size_t getReadyOffset();
+	static size_t getSlotsOffset(uint32_t nbSlots);
+	bool hasReadySlots() const;
+public:
+	~ShmRegion();
+	ShmRegion(const ShmRegion&) = delete;
+	ShmRegion& operator=(const ShmRegion&) = delete;
+
+	/**
+	 * @brief Creates a region for nbSlots VMs, named after the pid of the simulator
+	 * @return the region, NULL on error
+	 */
+	static ShmRegion* create(uint32_t nbSlots);
+	/**
+	 * @brief Maps the region created by the simulator, from a VM
+	 * @return the region, NULL on error or version mismatch
+	 */
+	static ShmRegion* attach(const std::string &name);
+
+	const std::string& getName() const { return name; }
+	uint32_t getNbSlots() const { return header->nbSlots; }
+	ShmSlot& getSlot(uint32_t slot) { return slots[slot]; }
+
+	// Simulator end
+	/**
+	 * @brief Sends a command to a VM, unless its ring is full
+	 * @return true if the command was sent
+	 */
+	bool trySendToVM(uint32_t slot, const uint64_t *command) { return slots[slot].toVM.tryPush(command); }
+	/**
+	 * @brief Collects the slots which have sent commands since the last call, clearing their flag.
+	 *  Each ring is then to be drained until empty.
+	 */
+	void getReadySlots(std::vector<uint32_t> &readySlots);
+	bool tryReceiveFromVM(uint32_t slot, uint64_t *buffer) { return slots[slot].toSimulator.tryPop(buffer); }
+	//!< @brief Sleeps until a VM sends a command, at most timeoutMs (-1 for no limit)
+	void waitForVMs(int timeoutMs);
+
+	// VM end
+	/**
+	 * @brief Sends a command to the simulator, unless the ring of the slot is full, and rings the doorbell
+	 * @return true if the command was sent
+	 */
+	bool trySendToSimulator(uint32_t slot, const uint64_t *command);
+	//!< @brief Sends a command to the simulator, sleeping while the ring of the slot is full
+	void sendToSimulator(uint32_t slot, const uint64_t *command);
+	//!< @brief Receives a command from the simulator, sleeping until one is sent
+	void receiveFromSimulator(uint32_t slot, uint64_t *buffer);
+};
+
+} // MeldProcess namespace
+
+#endif // MELDPROCESSSHM_H_
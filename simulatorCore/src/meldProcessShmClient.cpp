@@ -0,0 +1,52 @@
+/*! @file meldProcessShmClient.cpp
+ * @brief VM end of the shared memory transport of the VM commands.
+ * @date 18/10/2026
+ */
+
+#include "meldProcessShmClient.h"
+#include "meldProcessShm.h"
+
+#include <cstdlib>
+#include <cerrno>
+#include <string>
+
+using namespace std;
+using namespace MeldProcess;
+
+static ShmRegion *region = NULL;
+static uint32_t slot = 0;
+
+int meldShmAttach(void) {
+	const char *name = getenv(ShmRegion::nameVariable);
+	const char *slotStr = getenv(ShmRegion::slotVariable);
+	if (name == NULL || slotStr == NULL) return 0;
+	if (region != NULL) return 1;
+
+	char *end;
+	errno = 0;
+	const unsigned long s = strtoul(slotStr, &end, 10);
+	if (errno != 0 || end == slotStr || *end != '\0') return -1;
+	ShmRegion *r = ShmRegion::attach(name);
+	if (r == NULL) return -1;
+	if (s >= r->getNbSlots()) {
+		delete r;
+		return -1;
+	}
+	region = r;
+	slot = (uint32_t)s;
+	region->getSlot(slot).attached.store(1);
+	return 1;
+}
+
+void meldShmSend(const uint64_t *command) {
+	region->sendToSimulator(slot, command);
+}
+
+void meldShmReceive(uint64_t *buffer) {
+	region->receiveFromSimulator(slot, buffer);
+}
+
+void meldShmDetach(void) {
+	delete region;
+	region = NULL;
+}
@@ -0,0 +1,41 @@
+/*! @file meldProcessShmClient.h
+ * @brief VM end of the shared memory transport of the VM commands (see meldProcessShm.h), with
+ *  C linkage so that the MeldVM can call it in place of its socket.
+ *
+ *  A VM launched by a simulator run with -m <VMpath>:shm calls meldShmAttach first. If it returns
+ *  1, commands are then exchanged with meldShmSend and meldShmReceive, in the format used on the
+ *  socket: words of 64 bits, the first one being the size of the content in bytes. The VM is
+ *  linked with meldProcessShmClient.cpp and meldProcessShm.cpp.
+ * @date 18/10/2026
+ */
+
+#ifndef MELDPROCESSSHMCLIENT_H_
+#define MELDPROCESSSHMCLIENT_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Attaches the region and the slot named by the environment, and tells the simulator
+ * @return 1 once attached, 0 if the VM was not launched for shared memory, -1 on error
+ */
+int meldShmAttach(void);
+
+//!< @brief Sends a command to the simulator, sleeping while the ring of the VM is full
+void meldShmSend(const uint64_t *command);
+
+//!< @brief Receives a command from the simulator, sleeping until one is sent
+//!< @param buffer receives the command, of VM_COMMAND_MAX_LENGHT words at least
+void meldShmReceive(uint64_t *buffer);
+
+//!< @brief Unmaps the region
+void meldShmDetach(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MELDPROCESSSHMCLIENT_H_
@@ -33,13 +33,16 @@ string MeldProcessVM::vmPath;
 string MeldProcessVM::programPath;
 bool MeldProcessVM::debugging = false;
 map<int, MeldProcessVM*> MeldProcessVM::vmMap;
+ShmRegion *MeldProcessVM::shm = NULL;
+vector<MeldProcessVM*> MeldProcessVM::slotVMs;
+vector<uint32_t> MeldProcessVM::readySlots;
 
 MeldProcessVM::MeldProcessVM(BuildingBlock* bb){
 	int ret;
 	boost::system::error_code error;
 	stringstream vmLogFile;
 
-	assert(ios != NULL && acceptor != NULL);
+	assert((ios != NULL && acceptor != NULL) || shm != NULL);
 	hostBlock = bb;
 	currentLocalDate = 0; // mode fastest
 	hasWork = true; // mode fastest
@@ -53,15 +56,28 @@ MeldProcessVM::MeldProcessVM(BuildingBlock* bb){
 	// Start the VM
 	pid = 0;
 	memset(inBuffer,0,VM_COMMAND_MAX_LENGHT*sizeof(commandType));
+	slot = slotVMs.size();
+	if (shm != NULL) {
+		if (slot >= shm->getNbSlots()) {
+			cerr << "VisibleSim error: no shared memory slot left for the VM " << hostBlock->blockId
+				 << " (" << shm->getNbSlots() << " slots, see -m)" << endl;
+			exit(EXIT_FAILURE);
+		}
+		slotVMs.push_back(this);
+	}
 	mutex_ios.lock();
-	ios->notify_fork(boost::asio::io_service::fork_prepare);
+	if (ios) ios->notify_fork(boost::asio::io_service::fork_prepare);
 	pid = fork();
 	if(pid < 0) {ERRPUT << "Error when starting the VM" << endl;}
 	if(pid == 0) {
-		ios->notify_fork(boost::asio::io_service::fork_child);
+		if (ios) ios->notify_fork(boost::asio::io_service::fork_child);
 		mutex_ios.unlock();
-		acceptor->close();
+		if (acceptor) acceptor->close();
 		closeAllSockets();
+		if (shm != NULL) {
+			setenv(ShmRegion::nameVariable, shm->getName().c_str(), 1);
+			setenv(ShmRegion::slotVariable, to_string(slot).c_str(), 1);
+		}
 #ifdef LOGFILE
 		log_file.close();
 #endif
@@ -83,8 +99,22 @@ MeldProcessVM::MeldProcessVM(BuildingBlock* bb){
 			exit(EXIT_FAILURE);
 		}
 	}	
-	ios->notify_fork(boost::asio::io_service::fork_parent);
+	if (ios) ios->notify_fork(boost::asio::io_service::fork_parent);
 	mutex_ios.unlock();
+	if (shm != NULL) {
+		// The VM sets the attached flag of its slot once it has mapped the region
+		while (!shm->getSlot(slot).attached.load() && (pid != waitpid(pid, NULL, WNOHANG))) {
+			usleep(1000);
+		}
+		if (!shm->getSlot(slot).attached.load()) {
+			connectionError(vmLogFile.str());
+		}
+		idSent = false;
+		deterministicSet = false;
+		nbSentCommands = 0;
+		vmMap.insert(std::pair<int,MeldProcessVM*>(bb->blockId,this));
+		return;
+	}
 	socket = std::shared_ptr<tcp::socket>(new tcp::socket(*ios));
 	if (hostBlock->blockId == 1) {
 		bool connected = false;
@@ -97,20 +127,7 @@ MeldProcessVM::MeldProcessVM(BuildingBlock* bb){
             }
 		}
 		if(!connected) {
-			ifstream file (vmLogFile.str().c_str());
-			string line;
-			cerr << "VisibleSim error: unable to connect to the VM" << endl;
-			cerr << vmLogFile.str() << ":" << endl;
-			if (file.is_open()) {
-				while (!file.eof()) {
-					getline(file,line);
-					cerr << line;
-				}
-				cerr << endl;
-				file.close();
-			}
-			acceptor->close();
-			exit(EXIT_FAILURE);
+			connectionError(vmLogFile.str());
 		}
 	} else {
 		acceptor->accept(*(socket.get()));
@@ -122,6 +139,23 @@ MeldProcessVM::MeldProcessVM(BuildingBlock* bb){
 	vmMap.insert(std::pair<int,MeldProcessVM*>(bb->blockId,this));
 }
 
+void MeldProcessVM::connectionError(const string &vmLogFile) {
+	ifstream file (vmLogFile.c_str());
+	string line;
+	cerr << "VisibleSim error: unable to connect to the VM" << endl;
+	cerr << vmLogFile << ":" << endl;
+	if (file.is_open()) {
+		while (!file.eof()) {
+			getline(file,line);
+			cerr << line;
+		}
+		cerr << endl;
+		file.close();
+	}
+	if (acceptor) acceptor->close();
+	exit(EXIT_FAILURE);
+}
+
 void MeldProcessVM::asyncAcceptHandler(boost::system::error_code& error, bool* connected) {
 	if (error) {
 		*connected = false;
@@ -133,6 +167,9 @@ void MeldProcessVM::asyncAcceptHandler(boost::system::error_code& error, bool* c
 MeldProcessVM::~MeldProcessVM() {
 	closeSocket();
 	killProcess();
+	if (shm != NULL) {
+		slotVMs[slot] = NULL;
+	}
 }
 
 void MeldProcessVM::terminate() {
@@ -199,6 +236,22 @@ void MeldProcessVM::asyncReadCommand() {
 }
 
 int MeldProcessVM::sendCommand(VMCommand &command){
+	if (shm != NULL) {
+		if (command.getType() != VM_COMMAND_DEBUG) {
+			nbSentCommands++;
+			handleDeterministicMode(command);
+		}
+		// While the ring is full, the commands of the VMs are handled, the VM may wait for the simulator
+		while (!shm->trySendToVM(slot, command.getData())) {
+			if (pid == waitpid(pid, NULL, WNOHANG)) {
+				ERRPUT << "Connection to the VM "<< hostBlock->blockId << " lost" << endl;
+				return 0;
+			}
+			checkForReceivedCommands();
+			shm->getSlot(slot).toVM.waitForSpace(1);
+		}
+		return 1;
+	}
 	if (socket == NULL) {
 		ERRPUT << "Simulator is not connected to the VM "<< hostBlock->blockId << endl;
 		return 0;
@@ -226,6 +279,21 @@ void MeldProcessVM::handle_write(const boost::system::error_code& error)
 }
 
 void MeldProcessVM::checkForReceivedCommands() {
+	if (shm != NULL) {
+		// Not while a command is being handled, which may send a command to a VM whose ring is full
+		if (!mutex_ios.try_lock()) return;
+		readySlots.clear();
+		shm->getReadySlots(readySlots);
+		for (uint32_t s : readySlots) {
+			MeldProcessVM *vm = slotVMs[s];
+			if (vm == NULL) continue;
+			while (shm->tryReceiveFromVM(s, vm->inBuffer)) {
+				vm->handleInBuffer();
+			}
+		}
+		mutex_ios.unlock();
+		return;
+	}
 	if (ios != NULL) {
 		mutex_ios.lock();
 		try {
@@ -238,7 +306,9 @@ void MeldProcessVM::checkForReceivedCommands() {
 }
 
 void MeldProcessVM::waitForOneCommand() {
-	if (ios != NULL) {
+	if (shm != NULL) {
+		shm->waitForVMs(-1);
+	} else if (ios != NULL) {
 		mutex_ios.lock();
 		try {
 			ios->run_one();
@@ -262,7 +332,22 @@ void MeldProcessVM::createServer(int p) {
 	acceptor =  new tcp::acceptor(*ios, tcp::endpoint(tcp::v4(), p));
 }
 
+void MeldProcessVM::createSharedMemoryServer(uint32_t nbVMs) {
+	assert(ios == NULL && shm == NULL);
+	shm = ShmRegion::create(nbVMs);
+	if (shm == NULL) {
+		cerr << "error: unable to create the shared memory region of the Meld VMs: " << strerror(errno) << endl;
+		exit(EXIT_FAILURE);
+	}
+}
+
 void MeldProcessVM::deleteServer() {
+	if (shm != NULL) {
+		delete shm;
+		shm = NULL;
+		slotVMs.clear();
+		return;
+	}
 	ios->stop();
 	delete acceptor;
 	delete ios;
@@ -347,6 +432,7 @@ void MeldProcessVM::handleCommand(VMCommand &command) {
 void MeldProcessVM::closeAllSockets() {
 	map<int, MeldProcessVM*>::iterator it;
 	for(it = vmMap.begin(); it != vmMap.end(); it++) {
+		if (it->second->socket == NULL) continue;
 		it->second->socket->close();
 		it->second->socket.reset(); 
 	}
@@ -15,6 +15,7 @@
 #include <boost/asio.hpp>
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
 #include "meldProcessVMCommands.h"
+#include "meldProcessShm.h"
 #include "buildingBlock.h"
 
 using namespace std;
@@ -45,6 +46,10 @@ protected:
 	static string vmPath;
 	static string programPath;
 	static bool debugging;
+	/* shared memory transport, replaces the TCP server when not NULL */
+	static ShmRegion *shm;
+	static vector<MeldProcessVM*> slotVMs;
+	static vector<uint32_t> readySlots;
 	
 	Time currentLocalDate; // fastest mode
 	bool hasWork; // fastest mode
@@ -62,6 +67,8 @@ public:
 
 	/* associated VM program pid */
 	pid_t pid;
+	/* slot of the VM in the shared memory region, if any */
+	uint32_t slot;
 	/* buffer used to receive tcp message */
 	commandType inBuffer[VM_COMMAND_MAX_LENGHT];
 		
@@ -81,6 +88,8 @@ public:
 	void asyncReadCommandHandler(const boost::system::error_code& error, std::size_t bytes_transferred);
 	void handleInBuffer();
 	void handle_write(const boost::system::error_code& error);
+	/* print the log of the VM that could not connect, and exit */
+	void connectionError(const string &vmLogFile);
 	/* kill the VM process */
 	void killProcess();
 	/* close the socket associated to the VM program */
@@ -95,6 +104,7 @@ public:
 	inline static bool isInDebuggingMode() { return debugging; };
 	static void setConfiguration(string v, string p, bool d);
 	static void createServer(int p);
+	static void createSharedMemoryServer(uint32_t nbVMs);
 	static void deleteServer();
 	static void checkForReceivedCommands();
 	static void waitForOneCommand();
@@ -109,6 +119,7 @@ public:
 };
 
 	inline void createVMServer(int p) { MeldProcessVM::createServer(p); };
+	inline void createVMSharedMemoryServer(uint32_t nbVMs) { MeldProcessVM::createSharedMemoryServer(nbVMs); };
 	inline void deleteVMServer() { MeldProcessVM::deleteServer(); };
 	inline void setVMConfiguration(string v, string p, bool d) { MeldProcessVM::setConfiguration(v,p,d); };
 	inline void checkForReceivedVMCommands() { MeldProcessVM::checkForReceivedCommands(); };
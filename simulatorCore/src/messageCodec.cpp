@@ -0,0 +1,54 @@
+/*! @file messageCodec.cpp
+ * @brief Compact wire format of the messages, and capture of the messages on the wire.
+ * @date 17/10/2026
+ */
+
+#include "messageCodec.h"
+
+#include <fstream>
+#include <mutex>
+#include <cstdio>
+
+#include "network.h"
+#include "buildingBlock.h"
+
+using namespace std;
+
+namespace BaseSimulator {
+
+namespace {
+
+mutex captureMutex;     //!< Messages may be sent concurrently (see ParallelScheduler)
+ofstream captureFile;
+
+} // anonymous namespace
+
+bool WireCapture::open(const string &filename) {
+    captureFile.open(filename, ios::out | ios::trunc);
+    return captureFile.is_open();
+}
+
+bool WireCapture::isOpen() {
+    return captureFile.is_open();
+}
+
+void WireCapture::write(Time date, const P2PNetworkInterface *itf, const Message &msg) {
+    WireBuffer buffer;
+    msg.serialize(buffer);
+
+    const P2PNetworkInterface *remote = itf->connectedInterface;
+    string line = to_string(date) + " " + to_string(itf->hostBlock->blockId) + ":"
+        + to_string(itf->localId) + " " + to_string(remote ? remote->hostBlock->blockId : 0) + ":"
+        + to_string(remote ? remote->localId : 0) + " " + to_string(buffer.size()) + " ";
+    char hex[3];
+    for (uint8_t b : buffer.getBytes()) {
+        snprintf(hex, sizeof(hex), "%02x", b);
+        line += hex;
+    }
+    line += '\n';
+
+    lock_guard<mutex> lock(captureMutex);
+    captureFile << line;
+}
+
+} // BaseSimulator namespace
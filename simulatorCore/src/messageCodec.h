@@ -0,0 +1,367 @@
+/*! @file messageCodec.h
+ * @brief Compact wire format of the messages, from which their size, hence their transmission
+ *  duration, is derived. Messages can also be captured on the wire (-w command line option).
+ * @date 17/10/2026
+ */
+
+#ifndef MESSAGECODEC_H_
+#define MESSAGECODEC_H_
+
+#include <vector>
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <map>
+#include <array>
+#include <string>
+#include <bitset>
+#include <utility>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "tDefs.h"
+#include "cell3DPosition.h"
+
+class Message;
+class P2PNetworkInterface;
+
+namespace BaseSimulator {
+
+/**
+ * @brief Encoding of a value of type T on the wire.
+ *  Specializations define size(v), the number of bytes of v on the wire, write(buffer, v), and
+ *  read(reader, v), which decodes what write encoded (see Snapshot).
+ *  Integers and enumerations are encoded as zigzag LEB128 varints, so that small values take a
+ *  single byte, whatever their type.
+ */
+template<class T, class Enable = void>
+struct WireFormat;
+
+//!< Bytes of the wire encoding of the messages
+class WireBuffer {
+    std::vector<uint8_t> bytes;
+public:
+    //!< @brief Number of bytes of unsigned value v encoded as a LEB128 varint
+    static constexpr size_t varintSize(uint64_t v) {
+        size_t n = 1;
+        while (v >= 0x80) { v >>= 7; n++; }
+        return n;
+    }
+
+    static constexpr uint64_t zigzag(int64_t v) {
+        return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+    }
+
+    void writeByte(uint8_t b) { bytes.push_back(b); }
+    void writeVarint(uint64_t v) {
+        while (v >= 0x80) {
+            bytes.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        bytes.push_back((uint8_t)v);
+    }
+    void writeBytes(const void *data, size_t n) {
+        const uint8_t *p = static_cast<const uint8_t*>(data);
+        bytes.insert(bytes.end(), p, p + n);
+    }
+
+    //!< @brief Appends the encoding of all the values
+    template<class... Ts>
+    void write(const Ts&... values) {
+        (WireFormat<Ts>::write(*this, values), ...);
+    }
+
+    //!< @brief Returns the number of bytes of the encoding of all the values
+    template<class... Ts>
+    static size_t sizeOf(const Ts&... values) {
+        return (size_t(0) + ... + WireFormat<Ts>::size(values));
+    }
+
+    const std::vector<uint8_t>& getBytes() const { return bytes; }
+    size_t size() const { return bytes.size(); }
+    void clear() { bytes.clear(); }
+};
+
+/**
+ * @brief Decoder of bytes written by a WireBuffer, which it does not own
+ * @throw std::out_of_range when reading past the end of the bytes
+ */
+class WireReader {
+    const uint8_t *bytes;
+    size_t length;
+    size_t position = 0;
+
+    void require(size_t n) const {
+        if (n > length - position) throw std::out_of_range("truncated wire encoding");
+    }
+public:
+    WireReader(const uint8_t *data, size_t n) : bytes(data), length(n) {}
+    WireReader(const std::vector<uint8_t> &data) : WireReader(data.data(), data.size()) {}
+
+    static constexpr int64_t unzigzag(uint64_t v) {
+        return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    }
+
+    uint8_t readByte() {
+        require(1);
+        return bytes[position++];
+    }
+    uint64_t readVarint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const uint8_t b = readByte();
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (not (b & 0x80)) return v;
+        }
+        throw std::out_of_range("ill-formed varint");
+    }
+    void readBytes(void *data, size_t n) {
+        require(n);
+        std::copy(bytes + position, bytes + position + n, static_cast<uint8_t*>(data));
+        position += n;
+    }
+    //!< @brief Reads a number of elements, which cannot exceed the number of remaining bytes
+    size_t readCount() {
+        const uint64_t n = readVarint();
+        require(n);
+        return (size_t)n;
+    }
+
+    //!< @brief Decodes all the values, in the order they were written
+    template<class... Ts>
+    void read(Ts&... values) {
+        (WireFormat<Ts>::read(*this, values), ...);
+    }
+
+    size_t remaining() const { return length - position; }
+};
+
+template<>
+struct WireFormat<bool> {
+    static constexpr size_t size(bool) { return 1; }
+    static void write(WireBuffer &b, bool v) { b.writeByte(v); }
+    static void read(WireReader &r, bool &v) { v = r.readByte() != 0; }
+};
+
+template<class T>
+struct WireFormat<T, typename std::enable_if<std::is_integral<T>::value and sizeof(T) == 1
+                                             and not std::is_same<T, bool>::value>::type> {
+    static constexpr size_t size(T) { return 1; }
+    static void write(WireBuffer &b, T v) { b.writeByte((uint8_t)v); }
+    static void read(WireReader &r, T &v) { v = (T)r.readByte(); }
+};
+
+template<class T>
+struct WireFormat<T, typename std::enable_if<(std::is_integral<T>::value and sizeof(T) > 1)
+                                             or std::is_enum<T>::value>::type> {
+    static uint64_t encode(T v) {
+        if (std::is_signed<T>::value or std::is_enum<T>::value)
+            return WireBuffer::zigzag((int64_t)v);
+        return (uint64_t)v;
+    }
+    static size_t size(T v) { return WireBuffer::varintSize(encode(v)); }
+    static void write(WireBuffer &b, T v) { b.writeVarint(encode(v)); }
+    static void read(WireReader &r, T &v) {
+        const uint64_t e = r.readVarint();
+        if (std::is_signed<T>::value or std::is_enum<T>::value) v = (T)WireReader::unzigzag(e);
+        else v = (T)e;
+    }
+};
+
+template<class T>
+struct WireFormat<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static constexpr size_t size(T) { return sizeof(T); }
+    static void write(WireBuffer &b, T v) { b.writeBytes(&v, sizeof(T)); }
+    static void read(WireReader &r, T &v) { r.readBytes(&v, sizeof(T)); }
+};
+
+template<>
+struct WireFormat<Cell3DPosition> {
+    static size_t size(const Cell3DPosition &p) {
+        return WireBuffer::sizeOf(p.pt[0], p.pt[1], p.pt[2]);
+    }
+    static void write(WireBuffer &b, const Cell3DPosition &p) { b.write(p.pt[0], p.pt[1], p.pt[2]); }
+    static void read(WireReader &r, Cell3DPosition &p) { r.read(p.pt[0], p.pt[1], p.pt[2]); }
+};
+
+template<size_t N>
+struct WireFormat<std::bitset<N>> {
+    static constexpr size_t size(const std::bitset<N>&) { return (N + 7) / 8; }
+    static void write(WireBuffer &b, const std::bitset<N> &v) {
+        for (size_t i = 0; i < N; i += 8) {
+            uint8_t byte = 0;
+            for (size_t j = i; j < N and j < i + 8; j++) byte |= v[j] << (j - i);
+            b.writeByte(byte);
+        }
+    }
+    static void read(WireReader &r, std::bitset<N> &v) {
+        for (size_t i = 0; i < N; i += 8) {
+            const uint8_t byte = r.readByte();
+            for (size_t j = i; j < N and j < i + 8; j++) v[j] = (byte >> (j - i)) & 1;
+        }
+    }
+};
+
+template<>
+struct WireFormat<std::string> {
+    static size_t size(const std::string &s) { return WireBuffer::varintSize(s.size()) + s.size(); }
+    static void write(WireBuffer &b, const std::string &s) {
+        b.writeVarint(s.size());
+        b.writeBytes(s.data(), s.size());
+    }
+    static void read(WireReader &r, std::string &s) {
+        s.resize(r.readCount());
+        r.readBytes(&s[0], s.size());
+    }
+};
+
+template<class T>
+struct WireFormat<std::vector<T>> {
+    static size_t size(const std::vector<T> &v) {
+        size_t n = WireBuffer::varintSize(v.size());
+        for (const T &e : v) n += WireFormat<T>::size(e);
+        return n;
+    }
+    static void write(WireBuffer &b, const std::vector<T> &v) {
+        b.writeVarint(v.size());
+        for (const T &e : v) WireFormat<T>::write(b, e);
+    }
+    static void read(WireReader &r, std::vector<T> &v) {
+        v.resize(r.readCount());
+        for (T &e : v) WireFormat<T>::read(r, e);
+    }
+};
+
+template<class T>
+struct WireFormat<std::deque<T>> {
+    static size_t size(const std::deque<T> &v) {
+        size_t n = WireBuffer::varintSize(v.size());
+        for (const T &e : v) n += WireFormat<T>::size(e);
+        return n;
+    }
+    static void write(WireBuffer &b, const std::deque<T> &v) {
+        b.writeVarint(v.size());
+        for (const T &e : v) WireFormat<T>::write(b, e);
+    }
+    static void read(WireReader &r, std::deque<T> &v) {
+        v.resize(r.readCount());
+        for (T &e : v) WireFormat<T>::read(r, e);
+    }
+};
+
+template<class T, size_t N>
+struct WireFormat<std::array<T, N>> {
+    static size_t size(const std::array<T, N> &v) {
+        size_t n = 0;
+        for (const T &e : v) n += WireFormat<T>::size(e);
+        return n;
+    }
+    static void write(WireBuffer &b, const std::array<T, N> &v) {
+        for (const T &e : v) WireFormat<T>::write(b, e);
+    }
+    static void read(WireReader &r, std::array<T, N> &v) {
+        for (T &e : v) WireFormat<T>::read(r, e);
+    }
+};
+
+template<class T, size_t N>
+struct WireFormat<T[N]> {
+    static size_t size(const T (&v)[N]) {
+        size_t n = 0;
+        for (const T &e : v) n += WireFormat<T>::size(e);
+        return n;
+    }
+    static void write(WireBuffer &b, const T (&v)[N]) {
+        for (const T &e : v) WireFormat<T>::write(b, e);
+    }
+    static void read(WireReader &r, T (&v)[N]) {
+        for (T &e : v) WireFormat<T>::read(r, e);
+    }
+};
+
+template<class A, class B>
+struct WireFormat<std::pair<A, B>> {
+    static size_t size(const std::pair<A, B> &p) { return WireBuffer::sizeOf(p.first, p.second); }
+    static void write(WireBuffer &b, const std::pair<A, B> &p) { b.write(p.first, p.second); }
+    static void read(WireReader &r, std::pair<A, B> &p) { r.read(p.first, p.second); }
+};
+
+//!< Elements of sets and keys of maps are written in their order, and read back with a hint
+template<class T>
+struct WireFormat<std::set<T>> {
+    static size_t size(const std::set<T> &v) {
+        size_t n = WireBuffer::varintSize(v.size());
+        for (const T &e : v) n += WireFormat<T>::size(e);
+        return n;
+    }
+    static void write(WireBuffer &b, const std::set<T> &v) {
+        b.writeVarint(v.size());
+        for (const T &e : v) WireFormat<T>::write(b, e);
+    }
+    static void read(WireReader &r, std::set<T> &v) {
+        v.clear();
+        for (size_t n = r.readCount(); n > 0; n--) {
+            T e;
+            WireFormat<T>::read(r, e);
+            v.emplace_hint(v.end(), std::move(e));
+        }
+    }
+};
+
+template<class K, class V>
+struct WireFormat<std::map<K, V>> {
+    static size_t size(const std::map<K, V> &m) {
+        size_t n = WireBuffer::varintSize(m.size());
+        for (const auto &e : m) n += WireBuffer::sizeOf(e.first, e.second);
+        return n;
+    }
+    static void write(WireBuffer &b, const std::map<K, V> &m) {
+        b.writeVarint(m.size());
+        for (const auto &e : m) b.write(e.first, e.second);
+    }
+    static void read(WireReader &r, std::map<K, V> &m) {
+        m.clear();
+        for (size_t n = r.readCount(); n > 0; n--) {
+            std::pair<K, V> e;
+            r.read(e.first, e.second);
+            m.emplace_hint(m.end(), std::move(e));
+        }
+    }
+};
+
+/**
+ * @brief Capture of the messages on the wire (-w command line option).
+ *  Each message is written when its transmission starts, as a line of text:
+ *  "<date> <sender id>:<interface> <receiver id>:<interface> <size> <hex bytes>", hence
+ *  sorting on the second and third columns groups the messages per link.
+ */
+class WireCapture {
+public:
+    /**
+     * @brief Starts capturing messages to filename, truncated
+     * @return true if the file could be opened, false otherwise
+     */
+    static bool open(const std::string &filename);
+    static bool isOpen();
+    //!< @brief Writes message msg, being sent by interface itf at date
+    static void write(Time date, const P2PNetworkInterface *itf, const Message &msg);
+};
+
+} // BaseSimulator namespace
+
+/**
+ * @brief Declares the fields of a message class, which are encoded on the wire after the header
+ *  of the message, and defines Message::serialize and Message::size accordingly.
+ *  Fields can be any expression having a WireFormat, such as (uint8_t)itf->localId.
+ * @example MESSAGE_WIRE_FIELDS(srcPos, srcId)
+ */
+#define MESSAGE_WIRE_FIELDS(...)                                        \
+    virtual void serializeFields(BaseSimulator::WireBuffer &buffer) const override { \
+        buffer.write(__VA_ARGS__);                                      \
+    }                                                                   \
+    virtual unsigned int size() const override {                        \
+        return Message::headerSize + BaseSimulator::WireBuffer::sizeOf(__VA_ARGS__); \
+    }
+
+#endif /* MESSAGECODEC_H_ */
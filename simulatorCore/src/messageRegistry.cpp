@@ -0,0 +1,183 @@
+/*! @file messageRegistry.cpp
+ * @brief Message handlers shared by all the instances of a block code class.
+ * @date 17/10/2026
+ */
+
+#include "messageRegistry.h"
+
+#include <mutex>
+#include <atomic>
+#include <iostream>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <cxxabi.h>
+#include <cstdlib>
+
+#include "network.h"
+#include "statsIndividual.h"
+#include "schedulerProfiler.h"
+
+using namespace std;
+
+namespace BaseSimulator {
+
+namespace {
+
+mutex registriesMutex;
+vector<MessageTypeRegistry*> registries; //!< All the registries, in creation order
+
+atomic<bool> frozen(false);
+
+// Statistics of the handleable messages, per message class, in an open addressing table
+// filled without lock: a class takes the first free slot after its hash by setting its key.
+// Classes beyond the capacity are accounted together.
+const size_t handleableCapacity = 256;
+atomic<const type_info*> handleableKeys[handleableCapacity];
+MessageTypeRegistry::TypeStats handleableStats[handleableCapacity];
+MessageTypeRegistry::TypeStats otherHandleableStats;
+
+string demangle(const char *name) {
+    int status;
+    char *demangled = abi::__cxa_demangle(name, NULL, 0, &status);
+    string s = status == 0 ? demangled : name;
+    free(demangled);
+    return s;
+}
+
+MessageTypeRegistry::TypeStats& getHandleableStats(const type_info &type) {
+    const size_t hash = type.hash_code();
+    for (size_t i = 0; i < handleableCapacity; i++) {
+        const size_t slot = (hash + i) % handleableCapacity;
+        const type_info *key = handleableKeys[slot].load(memory_order_acquire);
+        if (key == NULL) {
+            // The name is only read by getStats, once the handlers have returned
+            if (handleableKeys[slot].compare_exchange_strong(key, &type, memory_order_acq_rel)) {
+                handleableStats[slot].name = demangle(type.name());
+                return handleableStats[slot];
+            }
+        }
+        if (*key == type) return handleableStats[slot];
+    }
+
+    return otherHandleableStats;
+}
+
+} // anonymous namespace
+
+MessageTypeRegistry::MessageTypeRegistry(const type_info &blockCodeType)
+    : blockCodeName(demangle(blockCodeType.name())) {}
+
+MessageTypeRegistry* MessageTypeRegistry::create(const type_info &blockCodeType) {
+    MessageTypeRegistry *registry = new MessageTypeRegistry(blockCodeType);
+    lock_guard<mutex> lock(registriesMutex);
+    registries.push_back(registry);
+    return registry;
+}
+
+uint64_t MessageTypeRegistry::getTime() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void MessageTypeRegistry::account(TypeStats &s, uint64_t startTime) {
+    // Handlers of different modules may run concurrently (see ParallelScheduler)
+    __atomic_fetch_add(&s.nbHandled, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s.handlingTime, getTime() - startTime, __ATOMIC_RELAXED);
+}
+
+void MessageTypeRegistry::registerHandler(unsigned int type, MessageHandler handler,
+                                          const string &name) {
+    if (hasHandler(type)) return;
+    if (frozen.load(memory_order_relaxed)) {
+        cerr << "error: handler of message type " << type << " registered by " << blockCodeName
+             << " once the simulation has started, register it from the constructor" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (type >= handlers.size()) {
+        handlers.resize(type + 1);
+        typeStats.resize(type + 1);
+    }
+
+    handlers[type] = std::move(handler);
+    typeStats[type].name = name.empty() ? "#" + to_string(type) : name;
+}
+
+void MessageTypeRegistry::freeze() {
+    frozen.store(true);
+}
+
+bool MessageTypeRegistry::dispatch(BlockCode *bc, shared_ptr<Message> msg,
+                                   P2PNetworkInterface *itf) {
+    const unsigned int type = msg->type;
+    if (not hasHandler(type)) return false;
+    if (SchedulerProfiler::isEnabled()) SchedulerProfiler::setHandler(this, type);
+
+    if (not utils::StatsIndividual::enable) {
+        handlers[type](bc, std::move(msg), itf);
+    } else {
+        uint64_t start = getTime();
+        handlers[type](bc, std::move(msg), itf);
+        account(typeStats[type], start);
+    }
+
+    return true;
+}
+
+void MessageTypeRegistry::handle(BlockCode *bc, HandleableMessage *msg) {
+    if (SchedulerProfiler::isEnabled()) SchedulerProfiler::setHandler(NULL, (uintptr_t)&typeid(*msg));
+
+    if (not utils::StatsIndividual::enable) {
+        msg->handle(bc);
+        return;
+    }
+
+    TypeStats &s = getHandleableStats(typeid(*msg));
+    uint64_t start = getTime();
+    msg->handle(bc);
+    account(s, start);
+}
+
+string MessageTypeRegistry::getStats() {
+    stringstream out;
+    out << fixed << setprecision(3);
+
+    auto print = [&out](const TypeStats &s) {
+        out << s.name << ": " << s.nbHandled << " handled, "
+            << s.handlingTime / 1e6 << " ms, "
+            << (s.nbHandled ? s.handlingTime / 1e3 / s.nbHandled : 0) << " us/message\n";
+    };
+
+    out << "=== MESSAGE HANDLING STATISTICS ===\n";
+    out << "Format: \"type: count total-time mean-time\"\n";
+    lock_guard<mutex> lock(registriesMutex);
+    for (const MessageTypeRegistry *registry : registries) {
+        out << registry->blockCodeName << "\n";
+        for (const TypeStats &s : registry->typeStats)
+            if (not s.name.empty()) print(s);
+    }
+
+    bool first = true;
+    for (size_t slot = 0; slot < handleableCapacity; slot++) {
+        if (handleableKeys[slot].load(memory_order_acquire) == NULL) continue;
+        if (first) out << "Handleable messages\n";
+        first = false;
+        print(handleableStats[slot]);
+    }
+    if (otherHandleableStats.nbHandled) {
+        otherHandleableStats.name = "Other handleable messages";
+        print(otherHandleableStats);
+    }
+
+    return out.str();
+}
+
+string MessageTypeRegistry::getFrameName(const MessageTypeRegistry *registry, uintptr_t handler) {
+    if (not registry) return demangle(reinterpret_cast<const type_info*>(handler)->name());
+
+    const string &name = handler < registry->typeStats.size() ? registry->typeStats[handler].name : "";
+    return registry->blockCodeName + ";" + (name.empty() ? "#" + to_string(handler) : name);
+}
+
+} // BaseSimulator namespace
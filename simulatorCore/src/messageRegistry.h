@@ -0,0 +1,110 @@
+/*! @file messageRegistry.h
+ * @brief Message handlers shared by all the instances of a block code class, dispatched in
+ *  constant time by message type, along with per type handling statistics (-i command line option).
+ * @date 17/10/2026
+ */
+
+#ifndef MESSAGEREGISTRY_H_
+#define MESSAGEREGISTRY_H_
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <typeinfo>
+#include <cstdint>
+
+class Message;
+class HandleableMessage;
+class P2PNetworkInterface;
+
+namespace BaseSimulator {
+
+class BlockCode;
+
+//!< Handler of a message type, called on the receiving block code
+typedef std::function<void (BlockCode*,std::shared_ptr<Message>,P2PNetworkInterface*)> MessageHandler;
+
+/**
+ * @brief Message handlers of a block code class, in a dense vector indexed by message type.
+ *
+ *  There is a single registry per block code class, see get<BC>(), filled once whatever the
+ *  number of modules. Registries are frozen when the simulation starts (see freeze), so that
+ *  handlers running on several threads read them without synchronization. Handling counts and durations are gathered per message type when per
+ *  module statistics are enabled (StatsIndividual::enable), including for HandleableMessage,
+ *  which are handled by MessageTypeRegistry::handle.
+ */
+class MessageTypeRegistry {
+public:
+    //!< Handling statistics of a message type
+    struct TypeStats {
+        std::string name;
+        uint64_t nbHandled = 0;
+        uint64_t handlingTime = 0;  //!< ns
+    };
+private:
+    std::string blockCodeName;
+    std::vector<MessageHandler> handlers; //!< Indexed by message type, empty if there is none
+    std::vector<TypeStats> typeStats;     //!< Indexed by message type
+
+    MessageTypeRegistry(const std::type_info &blockCodeType);
+
+    static MessageTypeRegistry* create(const std::type_info &blockCodeType);
+    static uint64_t getTime();
+    static void account(TypeStats &s, uint64_t startTime);
+public:
+    MessageTypeRegistry(const MessageTypeRegistry&) = delete;
+    MessageTypeRegistry& operator=(const MessageTypeRegistry&) = delete;
+
+    //!< @brief Returns the registry of block code class BC
+    template<class BC>
+    static MessageTypeRegistry& get() {
+        static MessageTypeRegistry *registry = create(typeid(BC));
+        return *registry;
+    }
+
+    /**
+     * @brief Registers the handler of a message type. Subsequent registrations for the same
+     *  type are ignored, so that block codes can register their handlers from their constructor.
+     *  Registering a new type once the registries are frozen is a fatal error.
+     * @param type message type
+     * @param handler function called on the receiving block code
+     * @param name name of the type in the statistics, "#<type>" if empty
+     */
+    void registerHandler(unsigned int type, MessageHandler handler, const std::string &name = "");
+
+    /**
+     * @brief Forbids the registration of new message types, in every registry. Called by
+     *  Simulator::startSimulation, once the modules of the configuration are created.
+     */
+    static void freeze();
+
+    bool hasHandler(unsigned int type) const {
+        return type < handlers.size() and handlers[type];
+    }
+
+    /**
+     * @brief Calls the handler of the type of message msg
+     * @return false if there is no handler for this type
+     */
+    bool dispatch(BlockCode *bc, std::shared_ptr<Message> msg, P2PNetworkInterface *itf);
+
+    /**
+     * @brief Calls msg->handle(bc), accounting it in the statistics of the class of msg
+     */
+    static void handle(BlockCode *bc, HandleableMessage *msg);
+
+    //!< @brief Returns the handling statistics of all the registries, and of handleable messages
+    static std::string getStats();
+
+    /**
+     * @brief Returns the name of a handler, as a frame of the scheduler profile (see SchedulerProfiler)
+     * @param registry registry of the handler, NULL for a handleable message
+     * @param handler message type, or address of the type_info of a handleable message
+     */
+    static std::string getFrameName(const MessageTypeRegistry *registry, uintptr_t handler);
+};
+
+} // BaseSimulator namespace
+
+#endif /* MESSAGEREGISTRY_H_ */
@@ -10,6 +10,7 @@
 
 #include "blockCode.h"
 #include "multiRobotsBlock.h"
+#include "events.h"
 
 namespace MultiRobots {
 
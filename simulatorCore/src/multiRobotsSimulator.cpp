@@ -29,9 +29,9 @@ MultiRobotsSimulator::~MultiRobotsSimulator() {
 }
 
 void MultiRobotsSimulator::createSimulator(int argc, char *argv[], BlockCodeBuilder bcb) {
-    simulator =  new MultiRobotsSimulator(argc, argv, bcb);
-    simulator->parseConfiguration(argc, argv);
-    simulator->startSimulation();
+    Simulator::createSimulator(argc, argv, bcb, [](int argc, char *argv[], BlockCodeBuilder bcb) -> Simulator* {
+        return new MultiRobotsSimulator(argc, argv, bcb);
+    });
 }
 
 void MultiRobotsSimulator::loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
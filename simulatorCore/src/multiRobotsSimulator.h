@@ -29,7 +29,7 @@ public:
 
     static MultiRobotsSimulator* getSimulator() {
     assert(simulator != NULL);
-    return((MultiRobotsSimulator*)simulator);
+    return((MultiRobotsSimulator*)simulator.get());
     }
 
     virtual void loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
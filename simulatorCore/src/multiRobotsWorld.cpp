@@ -47,12 +47,15 @@ MultiRobotsWorld::~MultiRobotsWorld() {
 }
 
 void MultiRobotsWorld::deleteWorld() {
-    delete((MultiRobotsWorld*)world);
+    delete((MultiRobotsWorld*)world.get());
 }
 
 void MultiRobotsWorld::addBlock(bID blockId, BlockCodeBuilder bcb,
                                  const Cell3DPosition &pos, const Color &col,
                                  short orientation, bool master) {
+    if (getScheduler()->deferWorldAction([=]() { addBlock(blockId, bcb, pos, col, orientation, master); }))
+        return;
+
     if (blockId > maxBlockId)
         maxBlockId = blockId;
     else if (blockId == 0)
@@ -35,7 +35,7 @@ public:
     static void deleteWorld();
     static MultiRobotsWorld* getWorld() {
         assert(world != NULL);
-        return((MultiRobotsWorld*)world);
+        return((MultiRobotsWorld*)world.get());
     }
     void printInfo() {
         OUTPUT << "I'm a MultiRobotsWorld" << endl;
@@ -7,12 +7,15 @@
 
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 
 #include "scheduler.h"
 #include "network.h"
 #include "trace.h"
 #include "statsIndividual.h"
 #include "utils.h"
+#include "traceSink.h"
+#include "snapshot.h"
 
 //#define TRANSMISSION_TIME_DEBUG
 
@@ -20,11 +23,11 @@ using namespace std;
 using namespace BaseSimulator;
 using namespace BaseSimulator::utils;
 
-uint64_t Message::nextId = 0;
-uint64_t Message::nbMessages = 0;
+BaseSimulator::RunLocal<std::atomic<bID>> Message::nextId { 0u };
+BaseSimulator::RunLocal<std::atomic<bID>> Message::nbMessages { 0u };
 
-bID P2PNetworkInterface::nextId = 0;
-int P2PNetworkInterface::defaultDataRate = 1000000;
+BaseSimulator::RunLocal<bID> P2PNetworkInterface::nextId { 0u };
+BaseSimulator::RunLocal<int> P2PNetworkInterface::defaultDataRate { 1000000 };
 
 //===========================================================================================================
 //
@@ -33,25 +36,35 @@ int P2PNetworkInterface::defaultDataRate = 1000000;
 //===========================================================================================================
 
 Message::Message() {
-    id = nextId;
-    nextId++;
-    nbMessages++;
+    id = nextId.get()++;
+    nbMessages.get()++;
     MESSAGE_CONSTRUCTOR_INFO();
 }
 
 Message::~Message() {
     MESSAGE_DESTRUCTOR_INFO();
-    nbMessages--;
+    nbMessages.get()--;
 }
 
 uint64_t Message::getNbMessages() {
-    return(nbMessages);
+    return(nbMessages.get());
 }
 
 string Message::getMessageName() const {
     return("generic message");
 }
 
+void Message::serialize(WireBuffer &buffer) const {
+    const size_t start = buffer.size();
+    const unsigned int length = size() - headerSize;
+    buffer.writeByte(type & 0xFF);
+    buffer.writeByte((type >> 8) & 0xFF);
+    buffer.writeByte(length & 0xFF);
+    buffer.writeByte((length >> 8) & 0xFF);
+    serializeFields(buffer);
+    while (buffer.size() - start < size()) buffer.writeByte(0);
+}
+
 Message* Message::clone() const {
     Message* ptr = new Message(*this);
     ptr->sourceInterface = sourceInterface;
@@ -88,14 +101,42 @@ P2PNetworkInterface::P2PNetworkInterface(BaseSimulator::BuildingBlock *b) {
     connectedInterface = NULL;
     availabilityDate = 0;
     globalId = nextId;
-    nextId++;
+    nextId.get()++;
+    // Interfaces are created in the order of their index in the block
+    localId = b ? b->getNbInterfaces() : 0;
     dataRate = new StaticRate(defaultDataRate);
+    constantDataRate = defaultDataRate;
+    linkModel = NULL;
+    linkState = NULL;
+    nbMessagesToDrop = 0;
+    if (b) setLinkModel(LinkModel::get(b->blockId, localId));
 }
 
 void P2PNetworkInterface::setDataRate(Rate *r) {
   assert(r != NULL);
   delete dataRate;
   dataRate = r;
+  StaticRate *staticRate = dynamic_cast<StaticRate*>(r);
+  constantDataRate = staticRate ? staticRate->get() : 0;
+}
+
+void P2PNetworkInterface::setLinkModel(const LinkModel *m) {
+    delete linkState;
+    linkState = NULL;
+    linkModel = m;
+    if (not m) return;
+
+    // Random draws only depend on the seed of the links and on the interface
+    const ruint seed = LinkModel::getSeed() ^ (ruint)(hostBlock->blockId * 2654435761u + localId);
+    if (m->dataRate > 0) {
+        if (m->dataRateStdDev > 0) {
+            doubleRNG g = utils::Random::getNormalDoubleRNG(seed + 1, m->dataRate, m->dataRateStdDev);
+            setDataRate(new RandomRate(g));
+        } else {
+            setDataRate(new StaticRate(m->dataRate));
+        }
+    }
+    if (not m->isConstant()) linkState = new LinkState(m, seed);
 }
 
 P2PNetworkInterface::~P2PNetworkInterface() {
@@ -105,6 +146,7 @@ P2PNetworkInterface::~P2PNetworkInterface() {
 #endif
 #endif
     delete dataRate;
+    delete linkState;
 }
 
 void P2PNetworkInterface::send(Message *m) {
@@ -118,7 +160,12 @@ bool P2PNetworkInterface::addToOutgoingBuffer(MessagePtr msg) {
         outgoingQueue.push_back(msg);
         BaseSimulator::utils::StatsIndividual::incOutgoingMessageQueueSize(hostBlock->stats);
         if (availabilityDate < BaseSimulator::getScheduler()->now()) availabilityDate = BaseSimulator::getScheduler()->now();
-        if (outgoingQueue.size() == 1 && messageBeingTransmitted == NULL) { //TODO
+        if (messageBeingTransmitted != NULL) {
+            // Joins the current burst, right after the last message queued
+            Time start = outgoingQueue.size() > 1 ?
+                outgoingQueue[outgoingQueue.size() - 2].completionDate : availabilityDate;
+            outgoingQueue.back().completionDate = start + getTransmissionDuration(msg);
+        } else if (outgoingQueue.size() == 1) {
             BaseSimulator::getScheduler()->schedule(new NetworkInterfaceStartTransmittingEvent(availabilityDate,this));
         }
         return(true);
@@ -131,9 +178,7 @@ bool P2PNetworkInterface::addToOutgoingBuffer(MessagePtr msg) {
 }
 
 void P2PNetworkInterface::send() {
-    MessagePtr msg;
     stringstream info;
-    Time transmissionDuration;
 
     if (!connectedInterface) {
         info << "*** WARNING *** [block " << hostBlock->blockId << ",interface " << globalId <<"] : trying to send a Message but no interface connected";
@@ -147,26 +192,74 @@ void P2PNetworkInterface::send() {
         exit(EXIT_FAILURE);
     }
 
-    msg = outgoingQueue.front();
+    // Messages are sent back to back, each one as soon as the previous one is transmitted
+    Time date = BaseSimulator::getScheduler()->now();
+    for (size_t i = 0; i < outgoingQueue.size(); i++) {
+        date += getTransmissionDuration(outgoingQueue[i].message);
+        outgoingQueue[i].completionDate = date;
+    }
+
+    sendNext();
+}
+
+void P2PNetworkInterface::sendNext(NetworkInterfaceStopTransmittingEvent *stopEvent) {
+    stringstream info;
+
+    if (!connectedInterface) {
+        info << "*** WARNING *** [block " << hostBlock->blockId << ",interface " << globalId <<"] : trying to send a Message but no interface connected";
+        BaseSimulator::getScheduler()->trace(info.str());
+        return;
+    }
+
+    MessagePtr msg = std::move(outgoingQueue.front().message);
+    availabilityDate = outgoingQueue.front().completionDate;
     outgoingQueue.pop_front();
 
     BaseSimulator::utils::StatsIndividual::decOutgoingMessageQueueSize(hostBlock->stats);
 
-    transmissionDuration = getTransmissionDuration(msg);
-
-#ifdef TRANSMISSION_TIME_DEBUG
-    cerr << "Message size (bytes): " << msg->size() << endl;
-    cerr << "Data rate (bit/s): " << dataRate->get() << endl;
-    cerr << "Message transmission duration (us): " << transmissionDuration
-         << endl;
-#endif
     messageBeingTransmitted = msg;
     messageBeingTransmitted->sourceInterface = this;
     messageBeingTransmitted->destinationInterface = connectedInterface;
 
-    availabilityDate = BaseSimulator::getScheduler()->now()+transmissionDuration;
+    if (WireCapture::isOpen())
+        WireCapture::write(BaseSimulator::getScheduler()->now(), this, *msg);
+
+    // Link model: constant latency needs no per message work, other models have a state
+    Time deliveryDate = availabilityDate;
+    bool lost = false;
+    if (nbMessagesToDrop) {
+        nbMessagesToDrop--;
+        lost = true;
+    } else if (linkState) {
+        lost = linkState->isLost(BaseSimulator::getScheduler()->now());
+        if (not lost) deliveryDate = linkState->getDeliveryDate(availabilityDate);
+    } else if (linkModel) {
+        deliveryDate += linkModel->latency;
+    }
+
+    if (lost and TraceSink::isEnabled(TraceCategory::Message)) {
+        info << "message " << msg->getMessageName() << " to #" << getConnectedBlockId()
+             << " lost on interface " << localId;
+        BaseSimulator::getScheduler()->trace(info.str(), hostBlock->blockId);
+    }
 
-    BaseSimulator::getScheduler()->schedule(new NetworkInterfaceStopTransmittingEvent(BaseSimulator::getScheduler()->now()+transmissionDuration, this));
+    // With the parallel scheduler, or when the link has a latency, the receiving block gets
+    //  the message through an event of its own. With the parallel scheduler, it is processed
+    //  right before the end of transmission event of the sender.
+    bool split = lost or deliveryDate != availabilityDate or BaseSimulator::getScheduler()->isParallel();
+    if (split and not lost) {
+        NetworkInterfaceDeliverEvent *deliverEvent = new NetworkInterfaceDeliverEvent(deliveryDate, this, msg);
+        deliverEvent->parallelOnly = deliveryDate == availabilityDate;
+        BaseSimulator::getScheduler()->schedule(deliverEvent);
+    }
+    if (stopEvent) {
+        // The end of transmission event of the previous message, just consumed, is reused
+        stopEvent->date = availabilityDate;
+        stopEvent->deliver = not split;
+        BaseSimulator::getScheduler()->schedule(stopEvent);
+    } else {
+        BaseSimulator::getScheduler()->schedule(new NetworkInterfaceStopTransmittingEvent(availabilityDate, this, !split));
+    }
 
     StatsCollector::getInstance().incMsgCount();
     StatsIndividual::incSentMessageCount(hostBlock->stats);
@@ -195,11 +288,82 @@ void P2PNetworkInterface::connect(P2PNetworkInterface *ni) {
 }
 
 Time P2PNetworkInterface::getTransmissionDuration(MessagePtr &m) {
-  double rate = dataRate->get();
+  double rate = constantDataRate;
+  if (rate == 0) rate = max(dataRate->get(), 1.0); // Gaussian data rates are truncated
   Time transmissionDuration = (m->size()*8000000ULL)/rate;
+#ifdef TRANSMISSION_TIME_DEBUG
+  cerr << "Message size (bytes): " << m->size() << endl;
+  cerr << "Data rate (bit/s): " << rate << endl;
+  cerr << "Message transmission duration (us): " << transmissionDuration
+       << endl;
+#endif
   return transmissionDuration;
 }
 
+void P2PNetworkInterface::save(SnapshotWriter &w) const {
+    if (constantDataRate == 0) {
+        stringstream err;
+        err << "interface " << localId << " of module " << hostBlock->blockId
+            << " has a random data rate, whose generator cannot be saved";
+        throw SnapshotException(err.str());
+    }
+
+    // Models are the ones of the configuration file, only the state of the link is saved
+    const vector<LinkModel*> &models = LinkModel::getModels();
+    w.writeInterface(connectedInterface);
+    w.writeVarint(linkModel ? find(models.begin(), models.end(), linkModel) - models.begin() + 1 : 0);
+    w.write(linkState != NULL);
+    if (linkState) linkState->save(w);
+    w.write(constantDataRate, availabilityDate, nbMessagesToDrop);
+
+    w.writeVarint(outgoingQueue.size());
+    for (size_t i = 0; i < outgoingQueue.size(); i++) {
+        w.writeMessage(outgoingQueue[i].message);
+        w.write(outgoingQueue[i].completionDate);
+    }
+    w.writeMessage(messageBeingTransmitted);
+}
+
+void P2PNetworkInterface::restore(SnapshotReader &r) {
+    connectedInterface = r.readInterface();
+
+    const vector<LinkModel*> &models = LinkModel::getModels();
+    const uint64_t model = r.readVarint();
+    if (model > models.size())
+        throw SnapshotException("the link models do not match the ones of the configuration file");
+    if ((model ? models[model - 1] : NULL) != linkModel)
+        setLinkModel(model ? models[model - 1] : NULL);
+    bool hasLinkState;
+    r.read(hasLinkState);
+    if (hasLinkState != (linkState != NULL))
+        throw SnapshotException("the link models do not match the ones of the configuration file");
+    if (linkState) linkState->restore(r);
+
+    double rate;
+    r.read(rate, availabilityDate, nbMessagesToDrop);
+    if (rate != constantDataRate) setDataRate(new StaticRate(rate));
+
+    outgoingQueue.clear();
+    for (size_t n = r.readCount(); n > 0; n--) {
+        outgoingQueue.push_back(r.readMessage());
+        r.read(outgoingQueue.back().completionDate);
+    }
+    messageBeingTransmitted = r.readMessage();
+}
+
+Time P2PNetworkInterface::getMinimumDeliveryDelay() const {
+    Time delay = constantDataRate > 0 ? (Time)((Message::headerSize*8000000ULL)/constantDataRate) : 0;
+    if (linkModel and linkModel->latencyStdDev == 0) delay += linkModel->latency;
+    return delay;
+}
+
+void OutgoingMessageQueue::grow() {
+    vector<Entry> larger(entries.size() * 2);
+    for (size_t i = 0; i < count; i++) larger[i] = std::move((*this)[i]);
+    entries.swap(larger);
+    head = 0;
+}
+
 bool P2PNetworkInterface::isConnected() const {
   return connectedInterface != NULL;
 }
@@ -9,16 +9,29 @@
 #define NETWORK_H_
 
 #include <deque>
+#include <vector>
+#include <memory>
+#include <atomic>
 #include <string.h>
 
 #include "tDefs.h"
+#include "runContext.h"
 #include "rate.h"
 #include "buildingBlock.h"
+#include "messageCodec.h"
+#include "linkModel.h"
 
 using namespace std;
 
 class Message;
 class P2PNetworkInterface;
+class NetworkInterfaceStopTransmittingEvent;
+
+namespace BaseSimulator {
+class Snapshot;
+class SnapshotWriter;
+class SnapshotReader;
+}
 
 typedef std::shared_ptr<Message> MessagePtr;
 
@@ -38,15 +51,18 @@ typedef std::shared_ptr<Message> MessagePtr;
 
 class Message {
 protected:
-    static bID nextId;
+    static BaseSimulator::RunLocal<std::atomic<bID>> nextId;
     //static unsigned int nextId;
-    static bID nbMessages;
+    static BaseSimulator::RunLocal<std::atomic<bID>> nbMessages;
     //static unsigned int nbMessages;
 public:
+    //!< Bytes of the header of a message on the wire: type and length of the fields (2 bytes each)
+    static const unsigned int headerSize = 4;
+
     bID id;
     //unsigned int id;
-    unsigned int type;
-    P2PNetworkInterface *sourceInterface, *destinationInterface;
+    unsigned int type = 0;
+    P2PNetworkInterface *sourceInterface = NULL, *destinationInterface = NULL; //!< Set when the message is sent
 
     Message();
     Message(unsigned int t):type(t) {};
@@ -54,18 +70,59 @@ public:
 
     static uint64_t getNbMessages();
     virtual string getMessageName() const;
-    static void incrementMessageCounts() { nextId++; nbMessages++; }
-
+    static void incrementMessageCounts() { nextId.get()++; nbMessages.get()++; }
 
-    virtual unsigned int size() const { return(4); }
+    /**
+     * @brief Returns the number of bytes of the message on the wire, from which its transmission
+     *  duration is computed. Derived from the fields declared with MESSAGE_WIRE_FIELDS.
+     */
+    virtual unsigned int size() const { return(headerSize); }
+    /**
+     * @brief Appends the wire encoding of the message to buffer: header, then fields.
+     *  Messages whose size() is not derived from their fields are padded with zeros.
+     */
+    void serialize(BaseSimulator::WireBuffer &buffer) const;
+    //!< @brief Appends the wire encoding of the fields of the message, see MESSAGE_WIRE_FIELDS
+    virtual void serializeFields(BaseSimulator::WireBuffer &buffer) const {}
     /**
      * @brief Clones the message. This is necessary when broadcasting
      * @attention Needs to overloaded in subclasses to avoid slicing (https://en.wikipedia.org/wiki/Object_slicing) when broadcasting subclasses of Message
+     * @note Large payloads are best carried by a MessageOf, whose clones share their payload
      * @example virtual Message* clone() { return new MyMessageType(*this); }*/
     virtual Message* clone() const;
     virtual bool isMessageHandleable() const { return false; };
+
+    friend class BaseSimulator::Snapshot;
+};
+
+/**
+ * @brief Reference counted payload of a message, shared by the copies of the message.
+ *  Read accesses never copy it. A write access copies it first if other messages share it
+ *  (copy-on-write), so that the change is only seen by the message being modified.
+ * @attention A payload must not be modified while a message sharing it is read by another thread.
+ */
+template <class T>
+class SharedPayload {
+    mutable std::shared_ptr<T> ptr;
+public:
+    SharedPayload(const T &data):ptr(std::make_shared<T>(data)) {};
+    SharedPayload(std::shared_ptr<T> data):ptr(std::move(data)) {};
+
+    //!< @brief Read-only access, shared with the copies of the message
+    const T& get() const { return *ptr; };
+    //!< @brief Write access, copying the payload first if it is shared
+    T* getMutable() const {
+        if (ptr.use_count() > 1) ptr = std::make_shared<T>(*ptr);
+        return ptr.get();
+    };
+    const std::shared_ptr<T>& getShared() const { return ptr; };
 };
 
+/**
+ * @brief Message handled by a virtual function. Its clone() is written by each subclass and
+ *  copies its members: large members are best held in a SharedPayload, so that the clones of
+ *  a broadcast share them.
+ */
 class HandleableMessage:public Message {
 public:
     HandleableMessage();
@@ -78,22 +135,103 @@ public:
     virtual Message* clone() const override = 0;
 };
 
+//!< @brief true if values of type T can be encoded on the wire
+template<class T, class = void>
+struct HasWireFormat : std::false_type {};
+template<class T>
+struct HasWireFormat<T, decltype((void)BaseSimulator::WireFormat<T>::size(std::declval<const T&>()))>
+    : std::true_type {};
+
+/**
+ * @brief Message carrying a payload of type T.
+ *  The payload is a SharedPayload: the clones of a message, such as the ones sent to each
+ *  neighbor by BlockCode::sendMessageToAllNeighbors, share it and only allocate their own
+ *  envelope (type, id and interfaces), until one of them modifies it through getData().
+ */
 template <class T>
 class MessageOf:public Message {
-    T *ptrData;
+    SharedPayload<T> payload;
 public :
-    MessageOf(unsigned int t,const T &data):Message(t) { ptrData = new T(data); };
-    ~MessageOf() { delete ptrData; };
-    T* getData() const { return ptrData; };
+    MessageOf(unsigned int t,const T &data):Message(t),payload(data) {};
+    //!< @brief Builds a message around an existing payload, which may be shared with other messages
+    MessageOf(unsigned int t,std::shared_ptr<T> data):Message(t),payload(std::move(data)) {};
+    //!< @brief Returns the payload, which is copied first if other messages share it
+    T* getData() const { return payload.getMutable(); };
+    //!< @brief Returns the payload without ever copying it
+    const T* getConstData() const { return &payload.get(); };
+    const std::shared_ptr<T>& getSharedData() const { return payload.getShared(); };
     virtual Message* clone() const override {
-        MessageOf<T> *ptr = new MessageOf<T>(type,*ptrData);
-        ptr->sourceInterface = sourceInterface;
-        ptr->destinationInterface = destinationInterface;
-        return ptr;
+        return new MessageOf<T>(*this);
+    }
+
+    //!< @brief Payloads without a wire format count for sizeof(T) bytes
+    virtual unsigned int size() const override {
+        if constexpr (HasWireFormat<T>::value)
+            return headerSize + BaseSimulator::WireBuffer::sizeOf(payload.get());
+        else
+            return headerSize + sizeof(T);
+    }
+
+    virtual void serializeFields(BaseSimulator::WireBuffer &buffer) const override {
+        if constexpr (HasWireFormat<T>::value) buffer.write(payload.get());
     }
 
 };
 
+//===========================================================================================================
+//
+//          OutgoingMessageQueue  (class)
+//
+//===========================================================================================================
+
+/**
+ * @brief FIFO of the messages waiting to be sent by an interface, stored in a ring buffer.
+ *  Its capacity only grows when a burst of messages exceeds it, so that sending does not
+ *  allocate once the simulation has reached its working size.
+ */
+class OutgoingMessageQueue {
+public:
+    struct Entry {
+        MessagePtr message;
+        Time completionDate; //!< End of transmission date, known once the message is part of a burst
+    };
+private:
+    static const size_t initialCapacity = 8; //!< Power of two
+
+    std::vector<Entry> entries;
+    size_t head = 0;            //!< Index of the first message
+    size_t count = 0;
+
+    //!< @brief Doubles the capacity, moving the messages to the beginning of the buffer
+    void grow();
+public:
+    OutgoingMessageQueue() : entries(initialCapacity) {};
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    //!< @brief Returns the ith message from the front of the queue
+    Entry& operator[](size_t i) { return entries[(head + i) & (entries.size() - 1)]; }
+    const Entry& operator[](size_t i) const { return entries[(head + i) & (entries.size() - 1)]; }
+    Entry& front() { return (*this)[0]; }
+    Entry& back() { return (*this)[count - 1]; }
+
+    void push_back(MessagePtr msg) {
+        if (count == entries.size()) grow();
+        Entry &e = (*this)[count++];
+        e.message = std::move(msg);
+        e.completionDate = 0;
+    }
+
+    void pop_front() {
+        entries[head].message.reset();
+        head = (head + 1) & (entries.size() - 1);
+        count--;
+    }
+
+    void clear() { while (count) pop_front(); }
+};
+
 //===========================================================================================================
 //
 //          P2PNetworkInterface  (class)
@@ -102,21 +240,25 @@ public :
 
 class P2PNetworkInterface {
 protected:
-    static bID nextId;
-    static int defaultDataRate;
+    static BaseSimulator::RunLocal<bID> nextId;
+    static BaseSimulator::RunLocal<int> defaultDataRate;
 
     BaseSimulator::Rate* dataRate;
+    double constantDataRate;    //!< Value of dataRate if it is a StaticRate, 0 otherwise
+    const BaseSimulator::LinkModel *linkModel;  //!< NULL if no link model applies
+    BaseSimulator::LinkState *linkState;        //!< NULL if there is no model, or if it is constant
 public:
 
     bID globalId;
     bID localId;
-    deque<MessagePtr> outgoingQueue;
+    OutgoingMessageQueue outgoingQueue;
 
     P2PNetworkInterface *connectedInterface;
     BaseSimulator::BuildingBlock *hostBlock;
     Time availabilityDate;
 
     MessagePtr messageBeingTransmitted;
+    unsigned int nbMessagesToDrop; //!< Number of the next messages sent that are lost (see FaultInjector)
 
     P2PNetworkInterface(BaseSimulator::BuildingBlock *b);
     ~P2PNetworkInterface();
@@ -124,7 +266,17 @@ public:
     void send(Message *m);
 
     bool addToOutgoingBuffer(MessagePtr msg);
+    /**
+     * @brief Starts transmitting a burst of messages: computes the completion dates of all the
+     *  queued messages, then starts the transmission of the first one
+     */
     void send();
+    /**
+     * @brief Starts the transmission of the first queued message, whose completion date is known.
+     * @param stopEvent end of transmission event of the previous message of the burst, scheduled
+     *  again for this message. If NULL, a new one is created.
+     */
+    void sendNext(NetworkInterfaceStopTransmittingEvent *stopEvent = NULL);
     void connect(P2PNetworkInterface *ni);
     int getConnectedBlockId() {
         return (connectedInterface!=NULL && connectedInterface->hostBlock!=NULL)?connectedInterface->hostBlock->blockId:-1;
@@ -136,7 +288,36 @@ public:
     bool isConnected() const;
 
     void setDataRate(BaseSimulator::Rate* r);
+    /**
+     * @brief Sets the link model of the interface, which also sets its data rate if the model
+     *  has one
+     * @param m model, or NULL to remove the current one
+     */
+    void setLinkModel(const BaseSimulator::LinkModel *m);
+    const BaseSimulator::LinkModel* getLinkModel() const { return linkModel; }
+    //!< @brief Returns true if the link model of the interface has an outage at date
+    bool isLinkDown(Time date) const { return linkModel and linkModel->isDown(date); }
+    //!< @brief Returns the data rate of interfaces that have not been given a specific one (bit/s)
+    static int getDefaultDataRate() { return defaultDataRate; }
     Time getTransmissionDuration(MessagePtr &m);
+    /**
+     * @brief Returns a lower bound of the delay between the start of the transmission of a
+     *  message on this interface and its delivery: transmission duration of a message header
+     *  at the data rate of the interface, plus the latency of its link. Random data rates and
+     *  latencies have no bound, they only count for 0.
+     */
+    Time getMinimumDeliveryDelay() const;
+
+    /**
+     * @brief Writes the state of the interface to a snapshot: connection, state of its link,
+     *  queued messages and message being transmitted
+     * @throw SnapshotException if its data rate is random, since its generator cannot be saved
+     */
+    void save(BaseSimulator::SnapshotWriter &w) const;
+    //!< @brief Reads back the state written by save
+    void restore(BaseSimulator::SnapshotReader &r);
+
+    friend class BaseSimulator::Snapshot;
 };
 
 #endif /* NETWORK_H_ */
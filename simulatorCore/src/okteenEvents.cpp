@@ -10,6 +10,7 @@
 
 #include "okteenEvents.h"
 #include "okteenWorld.h"
+#include "simulator.h"
 
 using namespace BaseSimulator::utils;
 
@@ -43,6 +44,13 @@ void OkteenMotionsStartEvent::consume() {
 
     motion.module->setColor(DARKGREY);
     motion.init();
+
+    if (Simulator::logicalMotions()) {
+        // Skip the animation steps: the stop comes one delay after the last of the nbSteps steps
+        scheduler->schedule(new OkteenMotionsStopEvent(scheduler->now() + (OkteenMotions::nbSteps + 1) * ANIMATION_DELAY, motion));
+        return;
+    }
+
     scheduler->schedule(new OkteenMotionsStepEvent(scheduler->now() + ANIMATION_DELAY, motion));
 }
 
@@ -123,10 +131,11 @@ void OkteenMotionsStopEvent::consume() {
     OkteenWorld *wrld=OkteenWorld::getWorld();
 
     motion.module->setPosition(position);
-    stringstream info;
-    info.str("");
-    info << "connect Block " << motion.module->blockId;
-    getScheduler()->trace(info.str(),motion.module->blockId,LIGHTBLUE);
+    if (TraceSink::isEnabled(TraceCategory::Motion)) {
+        stringstream info;
+        info << "connect Block " << motion.module->blockId;
+        getScheduler()->trace(info.str(),motion.module->blockId,LIGHTBLUE,TraceCategory::Motion);
+    }
     wrld->connectBlock(motion.module, false);
     Scheduler *scheduler = getScheduler();
     scheduler->schedule(new OkteenMotionsEndEvent(scheduler->now() + ANIMATION_DELAY, motion.module));
@@ -448,7 +457,7 @@ bool OkteenMotions::nextStep(Matrix &m) {
     }
 
     step++;
-    return (step>20);
+    return (step>=nbSteps);
 }
 
 void OkteenMotions::getFinalPosition(Cell3DPosition &position) {
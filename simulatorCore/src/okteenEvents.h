@@ -31,6 +31,8 @@ public :
     OkteenMotions(OkteenBlock *mobile,SCLattice::Direction connector,SCLattice::Direction axisDir);
     OkteenMotions() {};
 
+    static const int nbSteps = 21; //!< Number of calls to nextStep until the end of the animation
+
     void init() {
         //currentAction=1;
         step=0;
@@ -36,9 +36,9 @@ OkteenSimulator::~OkteenSimulator() {
 }
 
 void OkteenSimulator::createSimulator(int argc, char *argv[], BlockCodeBuilder bcb) {
-    simulator =  new OkteenSimulator(argc, argv, bcb);
-    simulator->parseConfiguration(argc, argv);
-    simulator->startSimulation();
+    Simulator::createSimulator(argc, argv, bcb, [](int argc, char *argv[], BlockCodeBuilder bcb) -> Simulator* {
+        return new OkteenSimulator(argc, argv, bcb);
+    });
 }
 
 void OkteenSimulator::loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
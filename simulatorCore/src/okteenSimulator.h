@@ -30,7 +30,7 @@ public:
 
     static OkteenSimulator* getSimulator() {
         assert(simulator != NULL);
-        return((OkteenSimulator*)simulator);
+        return((OkteenSimulator*)simulator.get());
     }
 
     virtual void loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
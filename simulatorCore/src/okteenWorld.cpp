@@ -52,11 +52,14 @@ OkteenWorld::~OkteenWorld() {
 }
 
 void OkteenWorld::deleteWorld() {
-    delete((OkteenWorld*)world);
+    delete((OkteenWorld*)world.get());
 }
 
 void OkteenWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPosition &pos, const Color &col,
                              short orientation, bool master) {
+    if (getScheduler()->deferWorldAction([=]() { addBlock(blockId, bcb, pos, col, orientation, master); }))
+        return;
+
     if (blockId > maxBlockId)
         maxBlockId = blockId;
     else if (blockId == 0)
@@ -86,7 +89,7 @@ void OkteenWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPositi
 void OkteenWorld::linkBlock(const Cell3DPosition& pos) {
     OkteenBlock *module = (OkteenBlock *)lattice->getBlock(pos);
     OkteenBlock* neighborBlock;
-    vector<Cell3DPosition> nRelCells = lattice->getRelativeConnectivity(pos);
+    const vector<Cell3DPosition> &nRelCells = lattice->getRelativeConnectivity(pos);
     Cell3DPosition nPos;
 
     OUTPUT << "pos:" << pos << "  #" << module->blockId << endl;
@@ -43,7 +43,7 @@ public:
     static void deleteWorld();
     static OkteenWorld* getWorld() {
         assert(world != NULL);
-        return((OkteenWorld*)world);
+        return((OkteenWorld*)world.get());
     }
 
     void printInfo() {
@@ -459,7 +459,7 @@ void GlutContext::specialFunc(int key, int x, int y)
     switch(key) {
 
         case GLUT_KEY_PAGE_UP: {
-            Rotations3D::rotationDelayMultiplier /= 1.5f;
+            Rotations3D::rotationDelayMultiplier.get() /= 1.5f;
             const float minRotationDelayMultiplier = 0.001f;
             if (Rotations3D::rotationDelayMultiplier < minRotationDelayMultiplier) {
                 Rotations3D::rotationDelayMultiplier = minRotationDelayMultiplier;
@@ -473,7 +473,7 @@ void GlutContext::specialFunc(int key, int x, int y)
 
         case GLUT_KEY_PAGE_DOWN: {
             // PTHA: #TODO Should consider creating a configuration variables system
-            Rotations3D::rotationDelayMultiplier *= 1.5f;
+            Rotations3D::rotationDelayMultiplier.get() *= 1.5f;
             const float maxRotationDelayMultiplier = 10.0f;
             if (Rotations3D::rotationDelayMultiplier > maxRotationDelayMultiplier) {
                 Rotations3D::rotationDelayMultiplier = maxRotationDelayMultiplier;
@@ -760,6 +760,8 @@ void GlutContext::mainLoop() {
     s->stop(s->now());
 
     deleteScheduler();
+    // The simulations of a batch are followed by the next ones on the same thread (see BatchRunner)
+    if (not RunContext::current()->isProcessContext()) return;
     std::chrono::milliseconds timespan(500);
     std::this_thread::sleep_for(timespan);
 
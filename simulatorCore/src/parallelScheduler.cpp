@@ -0,0 +1,451 @@
+/*! @file parallelScheduler.cpp
+ * @brief Conservative parallel discrete event scheduler.
+ * @date 17/10/2026
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+
+#include "parallelScheduler.h"
+#include "buildingBlock.h"
+#include "blockCode.h"
+#include "trace.h"
+#include "world.h"
+#include "simulator.h"
+#include "schedulerProfiler.h"
+
+using namespace std;
+using namespace BaseSimulator;
+using namespace BaseSimulator::utils;
+using us = chrono::microseconds;
+using get_time = chrono::steady_clock;
+
+void ParallelScheduler::LogicalProcess::push(Entry &&e) {
+    pending.push_back(std::move(e));
+    push_heap(pending.begin(), pending.end(), [](const Entry &a, const Entry &b) { return a.after(b); });
+}
+
+ParallelScheduler::Entry ParallelScheduler::LogicalProcess::pop() {
+    pop_heap(pending.begin(), pending.end(), [](const Entry &a, const Entry &b) { return a.after(b); });
+    Entry e = std::move(pending.back());
+    pending.pop_back();
+    return e;
+}
+
+//!< Action on the world requested by a block code during a window, performed alone at its end
+class WorldActionEvent : public Event {
+    std::function<void()> action;
+public:
+    WorldActionEvent(Time t, const std::function<void()> &a) : Event(t), action(a) { eventType = EVENT_WORLD_ACTION; }
+    void consume() override { action(); }
+    const string getEventName() override { return("WorldAction Event"); }
+};
+
+ParallelScheduler::ParallelScheduler(int threads, size_t minWindow) : nbThreads(threads), minParallelWindow(minWindow) {
+#ifdef DEBUG_OBJECT_LIFECYCLE
+    OUTPUT << TermColor::LifecycleColor << "ParallelScheduler constructor" << endl;
+#endif
+    state = NOTREADY;
+    schedulerMode = SCHEDULER_MODE_FASTEST;
+    schedulerThread = new thread(bind(&ParallelScheduler::startPaused, this));
+}
+
+ParallelScheduler::~ParallelScheduler() {
+#ifdef DEBUG_OBJECT_LIFECYCLE
+    OUTPUT << TermColor::LifecycleColor << "ParallelScheduler destructor\33[0m" << endl;
+#endif
+}
+
+void ParallelScheduler::createScheduler(int threads, size_t minWindow) {
+    scheduler = new ParallelScheduler(max(threads, 1), minWindow);
+}
+
+void ParallelScheduler::deleteScheduler() {
+    delete((ParallelScheduler*)scheduler.get());
+}
+
+bool ParallelScheduler::schedule(Event *ev) {
+    LogicalProcess *lp = currentLP;
+    if (lp == NULL) return Scheduler::schedule(ev);
+
+    assert(ev != NULL);
+    EventPtr pev(ev);
+
+    if (pev->date < lp->context.date || pev->date > maximumDate) {
+        lock_guard<mutex> lock(mutex_trace);
+        OUTPUT << "ERROR : An event cannot be scheduled in the past or beyond the end of simulation date !\n";
+        OUTPUT << "current time : " << lp->context.date << endl;
+        OUTPUT << "ev->eventDate : " << pev->date << endl;
+        OUTPUT << "ev->getEventName() : " << pev->getEventName() << endl;
+        return(false);
+    }
+
+    uint32_t idx = lp->nbChildren++;
+
+    if (pev->date < childrenEnd) {
+        // Transmissions of the logical process are handled in the current window
+        if (isTransmissionEvent(pev.get()) && findLP(pev->getOwnerBlock()) == lp) {
+            lp->push(Entry{pev->date, 1, idx, lp->processed.size() - 1, std::move(pev)});
+            return(true);
+        }
+
+        // Acting on another logical process, or running a block code, sooner than the lookahead:
+        //  other logical processes may already have processed later events of the window
+        if (nbEarlyEvents++ == 0) {
+            lock_guard<mutex> lock(mutex_trace);
+            BuildingBlock *owner = pev->getOwnerBlock();
+            cerr << TermColor::ErrorColor << "WARNING : " << pev->getEventName() << " scheduled at " << pev->date
+                 << " at " << lp->context.date << " for module #" << (owner ? (int)owner->blockId : -1)
+                 << " is sooner than the lookahead, it is held back until the end of the window and the "
+                 << "simulation may differ from a sequential one" << TermColor::Reset << endl;
+        }
+    }
+
+    // Events of the other dates of the window are processed by the next ones, as are those of
+    //  its last date, which a sequential execution would process after all the events of the window
+    lp->deferred.push_back(std::move(pev));
+    return(true);
+}
+
+bool ParallelScheduler::deferWorldAction(const std::function<void()> &action) {
+    if (currentLP == NULL) return false;
+
+    // Has no concerned block, hence processed as a global event
+    schedule(new WorldActionEvent(currentLP->context.date, action));
+    return true;
+}
+
+void ParallelScheduler::partition() {
+    // A few partitions per thread, claimed dynamically, balance the load when activity is localized
+    lps = vector<LogicalProcess>(4 * nbThreads);
+    partitionOf.clear();
+}
+
+bool ParallelScheduler::isTransmissionEvent(Event *ev) {
+    switch (ev->eventType) {
+    case EVENT_NI_ENQUEUE_OUTGOING_MESSAGE:
+    case EVENT_NI_START_TRANSMITTING:
+        return true;
+    case EVENT_NI_STOP_TRANSMITTING:
+        // Messages are handed to the receiving block by a NetworkInterfaceDeliverEvent
+        return not static_cast<NetworkInterfaceStopTransmittingEvent*>(ev)->deliver;
+    default:
+        return false;
+    }
+}
+
+ParallelScheduler::LogicalProcess& ParallelScheduler::getLP(BuildingBlock *bb) {
+    if (bb->blockId >= partitionOf.size()) partitionOf.resize(bb->blockId + 1, UINT32_MAX);
+
+    // Blocks are assigned to the slab of the lattice along the x axis they are in when first met
+    uint32_t &p = partitionOf[bb->blockId];
+    if (p == UINT32_MAX) {
+        int sizeX = max((int)getWorld()->lattice->gridSize[0], 1);
+        int x = min(max((int)bb->position[0], 0), sizeX - 1);
+        p = (uint32_t)x * lps.size() / sizeX;
+
+        for (P2PNetworkInterface *ni : bb->getP2PNetworkInterfaces())
+            lps[p].lookahead = min(lps[p].lookahead, ni->getMinimumDeliveryDelay());
+    }
+
+    return lps[p];
+}
+
+ParallelScheduler::LogicalProcess* ParallelScheduler::findLP(BuildingBlock *bb) {
+    if (bb == NULL || bb->blockId >= partitionOf.size() || partitionOf[bb->blockId] == UINT32_MAX) return NULL;
+    return &lps[partitionOf[bb->blockId]];
+}
+
+void ParallelScheduler::processGlobalEvent() {
+    EventPtr pev = eventsQueue->top();
+    currentDate = pev->date;
+    contextModule = pev->getConcernedBlock();
+    // World actions are the deferred part of events already logged and counted
+    const bool worldAction = pev->eventType == EVENT_WORLD_ACTION;
+    const bool logged = ReplayLog::isEnabled() and not worldAction;
+    if (logged) ReplayLog::beginEvent();
+    if (SchedulerProfiler::isEnabled()) SchedulerProfiler::beginEvent(currentDate, eventsMapSize);
+    pev->consume();
+    if (SchedulerProfiler::isEnabled()) SchedulerProfiler::endEvent(pev.get());
+    if (logged) ReplayLog::append(ReplayLog::endEvent(currentDate, pev.get()));
+    contextModule = NULL;
+    if (!worldAction) StatsCollector::getInstance().incEventsCount();
+    eventsQueue->pop();
+    eventsMapSize--;
+    nbGlobalEvents++;
+}
+
+void ParallelScheduler::processLP(LogicalProcess &lp) {
+    currentLP = &lp;
+    workerContext = &lp.context;
+
+    while (!lp.pending.empty()) {
+        Entry e = lp.pop();
+        lp.context.date = e.date;
+        lp.context.module = e.ev->getConcernedBlock();
+        lp.nbChildren = 0;
+        lp.processed.push_back(Record{e.date, e.cls, e.idx, e.rank, lp.deferred.size(), 0,
+                                      e.ev->eventType == EVENT_NI_DELIVER
+                                      and static_cast<NetworkInterfaceDeliverEvent*>(e.ev.get())->parallelOnly});
+        if (ReplayLog::isEnabled()) ReplayLog::beginEvent();
+        if (SchedulerProfiler::isEnabled()) SchedulerProfiler::beginEvent();
+        e.ev->consume();
+        if (SchedulerProfiler::isEnabled()) SchedulerProfiler::endEvent(e.ev.get());
+        if (ReplayLog::isEnabled()) lp.replayed.push_back(ReplayLog::endEvent(e.date, e.ev.get()));
+        lp.processed.back().endDeferred = lp.deferred.size();
+    }
+
+    lp.context.module = NULL;
+    workerContext = NULL;
+    currentLP = NULL;
+}
+
+void ParallelScheduler::processActiveLPs() {
+    size_t i;
+    while ((i = nextLP.fetch_add(1)) < activeLPs.size()) {
+        processLP(*activeLPs[i]);
+    }
+}
+
+void ParallelScheduler::workerLoop() {
+    RunContext::adopt(runContext);
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            unique_lock<mutex> lock(poolMutex);
+            poolCv.wait(lock, [this, seen]() { return stopWorkers || generation != seen; });
+            if (stopWorkers) return;
+            seen = generation;
+        }
+
+        processActiveLPs();
+
+        lock_guard<mutex> lock(poolMutex);
+        if (--nbBusyWorkers == 0) doneCv.notify_one();
+    }
+}
+
+void ParallelScheduler::processWindow() {
+    Time start = eventsQueue->top()->date;
+    windowEnd = TIME_MAX;
+    childrenEnd = TIME_MAX;
+    currentDate = start;
+    if (SchedulerProfiler::isEnabled()) SchedulerProfiler::sampleQueue(start, eventsMapSize);
+
+    // Distribute the events of the window, up to the first global one, to the logical processes,
+    //  while narrowing the window to the earliest date at which they may act on another one
+    uint64_t rank = 0;
+    while (!eventsQueue->empty()) {
+        const EventPtr &pev = eventsQueue->top();
+        if (pev->date >= windowEnd) break;
+        if (pev->isGlobal()) {
+            windowEnd = pev->date;
+            childrenEnd = min(childrenEnd, pev->date);
+            break;
+        }
+
+        LogicalProcess &lp = getLP(pev->getOwnerBlock());
+        if (!lp.active) {
+            lp.active = true;
+            activeLPs.push_back(&lp);
+        }
+        if (isTransmissionEvent(pev.get())) {
+            // Messages of this transmission, and of those it starts, are delivered after the lookahead
+            const Time delivery = pev->date > TIME_MAX - lp.lookahead ? TIME_MAX : pev->date + lp.lookahead;
+            childrenEnd = min(childrenEnd, delivery);
+            windowEnd = min(windowEnd, max(delivery, pev->date + 1));
+        } else {
+            // May run a block code acting on other modules right away: ends the window with its date
+            childrenEnd = min(childrenEnd, pev->date);
+            windowEnd = min(windowEnd, pev->date + 1);
+        }
+        lp.push(Entry{pev->date, 0, 0, rank++, pev});
+        eventsQueue->pop();
+        eventsMapSize--;
+    }
+    nbWindowEvents += rank;
+
+    if (rank < minParallelWindow || activeLPs.size() == 1 || workers.empty()) {
+        for (LogicalProcess *lp : activeLPs) processLP(*lp);
+    } else {
+        nbParallelWindows++;
+        {
+            lock_guard<mutex> lock(poolMutex);
+            nextLP = 0;
+            nbBusyWorkers = workers.size();
+            generation++;
+        }
+        poolCv.notify_all();
+        processActiveLPs();
+
+        unique_lock<mutex> lock(poolMutex);
+        doneCv.wait(lock, [this]() { return nbBusyWorkers == 0; });
+    }
+
+    mergeWindow();
+    nbWindows++;
+
+    for (LogicalProcess *lp : activeLPs) {
+        lp->processed.clear();
+        lp->replayed.clear();
+        lp->deferred.clear();
+        lp->globalRanks.clear();
+        lp->active = false;
+    }
+    activeLPs.clear();
+}
+
+void ParallelScheduler::mergeWindow() {
+    // Position of the next processed event to merge, in each logical process
+    struct Head {
+        LogicalProcess *lp;
+        size_t i;
+    };
+
+    // Reversed order of processing in a sequential execution. Events created in the window are
+    //  ordered by the rank of their parent, which has always been merged before them.
+    auto after = [](const Head &x, const Head &y) {
+        const Record &a = x.lp->processed[x.i];
+        const Record &b = y.lp->processed[y.i];
+        if (a.date != b.date) return a.date > b.date;
+        if (a.cls != b.cls) return a.cls > b.cls;
+        if (a.cls == 0) return a.rank > b.rank;
+        uint64_t pa = x.lp->globalRanks[a.rank], pb = y.lp->globalRanks[b.rank];
+        if (pa != pb) return pa > pb;
+        return a.idx > b.idx;
+    };
+
+    vector<Head> heads;
+    for (LogicalProcess *lp : activeLPs) {
+        if (lp->processed.empty()) continue;
+        lp->globalRanks.resize(lp->processed.size());
+        heads.push_back(Head{lp, 0});
+    }
+    make_heap(heads.begin(), heads.end(), after);
+
+    uint64_t rank = 0;
+    while (!heads.empty()) {
+        pop_heap(heads.begin(), heads.end(), after);
+        Head &h = heads.back();
+        const Record &r = h.lp->processed[h.i];
+        h.lp->globalRanks[h.i] = rank++;
+
+        // The queue numbers these events in insertion order, i.e. the order they would have been created in
+        for (size_t d = r.firstDeferred; d < r.endDeferred; d++) {
+            eventsQueue->push(std::move(h.lp->deferred[d]));
+            eventsMapSize++;
+        }
+        if (r.date > currentDate) currentDate = r.date;
+        if (ReplayLog::isEnabled()) ReplayLog::append(h.lp->replayed[h.i]);
+        // Deliveries without latency are the receiving part of end of transmission events of the sequential schedulers
+        if (!r.delivery) StatsCollector::getInstance().incEventsCount();
+
+        if (++h.i < h.lp->processed.size()) {
+            push_heap(heads.begin(), heads.end(), after);
+        } else {
+            heads.pop_back();
+        }
+    }
+
+    StatsCollector::getInstance().updateLargestEventsQueueSize(eventsMapSize);
+}
+
+void *ParallelScheduler::startPaused(/*void *param*/) {
+    RunContext::adopt(runContext);
+    cout << TermColor::SchedulerColor << "Scheduler Mode :" << schedulerMode << TermColor::Reset  << endl;
+    cout << TermColor::SchedulerColor << "Scheduler Length :" << schedulerLength << TermColor::Reset  << endl;
+    sem_schedulerStart->wait();
+
+    // if ENDED: Simulation terminated before scheduler start, quitting
+    if (state != ENDED) {
+
+        state = RUNNING;
+
+        partition();
+        for (int i = 1; i < nbThreads; i++) {
+            workers.emplace_back(&ParallelScheduler::workerLoop, this);
+        }
+
+        auto systemStartTime = get_time::now();
+        cout << TermColor::SchedulerColor << "" << "Scheduler : start order received " << 0 << TermColor::Reset << endl;
+        cout << TermColor::SchedulerColor << "Parallel scheduler : " << nbThreads << " thread(s), "
+             << lps.size() << " partition(s)" << TermColor::Reset << endl;
+
+        // Events are processed as fast as possible, whatever the requested mode
+        while(!eventsQueue->empty() || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
+            // Check that we have not reached the maximum simulation date, if there is one
+            if (currentDate > maximumDate) {
+                cout << TermColor::SchedulerColor << "" << "Scheduler : maximum simulation date (" << maximumDate
+                     << ") has been reached. Terminating..." << TermColor::Reset << endl;
+                break;
+            }
+
+            if (!eventsQueue->empty()) {
+                if (eventsQueue->top()->isGlobal()) processGlobalEvent();
+                else processWindow();
+            }
+
+            if (terminate.load()) {
+                break;
+            }
+        }
+
+        {
+            lock_guard<mutex> lock(poolMutex);
+            stopWorkers = true;
+        }
+        poolCv.notify_all();
+        for (thread &t : workers) t.join();
+        workers.clear();
+
+        auto systemStopTime = get_time::now();
+        auto elapsedTime = systemStopTime - systemStartTime;
+
+        cout << TermColor::SchedulerColor << "Scheduler end : " << chrono::duration_cast<us>(elapsedTime).count() << TermColor::Reset << endl;
+        Time minLookahead = TIME_MAX, maxLookahead = 0;
+        for (const LogicalProcess &lp : lps) {
+            if (lp.lookahead == TIME_MAX) continue;
+            minLookahead = min(minLookahead, lp.lookahead);
+            maxLookahead = max(maxLookahead, lp.lookahead);
+        }
+        cout << TermColor::SchedulerColor << "Parallel scheduler : " << nbWindows << " window(s) of "
+             << (nbWindows ? (double)nbWindowEvents / nbWindows : 0) << " event(s) on average, "
+             << nbParallelWindows << " processed by several threads, " << nbGlobalEvents << " global event(s)";
+        if (minLookahead <= maxLookahead)
+            cout << ", lookahead " << minLookahead << " to " << maxLookahead << " us";
+        cout << TermColor::Reset << endl;
+        if (nbEarlyEvents > 0) {
+            cerr << TermColor::ErrorColor << "WARNING : " << nbEarlyEvents << " event(s) scheduled sooner than "
+                 << "the lookahead were held back" << TermColor::Reset << endl;
+        }
+
+        StatsCollector::getInstance().updateElapsedTime(currentDate, chrono::duration_cast<us>(elapsedTime).count());
+        StatsCollector::getInstance().setLivingCounters(Event::getNbLivingEvents(), Message::getNbMessages());
+        StatsCollector::getInstance().setEventPoolCounters(PoolAllocator::getNbSlabs(), PoolAllocator::getReservedBytes(),
+                                                            PoolAllocator::getNbLargeAllocations());
+        StatsCollector::getInstance().setEndEventsQueueSize(eventsQueue->size());
+        ReplayLog::close();
+        SchedulerProfiler::write();
+
+        // if simulation is a regression testing run, export configuration before leaving
+        if ((Simulator::regrTesting or Simulator::exportFinalConfiguration)
+            && !terminate.load()) {
+            getWorld()->exportConfiguration();
+        }
+
+        // if autoStop is enabled, terminate simulation
+        if (willAutoStop() && !terminate.load()) {
+            glutLeaveMainLoop();
+        }
+
+        printStats();
+
+    }
+
+    terminate.store(true);
+    schedulerThread = NULL;	// No need for the scheduler to delete this thread, it will have terminated already
+
+    return(NULL);
+}
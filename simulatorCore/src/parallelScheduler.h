@@ -0,0 +1,182 @@
+/*! @file parallelScheduler.h
+ * @brief Conservative parallel discrete event scheduler, processing the events of distinct
+ *  regions of the lattice on several threads.
+ *
+ *  Simulated time is cut into windows (YAWNS protocol, D. Nicol, 1993), whose events are processed
+ *  concurrently by logical processes in charge of regions of the lattice. A window ends before the
+ *  earliest date at which one of its events may act on another logical process, which is derived
+ *  from the events themselves:
+ *  - transmission events (start and end of transmissions, messages queued for sending) only act on
+ *    the interface of their block, and deliver messages after the lookahead of their logical
+ *    process: the minimum transmission duration of a message header plus the minimum latency of
+ *    the links of its blocks (see P2PNetworkInterface::getMinimumDeliveryDelay()).
+ *  - other events may run a block code, which may start a motion, add or remove a module, or send
+ *    an event to another module right away: the window ends with their date.
+ *  Events that may act on several blocks (motions, see Event::isGlobal()) close the window, and are
+ *  processed alone, in order.
+ *
+ *  Transmission events scheduled during a window for the same logical process, before the first
+ *  date at which another logical process may be acted upon, are processed in it, other events are
+ *  processed by the next windows. Events are never moved in time. An event scheduled sooner than
+ *  allowed by the lookahead (e.g. by a message smaller than its header) is held back until the end
+ *  of the window and reported, since other logical processes may have processed later events.
+ *
+ *  Events scheduled during a window are merged back into the pending event set at its end, in
+ *  the order a sequential execution would have created them. Results are thus independent of the
+ *  number of threads and of the partition, and identical to those of the CPPScheduler, except
+ *  that the modules added or removed by a block code are only so once the events of the window
+ *  are processed (see deferWorldAction()).
+ *
+ *  @attention Block codes must only interact with other blocks through messages and motions:
+ *   direct accesses to the code or state of other blocks, and unprotected shared variables, are not safe.
+ * @date 17/10/2026
+ */
+
+#ifndef PARALLELSCHEDULER_H_
+#define PARALLELSCHEDULER_H_
+
+#include <thread>
+#include <functional>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+#include "scheduler.h"
+#include "network.h"
+#include "trace.h"
+#include "replayLog.h"
+
+class ParallelScheduler : public BaseSimulator::Scheduler {
+protected:
+    /**
+     * @brief A pending event of a logical process, with its ordering key in the window.
+     *  Events taken from the global queue (cls 0) are ordered by their rank in it. Events
+     *  created during the window (cls 1) come after them, ordered by the processing rank of
+     *  their parent in the logical process, then by creation order (idx).
+     */
+    struct Entry {
+        Time date;
+        uint32_t cls;
+        uint32_t idx;
+        uint64_t rank;
+        EventPtr ev;
+
+        //!< @brief Returns true if this event is to be processed after e
+        inline bool after(const Entry &e) const {
+            if (date != e.date) return date > e.date;
+            if (cls != e.cls) return cls > e.cls;
+            if (rank != e.rank) return rank > e.rank;
+            return idx > e.idx;
+        }
+    };
+
+    //!< Ordering key of a processed event, and range of the events it scheduled after the window
+    struct Record {
+        Time date;
+        uint32_t cls;
+        uint32_t idx;
+        uint64_t rank;
+        size_t firstDeferred;
+        size_t endDeferred;
+        bool delivery;                          //!< Not counted, see NetworkInterfaceDeliverEvent::parallelOnly
+    };
+
+    //!< Events of a region of the lattice, processed by a single thread during a window
+    struct LogicalProcess {
+        std::vector<Entry> pending;             //!< Binary min-heap of events to process in the window
+        std::vector<Record> processed;          //!< Processed events, in processing order
+        std::vector<ReplayLog::Entry> replayed; //!< Replay log records of the processed events, if logged
+        std::vector<EventPtr> deferred;         //!< Events scheduled beyond the window, in creation order
+        std::vector<uint64_t> globalRanks;      //!< Global processing rank of each processed event, set at merge
+        WorkerContext context;                  //!< Date and block of the event being processed
+        Time lookahead = TIME_MAX;              //!< Minimum delay between a transmission by its blocks and the delivery of the message
+        uint32_t nbChildren = 0;                //!< Number of events scheduled by the event being processed
+        bool active = false;                    //!< Has events in the current window
+
+        void push(Entry &&e);
+        Entry pop();
+    };
+
+    int nbThreads;                              //!< Number of threads processing windows, including the scheduler thread
+    size_t minParallelWindow;                   //!< Smaller windows are processed by the scheduler thread alone
+    Time windowEnd = 0;                         //!< Exclusive upper bound of the dates of the events of the current window
+    Time childrenEnd = 0;                       //!< Exclusive upper bound of the dates of the events scheduled and processed in the current window
+    std::vector<LogicalProcess> lps;            //!< One logical process per partition
+    std::vector<uint32_t> partitionOf;          //!< Partition of each block, indexed by blockId (UINT32_MAX if not assigned yet)
+    std::vector<LogicalProcess*> activeLPs;     //!< Logical processes having events in the current window
+
+    // Worker threads
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable poolCv;             //!< Signals a new window, or the end of the simulation
+    std::condition_variable doneCv;             //!< Signals the scheduler thread that workers are done
+    uint64_t generation = 0;                    //!< Incremented for each window processed by the workers
+    int nbBusyWorkers = 0;
+    bool stopWorkers = false;
+    std::atomic<size_t> nextLP{0};              //!< Next active logical process to be claimed by a thread
+
+    // Statistics
+    uint64_t nbWindows = 0;
+    uint64_t nbParallelWindows = 0;             //!< Windows processed by several threads
+    uint64_t nbWindowEvents = 0;                //!< Events taken from the queue by windows
+    uint64_t nbGlobalEvents = 0;
+    std::atomic<uint64_t> nbEarlyEvents{0};     //!< Events held back, scheduled sooner than the lookahead allows
+
+    //!< Logical process of the events currently processed by the calling thread, NULL outside of windows
+    inline static thread_local LogicalProcess *currentLP = NULL;
+
+    ParallelScheduler(int threads, size_t minWindow);
+    virtual ~ParallelScheduler();
+    void* startPaused(/*void *param */);
+
+    //!< @brief Creates the logical processes, each one being in charge of a slab of the lattice
+    void partition();
+    //!< @brief Returns true if ev only acts on the interface of its block, and delivers messages after the lookahead
+    static bool isTransmissionEvent(Event *ev);
+    //!< @brief Returns the logical process in charge of the events of bb, assigning it to a partition if needed
+    LogicalProcess& getLP(BaseSimulator::BuildingBlock *bb);
+    //!< @brief Returns the logical process in charge of the events of bb, NULL if not assigned yet. Safe during windows.
+    LogicalProcess* findLP(BaseSimulator::BuildingBlock *bb);
+    //!< @brief Processes the earliest event of the queue alone, like the CPPScheduler does
+    void processGlobalEvent();
+    //!< @brief Processes all the local events of the next window
+    void processWindow();
+    //!< @brief Processes all the events of lp for the current window
+    void processLP(LogicalProcess &lp);
+    //!< @brief Claims and processes active logical processes until there is none left
+    void processActiveLPs();
+    //!< @brief Inserts the events scheduled during the window into the queue, in sequential creation order
+    void mergeWindow();
+    void workerLoop();
+
+public:
+    /**
+     * @brief Creates the scheduler
+     * @param threads number of threads processing events
+     * @param minWindow minimum number of events of a window for it to be processed by several threads
+     */
+    static void createScheduler(int threads, size_t minWindow = 64);
+    static void deleteScheduler();
+    static ParallelScheduler* getScheduler() {
+        assert(scheduler != NULL);
+        return((ParallelScheduler*)scheduler.get());
+    }
+
+    void printInfo() override {
+        OUTPUT << "I'm a ParallelScheduler" << endl;
+    }
+
+    bool schedule(Event *ev) override;
+    bool isParallel() const override { return true; }
+    //!< @brief Actions requested during a window are postponed to its end, and performed alone
+    bool deferWorldAction(const std::function<void()> &action) override;
+
+    void waitForSchedulerEnd() {
+        schedulerThread->join();
+    }
+
+    inline int getMode() { return schedulerMode; }
+};
+
+#endif /* PARALLELSCHEDULER_H_ */
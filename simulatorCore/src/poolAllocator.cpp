@@ -0,0 +1,101 @@
+/*! @file poolAllocator.cpp
+ * @brief Size-class slab allocator for small, short-lived simulation objects (events).
+ * @date 17/10/2026
+ */
+
+#include "poolAllocator.h"
+
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <cstdlib>
+
+namespace BaseSimulator {
+namespace utils {
+
+static const size_t nbSizeClasses = PoolAllocator::maxPooledSize / PoolAllocator::granularity;
+
+//!< A free block, linked to the next free block of the same size class
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+// Each thread recycles the blocks it releases, without any synchronization. Blocks allocated
+//  by a thread (e.g. the GUI thread) can safely be released by another one (the scheduler).
+static thread_local FreeBlock *freeLists[nbSizeClasses];
+
+static std::mutex slabsMutex; //!< Protects the slab counters below
+static uint64_t nbSlabs = 0;
+static uint64_t reservedBytes = 0;
+static std::atomic<uint64_t> nbLargeAllocations{0};
+
+static inline size_t sizeClass(size_t size) {
+    return (size + PoolAllocator::granularity - 1) / PoolAllocator::granularity - 1;
+}
+
+//!< @brief Carves a new slab into free blocks of size class cls, for the calling thread
+static void refill(size_t cls) {
+    const size_t blockSize = (cls + 1) * PoolAllocator::granularity;
+    char *slab = static_cast<char*>(std::malloc(PoolAllocator::slabSize));
+    if (slab == NULL) throw std::bad_alloc();
+
+    {
+        std::lock_guard<std::mutex> lock(slabsMutex);
+        nbSlabs++;
+        reservedBytes += PoolAllocator::slabSize;
+    }
+
+    // Slabs are never returned to the system: events may still be released during static
+    //  destruction, and the memory is reused for the whole simulation anyway.
+    const size_t nbBlocks = PoolAllocator::slabSize / blockSize;
+    for (size_t i = nbBlocks; i-- > 0;) {
+        FreeBlock *b = reinterpret_cast<FreeBlock*>(slab + i * blockSize);
+        b->next = freeLists[cls];
+        freeLists[cls] = b;
+    }
+}
+
+void* PoolAllocator::allocate(size_t size) {
+    if (size > maxPooledSize) {
+        nbLargeAllocations.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    size_t cls = sizeClass(size ? size : 1);
+    if (freeLists[cls] == NULL) refill(cls);
+
+    FreeBlock *b = freeLists[cls];
+    freeLists[cls] = b->next;
+    return b;
+}
+
+void PoolAllocator::deallocate(void *p, size_t size) {
+    if (p == NULL) return;
+
+    if (size > maxPooledSize) {
+        ::operator delete(p);
+        return;
+    }
+
+    size_t cls = sizeClass(size ? size : 1);
+    FreeBlock *b = static_cast<FreeBlock*>(p);
+    b->next = freeLists[cls];
+    freeLists[cls] = b;
+}
+
+uint64_t PoolAllocator::getNbSlabs() {
+    std::lock_guard<std::mutex> lock(slabsMutex);
+    return nbSlabs;
+}
+
+uint64_t PoolAllocator::getReservedBytes() {
+    std::lock_guard<std::mutex> lock(slabsMutex);
+    return reservedBytes;
+}
+
+uint64_t PoolAllocator::getNbLargeAllocations() {
+    return nbLargeAllocations.load(std::memory_order_relaxed);
+}
+
+} // namespace utils
+} // namespace BaseSimulator
@@ -0,0 +1,48 @@
+/*! @file poolAllocator.h
+ * @brief Size-class slab allocator for small, short-lived simulation objects (events).
+ *  Blocks are recycled through per-thread free lists, so that once the simulation has reached
+ *  its working set, allocating and releasing objects never goes through malloc.
+ * @date 17/10/2026
+ */
+
+#ifndef POOLALLOCATOR_H_
+#define POOLALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BaseSimulator {
+namespace utils {
+
+class PoolAllocator {
+public:
+    static const size_t granularity = 16; //!< Sizes are rounded up to a multiple of granularity
+    static const size_t maxPooledSize = 1024; //!< Larger objects are directly allocated with ::operator new (motion events hold a whole Rotations3D)
+    static const size_t slabSize = 64 * 1024; //!< Size of the memory chunks from which blocks are carved
+
+    /**
+     * @brief Allocates a block of at least size bytes
+     * @param size requested size
+     * @return pointer to the block, aligned on granularity
+     */
+    static void* allocate(size_t size);
+
+    /**
+     * @brief Returns a block to the pool
+     * @param p block previously returned by allocate
+     * @param size the size that was given to allocate
+     */
+    static void deallocate(void *p, size_t size);
+
+    //!< @brief Returns the number of slabs allocated so far (each one is a single malloc)
+    static uint64_t getNbSlabs();
+    //!< @brief Returns the number of bytes reserved by the slabs
+    static uint64_t getReservedBytes();
+    //!< @brief Returns the number of allocations too large to be pooled
+    static uint64_t getNbLargeAllocations();
+};
+
+} // namespace utils
+} // namespace BaseSimulator
+
+#endif // POOLALLOCATOR_H_
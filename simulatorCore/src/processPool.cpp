@@ -0,0 +1,108 @@
+/*! @file processPool.cpp
+ * @brief Pool of processes running independent simulations.
+ * @date 17/10/2026
+ */
+
+#include "processPool.h"
+
+#include <map>
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+
+#include "simulator.h"
+#include "statsCollector.h"
+#include "trace.h"
+
+using namespace std;
+using namespace BaseSimulator::utils;
+
+namespace BaseSimulator {
+
+int ProcessPool::resultFd = -1;
+
+long ProcessPool::run(size_t nbRuns, int nbProcesses, vector<Outcome> &outcomes) {
+    if (nbProcesses <= 0) nbProcesses = max(1u, thread::hardware_concurrency());
+    outcomes.assign(nbRuns, Outcome());
+
+    map<pid_t, pair<size_t,int>> children; // Run and read end of its pipe, per process
+    size_t next = 0;
+    while (next < nbRuns or not children.empty()) {
+        if (next < nbRuns and children.size() < (size_t)nbProcesses) {
+            int fds[2];
+            if (pipe(fds) != 0) {
+                perror("pipe");
+                exit(EXIT_FAILURE);
+            }
+
+            cout.flush();
+            cerr.flush();
+            const pid_t pid = fork();
+            if (pid < 0) {
+                perror("fork");
+                exit(EXIT_FAILURE);
+            }
+
+            if (pid == 0) {
+                for (auto &child : children) close(child.second.second);
+                close(fds[0]);
+                const int devNull = open("/dev/null", O_WRONLY);
+                dup2(devNull, STDOUT_FILENO);
+                dup2(devNull, STDERR_FILENO);
+                close(devNull);
+                if (log_file.is_open()) log_file.close();
+                Simulator::exportFinalConfiguration = false;
+                Simulator::regrTesting = false;
+                resultFd = fds[1];
+                return next;
+            }
+
+            close(fds[1]);
+            children[pid] = make_pair(next++, fds[0]);
+        } else {
+            int status;
+            const pid_t pid = wait(&status);
+            auto it = children.find(pid);
+            if (it == children.end()) continue;
+
+            // Results are small enough to stay in the pipe until the process exits
+            Outcome &outcome = outcomes[it->second.first];
+            uint8_t buffer[4096];
+            ssize_t n;
+            while ((n = read(it->second.second, buffer, sizeof(buffer))) > 0)
+                outcome.data.insert(outcome.data.end(), buffer, buffer + n);
+            outcome.reported = not outcome.data.empty();
+            close(it->second.second);
+            children.erase(it);
+        }
+    }
+
+    return -1;
+}
+
+void ProcessPool::report(const void *data, size_t size) {
+    if (resultFd < 0) return;
+
+    if (write(resultFd, data, size) != (ssize_t)size) perror("write");
+    close(resultFd);
+    resultFd = -1;
+}
+
+ProcessPool::Summary ProcessPool::getSummary() {
+    const StatsCollector &stats = StatsCollector::getInstance();
+    Summary s;
+    s.completed = stats.isCompleted();
+    s.completionDate = stats.getCompletionDate();
+    s.nbMessages = s.completed ? stats.getCompletionMsgCount() : stats.getMsgCount();
+    s.endDate = stats.getSimulatedElapsedTime();
+    s.nbEvents = stats.getEventsCount();
+    s.realTime = stats.getRealElapsedTime();
+    return s;
+}
+
+} // BaseSimulator namespace
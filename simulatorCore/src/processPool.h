@@ -0,0 +1,65 @@
+/*! @file processPool.h
+ * @brief Pool of processes running independent simulations, used by the fault injection
+ *  campaigns.
+ * @date 17/10/2026
+ */
+
+#ifndef PROCESSPOOL_H_
+#define PROCESSPOOL_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "tDefs.h"
+
+namespace BaseSimulator {
+
+/**
+ * @brief Runs simulations in forked processes, a given number at once.
+ *
+ *  Simulations are forked once the command line and the configuration files are read, which they
+ *  share with the parent process, and before any thread is started. Simulation processes are silent, and report their result to the parent
+ *  process through a pipe.
+ */
+class ProcessPool {
+    static int resultFd;        //!< Write end of the pipe to the parent process, -1 in the parent process
+public:
+    //!< Result of a simulation, as reported by its process
+    struct Outcome {
+        bool reported = false;  //!< False if the process died before reporting
+        std::vector<uint8_t> data;
+    };
+
+    /**
+     * @brief Forks a process per simulation, nbProcesses at once
+     * @param nbRuns number of simulations
+     * @param nbProcesses number of simulations run at once, 0 for the number of cores
+     * @param outcomes set to the results of the simulations, in the parent process
+     * @return in a simulation process, the index of its simulation. In the parent process, -1
+     *  once all the simulation processes have exited.
+     *  Simulation processes forked from the scheduler thread only have this thread, and exit
+     *  with it.
+     */
+    static long run(size_t nbRuns, int nbProcesses, std::vector<Outcome> &outcomes);
+
+    static bool isSimulationProcess() { return resultFd >= 0; }
+
+    //!< @brief Sends the result of the simulation to the parent process, once
+    static void report(const void *data, size_t size);
+
+    //!< @brief Summary of a simulation, from its statistics (also reported by the batch mode)
+    struct Summary {
+        uint8_t completed;      //!< See StatsCollector::notifyCompletion
+        Time completionDate;
+        uint64_t nbMessages;    //!< Sent before completion, or before the end of the simulation
+        Time endDate;
+        uint64_t nbEvents;
+        double realTime;        //!< us
+    };
+    static Summary getSummary();
+};
+
+} // BaseSimulator namespace
+
+#endif /* PROCESSPOOL_H_ */
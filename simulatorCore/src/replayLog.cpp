@@ -0,0 +1,194 @@
+/*! @file replayLog.cpp
+ * @brief Replay log of the processed events.
+ * @date 17/10/2026
+ */
+
+#include "replayLog.h"
+
+#include <iostream>
+#include <iterator>
+#include <cstring>
+
+#include "events.h"
+#include "buildingBlock.h"
+#include "trace.h"
+
+using namespace std;
+using namespace BaseSimulator::utils;
+
+namespace BaseSimulator {
+
+ReplayLog::Mode ReplayLog::mode = ReplayLog::Mode::None;
+string ReplayLog::filename;
+ofstream ReplayLog::out;
+vector<uint8_t> ReplayLog::buffer;
+size_t ReplayLog::position = 0;
+Time ReplayLog::lastDate = 0;
+uint64_t ReplayLog::nbEntries = 0;
+bool ReplayLog::diverged = false;
+string ReplayLog::scheduler;
+
+namespace {
+
+const char magic[] = { 'V', 'S', 'R', 'L', 2 };
+
+const size_t flushSize = 1 << 16;   //!< Recorded bytes written at once
+
+void writeVarint(vector<uint8_t> &b, uint64_t v) {
+    while (v >= 0x80) {
+        b.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    b.push_back((uint8_t)v);
+}
+
+bool readVarint(const vector<uint8_t> &b, size_t &pos, uint64_t &v) {
+    v = 0;
+    for (int shift = 0; pos < b.size() and shift < 64; shift += 7) {
+        const uint8_t byte = b[pos++];
+        v |= (uint64_t)(byte & 0x7F) << shift;
+        if (not (byte & 0x80)) return true;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+bool ReplayLog::open(const string &file, Mode m) {
+    filename = file;
+    buffer.clear();
+
+    if (m == Mode::Record) {
+        out.open(file, ios::binary | ios::trunc);
+        if (not out) return false;
+        buffer.insert(buffer.end(), magic, magic + sizeof(magic));
+    } else {
+        ifstream in(file, ios::binary);
+        if (not in) return false;
+        buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        if (buffer.size() < sizeof(magic) or memcmp(buffer.data(), magic, sizeof(magic)) != 0)
+            return false;
+        position = sizeof(magic);
+
+        uint64_t length;
+        if (not readVarint(buffer, position, length) or position + length > buffer.size())
+            return false;
+        scheduler.assign((const char*)&buffer[position], length);
+        position += length;
+    }
+
+    mode = m;
+    return true;
+}
+
+bool ReplayLog::setScheduler(const string &name) {
+    if (mode == Mode::Check) return name == scheduler;
+
+    // The header is written with the first records
+    scheduler = name;
+    writeVarint(buffer, name.size());
+    buffer.insert(buffer.end(), name.begin(), name.end());
+    return true;
+}
+
+ReplayLog::Entry ReplayLog::endEvent(Time date, Event *ev) {
+    Entry e;
+    e.date = date;
+    e.type = ev->eventType;
+    BuildingBlock *bb = ev->getConcernedBlock();
+    e.blockId = bb ? bb->blockId : 0;
+    e.nbDraws = nbDraws;
+    e.drawsHash = nbDraws ? drawsHash : 0;
+    return e;
+}
+
+bool ReplayLog::readEntry(Entry &e) {
+    uint64_t delta, type, id, draws;
+    if (not readVarint(buffer, position, delta) or not readVarint(buffer, position, type)
+        or not readVarint(buffer, position, id) or not readVarint(buffer, position, draws))
+        return false;
+
+    e.date = lastDate + delta;
+    e.type = (int)type;
+    e.blockId = (bID)id;
+    e.nbDraws = (uint32_t)draws;
+    e.drawsHash = 0;
+    if (draws) {
+        if (position + 4 > buffer.size()) return false;
+        memcpy(&e.drawsHash, &buffer[position], 4);
+        position += 4;
+    }
+
+    return true;
+}
+
+void ReplayLog::append(const Entry &e) {
+    if (mode == Mode::Record) {
+        writeVarint(buffer, e.date - lastDate);
+        writeVarint(buffer, (uint64_t)e.type);
+        writeVarint(buffer, e.blockId);
+        writeVarint(buffer, e.nbDraws);
+        if (e.nbDraws) buffer.insert(buffer.end(), (const uint8_t*)&e.drawsHash, (const uint8_t*)&e.drawsHash + 4);
+        if (buffer.size() >= flushSize) {
+            out.write((const char*)buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    } else if (not diverged) {
+        Entry recorded;
+        if (position >= buffer.size()) {
+            report(NULL, &e);
+        } else if (not readEntry(recorded)) {
+            cerr << TermColor::ErrorColor << "error: replay log " << filename << " is truncated at event "
+                 << nbEntries << TermColor::Reset << endl;
+            diverged = true;
+        } else if (not (recorded == e)) {
+            report(&recorded, &e);
+        }
+    }
+
+    lastDate = e.date;
+    nbEntries++;
+}
+
+void ReplayLog::report(const Entry *recorded, const Entry *replayed) {
+    // Only the first divergence is meaningful, the following events differ in cascade
+    diverged = true;
+
+    auto print = [](const char *what, const Entry *e) {
+        cerr << "\t" << what << ": ";
+        if (not e) {
+            cerr << "none" << endl;
+            return;
+        }
+        cerr << "date " << e->date << ", event type " << e->type << ", module " << e->blockId
+             << ", " << e->nbDraws << " random draw(s)";
+        if (e->nbDraws) cerr << " (hash " << hex << e->drawsHash << dec << ")";
+        cerr << endl;
+    };
+
+    cerr << TermColor::ErrorColor << "Replay diverges from " << filename << " at event " << nbEntries
+         << TermColor::Reset << endl;
+    print("recorded", recorded);
+    print("replayed", replayed);
+}
+
+void ReplayLog::close() {
+    if (mode == Mode::Record) {
+        out.write((const char*)buffer.data(), buffer.size());
+        out.close();
+        cerr << "Replay log: " << nbEntries << " events recorded in " << filename << endl;
+    } else if (mode == Mode::Check and not diverged) {
+        if (position < buffer.size()) {
+            Entry recorded;
+            if (readEntry(recorded)) report(&recorded, NULL);
+            else cerr << TermColor::ErrorColor << "error: replay log " << filename << " is truncated" << TermColor::Reset << endl;
+        } else {
+            cerr << "Replay log: " << nbEntries << " events identical to " << filename << endl;
+        }
+    }
+
+    buffer.clear();
+    mode = Mode::None;
+}
+
+} // BaseSimulator namespace
@@ -0,0 +1,118 @@
+/*! @file replayLog.h
+ * @brief Replay log of the processed events, recording a simulation or checking that it
+ *  replays a recorded one identically.
+ * @date 17/10/2026
+ */
+
+#ifndef REPLAYLOG_H_
+#define REPLAYLOG_H_
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+#include "tDefs.h"
+#include "random.h"
+
+class Event;
+
+namespace BaseSimulator {
+
+/**
+ * @brief Compact binary log of the events processed by the scheduler, in processing order: their
+ *  date, type, module, and the random numbers the module generators drew while processing them.
+ *  Numbers of the simulation generator are drawn when modules are created, possibly after the
+ *  event requesting it (see ParallelScheduler::deferWorldAction). They seed the module generators,
+ *  whose draws then differ if they do.
+ *
+ *  A simulation either records its log (-L command line option), or checks its events against a
+ *  recorded log (-V command line option), and reports the first event that differs. A simulation
+ *  run again with the same configuration file, seed and scheduler replays its log identically.
+ *  Logs record their scheduler (see setScheduler), and are only checked against the same one.
+ *
+ *  The log starts with a header ("VSRL", version, length and name of the scheduler), followed by
+ *  a record per event, made of varints: date increment, event type, module id (0 for global
+ *  events), number of random draws, then, if there were draws, a 4 bytes hash of the drawn numbers.
+ */
+class ReplayLog {
+public:
+    //!< Record of a processed event
+    struct Entry {
+        Time date = 0;
+        int type = 0;
+        bID blockId = 0;
+        uint32_t nbDraws = 0;
+        uint32_t drawsHash = 0;
+
+        bool operator==(const Entry &e) const {
+            return date == e.date and type == e.type and blockId == e.blockId
+                and nbDraws == e.nbDraws and drawsHash == e.drawsHash;
+        }
+    };
+
+    enum class Mode { None, Record, Check };
+
+private:
+    static Mode mode;
+    static std::string filename;
+    static std::ofstream out;
+    static std::vector<uint8_t> buffer;     //!< Encoded records, recorded or to check
+    static size_t position;                 //!< Next record to check in buffer
+    static Time lastDate;
+    static uint64_t nbEntries;
+    static bool diverged;
+
+    // Random numbers drawn by the event being processed by this thread
+    inline static thread_local uint32_t nbDraws = 0;
+    inline static thread_local uint32_t drawsHash = 0;
+
+    static std::string scheduler;           //!< Scheduler of the log, see setScheduler
+
+    static bool readEntry(Entry &e);
+    static void report(const Entry *recorded, const Entry *replayed);
+public:
+    /**
+     * @brief Opens a replay log
+     * @param file log to record, or to check the simulation against
+     * @param m Record or Check
+     * @return false if the file cannot be opened, or is not a replay log
+     */
+    static bool open(const std::string &file, Mode m);
+    static bool isEnabled() { return mode != Mode::None; }
+
+    /**
+     * @brief Records the scheduler of the simulation in the log, or checks that the log was
+     *  recorded with this scheduler. Called once the command line is read, before any event.
+     * @param name scheduler and its parameters, such as "parallel 4 threads"
+     * @return false if the log to check was recorded with another scheduler, see getScheduler
+     */
+    static bool setScheduler(const std::string &name);
+    //!< @brief Returns the scheduler of the log
+    static const std::string& getScheduler() { return scheduler; }
+
+    //!< @brief Accounts a random number drawn by the event being processed by the calling thread
+    static void noteDraw(ruint v) {
+        nbDraws++;
+        drawsHash = (drawsHash ^ (uint32_t)v) * 16777619u;
+    }
+
+    //!< @brief Called before processing an event, by the thread processing it
+    static void beginEvent() { nbDraws = 0; drawsHash = 2166136261u; }
+
+    //!< @brief Called after processing ev, by the thread processing it. Returns its record.
+    static Entry endEvent(Time date, Event *ev);
+
+    /**
+     * @brief Records e, or checks it against the log, reporting the first divergence. Must be
+     *  called in processing order.
+     */
+    static void append(const Entry &e);
+
+    //!< @brief Flushes the recorded log, or checks that the simulation did not end early
+    static void close();
+};
+
+} // BaseSimulator namespace
+
+#endif /* REPLAYLOG_H_ */
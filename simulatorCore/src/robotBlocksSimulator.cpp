@@ -35,9 +35,9 @@ RobotBlocksSimulator::~RobotBlocksSimulator() {
 }
 
 void RobotBlocksSimulator::createSimulator(int argc, char *argv[], BlockCodeBuilder bcb) {
-    simulator =  new RobotBlocksSimulator(argc, argv, bcb);
-    simulator->parseConfiguration(argc, argv);
-    simulator->startSimulation();
+    Simulator::createSimulator(argc, argv, bcb, [](int argc, char *argv[], BlockCodeBuilder bcb) -> Simulator* {
+        return new RobotBlocksSimulator(argc, argv, bcb);
+    });
 }
 
 void RobotBlocksSimulator::loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
@@ -30,7 +30,7 @@ public:
 
     static RobotBlocksSimulator* getSimulator() {
         assert(simulator != NULL);
-        return((RobotBlocksSimulator*)simulator);
+        return((RobotBlocksSimulator*)simulator.get());
     }
 
     virtual void loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
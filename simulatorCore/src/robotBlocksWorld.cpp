@@ -45,11 +45,14 @@ RobotBlocksWorld::~RobotBlocksWorld() {
 }
 
 void RobotBlocksWorld::deleteWorld() {
-    delete((RobotBlocksWorld*)world);
+    delete((RobotBlocksWorld*)world.get());
 }
 
 void RobotBlocksWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPosition &pos,
                                 const Color &col, short orientation, bool master) {
+    if (getScheduler()->deferWorldAction([=]() { addBlock(blockId, bcb, pos, col, orientation, master); }))
+        return;
+
     if (blockId > maxBlockId)
         maxBlockId = blockId;
     else if (blockId == 0)
@@ -79,7 +82,7 @@ void RobotBlocksWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DP
 void RobotBlocksWorld::linkBlock(const Cell3DPosition &pos) {
     RobotBlocksBlock *ptrNeighbor;
     RobotBlocksBlock *ptrBlock = (RobotBlocksBlock*)lattice->getBlock(pos);
-    vector<Cell3DPosition> nRelCells = lattice->getRelativeConnectivity(pos);
+    const vector<Cell3DPosition> &nRelCells = lattice->getRelativeConnectivity(pos);
     Cell3DPosition nPos;
 
     // Check neighbors for each interface
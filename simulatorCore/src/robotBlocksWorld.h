@@ -37,7 +37,7 @@ public:
     static void deleteWorld();
     static RobotBlocksWorld* getWorld() {
         assert(world != NULL);
-        return((RobotBlocksWorld*)world);
+        return((RobotBlocksWorld*)world.get());
     }
 
     void printInfo() {
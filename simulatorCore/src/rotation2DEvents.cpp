@@ -9,6 +9,7 @@
 #include "rotation2DEvents.h"
 #include "catoms2DWorld.h"
 #include "utils.h"
+#include "simulator.h"
 
 using namespace BaseSimulator::utils;
 
@@ -23,6 +24,24 @@ const int COM_DELAY=2000;
 const int ANGLE = 60;
 const int ANGULAR_STEP=12;
 
+/**
+ * @brief Rotates module rb by one angular step around pivot
+ * @note Stop event deduces the final grid position of the module from its GL position,
+ *  hence the steps are also applied when motions are logical
+ */
+static void rotateOneStep(Catoms2DBlock *rb, const Vector3D &pivot, int sens) {
+    Matrix roty;
+    roty.setRotationY(-sens*ANGULAR_STEP);
+    Vector3D BA(rb->ptrGlBlock->position[0] - pivot[0],
+                rb->ptrGlBlock->position[1] - pivot[1],
+                rb->ptrGlBlock->position[2] - pivot[2]);
+    Vector3D BC = roty*BA;
+    Vector3D pos = pivot+BC;
+    rb->angle += ANGULAR_STEP*sens;
+    Catoms2DWorld::getWorld()->updateGlData(rb,pos,
+                                            ((Catoms2DGlBlock*)rb->ptrGlBlock)->angle+ANGULAR_STEP*sens);
+}
+
 //===========================================================================================================
 //
 //          Rotation2DMove  (class)
@@ -103,6 +122,21 @@ void Rotation2DStartEvent::consume() {
     cerr << "Motion should end at " << getScheduler()->now()+duration << endl;
     cerr << "----------" << endl;
 #endif
+
+    if (Simulator::logicalMotions()) {
+        // Apply all steps at once, with the same date arithmetic as Rotation2DStepEvent
+        Time t = scheduler->now() + stepDuration;
+        for (double a = angle; a >= ANGULAR_STEP; a -= ANGULAR_STEP) {
+            steps = a/ANGULAR_STEP;
+            stepDuration = (long double)remaining/(long double)steps;
+            rotateOneStep(rb, pivot, sens);
+            t += stepDuration;
+            remaining -= stepDuration;
+        }
+        scheduler->schedule(new Rotation2DStopEvent(t + remaining,rb,remaining));
+        return;
+    }
+
     scheduler->schedule(new Rotation2DStepEvent(scheduler->now() + stepDuration, rb,pivot,angle,sens,remaining));
 }
 
@@ -145,8 +179,6 @@ void Rotation2DStepEvent::consume() {
 #ifdef DURATION_MOTION_DEBUG
     cerr << "@" << rb->blockId << " motion step, angle " << angle << " at " << getScheduler()->now() << " (" << date << ")" << endl;
 #endif
-    Matrix roty;
-
     unsigned int steps = REMAINING_STEPS;
     Time stepDuration = (long double)duration/(long double)steps;
     Time remaining = duration - stepDuration;
@@ -154,15 +186,7 @@ void Rotation2DStepEvent::consume() {
     if (angle < ANGULAR_STEP) {
         scheduler->schedule(new Rotation2DStopEvent(scheduler->now() + duration,rb,duration));
     } else {
-        roty.setRotationY(-sens*ANGULAR_STEP);
-        Vector3D BA(rb->ptrGlBlock->position[0] - pivot[0],
-                    rb->ptrGlBlock->position[1] - pivot[1],
-                    rb->ptrGlBlock->position[2] - pivot[2]);
-        Vector3D BC = roty*BA;
-        Vector3D pos = pivot+BC;
-        rb->angle += ANGULAR_STEP*sens;
-        Catoms2DWorld::getWorld()->updateGlData(rb,pos,
-                                                ((Catoms2DGlBlock*)rb->ptrGlBlock)->angle+ANGULAR_STEP*sens);
+        rotateOneStep(rb, pivot, sens);
         scheduler->schedule(new Rotation2DStepEvent(scheduler->now() + stepDuration,rb,
                             pivot,angle-ANGULAR_STEP,sens,remaining));
     }
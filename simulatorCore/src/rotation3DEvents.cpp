@@ -10,19 +10,31 @@
 #include "rotation3DEvents.h"
 #include "catoms3DWorld.h"
 #include "catoms3DMotionEngine.h"
+#include "simulator.h"
+#include "snapshot.h"
 
 using namespace BaseSimulator::utils;
 using namespace Catoms3D;
 
-mt19937 Rotations3D::rng = mt19937(std::random_device()());
 int DELTA = 3;
-uniform_int_distribution<std::mt19937::result_type>
-Rotations3D::randomAnimationDelay = uniform_int_distribution<std::mt19937::result_type>
-    (-(ANIMATION_DELAY / DELTA),ANIMATION_DELAY / DELTA);
 const int Rotations3D::ANIMATION_DELAY = 400000;
 const int Rotations3D::COM_DELAY = 0;//2000;
 const int Rotations3D::nbRotationSteps = 20;
-float Rotations3D::rotationDelayMultiplier = 1.0f;
+RunLocal<float> Rotations3D::rotationDelayMultiplier { 1.0f };
+
+Time Rotations3D::getNextRotationEventDelay() {
+    int rad;
+#if RANDOM_ROTATION_TIME == 1
+    // Drawn from the simulation generator, so that the simulation stays reproducible from its seed
+    const int maxDelay = ANIMATION_DELAY / DELTA;
+    rad = (int)(BaseSimulator::Simulator::getSimulator()->getRandomUint() % (2 * maxDelay + 1)) - maxDelay;
+#else
+    rad = 0;
+#endif
+
+    return rotationDelayMultiplier *
+        ((ANIMATION_DELAY + rad) / (2 * nbRotationSteps));
+}
 
 std::ostream& Catoms3D::operator<<(std::ostream &stream, Rotations3D const& rots) {
     stream << rots.axe1 << "/" << rots.angle1 << " -- " << rots.axe2 << "/" << rots.angle2;
@@ -134,6 +146,10 @@ void Rotation3DStartEvent::consume() {
     Scheduler *scheduler = getScheduler();
     // cout << "[t-" << scheduler->now() << "] rotation starts" << endl;
     Catoms3DBlock *catom = (Catoms3DBlock *)concernedBlock;
+    if (catom->motionsStuck) {
+        // The motion never starts, nor ends (see FaultInjector)
+        return;
+    }
     catom->setState(BuildingBlock::State::MOVING);
 
     Cell3DPosition position;
@@ -142,18 +158,19 @@ void Rotation3DStartEvent::consume() {
 
     catom->pivot = rot.pivot;
 
-    // Trace module rotation
-    stringstream info;
-    info.str("");
-    info << " starts rotating on pivot #" << rot.pivot->blockId << " ("
-         << rot.conFromP << " -> " << rot.conToP << ")";
-    scheduler->trace(info.str(),catom->blockId,LIGHTBLUE);
-
-    // Trace pivot actuation
-    info.str("");
-    info << " starts actuating for module #" << catom->blockId << " ("
-         << rot.conFromP << " -> " << rot.conToP << ")";
-    scheduler->trace(info.str(),rot.pivot->blockId,YELLOW);
+    if (TraceSink::isEnabled(TraceCategory::Motion)) {
+        // Trace module rotation
+        stringstream info;
+        info << " starts rotating on pivot #" << rot.pivot->blockId << " ("
+             << rot.conFromP << " -> " << rot.conToP << ")";
+        scheduler->trace(info.str(),catom->blockId,LIGHTBLUE,TraceCategory::Motion);
+
+        // Trace pivot actuation
+        info.str("");
+        info << " starts actuating for module #" << catom->blockId << " ("
+             << rot.conFromP << " -> " << rot.conToP << ")";
+        scheduler->trace(info.str(),rot.pivot->blockId,YELLOW,TraceCategory::Motion);
+    }
 
     scheduler->schedule(
         new PivotActuationStartEvent(scheduler->now(), const_cast<Catoms3DBlock*>(rot.pivot),
@@ -165,6 +182,16 @@ void Rotation3DStartEvent::consume() {
 
 //    catom->setColor(DARKGREY);
     rot.init(((Catoms3DGlBlock*)catom->ptrGlBlock)->mat);
+
+    if (Simulator::logicalMotions()) {
+        // Skip the animation steps, the rotation stops when the last step would have stopped it
+        Time duration = 0;
+        for (int i = 0; i < 2 * Rotations3D::nbRotationSteps; i++)
+            duration += Rotations3D::getNextRotationEventDelay();
+        scheduler->schedule(new Rotation3DStopEvent(scheduler->now() + duration, catom, rot));
+        return;
+    }
+
     scheduler->schedule(
         new Rotation3DStepEvent(scheduler->now()+Rotations3D::getNextRotationEventDelay(),
                                 catom, rot));
@@ -174,6 +201,19 @@ const string Rotation3DStartEvent::getEventName() {
     return("Rotation3DStart Event");
 }
 
+bool Rotation3DStartEvent::save(SnapshotWriter &w) const {
+    BlockEvent::save(w);
+    rot.save(w);
+    return true;
+}
+
+Event* Rotation3DStartEvent::restore(SnapshotReader &r, Time date) {
+    Catoms3DBlock *catom = static_cast<Catoms3DBlock*>(r.readBlock());
+    Rotations3D rot;
+    rot.restore(r);
+    return new Rotation3DStartEvent(date, catom, rot);
+}
+
 //===========================================================================================================
 //
 //          Rotation3DStepEvent  (class)
@@ -220,6 +260,19 @@ const string Rotation3DStepEvent::getEventName() {
     return("Rotation3DStep Event");
 }
 
+bool Rotation3DStepEvent::save(SnapshotWriter &w) const {
+    BlockEvent::save(w);
+    rot.save(w);
+    return true;
+}
+
+Event* Rotation3DStepEvent::restore(SnapshotReader &r, Time date) {
+    Catoms3DBlock *catom = static_cast<Catoms3DBlock*>(r.readBlock());
+    Rotations3D rot;
+    rot.restore(r);
+    return new Rotation3DStepEvent(date, catom, rot);
+}
+
 //===========================================================================================================
 //
 //          Rotation3DStepEvent  (class)
@@ -247,7 +300,8 @@ void Rotation3DStopEvent::consume() {
 
     Catoms3DWorld *wrld=Catoms3DWorld::getWorld();
     Scheduler *scheduler = getScheduler();
-    stringstream info; info.str("");
+    const bool traced = TraceSink::isEnabled(TraceCategory::Motion);
+    stringstream info;
     Cell3DPosition position;
     short orientation;
 
@@ -259,17 +313,21 @@ void Rotation3DStopEvent::consume() {
     catom->setPositionAndOrientation(position,orientation);
     wrld->connectBlock(catom, false);
 
-    info << " finished rotating to " << position << " on pivot #" << rot.pivot->blockId << " ("
-         << rot.conFromP << " -> " << rot.conToP << ")";
-    scheduler->trace(info.str(),catom->blockId,LIGHTBLUE);
+    if (traced) {
+        info << " finished rotating to " << position << " on pivot #" << rot.pivot->blockId << " ("
+             << rot.conFromP << " -> " << rot.conToP << ")";
+        scheduler->trace(info.str(),catom->blockId,LIGHTBLUE,TraceCategory::Motion);
+    }
 
     scheduler->schedule(
         new Rotation3DEndEvent(scheduler->now(), catom));
 
-    info.str("");
-    info << " finished actuating for module #" << catom->blockId << " ("
-         << rot.conFromP << " -> " << rot.conToP << ")";
-    scheduler->trace(info.str(),rot.pivot->blockId,YELLOW);
+    if (traced) {
+        info.str("");
+        info << " finished actuating for module #" << catom->blockId << " ("
+             << rot.conFromP << " -> " << rot.conToP << ")";
+        scheduler->trace(info.str(),rot.pivot->blockId,YELLOW,TraceCategory::Motion);
+    }
     scheduler->schedule(
         new PivotActuationEndEvent(scheduler->now(), const_cast<Catoms3DBlock*>(rot.pivot),
                                    rot.mobile, rot.conFromP, rot.conToP));
@@ -279,6 +337,19 @@ const string Rotation3DStopEvent::getEventName() {
     return("Rotation3DStop Event");
 }
 
+bool Rotation3DStopEvent::save(SnapshotWriter &w) const {
+    BlockEvent::save(w);
+    rot.save(w);
+    return true;
+}
+
+Event* Rotation3DStopEvent::restore(SnapshotReader &r, Time date) {
+    Catoms3DBlock *catom = static_cast<Catoms3DBlock*>(r.readBlock());
+    Rotations3D rot;
+    rot.restore(r);
+    return new Rotation3DStopEvent(date, catom, rot);
+}
+
 //===========================================================================================================
 //
 //          Rotation3DEndEvent  (class)
@@ -312,6 +383,10 @@ const string Rotation3DEndEvent::getEventName() {
     return("Rotation3DEnd Event");
 }
 
+Event* Rotation3DEndEvent::restore(SnapshotReader &r, Time date) {
+    return new Rotation3DEndEvent(date, static_cast<Catoms3DBlock*>(r.readBlock()));
+}
+
 //===========================================================================================================
 //
 //          Rotations3D  (class)
@@ -361,6 +436,20 @@ void Rotations3D::exportMatrix(const Matrix& m) {
 #endif
 }
 
+void Rotations3D::save(SnapshotWriter &w) const {
+    w.writeBlock(mobile);
+    w.writeBlock(pivot);
+    w.write(conFromP, conToP, exportMatrixCount, firstRotation, step, initialMatrix.m, finalMatrix.m,
+            A0C0.pt, A0D0.pt, A1C1.pt, A1D1.pt, axe1.pt, axe2.pt, angle1, angle2, catomId);
+}
+
+void Rotations3D::restore(SnapshotReader &r) {
+    mobile = static_cast<const Catoms3DBlock*>(r.readBlock());
+    pivot = static_cast<const Catoms3DBlock*>(r.readBlock());
+    r.read(conFromP, conToP, exportMatrixCount, firstRotation, step, initialMatrix.m, finalMatrix.m,
+           A0C0.pt, A0D0.pt, A1C1.pt, A1D1.pt, axe1.pt, axe2.pt, angle1, angle2, catomId);
+}
+
 Rotations3D::Rotations3D(const Catoms3DBlock *mobile, const Catoms3DBlock *fixe, double rprim,
                          const Vector3D &ax1, double ang1,
                          const Vector3D &ax2, double ang2,
@@ -21,10 +21,8 @@ using namespace Catoms3D;
 namespace Catoms3D {
 
 class Rotations3D {
-    static std::mt19937 rng;
-    static uniform_int_distribution<mt19937::result_type> randomAnimationDelay;
 public:
-    static float rotationDelayMultiplier;
+    static RunLocal<float> rotationDelayMultiplier;
     static const int ANIMATION_DELAY;
     static const int COM_DELAY;
     static const int nbRotationSteps; //<! @attention MUST BE AN EVEN NUMBER!!!
@@ -34,18 +32,8 @@ public:
     short conFromP, conToP;
 
 #define RANDOM_ROTATION_TIME 0
-    static Time getNextRotationEventDelay() {
-        int rad;
-#if RANDOM_ROTATION_TIME == 1
-        rad = (int)randomAnimationDelay(rng);
-#else
-        rad = 0;
-#endif
-        // cout << rad << endl;
-
-        return rotationDelayMultiplier *
-            ((ANIMATION_DELAY + rad) / (2 * nbRotationSteps));
-    }
+    //!< @brief Returns the delay between two steps of a rotation, randomized with RANDOM_ROTATION_TIME
+    static Time getNextRotationEventDelay();
 
 /**
    \brief Create a couple of rotations
@@ -76,6 +64,11 @@ public:
     void getFinalPositionAndOrientation(Cell3DPosition &position, short &orientation);
     void exportMatrix(const Matrix& m);
 
+    //!< @brief Writes the rotations to a snapshot, for the pending rotation events (see Snapshot)
+    void save(BaseSimulator::SnapshotWriter &w) const;
+    //!< @brief Reads back the rotations written by save
+    void restore(BaseSimulator::SnapshotReader &r);
+
 protected :
     short exportMatrixCount = 0;
     bool firstRotation;
@@ -201,6 +194,8 @@ public:
     void consumeBlockEvent() override {};
     void consume() override;
     const virtual string getEventName() override;
+    bool save(BaseSimulator::SnapshotWriter &w) const override;
+    static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
 };
 
 //===========================================================================================================
@@ -218,6 +213,8 @@ public:
         void consumeBlockEvent() override {};
         void consume() override;
         const virtual string getEventName() override;
+        bool save(BaseSimulator::SnapshotWriter &w) const override;
+        static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
     };
 
 //===========================================================================================================
@@ -235,6 +232,8 @@ public:
         void consumeBlockEvent() override {}
         void consume() override;
         const virtual string getEventName() override;
+        bool save(BaseSimulator::SnapshotWriter &w) const override;
+        static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
     };
 
 //===========================================================================================================
@@ -251,6 +250,7 @@ public:
         void consumeBlockEvent() override {}
         void consume() override;
         const virtual string getEventName() override;
+        static Event* restore(BaseSimulator::SnapshotReader &r, Time date);
     };
 
 #endif /* ROTATIONS3DEVENTS_H_ */
@@ -0,0 +1,52 @@
+/*! @file runContext.cpp
+ * @brief Per simulation instances of the variables of the simulator.
+ * @date 18/10/2026
+ */
+
+#include "runContext.h"
+
+#include <mutex>
+#include <iostream>
+#include <cstdlib>
+
+using namespace std;
+
+namespace BaseSimulator {
+
+RunContext RunContext::processContext;
+
+namespace {
+
+mutex indexMutex; //!< Protects the indexes below, given on first access by any thread
+int nbVariables = 0;
+RunContext::Deleter deleters[RunContext::maxNbVariables];
+
+} // anonymous namespace
+
+int RunContext::getIndex(atomic<int> &index, Deleter deleter) {
+    lock_guard<mutex> lock(indexMutex);
+    int i = index.load(memory_order_relaxed);
+    if (i >= 0) return i;
+
+    if (nbVariables == maxNbVariables) {
+        cerr << "error: more than " << maxNbVariables << " run local variables" << endl;
+        abort();
+    }
+    i = nbVariables++;
+    deleters[i] = deleter;
+    index.store(i, memory_order_release);
+    return i;
+}
+
+RunContext::~RunContext() {
+    // The instances of the process context are the variables themselves
+    if (isProcessContext()) return;
+
+    lock_guard<mutex> lock(indexMutex);
+    for (int i = 0; i < nbVariables; i++) {
+        void *value = values[i].load(memory_order_acquire);
+        if (value) deleters[i](value);
+    }
+}
+
+} // BaseSimulator namespace
@@ -0,0 +1,124 @@
+/*! @file runContext.h
+ * @brief Per simulation instances of the variables of the simulator, so that several simulations
+ *  can be run at once by the threads of a process (see BatchRunner).
+ * @date 18/10/2026
+ */
+
+#ifndef RUNCONTEXT_H_
+#define RUNCONTEXT_H_
+
+#include <atomic>
+#include <utility>
+
+namespace BaseSimulator {
+
+/**
+ * @brief Context of a simulation, holding its instances of the run local variables (see RunLocal).
+ *
+ *  Each thread has a current context, the process context unless it adopted another one. The
+ *  instances of the process context are the variables themselves, so that a process running a
+ *  single simulation uses them as plain static variables. The threads of a simulation adopt the
+ *  context of the thread that created its scheduler.
+ */
+class RunContext {
+public:
+    static const int maxNbVariables = 256;  //!< Run local variables of the simulator and the block codes
+    typedef void (*Deleter)(void*);
+private:
+    static RunContext processContext;
+    inline static thread_local RunContext *currentContext = &processContext;
+
+    std::atomic<void*> values[maxNbVariables] = {}; //!< Instances of the variables, created on first access
+
+    template<typename T> friend class RunLocal;
+
+    /**
+     * @brief Gives an index to a run local variable, on the first access to its instances
+     * @param index index of the variable, set if it has none yet
+     * @param deleter deletes the instances of the variable
+     * @return index of the variable
+     */
+    static int getIndex(std::atomic<int> &index, Deleter deleter);
+public:
+    RunContext() = default;
+    RunContext(const RunContext&) = delete;
+    RunContext& operator=(const RunContext&) = delete;
+    //!< @brief Deletes the instances of the variables of the context
+    ~RunContext();
+
+    //!< @brief Returns the context of the calling thread
+    static RunContext* current() { return currentContext; }
+    //!< @brief Makes context the context of the calling thread, NULL for the process context
+    static void adopt(RunContext *context) { currentContext = context ? context : &processContext; }
+    //!< @brief Returns true if the context is the one of the process
+    bool isProcessContext() const { return this == &processContext; }
+};
+
+//!< Creates the instance of a run local variable for a new context, a copy of its process instance
+template<typename T>
+struct RunLocalInit {
+    static T* create(const T &processValue) { return new T(processValue); }
+};
+
+//!< Pointers start null, the objects of the process are not those of the simulation
+template<typename T>
+struct RunLocalInit<T*> {
+    static T** create(T* const&) { return new T*(nullptr); }
+};
+
+template<typename T>
+struct RunLocalInit<std::atomic<T>> {
+    static std::atomic<T>* create(const std::atomic<T> &processValue) {
+        return new std::atomic<T>(processValue.load());
+    }
+};
+
+/**
+ * @brief Static variable with an instance per simulation (see RunContext).
+ *
+ *  The instance of a context is created on its first access, as a copy of the process instance,
+ *  so that the options set by the command line before the simulations are started apply to all
+ *  of them, or null for pointers (see RunLocalInit). Run local variables must be static: they must outlive
+ *  the contexts that hold their instances.
+ */
+template<typename T>
+class RunLocal {
+    T processValue;
+    std::atomic<int> index { -1 };
+
+    static void destroy(void *value) { delete static_cast<T*>(value); }
+public:
+    template<typename... Args>
+    RunLocal(Args&&... args) : processValue(std::forward<Args>(args)...) {}
+    RunLocal(const RunLocal&) = delete;
+
+    //!< @brief Returns the instance of the current context
+    T& get() {
+        RunContext *context = RunContext::current();
+        if (context->isProcessContext()) return processValue;
+
+        int i = index.load(std::memory_order_acquire);
+        if (i < 0) i = RunContext::getIndex(index, destroy);
+        // The threads of a simulation may access the variable at once (see ParallelScheduler)
+        std::atomic<void*> &slot = context->values[i];
+        void *value = slot.load(std::memory_order_acquire);
+        if (not value) {
+            T *created = RunLocalInit<T>::create(processValue);
+            if (slot.compare_exchange_strong(value, created, std::memory_order_acq_rel)) value = created;
+            else delete created;
+        }
+        return *static_cast<T*>(value);
+    }
+
+    operator T&() { return get(); }
+    //!< @brief Member access, for pointer variables
+    T operator->() { return get(); }
+    RunLocal& operator=(const T &value) {
+        get() = value;
+        return *this;
+    }
+};
+
+} // BaseSimulator namespace
+
+#endif /* RUNCONTEXT_H_ */
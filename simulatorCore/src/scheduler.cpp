@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <iostream>
+#include <mutex>
 #include <stdlib.h>
 
 #include "openglViewer.h"
@@ -15,13 +16,14 @@
 #include "trace.h"
 #include "stdint.h"
 #include "statsIndividual.h"
+#include "messageRegistry.h"
 
 using namespace std;
 using namespace BaseSimulator::utils;
 
 namespace BaseSimulator {
 
-Scheduler *Scheduler::scheduler=NULL;
+RunLocal<Scheduler*> Scheduler::scheduler;
 std::mutex Scheduler::delMutex;
 std::mutex Scheduler::pause_mtx;
 std::condition_variable Scheduler::pause_cv;
@@ -43,7 +45,9 @@ Scheduler::Scheduler() {
         exit(EXIT_FAILURE);
     }
 
+    runContext = RunContext::current();
     sem_schedulerStart = new LightweightSemaphore(0);
+    eventsQueue = EventQueue::create(EventQueue::defaultType);
 }
 
 Scheduler::~Scheduler() {
@@ -54,6 +58,7 @@ Scheduler::~Scheduler() {
     if (schedulerThread)
         delete schedulerThread;
     delete sem_schedulerStart;
+    delete eventsQueue;
 }
 
 bool Scheduler::schedule(Event *ev) {
@@ -62,15 +67,15 @@ bool Scheduler::schedule(Event *ev) {
 
     EventPtr pev(ev);
 
-    static bool possibleOverflow = false;
-    static bool tooLate = false;
+    // Warnings are only printed once, by any of the simulations of the process
+    static atomic<bool> possibleOverflow{false};
+    static atomic<bool> tooLate{false};
     /*info << "Schedule a " << pev->getEventName() << " (" << ev->id << ")";
     trace(info.str());*/
 
     if (pev->date < Scheduler::currentDate) {
-        if (!possibleOverflow) {
+        if (!possibleOverflow.exchange(true)) {
             cerr << "WARNING: Attempt to schedule an event in the past (possible overflow detected?)!" << endl;
-            possibleOverflow = true;
         }
         OUTPUT << "ERROR : An event cannot be scheduled in the past !\n";
         OUTPUT << "current time : " << Scheduler::currentDate << endl;
@@ -80,9 +85,8 @@ bool Scheduler::schedule(Event *ev) {
     }
 
     if (pev->date > maximumDate) {
-        if (!tooLate) {
+        if (!tooLate.exchange(true)) {
             cerr << "WARNING: Maximum simulation date reached!" << endl;
-            tooLate = true;
         }
         OUTPUT << "WARNING : An event should not be scheduled beyond the end of simulation date !\n";
         OUTPUT << "pev->date : " << pev->date << endl;
@@ -92,7 +96,7 @@ bool Scheduler::schedule(Event *ev) {
 
     lock();
 
-    eventsMap.insert(pair<Time, EventPtr>(pev->date,pev));
+    eventsQueue->push(std::move(pev));
 
     eventsMapSize++;
 
@@ -105,35 +109,72 @@ bool Scheduler::schedule(Event *ev) {
 
 void Scheduler::removeEventsToBlock(BuildingBlock *bb) {
     lock();
-    multimap<Time,EventPtr>::iterator im = eventsMap.begin();
-    BuildingBlock *cb=NULL;
     OUTPUT << bb << endl;
-    while (im!=eventsMap.end()) {
-        cb=(*im).second->getConcernedBlock();
+    eventsQueue->removeIf([bb](const EventPtr &pev) {
+        BuildingBlock *cb = pev->getConcernedBlock();
         OUTPUT << cb << endl;
-        if (cb==bb) {
-            multimap<Time,EventPtr>::iterator im2 = im;
-            if(im != eventsMap.begin()) {
-                im--;
-                eventsMap.erase(im2);
-            } else {
-                eventsMap.erase(im2);
-                im = eventsMap.begin();
-            }
-        } else im++;
+        return cb == bb;
+    });
+    eventsMapSize = eventsQueue->size();
+    unlock();
+}
+
+std::vector<EventPtr> Scheduler::getPendingEvents() {
+    lock();
+    std::vector<EventPtr> events;
+    events.reserve(eventsQueue->size());
+    while (!eventsQueue->empty()) {
+        events.push_back(eventsQueue->top());
+        eventsQueue->pop();
     }
+    // Pushed back in the same order, so that events sharing a date keep their order
+    for (const EventPtr &pev : events) eventsQueue->push(pev);
     unlock();
+    return events;
 }
 
-void Scheduler::trace(string message, bID id,const Color &color) {
+void Scheduler::replacePendingEvents(Time date, const std::vector<EventPtr> &events) {
+    lock();
+    while (!eventsQueue->empty()) eventsQueue->pop();
+    for (const EventPtr &pev : events) eventsQueue->push(pev);
+    eventsMapSize = eventsQueue->size();
+    currentDate = date;
+    unlock();
+}
+
+void Scheduler::setEventQueueType(EventQueueType type) {
+    lock();
+    if (eventsQueue->empty()) {
+        delete eventsQueue;
+        eventsQueue = EventQueue::create(type);
+    } else {
+        ERRPUT << TermColor::ErrorColor << "ERROR : Event queue type cannot be changed once events have been scheduled"
+               << TermColor::Reset << endl;
+    }
+    unlock();
+}
+
+void Scheduler::trace(string message, bID id,const Color &color, TraceCategory category) {
+    if (not TraceSink::isEnabled(category)) return;
+
     if (GlutContext::GUIisEnabled) {
-        mutex_trace.lock();
+        lock_guard<mutex> lock(mutex_trace);
         GlutContext::addTrace(message,id,color);
-        mutex_trace.unlock();
     }
 
+    if (TraceSink::isOpen()) {
+        // The log text of the block codes is formatted as when traces are written to OUTPUT
+        static once_flag outputFormatted;
+        call_once(outputFormatted, []() { OUTPUT.precision(6); OUTPUT << fixed; });
+        // Concurrent writers are accepted by the sink, which sends the log text of this thread first
+        TraceSink::write(category, now(), id, message.data(), message.size());
+        return;
+    }
+
+    lock_guard<mutex> lock(mutex_trace);
     OUTPUT.precision(6);
-    OUTPUT << fixed << (double)(currentDate)/1000000 << " #" << id << ": " << message << endl;
+    OUTPUT << fixed;
+    OUTPUT << (double)(now())/1000000 << " #" << id << ": " << message << endl;
 }
 
 void Scheduler::start(int mode) {
@@ -200,35 +241,31 @@ bool Scheduler::debug(const string &command,bID &id,string &result) {
 
 int Scheduler::getNbEventsById(int id) {
     lock();
-    multimap<Time,EventPtr>::iterator im = eventsMap.begin();
     int count = 0;
-    while (im!=eventsMap.end()) {
-        if (im->second->eventType == id)
+    eventsQueue->forEach([id, &count](const EventPtr &pev) {
+        if (pev->eventType == id)
             count++;
-        im++;
-    }
+    });
     unlock();
     return count;
 }
 
 bool Scheduler::hasEvent(int id, unsigned long blockId) {
     lock();
-    multimap<Time,EventPtr>::iterator im = eventsMap.begin();
-    while (im!=eventsMap.end()) {
-        if (im->second->eventType == id && im->second->getConcernedBlock()->blockId == blockId) {
-            unlock();
-            return true;
-        }
-        im++;
-    }
+    bool found = false;
+    eventsQueue->forEach([id, blockId, &found](const EventPtr &pev) {
+        if (pev->eventType == id && pev->getConcernedBlock()->blockId == blockId)
+            found = true;
+    });
     unlock();
-    return false;
+    return found;
 }
 
 void Scheduler::printStats() {
   cout << StatsCollector::getInstance();
   if (StatsIndividual::enable) {
     cout << StatsIndividual::getStats();
+    cout << MessageTypeRegistry::getStats();
   }
 }
 
@@ -21,6 +21,9 @@
 #include "sema.h"
 #include "events.h"
 #include "statsCollector.h"
+#include "eventQueue.h"
+#include "traceSink.h"
+#include "runContext.h"
 
 using namespace std;
 
@@ -57,17 +60,18 @@ public:
  */
 class Scheduler {
 protected:
-	static Scheduler *scheduler; //!< Static pointer to the single scheduler instance
+	static RunLocal<Scheduler*> scheduler; //!< Static pointer to the single scheduler instance of the simulation
 	static std::mutex delMutex; //!< Static mutex used to ensure non-concurrent deletion of the instance of the scheduler
 	int schedulerMode; //!< Execution mode of the scheduler (1: Fastest, 2: Realtime, 3: Debug)
 	int schedulerLength; //!< Termination mode of the scheduler (1:Default, 2: Bounded, 3: Infinite)
 	LightweightSemaphore *sem_schedulerStart; //!< Semaphore used to synchronise scheduler thread start
 	std::thread *schedulerThread; //!< Thread for scheduler execution
+	RunContext *runContext; //!< Context of the simulation, adopted by the threads of the scheduler
 	vector <Keyword*> tabKeywords; //!< Collection of keywords for debugging (incomplete feature)
 
 	Time currentDate = 0; //!< Current discrete date of the scheduler in (us)
 	Time maximumDate = TIME_MAX; //!< Maximum possible date that the scheduler can reach before it terminates (Defaults to maximum value for discrette time type)
-	multimap<Time,EventPtr> eventsMap; //!< Collection of event lists indexed by date
+	EventQueue *eventsQueue; //!< Pending events, ordered by date (FIFO among events sharing the same date)
 	int eventsMapSize = 0; //!< Number of events in the event list
 	int largestEventsMapSize = 0; //!< Maximum size that the event list has reached during current simulation
 	std::mutex mutex_schedule;	  //!< Mutex to ensure mutual exclusion during event list modification
@@ -85,6 +89,14 @@ protected:
      * Pointer to the module for which the scheduler is currently handling an event
      */
     BuildingBlock* contextModule = NULL;
+
+    //!< Date and module of the event being processed by a worker thread of the parallel scheduler
+    struct WorkerContext {
+        Time date = 0;
+        BuildingBlock *module = NULL;
+    };
+    //!< Context of the calling thread if it is processing events in parallel with others, NULL otherwise
+    inline static thread_local WorkerContext *workerContext = NULL;
 public:
 	//!< Defines possible states of the scheduler
 	enum State {
@@ -106,11 +118,12 @@ public:
 	}
 
     BuildingBlock* getContextModule() const {
-        return contextModule;
+        return workerContext ? workerContext->module : contextModule;
     }
 
     BlockCode* getContextBlockCode() const {
-        return contextModule ? contextModule->blockCode : NULL;
+        BuildingBlock *module = getContextModule();
+        return module ? module->blockCode : NULL;
     }
     
 	//!< @brief Global function for triggering scheduler deletion (Takes a bit of synchronisation, see Scheduler::terminate)
@@ -155,8 +168,10 @@ public:
 		cout << "I'm a Scheduler" << endl;
 	}
 
-    int getNbEventsById(int id);
-    bool hasEvent(int id, unsigned long blockId);
+    //!< @brief Number of pending events of type id
+    virtual int getNbEventsById(int id);
+    //!< @brief Indicates if an event of type id is pending for module blockId
+    virtual bool hasEvent(int id, unsigned long blockId);
 
 	//!< @brief Getter for Scheduler::schedulerMode
 	int getMode() { return schedulerMode; };
@@ -175,6 +190,14 @@ public:
 	//!< @brief Getter for Scheduler::autoStart
 	inline bool willAutoStart() { return autoStart; }
 
+	/** @brief Replaces the event queue by an empty one of the requested type
+	 *  @param type event queue backend to use
+	 *  @attention can only be called before any event has been scheduled
+	 */
+	void setEventQueueType(EventQueueType type);
+	//!< @brief Getter for the name of the event queue backend in use
+	inline const string getEventQueueName() const { return eventsQueue->getName(); }
+
 	//!< @brief Setter for Scheduler::autoStop
 	inline void setAutoStop(bool as) { autoStop = as; }
 	//!< @brief Getter for Scheduler::autoStart
@@ -190,9 +213,22 @@ public:
 
 
 	/** @brief Return current scheduler date
-	 *  @return Scheduler::currentDate
+	 *  @return Scheduler::currentDate, or the date of the event being processed by the calling worker thread
+	 */
+	inline Time now() { return(workerContext ? workerContext->date : currentDate); };
+
+	//!< @brief Returns the current date of the scheduler, or 0 if none has been created yet
+	static Time getDate() { return scheduler ? scheduler->now() : 0; }
+
+	//!< @brief Tells whether events may be processed concurrently by several threads (see ParallelScheduler)
+	virtual bool isParallel() const { return false; }
+
+	/** @brief Postpones an action on the world (adding or removing a module...) if it cannot be done right away
+	 *  @param action function performing the action, called later by the scheduler if postponed
+	 *  @return true if the action has been postponed, false if the caller can perform it immediately
+	 *  The parallel scheduler postpones the actions requested by block codes running on its worker threads.
 	 */
-	inline Time now() { return(currentDate); };
+	virtual bool deferWorldAction(const std::function<void()> &action) { return false; }
 
         void toggle_pause();
 
@@ -200,13 +236,25 @@ public:
 	 *  @param message String to print
 	 *  @param id module identifier of the concerned block
 	 *  @param color color of the message, WHITE by default
+	 *  @param category kind of message, not traced if filtered out (see TraceSink::isEnabled)
 	 */
-	virtual void trace(string message,bID id=0,const Color &color=WHITE);
+	virtual void trace(string message,bID id=0,const Color &color=WHITE,
+                       TraceCategory category=TraceCategory::Trace);
 
 	/** @brief Remove all events relative to module bb from events list, in case of module deletion for example
 	 *  @param bb module from which the events have to be cleared
 	 */
-	void removeEventsToBlock(BuildingBlock *bb);
+	virtual void removeEventsToBlock(BuildingBlock *bb);
+
+	/** @brief Returns the pending events in the order they will be processed (see Snapshot)
+	 *  @return events sorted by date, FIFO among events sharing the same date
+	 */
+	std::vector<EventPtr> getPendingEvents();
+	/** @brief Replaces the pending events and sets the current date, when resuming a snapshot
+	 *  @param date date of the snapshot
+	 *  @param events new pending events, in the order they will be processed
+	 */
+	void replacePendingEvents(Time date, const std::vector<EventPtr> &events);
 
 	//!< @brief Lock the event list mutex
 	inline void lock() { mutex_schedule.lock(); };
@@ -0,0 +1,220 @@
+/*! @file schedulerProfiler.cpp
+ * @brief Profiler of the scheduler.
+ * @date 17/10/2026
+ */
+
+#include "schedulerProfiler.h"
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+
+#include "events.h"
+#include "messageRegistry.h"
+#include "trace.h"
+
+using namespace std;
+using namespace BaseSimulator::utils;
+
+namespace BaseSimulator {
+
+bool SchedulerProfiler::enabled = false;
+string SchedulerProfiler::filename;
+unsigned int SchedulerProfiler::samplingPeriod = SchedulerProfiler::defaultSamplingPeriod;
+Time SchedulerProfiler::queueInterval = 1024;
+vector<size_t> SchedulerProfiler::queueDepths;
+
+namespace {
+
+struct KeyHash {
+    size_t operator()(const SchedulerProfiler::Key &k) const {
+        return hash<uintptr_t>()((uintptr_t)k.registry ^ (k.handler << 16) ^ (uintptr_t)k.eventType);
+    }
+};
+
+//!< Statistics accounted by a thread
+struct Table {
+    unordered_map<SchedulerProfiler::Key, SchedulerProfiler::Stats, KeyHash> stats;
+    unordered_map<int, string> eventNames;
+};
+
+mutex tablesMutex;
+vector<unique_ptr<Table>> tables;
+thread_local Table *table = NULL;
+
+Table& getTable() {
+    if (not table) {
+        lock_guard<mutex> lock(tablesMutex);
+        tables.emplace_back(new Table());
+        table = tables.back().get();
+    }
+    return *table;
+}
+
+} // anonymous namespace
+
+uint64_t SchedulerProfiler::getTime() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+size_t SchedulerProfiler::getBucket(uint64_t ns) {
+    if (ns < 16) return ns;
+    // 16 buckets per power of two, from the 4 bits following the leading one
+    const int e = 63 - __builtin_clzll(ns);
+    return (e - 3) * 16 + ((ns >> (e - 4)) & 15);
+}
+
+uint64_t SchedulerProfiler::getBucketValue(size_t bucket) {
+    if (bucket < 16) return bucket;
+    const int e = bucket / 16 + 3;
+    // Middle of the bucket
+    return ((16 + bucket % 16) << (e - 4)) + ((1ull << (e - 4)) >> 1);
+}
+
+double SchedulerProfiler::getPercentile(const Stats &s, double p) {
+    const uint64_t rank = (uint64_t)(p * s.samples);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < nbBuckets; b++) {
+        seen += s.histogram[b];
+        if (seen > rank) return getBucketValue(b);
+    }
+    return 0;
+}
+
+unsigned int SchedulerProfiler::drawInterval() {
+    if (samplingPeriod <= 1) return 1;
+    // xorshift32, seeded per thread. Intervals are uniform in [1, 2 * samplingPeriod - 1].
+    if (samplingState == 0) samplingState = 2463534242u ^ (uint32_t)(uintptr_t)&samplingState;
+    samplingState ^= samplingState << 13;
+    samplingState ^= samplingState >> 17;
+    samplingState ^= samplingState << 5;
+    return 1 + samplingState % (2 * samplingPeriod - 1);
+}
+
+SchedulerProfiler::Stats& SchedulerProfiler::getStats(const Key &key, Event *ev) {
+    // Consecutive events often share their frame. Elements of unordered maps do not move.
+    if (lastStats and key == lastKey) return *lastStats;
+
+    Table &t = getTable();
+    Stats &s = t.stats[key];
+    if (s.count == 0 and t.eventNames.find(key.eventType) == t.eventNames.end())
+        t.eventNames[key.eventType] = ev->getEventName();
+    lastKey = key;
+    lastStats = &s;
+    return s;
+}
+
+void SchedulerProfiler::account(Event *ev) {
+    const uint64_t duration = sampled ? getTime() - startTime : 0;
+
+    Stats &s = getStats(Key{ ev->eventType, handlerRegistry, handlerId }, ev);
+    s.count++;
+    if (not sampled) return;
+    s.samples++;
+    s.total += duration;
+    s.histogram[getBucket(duration)]++;
+}
+
+void SchedulerProfiler::sampleQueue(Time date, size_t depth) {
+    if (queueDepths.empty()) queueDepths.resize(nbQueueSamples, 0);
+
+    // Intervals are doubled to cover the simulated time so far
+    while (date / queueInterval >= nbQueueSamples) {
+        for (size_t i = 0; i < nbQueueSamples / 2; i++)
+            queueDepths[i] = max(queueDepths[2 * i], queueDepths[2 * i + 1]);
+        fill(queueDepths.begin() + nbQueueSamples / 2, queueDepths.end(), 0);
+        queueInterval *= 2;
+    }
+
+    // Depths are stored plus one, 0 for intervals without any event
+    size_t &d = queueDepths[date / queueInterval];
+    if (depth + 1 > d) d = depth + 1;
+}
+
+void SchedulerProfiler::write() {
+    if (not enabled) return;
+
+    // Merges the tables of all the threads
+    map<string, Stats> frames;      // Folded stack, without the "scheduler" root
+    double total = 0;
+    {
+        lock_guard<mutex> lock(tablesMutex);
+        unordered_map<int, string> eventNames;
+        for (auto &t : tables)
+            eventNames.insert(t->eventNames.begin(), t->eventNames.end());
+
+        for (auto &t : tables) {
+            for (auto &p : t->stats) {
+                string frame = eventNames[p.first.eventType];
+                if (p.first.handler)
+                    frame += ";" + MessageTypeRegistry::getFrameName(p.first.registry, p.first.handler);
+                replace(frame.begin(), frame.end(), ' ', '_');
+
+                Stats &s = frames[frame];
+                s.count += p.second.count;
+                s.samples += p.second.samples;
+                s.total += p.second.total;
+                for (size_t b = 0; b < nbBuckets; b++) s.histogram[b] += p.second.histogram[b];
+            }
+        }
+    }
+    for (auto &f : frames) total += getEstimatedTotal(f.second);
+
+    // Frames without any timed event have no estimate
+    ofstream folded(filename);
+    for (auto &f : frames)
+        if (f.second.samples)
+            folded << "scheduler;" << f.first << " " << (uint64_t)getEstimatedTotal(f.second) << "\n";
+    folded.close();
+
+    ofstream queue(filename + ".queue.csv");
+    queue << "date,depth\n";
+    size_t last = queueDepths.size();
+    while (last > 0 and queueDepths[last - 1] == 0) last--;
+    for (size_t i = 0; i < last; i++)
+        if (queueDepths[i]) queue << i * queueInterval << "," << queueDepths[i] - 1 << "\n";
+    queue.close();
+
+    vector<pair<string,const Stats*>> sorted;
+    for (auto &f : frames) sorted.push_back(make_pair(f.first, &f.second));
+    sort(sorted.begin(), sorted.end(), [](const pair<string,const Stats*> &a, const pair<string,const Stats*> &b) {
+        return getEstimatedTotal(*a.second) > getEstimatedTotal(*b.second);
+    });
+
+    const ios::fmtflags flags = cout.flags();
+    const streamsize precision = cout.precision();
+    cout << TermColor::BBlue << "=== SCHEDULER PROFILE ===" << TermColor::Reset << endl;
+    if (samplingPeriod > 1)
+        cout << "1 event in " << samplingPeriod << " timed, totals are estimates" << endl;
+    cout << left << setw(60) << "event;handler" << right << setw(10) << "count" << setw(12) << "total (ms)"
+         << setw(8) << "share" << setw(10) << "mean (us)" << setw(9) << "p50" << setw(9) << "p90"
+         << setw(9) << "p99" << endl;
+    cout << fixed;
+    for (auto &f : sorted) {
+        const Stats &s = *f.second;
+        const double estimate = getEstimatedTotal(s);
+        cout << left << setw(60) << f.first.substr(0, 59) << right << setw(10) << s.count
+             << setprecision(2) << setw(12) << estimate / 1e6
+             << setprecision(1) << setw(7) << (total ? 100.0 * estimate / total : 0) << "%"
+             << setprecision(2);
+        if (s.samples)
+            cout << setw(10) << s.total / 1e3 / s.samples
+                 << setw(9) << getPercentile(s, 0.5) / 1e3 << setw(9) << getPercentile(s, 0.9) / 1e3
+                 << setw(9) << getPercentile(s, 0.99) / 1e3 << endl;
+        else
+            cout << setw(10) << "-" << setw(9) << "-" << setw(9) << "-" << setw(9) << "-" << endl;
+    }
+    cout.flags(flags);
+    cout.precision(precision);
+    cout << "Folded stacks written to " << filename << ", event queue depth to "
+         << filename << ".queue.csv" << endl;
+}
+
+} // BaseSimulator namespace
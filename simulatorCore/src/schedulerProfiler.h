@@ -0,0 +1,143 @@
+/*! @file schedulerProfiler.h
+ * @brief Profiler of the scheduler: wall clock time spent processing each type of event and in
+ *  each message handler, and depth of the event queue over simulated time.
+ * @date 17/10/2026
+ */
+
+#ifndef SCHEDULERPROFILER_H_
+#define SCHEDULERPROFILER_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "tDefs.h"
+
+class Event;
+
+namespace BaseSimulator {
+
+class MessageTypeRegistry;
+
+/**
+ * @brief Profiles the processing of the events, enabled with the -P command line option.
+ *
+ *  The time spent in Event::consume is accounted per event type and, for the events handling a
+ *  message, per block code class and message handler (see MessageTypeRegistry): count, total,
+ *  and percentiles from a log-linear histogram (16 buckets per power of two, 6% precision).
+ *  Each thread accounts in a table of its own (see ParallelScheduler), merged at the end.
+ *
+ *  Timing every event costs several percent of the simulation time, hence only one event in
+ *  samplingPeriod on average is timed, at random intervals so that periodic patterns of events
+ *  are not aliased. Every event is counted, so counts are exact. The total of a frame is
+ *  estimated as its count times the mean duration of its timed events, means and percentiles
+ *  are those of the timed events. A period of 1 times every event.
+ *
+ *  At the end of the simulation, a summary is printed, the profile is written as folded stacks,
+ *  "scheduler;<event>[;<block code>;<handler>] <ns>" per line, which flamegraph.pl renders, and
+ *  the depth of the event queue is written to <file>.queue.csv, "date,depth" per line (largest
+ *  depth over each of at most 1024 intervals of simulated time, those without events omitted).
+ */
+class SchedulerProfiler {
+public:
+    static constexpr size_t nbBuckets = 976;    //!< Covers 64 bits durations
+    static constexpr size_t nbQueueSamples = 1024;
+    static constexpr unsigned int defaultSamplingPeriod = 16;
+
+    //!< Statistics of a profiled frame, an event type or a message handler
+    struct Stats {
+        uint64_t count = 0;                     //!< Processed events
+        uint64_t samples = 0;                   //!< Timed events
+        uint64_t total = 0;                     //!< ns, of the timed events
+        std::vector<uint64_t> histogram = std::vector<uint64_t>(nbBuckets, 0);
+    };
+
+    //!< Frame of the folded stacks, the event type and the handler of its message, if any
+    struct Key {
+        int eventType;
+        const MessageTypeRegistry *registry;    //!< NULL for a handleable message, or no message
+        uintptr_t handler;                      //!< Message type, or type_info of a handleable message, 0 for none
+
+        bool operator==(const Key &k) const {
+            return eventType == k.eventType and registry == k.registry and handler == k.handler;
+        }
+    };
+
+private:
+    static bool enabled;
+    static std::string filename;
+    static unsigned int samplingPeriod;     //!< Mean number of events per timed event
+
+    // Depth of the event queue, largest per interval of simulated time
+    static Time queueInterval;
+    static std::vector<size_t> queueDepths;
+
+    // Event being processed by this thread
+    inline static thread_local unsigned int untilSample = 1;   //!< Events until the next timed one, included
+    inline static thread_local uint32_t samplingState = 0;     //!< Generator of the sampling intervals
+    inline static thread_local bool sampled = false;           //!< The event being processed is timed
+    inline static thread_local uint64_t startTime = 0;
+    inline static thread_local const MessageTypeRegistry *handlerRegistry = NULL;
+    inline static thread_local uintptr_t handlerId = 0;
+    inline static thread_local Key lastKey = { -1, NULL, 0 };  //!< Frame of the previous event
+    inline static thread_local Stats *lastStats = NULL;
+
+    static uint64_t getTime();
+    static size_t getBucket(uint64_t ns);
+    static uint64_t getBucketValue(size_t bucket);
+    static double getPercentile(const Stats &s, double p);
+    static unsigned int drawInterval();
+    //!< @brief Returns the statistics of the frame of this thread, created on first use
+    static Stats& getStats(const Key &key, Event *ev);
+    //!< @brief Returns the estimated total of s, ns
+    static double getEstimatedTotal(const Stats &s) {
+        return s.samples ? (double)s.total * s.count / s.samples : 0;
+    }
+public:
+    /**
+     * @brief Enables profiling, written to file at the end of the simulation
+     * @param period mean number of events per timed event, 1 to time them all
+     */
+    static void enable(const std::string &file, unsigned int period = defaultSamplingPeriod) {
+        enabled = true;
+        filename = file;
+        samplingPeriod = period;
+    }
+    static bool isEnabled() { return enabled; }
+
+    //!< @brief Called before processing an event, by the thread processing it
+    static void beginEvent() {
+        handlerRegistry = NULL;
+        handlerId = 0;
+        sampled = --untilSample == 0;
+        if (not sampled) return;
+        untilSample = drawInterval();
+        startTime = getTime();
+    }
+
+    //!< @brief Called before processing an event of the scheduler thread, sampling the event queue depth
+    static void beginEvent(Time date, size_t queueDepth) {
+        sampleQueue(date, queueDepth);
+        beginEvent();
+    }
+
+    //!< @brief Called after processing ev, by the thread processing it. Counts it, and times it if sampled.
+    static void endEvent(Event *ev) { account(ev); }
+    static void account(Event *ev);
+
+    //!< @brief Called by MessageTypeRegistry when a message is handled during the current event
+    static void setHandler(const MessageTypeRegistry *registry, uintptr_t id) {
+        handlerRegistry = registry;
+        handlerId = id;
+    }
+
+    static void sampleQueue(Time date, size_t depth);
+
+    //!< @brief Prints the summary of the profile and writes its files
+    static void write();
+};
+
+} // BaseSimulator namespace
+
+#endif /* SCHEDULERPROFILER_H_ */
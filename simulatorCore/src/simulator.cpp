@@ -15,8 +15,14 @@
 #include "meldInterpretVM.h"
 #include "meldInterpretScheduler.h"
 #include "cppScheduler.h"
+#include "parallelScheduler.h"
 #include "openglViewer.h"
 #include "utils.h"
+#include "linkModel.h"
+#include "faultInjector.h"
+#include "snapshot.h"
+#include "batchRunner.h"
+#include "messageRegistry.h"
 #include "rotation3DEvents.h"
 #include "targetEncoding/CSG/csg.h"
 #include "targetEncoding/CSG/csgParser.h"
@@ -32,14 +38,14 @@ using namespace std;
 
 namespace BaseSimulator {
 
-Simulator* simulator = NULL;
-
-Simulator* Simulator::simulator = NULL;
+RunLocal<Simulator*> Simulator::simulator;
 
 Simulator::Type	Simulator::type = CPP; // CPP code by default
 bool Simulator::regrTesting = false; // No regression testing by default
 
-Simulator::Simulator(int argc, char *argv[], BlockCodeBuilder _bcb): bcb(_bcb), cmdLine(argc,argv, _bcb) {
+Simulator::Simulator(int argc, char *argv[], BlockCodeBuilder _bcb): bcb(_bcb),
+    // The simulations of a batch share the command line parsed by the simulator of the batch
+    cmdLine(BatchRunner::getCommandLine() ? *BatchRunner::getCommandLine() : CommandLine(argc, argv, _bcb)) {
 #ifdef DEBUG_OBJECT_LIFECYCLE
     OUTPUT << TermColor::LifecycleColor << "Simulator constructor" << TermColor::Reset << endl;
 #endif
@@ -47,19 +53,26 @@ Simulator::Simulator(int argc, char *argv[], BlockCodeBuilder _bcb): bcb(_bcb),
     // Ensure that only one instance of simulator is running at once
     if (simulator == NULL) {
         simulator = this;
-        BaseSimulator::simulator = simulator;
     } else {
         ERRPUT << TermColor::ErrorColor << "Only one Simulator instance can be created, aborting !"
                << TermColor::Reset << endl;
         exit(EXIT_FAILURE);
     }
 
+    // The simulator of a batch only parses the command line, its simulations load their configuration
+    // from the documents of the batch (see BatchRunner)
+    xmlDoc = BatchRunner::getDocument();
+    if (BatchRunner::hasBatch() and not xmlDoc) return;
+
     // Ensure that the configuration file exists and is well-formed
 
     string confFileName = cmdLine.getConfigFile();
 
-    xmlDoc = new TiXmlDocument(confFileName.c_str());
-    bool isLoaded = xmlDoc->LoadFile();
+    bool isLoaded = xmlDoc != NULL;
+    if (not xmlDoc) {
+        xmlDoc = new TiXmlDocument(confFileName.c_str());
+        isLoaded = xmlDoc->LoadFile();
+    }
 
 
     if (cmdLine.isSimulationSeedSet()) {
@@ -76,6 +89,7 @@ Simulator::Simulator(int argc, char *argv[], BlockCodeBuilder _bcb): bcb(_bcb),
         rseed = seed;
         generator = uintRNG((ruint)rseed);
     }
+    generatorSeed = (ruint)rseed;
     cerr << "Seed: " << rseed << endl;
 
     if (!isLoaded) {
@@ -100,7 +114,8 @@ Simulator::~Simulator() {
 #ifdef DEBUG_OBJECT_LIFECYCLE
     OUTPUT << TermColor::LifecycleColor  << "Simulator destructor" << TermColor::Reset << endl;
 #endif
-    delete xmlDoc;
+    // The configurations of the simulations of a batch are shared, and deleted by the batch runner
+    if (xmlDoc != BatchRunner::getDocument()) delete xmlDoc;
 
 #ifdef ENABLE_MELDPROCESS
     if (getType() == MELDPROCESS) {
@@ -119,6 +134,15 @@ void Simulator::deleteSimulator() {
     simulator = NULL;
 }
 
+void Simulator::createSimulator(int argc, char *argv[], BlockCodeBuilder bcb, SimulatorBuilder build) {
+    build(argc, argv, bcb);
+    if (BatchRunner::hasBatch())
+        BatchRunner::run(simulator->getCmdLine(), argc, argv, bcb, build);
+
+    simulator->parseConfiguration(argc, argv);
+    simulator->startSimulation();
+}
+
 void Simulator::loadScheduler(int schedulerMaxDate) {
     int sl = cmdLine.getSchedulerLength();
     int sm = cmdLine.getSchedulerMode();
@@ -139,11 +163,18 @@ void Simulator::loadScheduler(int schedulerMaxDate) {
 #endif
             break;
         case CPP:
-            CPPScheduler::createScheduler();
+            if (cmdLine.getNbThreads() > 1 && !GlutContext::GUIisEnabled) {
+                ParallelScheduler::createScheduler(cmdLine.getNbThreads(), cmdLine.getMinParallelWindow());
+            } else {
+                if (cmdLine.getNbThreads() > 1)
+                    cerr << "warning: Parallel scheduler is only available in terminal mode (-t), ignoring -j" << endl;
+                CPPScheduler::createScheduler();
+            }
             break;
     }
 
     scheduler = getScheduler();
+    scheduler->setEventQueueType(cmdLine.getEventQueueType());
 
     // Set the scheduler execution mode on start, if enabled
     if (sm != CMD_LINE_UNDEFINED) {
@@ -161,6 +192,13 @@ void Simulator::loadScheduler(int schedulerMaxDate) {
         scheduler->setSchedulerMode(SCHEDULER_MODE_FASTEST);
     }
 
+    // Motion steps only serve the animation, skip them when nothing is drawn unless requested otherwise
+    int mf = cmdLine.getMotionFidelity();
+    if (mf != CMD_LINE_UNDEFINED)
+        motionFidelity = (MotionFidelity)mf;
+    else
+        motionFidelity = GlutContext::GUIisEnabled ? ANIMATED : LOGICAL;
+
     // Set the scheduler termination mode
     scheduler->setSchedulerLength(sl);
     scheduler->setAutoStop(cmdLine.getSchedulerAutoStop());
@@ -175,14 +213,23 @@ void Simulator::parseConfiguration(int argc, char*argv[]) {
         // Identify the type of the simulation (CPP / Meld Process / MeldInterpret)
         readSimulationType(argc, argv);
 
+        // Fault injection campaigns fork their simulations here, before any thread is started
+        parseFaults();
+        if (Snapshot::isSaving() and not FaultInjector::isEmpty())
+            throw ParsingException("faults cannot be injected in a simulation saving a snapshot (-S)\n");
+        FaultInjector::runCampaigns();
+
         // Configure the simulation world
         parseWorld(argc, argv);
         initializeIDPool();
 
         // Instantiate and configure the Scheduler
         loadScheduler(schedulerMaxDate);
+        // A resumed simulation schedules its faults once the snapshot is restored
+        if (not Snapshot::isResuming()) FaultInjector::schedule();
 
         // Parse and configure the remaining items
+        parseLinks();
         parseBlockList();
         parseCameraAndSpotlight();
         parseObstacles();
@@ -275,14 +322,11 @@ void Simulator::generateRandomIDs(const int n, const int idSeed, const int step)
     IDPool = vector<bID>(n);
     std::iota(begin(IDPool), end(IDPool), inc);
 
-    // Properly seed random number generator
-    std::mt19937 gen;
+    // The simulation generator, seeded from the simulation seed, keeps the distribution reproducible
     if (seed == -1) {
         OUTPUT << "Generating fully random contiguous ID distribution" <<  endl;
-        gen = std::mt19937(std::random_device{}());
     } else {
         OUTPUT << "Generating random contiguous ID distribution with seed: " << idSeed <<  endl;
-        gen = std::mt19937(idSeed);
     }
 
     // Shuffle the elements using the rng
@@ -449,7 +493,7 @@ void Simulator::readSimulationType(int argc, char*argv[]) {
         if (vmPath == "") {
             cerr << "error: no path defined for Meld VM" << endl;
             exit(1);
-        } else if (!vmPort) {
+        } else if (!vmPort && !cmdLine.getVMSharedMemory()) {
             cerr << "error: no port defined for Meld VM" << endl;
             exit(1);
         } else if (!file_exists(programPath)) {
@@ -459,7 +503,11 @@ void Simulator::readSimulationType(int argc, char*argv[]) {
         }
 
         MeldProcess::setVMConfiguration(vmPath, programPath, debugging);
-        MeldProcess::createVMServer(vmPort);
+        if (cmdLine.getVMSharedMemory()) {
+            MeldProcess::createVMSharedMemoryServer(cmdLine.getVMSharedMemorySlots());
+        } else {
+            MeldProcess::createVMServer(vmPort);
+        }
         if(debugging) {
             MeldProcess::createDebugger();
         }
@@ -542,6 +590,16 @@ void Simulator::parseWorld(int argc, char*argv[]) {
                  << " please use the command line option [-s <maxTime>]" << endl;
         }
 
+        attr = worldElement->Attribute("latticeStorage");
+        if (attr) {
+            if (!LatticeStorage::parseType(attr, Lattice::storageType)) {
+                stringstream error;
+                error << "Unknown latticeStorage \"" << attr
+                      << "\" in XML configuration file (dense, sparse)" << "\n";
+                throw ParsingException(error.str());
+            }
+        }
+
         // Get Blocksize
         float blockSize[3] = {0.0,0.0,0.0};
         xmlBlockListNode = xmlWorldNode->FirstChild("blockList");
@@ -1048,9 +1106,122 @@ void Simulator::parseCustomizations() {
     }
 }
 
+void Simulator::parseLinks() {
+    TiXmlNode *linksNode = xmlWorldNode->FirstChild("links");
+    if (not linksNode) return;
+
+    TiXmlElement *linksElement = linksNode->ToElement();
+    int seed;
+    if (linksElement->QueryIntAttribute("seed", &seed) == TIXML_SUCCESS)
+        LinkModel::setSeed((ruint)seed);
+    else
+        LinkModel::setSeed(getDerivedSeed(1));
+
+    auto error = [](const string &what, const char *name) {
+        stringstream err;
+        err << what << " of link model \"" << (name ? name : "") << "\" in configuration file" << "\n";
+        return ParsingException(err.str());
+    };
+
+    for (TiXmlElement *element = linksNode->FirstChildElement("linkModel"); element;
+         element = element->NextSiblingElement("linkModel")) {
+        const char *name = element->Attribute("name");
+        if (not name or LinkModel::find(name))
+            throw error("missing or duplicate name", name);
+
+        LinkModel *model = new LinkModel();
+        model->name = name;
+        double latency = 0;
+        element->QueryDoubleAttribute("dataRate", &model->dataRate);
+        element->QueryDoubleAttribute("dataRateStdDev", &model->dataRateStdDev);
+        element->QueryDoubleAttribute("latency", &latency);
+        element->QueryDoubleAttribute("latencyStdDev", &model->latencyStdDev);
+        model->latency = (Time)latency;
+        if (model->dataRate < 0 or model->dataRateStdDev < 0 or latency < 0
+            or model->latencyStdDev < 0)
+            throw error("negative data rate or latency", name);
+
+        const char *attr = element->Attribute("loss");
+        if (attr and not LinkModel::parseLossType(attr, model->lossType))
+            throw error("unknown loss \"" + string(attr) + "\" (none, gilbertElliott)", name);
+        element->QueryDoubleAttribute("pGoodToBad", &model->pGoodToBad);
+        element->QueryDoubleAttribute("pBadToGood", &model->pBadToGood);
+        element->QueryDoubleAttribute("lossGood", &model->lossGood);
+        element->QueryDoubleAttribute("lossBad", &model->lossBad);
+        for (double p : { model->pGoodToBad, model->pBadToGood, model->lossGood, model->lossBad })
+            if (p < 0 or p > 1) throw error("probability out of [0,1]", name);
+
+        attr = element->Attribute("outages");
+        if (attr and not model->parseOutages(attr))
+            throw error("invalid outages \"" + string(attr) + "\" (start-end;start-end, in us)", name);
+
+        LinkModel::add(model);
+    }
+
+    for (TiXmlElement *element = linksNode->FirstChildElement("link"); element;
+         element = element->NextSiblingElement("link")) {
+        const char *name = element->Attribute("model");
+        const LinkModel *model = name ? LinkModel::find(name) : NULL;
+        if (not model) throw error("unknown", name);
+
+        int blockId = 0, interface = -1;
+        element->QueryIntAttribute("blockId", &blockId);
+        element->QueryIntAttribute("interface", &interface);
+        LinkModel::assign(model, (bID)blockId, interface);
+    }
+}
+
+void Simulator::parseFaults() {
+    TiXmlNode *faultsNode = xmlWorldNode->FirstChild("faults");
+    int seed = 0;
+    bool seedSet = false;
+
+    if (faultsNode) {
+        TiXmlElement *faultsElement = faultsNode->ToElement();
+        seedSet = faultsElement->QueryIntAttribute("seed", &seed) == TIXML_SUCCESS;
+
+        for (TiXmlElement *element = faultsNode->FirstChildElement("fault"); element;
+             element = element->NextSiblingElement("fault")) {
+            Fault fault;
+            const char *type = element->Attribute("type");
+            const char *date = element->Attribute("date");
+            if (not type or not FaultInjector::parseType(type, fault.type)) {
+                stringstream error;
+                error << "Unknown fault type \"" << (type ? type : "")
+                      << "\" in configuration file (interfaceBreak, moduleDeath, messageDrop, stuckMotion)" << "\n";
+                throw ParsingException(error.str());
+            }
+            if (not date or not FaultInjector::parseDate(date, fault)) {
+                stringstream error;
+                error << "Invalid date \"" << (date ? date : "") << "\" of " << type
+                      << " fault in configuration file (<date> or <min>-<max>, in us)" << "\n";
+                throw ParsingException(error.str());
+            }
+
+            int blockId = 0, count = 1;
+            element->QueryIntAttribute("blockId", &blockId);
+            element->QueryIntAttribute("interface", &fault.interface);
+            element->QueryIntAttribute("count", &count);
+            if (blockId < 0 or count < 0) {
+                stringstream error;
+                error << "Negative blockId or count of " << type << " fault in configuration file" << "\n";
+                throw ParsingException(error.str());
+            }
+            fault.blockId = blockId;
+            fault.count = count;
+            FaultInjector::add(fault);
+        }
+    }
+
+    if (not FaultInjector::isEmpty())
+        FaultInjector::setSeed(seedSet ? (ruint)seed : getDerivedSeed(2));
+}
+
 void Simulator::startSimulation(void) {
     // Connect all blocks – TODO: Check if needed to do it here (maybe all blocks are linked on addition)
     world->linkBlocks();
+    if (Snapshot::isResuming()) Snapshot::restore();
+    MessageTypeRegistry::freeze();
 
     // Finalize scheduler configuration and start simulation if autoStart is enabled
     Scheduler *scheduler = getScheduler();
@@ -1067,4 +1238,12 @@ ruint Simulator::getRandomUint() {
     return generator();
 }
 
+ruint Simulator::getDerivedSeed(ruint stream) const {
+    // SplitMix64 finalizer, so that the streams of close seeds are not correlated
+    uint64_t z = ((uint64_t)generatorSeed << 32 | stream) + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (ruint)(z ^ (z >> 31));
+}
+
 } // Simulator namespace
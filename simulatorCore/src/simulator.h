@@ -25,8 +25,10 @@ using namespace std;
 namespace BaseSimulator {
 
 class Simulator;
+class Snapshot;
 
-extern Simulator *simulator;
+//!< Function creating a simulator of a type of module, see Simulator::createSimulator
+typedef Simulator *(*SimulatorBuilder)(int argc, char *argv[], BlockCodeBuilder bcb);
 
 /*! @class Simulator
  *  @brief Simulator is responsible for creating and configuring the core components of simulation (i.e. World, Scheduler), by parsing the configuration file and interpreting the command line args
@@ -36,11 +38,18 @@ class Simulator {
 public:
     enum Type {CPP = 0, MELDPROCESS = 1, MELDINTERPRET = 2};
     enum IDScheme {ORDERED = 0, MANUAL, RANDOM};
+    //!< Motion fidelity: ANIMATED schedules every intermediate step of a motion, as required for display.
+    //!<  LOGICAL jumps straight from the start to the stop of a motion, at the same simulated date.
+    enum MotionFidelity {ANIMATED = 0, LOGICAL};
 
     static bool regrTesting;			//!< Indicates if this simulation instance is performing regression testing
     inline static bool exportFinalConfiguration;
-    inline static string configFileName;
+    inline static RunLocal<string> configFileName;
     //!< (causes configuration export before simulator termination)
+    inline static RunLocal<MotionFidelity> motionFidelity { ANIMATED }; //!< LOGICAL by default when the GUI is disabled
+
+    //!< @brief Returns true if motion events must skip their intermediate animation steps
+    inline static bool logicalMotions() { return motionFidelity.get() == LOGICAL; }
 
     static Simulator* getSimulator() {
         assert(simulator != NULL);
@@ -52,6 +61,17 @@ public:
      */
     static void deleteSimulator();
 
+    /*!
+     *  @brief Creates the simulator and runs its simulation, or the simulations of the batch given
+     *   on the command line, each with a simulator of its own (see BatchRunner)
+     *
+     *  @param argc The number of command line arguments
+     *  @param argv The command line arguments
+     *  @param bcb The builder of the block codes
+     *  @param build Creates a simulator of the type of module of the simulation
+     */
+    static void createSimulator(int argc, char *argv[], BlockCodeBuilder bcb, SimulatorBuilder build);
+
     inline static void setType (Type t) { type = t; };
     inline static Type getType () { return type; };
     inline CommandLine& getCmdLine() { return cmdLine; }
@@ -78,6 +98,14 @@ public:
      */
     ruint getRandomUint();
 
+    /*!
+     *  @brief Returns the seed of an auxiliary random stream (link models, faults), derived from
+     *  the simulation seed without drawing from the simulation generator, so that enabling the
+     *  stream does not change the other random numbers of the simulation
+     *  @param stream identifier of the stream
+     */
+    ruint getDerivedSeed(ruint stream) const;
+
     /*
      * @brief Sets the simulation seed
      */
@@ -88,8 +116,9 @@ protected:
 
     int seed = DEFAULT_SIMULATION_SEED; //!< Simulation seed, used for every randomized operation
     uintRNG generator; //!< Simulation random generator, used for every randomized operation, except for the id distribution
+    ruint generatorSeed = 0; //!< Seed of the generator, the simulation seed or a random one
 
-    static Simulator *simulator; //!< Static member for accessing *this* simulator
+    static RunLocal<Simulator*> simulator; //!< Static member for accessing *this* simulator
     Scheduler *scheduler;		//!< Scheduler to be instantiated and configured
     World *world;				//!< Simulation world to be instantiated and configured
 
@@ -175,6 +204,19 @@ protected:
      */
     void parseCustomizations();
 
+    /**
+     *  @brief Parses the link models of the configuration file, and assigns them to the interfaces (see LinkModel).
+     *   Called before the blocks are created, which get their model when their interfaces are.
+     *  @throw ParsingException if a model is ill-formatted, or if a link refers to an unknown model
+     */
+    void parseLinks();
+
+    /**
+     *  @brief Parses the fault schedule of the configuration file, in addition to the faults of the command line (see FaultInjector)
+     *  @throw ParsingException if a fault is ill-formatted
+     */
+    void parseFaults();
+
 
         /*! @fn loadScheduler(int maximumDate)
      *  @brief Instantiates a scheduler instance for the simulation based on the type of CodeBlock
@@ -247,6 +289,8 @@ public:
     inline TiXmlDocument *getConfigDocument() { return xmlDoc; }
 
     inline BlockCodeBuilder getBlockCodeBuilder() { return bcb; }
+
+    friend class Snapshot;
 };
 
 inline void deleteSimulator() {
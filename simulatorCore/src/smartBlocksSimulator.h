@@ -27,7 +27,7 @@ public:
 
     static SmartBlocksSimulator* getSimulator() {
         assert(simulator != NULL);
-        return((SmartBlocksSimulator*)simulator);
+        return((SmartBlocksSimulator*)simulator.get());
     }
 
     virtual void loadWorld(const Cell3DPosition &gridSize, const Vector3D &gridScale,
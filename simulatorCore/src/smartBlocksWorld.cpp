@@ -39,13 +39,16 @@ SmartBlocksWorld::~SmartBlocksWorld() {
 }
 
 void SmartBlocksWorld::deleteWorld() {
-    delete((SmartBlocksWorld*)world);
+    delete((SmartBlocksWorld*)world.get());
     world=NULL;
 }
 
 void SmartBlocksWorld::addBlock(bID blockId, BlockCodeBuilder bcb,
                                 const Cell3DPosition &pos, const Color &col,
                                 short orientation, bool master) {
+    if (getScheduler()->deferWorldAction([=]() { addBlock(blockId, bcb, pos, col, orientation, master); }))
+        return;
+
     if (blockId > maxBlockId)
         maxBlockId = blockId;
     else if (blockId == 0)
@@ -73,7 +76,7 @@ void SmartBlocksWorld::addBlock(bID blockId, BlockCodeBuilder bcb,
 void SmartBlocksWorld::linkBlock(const Cell3DPosition &pos) {
     SmartBlocksBlock *ptrNeighbor;
     SmartBlocksBlock *ptrBlock = (SmartBlocksBlock*)lattice->getBlock(pos);
-    vector<Cell3DPosition> nRelCells = lattice->getRelativeConnectivity(pos);
+    const vector<Cell3DPosition> &nRelCells = lattice->getRelativeConnectivity(pos);
     Cell3DPosition nPos;
 
     // Check neighbors for each interface
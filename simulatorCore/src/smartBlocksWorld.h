@@ -34,7 +34,7 @@ public:
     static void deleteWorld();
     static SmartBlocksWorld* getWorld() {
         assert(world != NULL);
-        return((SmartBlocksWorld*)world);
+        return((SmartBlocksWorld*)world.get());
     }
 
     void printInfo() {
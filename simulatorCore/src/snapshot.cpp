@@ -0,0 +1,468 @@
+/*! @file snapshot.cpp
+ * @brief Binary snapshots of a simulation, and their resumption.
+ * @date 18/10/2026
+ */
+
+#include "snapshot.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iterator>
+#include <cstdlib>
+
+#include "world.h"
+#include "scheduler.h"
+#include "simulator.h"
+#include "blockCode.h"
+#include "buildingBlock.h"
+#include "lattice.h"
+#include "linkModel.h"
+#include "statsCollector.h"
+#include "faultInjector.h"
+#include "uniqueEventsId.h"
+#include "utils.h"
+
+using namespace std;
+using namespace BaseSimulator::utils;
+
+namespace BaseSimulator {
+
+Time Snapshot::saveDate = 0;
+string Snapshot::saveFile;
+string Snapshot::resumeFile;
+vector<uint8_t> Snapshot::resumeBytes;
+Time Snapshot::resumeDate = 0;
+mutex Snapshot::registryMutex;
+
+namespace {
+
+const char magic[4] = { 'V', 'S', 'N', 'P' };
+const uint8_t version = 1;
+
+//!< Words of the state of a generator, as printed by the standard library
+vector<uint32_t> getWords(const uintRNG &g) {
+    stringstream state;
+    state << g;
+    return vector<uint32_t>(istream_iterator<uint32_t>(state), istream_iterator<uint32_t>());
+}
+
+} // anonymous namespace
+
+//===========================================================================================================
+//
+//          WireFormat<uintRNG>
+//
+//===========================================================================================================
+
+size_t WireFormat<uintRNG>::size(const uintRNG &g) {
+    const size_t n = getWords(g).size();
+    return WireBuffer::varintSize(n) + 4 * n;
+}
+
+void WireFormat<uintRNG>::write(WireBuffer &b, const uintRNG &g) {
+    const vector<uint32_t> words = getWords(g);
+    b.writeVarint(words.size());
+    for (uint32_t w : words)
+        for (int i = 0; i < 4; i++) b.writeByte((uint8_t)(w >> (8 * i)));
+}
+
+void WireFormat<uintRNG>::read(WireReader &r, uintRNG &g) {
+    const size_t n = r.readCount();
+    stringstream state;
+    for (size_t k = 0; k < n; k++) {
+        uint32_t w = 0;
+        for (int i = 0; i < 4; i++) w |= (uint32_t)r.readByte() << (8 * i);
+        state << w << ' ';
+    }
+    state >> g;
+    if (state.fail()) throw SnapshotException("ill-formed state of random generator");
+}
+
+//===========================================================================================================
+//
+//          SnapshotWriter / SnapshotReader  (classes)
+//
+//===========================================================================================================
+
+void SnapshotWriter::writeBlock(const BuildingBlock *bb) {
+    write(bb ? bb->blockId : (bID)0);
+}
+
+void SnapshotWriter::writeInterface(const P2PNetworkInterface *itf) {
+    writeBlock(itf ? itf->hostBlock : NULL);
+    if (itf) write(itf->localId);
+}
+
+void SnapshotWriter::writeMessage(const MessagePtr &msg) {
+    if (not msg) {
+        writeVarint(0);
+        return;
+    }
+
+    auto known = messages.find(msg.get());
+    if (known != messages.end()) {
+        writeVarint(known->second);
+        return;
+    }
+    const size_t index = messages.size() + 1;
+    messages[msg.get()] = index;
+    writeVarint(index);
+
+    const string name = typeid(*msg).name();
+    {
+        lock_guard<mutex> lock(Snapshot::registryMutex);
+        if (not Snapshot::getMessageRestorers().count(name))
+            throw SnapshotException("messages " + msg->getMessageName() + " cannot be saved, "
+                                    "their class is not registered");
+    }
+    auto c = messageClasses.find(name);
+    if (c != messageClasses.end()) {
+        writeVarint(c->second);
+    } else {
+        const size_t classIndex = messageClasses.size() + 1;
+        messageClasses[name] = classIndex;
+        writeVarint(classIndex);
+        write(name);
+    }
+
+    write(msg->id, msg->type);
+    writeInterface(msg->sourceInterface);
+    writeInterface(msg->destinationInterface);
+    msg->serializeFields(*this);
+}
+
+void SnapshotWriter::writeEvent(const EventPtr &ev) {
+    {
+        lock_guard<mutex> lock(Snapshot::registryMutex);
+        if (not Snapshot::getEventRestorers().count(ev->eventType))
+            throw SnapshotException("events " + ev->getEventName() + " cannot be restored");
+    }
+
+    write(ev->eventType, ev->date, ev->id, ev->randomNumber);
+    if (not ev->save(*this))
+        throw SnapshotException("events " + ev->getEventName() + " cannot be saved");
+}
+
+BuildingBlock* SnapshotReader::readBlock() {
+    bID id;
+    read(id);
+    if (id == 0) return NULL;
+
+    BuildingBlock *bb = getWorld()->getBlockById(id);
+    if (not bb) throw SnapshotException("module " + to_string(id) + " does not exist");
+    return bb;
+}
+
+P2PNetworkInterface* SnapshotReader::readInterface() {
+    BuildingBlock *bb = readBlock();
+    if (not bb) return NULL;
+
+    bID localId;
+    read(localId);
+    if (localId >= bb->getNbInterfaces())
+        throw SnapshotException("module " + to_string(bb->blockId) + " has no interface " + to_string(localId));
+    return bb->getInterface(localId);
+}
+
+MessagePtr SnapshotReader::readMessage() {
+    const size_t index = (size_t)readVarint();
+    if (index == 0) return NULL;
+    if (index <= messages.size()) return messages[index - 1];
+    if (index != messages.size() + 1) throw SnapshotException("ill-formed message reference");
+
+    const size_t classIndex = (size_t)readVarint();
+    if (classIndex == messageClasses.size() + 1) {
+        messageClasses.emplace_back();
+        read(messageClasses.back());
+    } else if (classIndex == 0 or classIndex > messageClasses.size()) {
+        throw SnapshotException("ill-formed message class reference");
+    }
+    const string &name = messageClasses[classIndex - 1];
+
+    Snapshot::MessageRestorer restorer;
+    {
+        lock_guard<mutex> lock(Snapshot::registryMutex);
+        auto it = Snapshot::getMessageRestorers().find(name);
+        if (it == Snapshot::getMessageRestorers().end())
+            throw SnapshotException("message class " + name + " is not registered");
+        restorer = it->second;
+    }
+
+    bID id;
+    unsigned int type;
+    read(id, type);
+    P2PNetworkInterface *source = readInterface();
+    P2PNetworkInterface *destination = readInterface();
+    MessagePtr msg(restorer(*this));
+    msg->id = id;
+    msg->type = type;
+    msg->sourceInterface = source;
+    msg->destinationInterface = destination;
+    messages.push_back(msg);
+    return msg;
+}
+
+EventPtr SnapshotReader::readEvent() {
+    int type, id;
+    Time date;
+    ruint randomNumber;
+    read(type, date, id, randomNumber);
+
+    Snapshot::EventRestorer restorer;
+    {
+        lock_guard<mutex> lock(Snapshot::registryMutex);
+        auto it = Snapshot::getEventRestorers().find(type);
+        if (it == Snapshot::getEventRestorers().end())
+            throw SnapshotException("events of type " + to_string(type) + " are not registered");
+        restorer = it->second;
+    }
+
+    EventPtr ev(restorer(*this, date));
+    ev->id = id;
+    ev->randomNumber = randomNumber;
+    return ev;
+}
+
+//===========================================================================================================
+//
+//          Snapshot  (class)
+//
+//===========================================================================================================
+
+map<int, Snapshot::EventRestorer>& Snapshot::getEventRestorers() {
+    // Events of the core, the events of the worlds are registered by their constructor
+    static map<int, EventRestorer> restorers = {
+        { EVENT_CODE_START, &CodeStartEvent::restore },
+        { EVENT_END_SIMULATION, &CodeEndSimulationEvent::restore },
+        { EVENT_PROCESS_LOCAL_EVENT, &ProcessLocalEvent::restore },
+        { EVENT_NI_START_TRANSMITTING, &NetworkInterfaceStartTransmittingEvent::restore },
+        { EVENT_NI_STOP_TRANSMITTING, &NetworkInterfaceStopTransmittingEvent::restore },
+        { EVENT_NI_DELIVER, &NetworkInterfaceDeliverEvent::restore },
+        { EVENT_NI_RECEIVE, &NetworkInterfaceReceiveEvent::restore },
+        { EVENT_NI_ENQUEUE_OUTGOING_MESSAGE, &NetworkInterfaceEnqueueOutgoingEvent::restore },
+        { EVENT_SET_COLOR, &SetColorEvent::restore },
+        { EVENT_ADD_NEIGHBOR, &AddNeighborEvent::restore },
+        { EVENT_REMOVE_NEIGHBOR, &RemoveNeighborEvent::restore },
+        { EVENT_TAP, &TapEvent::restore },
+        { EVENT_ACCEL, &AccelEvent::restore },
+        { EVENT_SHAKE, &ShakeEvent::restore },
+        { EVENT_INTERRUPTION, &InterruptionEvent::restore },
+        { EVENT_PIVOT_ACTUATION_START, &PivotActuationStartEvent::restore },
+        { EVENT_PIVOT_ACTUATION_END, &PivotActuationEndEvent::restore },
+    };
+    return restorers;
+}
+
+map<string, Snapshot::MessageRestorer>& Snapshot::getMessageRestorers() {
+    static map<string, MessageRestorer> restorers;
+    return restorers;
+}
+
+void Snapshot::registerEvent(int type, EventRestorer restorer) {
+    lock_guard<mutex> lock(registryMutex);
+    getEventRestorers()[type] = restorer;
+}
+
+void Snapshot::write(SnapshotWriter &w) {
+    Simulator *sim = Simulator::getSimulator();
+    World *world = getWorld();
+    Lattice *lattice = world->lattice;
+    map<bID, BuildingBlock*> &blocks = world->getMap();
+    if (blocks.empty()) throw SnapshotException("no module to save");
+    BlockCode *firstCode = blocks.begin()->second->blockCode;
+
+    // Header: what the simulation resuming the snapshot must match
+    w.writeBytes(magic, sizeof(magic));
+    w.writeByte(version);
+    w.write(string(typeid(*firstCode).name()), Simulator::configFileName.get(), getScheduler()->now(),
+            sim->seed, sim->generatorSeed, Simulator::motionFidelity.get());
+    w.writeVarint(LinkModel::getModels().size());
+    for (const LinkModel *m : LinkModel::getModels()) w.write(m->name);
+
+    // Modules and lattice
+    w.writeVarint(blocks.size());
+    for (auto &p : blocks) {
+        BuildingBlock *bb = p.second;
+        const bool inLattice = lattice->getBlock(bb->position) == bb;
+        w.write(bb->blockId, (uint8_t)bb->getState(), bb->position, inLattice);
+    }
+    w.write(world->maxBlockId, lattice->nbModules);
+
+    const vector<EventPtr> events = getScheduler()->getPendingEvents();
+    w.writeVarint(events.size());
+    for (const EventPtr &ev : events) w.writeEvent(ev);
+
+    for (auto &p : blocks) {
+        BuildingBlock *bb = p.second;
+        bb->save(w);
+        w.write(bb->blockCode->availabilityDate, bb->blockCode->motionDest);
+        if (not bb->blockCode->saveState(w))
+            throw SnapshotException("block code of module " + to_string(bb->blockId)
+                                    + " does not implement saveState");
+    }
+    firstCode->saveSharedState(w);
+
+    w.write(sim->generator);
+    StatsCollector::getInstance().save(w);
+    w.write((int)Event::nextId.get().load(), (bID)Message::nextId.get().load(),
+            P2PNetworkInterface::nextId.get(), BuildingBlock::nextId.get());
+}
+
+void Snapshot::save() {
+    saveDate = 0;
+
+    SnapshotWriter w;
+    try {
+        write(w);
+    } catch (const SnapshotException &e) {
+        cerr << e.what() << ", cannot save " << saveFile << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    ofstream file(saveFile, ios::binary);
+    file.write(reinterpret_cast<const char*>(w.getBytes().data()), w.size());
+    if (not file) {
+        cerr << TermColor::ErrorColor << "error: cannot write the snapshot to " << saveFile << TermColor::Reset << endl;
+        exit(EXIT_FAILURE);
+    }
+    cerr << "snapshot: saved at " << getScheduler()->now() << " us to " << saveFile
+         << " (" << w.size() << " bytes)" << endl;
+}
+
+void Snapshot::load() {
+    if (not resumeBytes.empty()) return;
+
+    ifstream file(resumeFile, ios::binary);
+    if (file) resumeBytes.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    if (resumeBytes.size() < sizeof(magic) + 1) {
+        cerr << TermColor::ErrorColor << "error: cannot read the snapshot " << resumeFile << TermColor::Reset << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (not equal(magic, magic + sizeof(magic), resumeBytes.begin()) or resumeBytes[sizeof(magic)] != version) {
+        cerr << TermColor::ErrorColor << "error: " << resumeFile << " is not a snapshot of this version"
+             << TermColor::Reset << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    SnapshotReader r(resumeBytes);
+    string codeClass, config;
+    char header[sizeof(magic) + 1];
+    try {
+        r.readBytes(header, sizeof(header));
+        r.read(codeClass, config, resumeDate);
+    } catch (const out_of_range&) {
+        cerr << TermColor::ErrorColor << "error: truncated snapshot " << resumeFile << TermColor::Reset << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+Time Snapshot::getResumeDate() {
+    load();
+    return resumeDate;
+}
+
+void Snapshot::read(SnapshotReader &r) {
+    Simulator *sim = Simulator::getSimulator();
+    World *world = getWorld();
+    Lattice *lattice = world->lattice;
+    map<bID, BuildingBlock*> &blocks = world->getMap();
+    if (blocks.empty()) throw SnapshotException("no module to restore");
+    BlockCode *firstCode = blocks.begin()->second->blockCode;
+
+    char header[sizeof(magic) + 1];
+    string codeClass, config;
+    Time date;
+    Simulator::MotionFidelity fidelity;
+    r.readBytes(header, sizeof(header));
+    r.read(codeClass, config, date, sim->seed, sim->generatorSeed, fidelity);
+    if (codeClass != typeid(*firstCode).name())
+        throw SnapshotException("the snapshot was taken with another block code");
+    if (fidelity != Simulator::motionFidelity.get())
+        throw SnapshotException("the snapshot was taken with another motion fidelity (-M)");
+    if (config != Simulator::configFileName.get())
+        cerr << "warning: the snapshot was taken with configuration file " << config << endl;
+
+    const size_t nbModels = r.readCount();
+    if (nbModels != LinkModel::getModels().size())
+        throw SnapshotException("the snapshot was taken with other link models");
+    for (const LinkModel *m : LinkModel::getModels()) {
+        string name;
+        r.read(name);
+        if (name != m->name) throw SnapshotException("the snapshot was taken with other link models");
+    }
+
+    // Modules, placed again on a lattice emptied of the initial ones
+    for (auto &p : blocks)
+        if (lattice->getBlock(p.second->position) == p.second) lattice->remove(p.second->position, false);
+
+    vector<pair<BuildingBlock*, bool>> placed;
+    for (size_t n = r.readCount(); n > 0; n--) {
+        bID id;
+        uint8_t state;
+        Cell3DPosition position;
+        bool inLattice;
+        r.read(id, state, position, inLattice);
+
+        BuildingBlock *bb = world->getBlockById(id);
+        if (not bb) {
+            // Added during the simulation
+            world->addBlock(id, sim->getBlockCodeBuilder(), position, Color());
+            bb = world->getBlockById(id);
+            lattice->remove(position, false);
+        }
+        bb->setState((BuildingBlock::State)state);
+        bb->position = position;
+        placed.push_back(make_pair(bb, inLattice));
+    }
+    if (placed.size() != blocks.size())
+        throw SnapshotException("modules of the configuration are missing from the snapshot");
+    for (auto &p : placed)
+        if (p.second) lattice->insert(p.first, p.first->position, false);
+    r.read(world->maxBlockId, lattice->nbModules);
+
+    vector<EventPtr> events;
+    for (size_t n = r.readCount(); n > 0; n--) events.push_back(r.readEvent());
+    getScheduler()->replacePendingEvents(date, events);
+
+    for (auto &p : blocks) {
+        BuildingBlock *bb = p.second;
+        bb->restore(r);
+        r.read(bb->blockCode->availabilityDate, bb->blockCode->motionDest);
+        bb->blockCode->restoreState(r);
+    }
+    firstCode->restoreSharedState(r);
+
+    r.read(sim->generator);
+    // Last, the statistics were counting the events of the initial state
+    StatsCollector::getInstance().restore(r);
+    int eventId;
+    bID messageId;
+    r.read(eventId, messageId, P2PNetworkInterface::nextId.get(), BuildingBlock::nextId.get());
+    Event::nextId.get() = eventId;
+    Message::nextId.get() = messageId;
+
+    if (r.remaining()) throw SnapshotException("trailing bytes in the snapshot");
+}
+
+void Snapshot::restore() {
+    load();
+
+    SnapshotReader r(resumeBytes);
+    try {
+        read(r);
+    } catch (const SnapshotException &e) {
+        cerr << e.what() << ", cannot resume " << resumeFile << endl;
+        exit(EXIT_FAILURE);
+    } catch (const out_of_range &e) {
+        cerr << TermColor::ErrorColor << "error: cannot resume the snapshot " << resumeFile << ", " << e.what()
+             << TermColor::Reset << endl;
+        exit(EXIT_FAILURE);
+    }
+    cerr << "snapshot: resumed at " << resumeDate << " us from " << resumeFile << endl;
+
+    // Faults of the simulation, which the snapshot does not hold (see FaultInjector::runCampaigns)
+    FaultInjector::schedule();
+}
+
+} // BaseSimulator namespace
@@ -0,0 +1,156 @@
+/*! @file snapshot.h
+ * @brief Binary snapshots of a simulation at a given date (-S command line option), from which
+ *  the simulation can be resumed (-U), or the simulations of fault injection campaigns forked.
+ * @date 18/10/2026
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <typeinfo>
+
+#include "tDefs.h"
+#include "random.h"
+#include "exceptions.h"
+#include "messageCodec.h"
+#include "network.h"
+#include "events.h"
+
+namespace BaseSimulator {
+
+class BuildingBlock;
+
+class SnapshotException : public VisibleSimException {
+public:
+    SnapshotException(const std::string &reason) : VisibleSimException(reason, std::string("snapshot")) {}
+};
+
+//!< Random generators are saved as their whole state, so that a resumed simulation draws the same numbers
+template<>
+struct WireFormat<uintRNG> {
+    static size_t size(const uintRNG &g);
+    static void write(WireBuffer &b, const uintRNG &g);
+    static void read(WireReader &r, uintRNG &g);
+};
+
+/**
+ * @brief Encoder of a snapshot. Values are written in the wire format of the messages, and
+ *  references to modules, interfaces, messages and events as identifiers.
+ */
+class SnapshotWriter : public WireBuffer {
+    std::map<const Message*, size_t> messages; //!< Index of the messages written so far, from 1
+    std::map<std::string, size_t> messageClasses; //!< Index of the classes of these messages, from 1
+public:
+    //!< @brief Writes the id of bb, 0 for NULL
+    void writeBlock(const BuildingBlock *bb);
+    //!< @brief Writes the module and the index of itf, a 0 module for NULL
+    void writeInterface(const P2PNetworkInterface *itf);
+    /**
+     * @brief Writes msg once, then its index, so that messages shared by several events or
+     *  queues are still shared when resumed
+     * @throw SnapshotException if the class of the message is not registered (see Snapshot::registerMessage)
+     */
+    void writeMessage(const MessagePtr &msg);
+    /**
+     * @brief Writes the type, date and fields of a pending event
+     * @throw SnapshotException if the event cannot be saved, or restored (see Snapshot::registerEvent)
+     */
+    void writeEvent(const EventPtr &ev);
+};
+
+//!< @brief Decoder of a snapshot, the mirror of SnapshotWriter
+class SnapshotReader : public WireReader {
+    std::vector<MessagePtr> messages;
+    std::vector<std::string> messageClasses;
+public:
+    SnapshotReader(const std::vector<uint8_t> &bytes) : WireReader(bytes) {}
+
+    //!< @throw SnapshotException if the module does not exist
+    BuildingBlock* readBlock();
+    P2PNetworkInterface* readInterface();
+    MessagePtr readMessage();
+    EventPtr readEvent();
+};
+
+/**
+ * @brief Snapshots of the state of a simulation: pending events, modules and lattice,
+ *  interfaces and their queued messages, states of the block codes (see BlockCode::saveState),
+ *  random generators and statistics. A snapshot is taken by the scheduler right before the
+ *  first event processed at or after its date, and resumed once the world of the same
+ *  configuration file has been built, in place of its initial state.
+ *
+ *  Resuming a snapshot with fault injection campaigns (-C) forks their simulations from it, so
+ *  that each simulation only costs the suffix of the fault free one after the snapshot date.
+ *
+ *  Only the state that can be saved exactly is accepted, an error is reported otherwise: events
+ *  and messages of classes registered with a restore function, interfaces with a constant data
+ *  rate, modules with a perfect clock, block codes implementing saveState, and fault free
+ *  simulations of the sequential scheduler.
+ */
+class Snapshot {
+public:
+    //!< Creates an event of the type it is registered for, at date, from its saved fields
+    typedef Event* (*EventRestorer)(SnapshotReader &r, Time date);
+    //!< Creates a message of the class it is registered for, from its saved fields
+    typedef Message* (*MessageRestorer)(SnapshotReader &r);
+private:
+    static Time saveDate;       //!< 0 if no snapshot is to be taken, or once it has been taken
+    static std::string saveFile;
+    static std::string resumeFile;
+    static std::vector<uint8_t> resumeBytes; //!< Loaded on first use
+    static Time resumeDate;
+    static std::mutex registryMutex;
+
+    static std::map<int, EventRestorer>& getEventRestorers();
+    static std::map<std::string, MessageRestorer>& getMessageRestorers();
+    static void load();
+    static void write(SnapshotWriter &w);
+    static void read(SnapshotReader &r);
+
+    friend class SnapshotWriter;
+    friend class SnapshotReader;
+public:
+    //!< @brief Takes a snapshot to file, right before the first event processed at or after date
+    static void setSave(Time date, const std::string &file) { saveDate = date; saveFile = file; }
+    static bool isSaving() { return not saveFile.empty(); }
+    //!< @brief Tells whether the snapshot must be taken before processing an event at date
+    static bool isDue(Time date) { return saveDate and date >= saveDate; }
+    /**
+     * @brief Writes the snapshot of the simulation at the current date. Exits if part of its
+     *  state cannot be saved.
+     *  Called by the scheduler thread, between two events.
+     */
+    static void save();
+
+    //!< @brief Resumes the simulation from the snapshot of file instead of starting it
+    static void setResume(const std::string &file) { resumeFile = file; }
+    static bool isResuming() { return not resumeFile.empty(); }
+    //!< @brief Returns the date of the snapshot being resumed. Exits if it cannot be read.
+    static Time getResumeDate();
+    /**
+     * @brief Replaces the initial state of the simulation by the one of the snapshot. Exits if
+     *  the snapshot cannot be read, or does not match the configuration of the simulation.
+     *  Called once the world has been built and linked, before the scheduler starts.
+     */
+    static void restore();
+
+    //!< @brief Registers the restore function of the events of type
+    static void registerEvent(int type, EventRestorer restorer);
+    /**
+     * @brief Registers message class M, which must define static Message* restore(SnapshotReader&),
+     *  reading the fields declared with MESSAGE_WIRE_FIELDS
+     */
+    template<class M>
+    static void registerMessage() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        getMessageRestorers()[typeid(M).name()] = &M::restore;
+    }
+};
+
+} // BaseSimulator namespace
+
+#endif /* SNAPSHOT_H_ */
@@ -10,12 +10,27 @@
 #include <iomanip>
 
 #include "world.h"
+#include "snapshot.h"
 
 using namespace std;
 
 namespace BaseSimulator {
+
+utils::StatsCollector* RunLocalInit<utils::StatsCollector>::create(const utils::StatsCollector&) {
+    return new utils::StatsCollector();
+}
+
 namespace utils {
 
+RunLocal<StatsCollector> StatsCollector::instance;
+
+void StatsCollector::notifyCompletion(Time date) {
+    if (__atomic_exchange_n(&completed, true, __ATOMIC_ACQ_REL)) return;
+
+    completionDate = date;
+    completionMessages = getMsgCount();
+}
+
 ostream& operator<<(ostream& out,const StatsCollector &sc) {
     out << TermColor::BBlue;
     out << endl << "=== GLOBAL STATISTICS ===" << endl;
@@ -39,11 +54,28 @@ ostream& operator<<(ostream& out,const StatsCollector &sc) {
         << TermColor::BMagenta << sc.nbLivingEvents << endl;
     out << TermColor::BWhite << "Message(s) left in memory before destroying Scheduler: "
         << TermColor::BMagenta << sc.nbLivingMessages << endl;
+    out << TermColor::BWhite << "Event pool slabs allocated: "
+        << TermColor::BMagenta << sc.nbEventSlabs << " (" << sc.eventPoolBytes / 1024 << " kB)" << endl;
+    out << TermColor::BWhite << "Event(s) allocated outside of the pool: "
+        << TermColor::BMagenta << sc.nbLargeEventAllocations << endl;
     out << TermColor::BWhite << "Number of events processed per second: "
         << TermColor::BMagenta << sc.computeEventPerSec() << endl;
     out << TermColor::Reset;
     return out;
 }
 
+void StatsCollector::save(SnapshotWriter &w) const {
+    w.write((uint64_t)messagesProcessed.load(), (uint64_t)motionsProcessed.load(), eventsProcessed,
+            largestEventsQueueSize, completed, completionDate, completionMessages);
+}
+
+void StatsCollector::restore(SnapshotReader &r) {
+    uint64_t messages, motions;
+    r.read(messages, motions, eventsProcessed, largestEventsQueueSize,
+           completed, completionDate, completionMessages);
+    messagesProcessed.store(messages);
+    motionsProcessed.store(motions);
+}
+
 } // namespace BaseSimulator::utils
 } // namespace BaseSimulator
@@ -10,10 +10,25 @@
 
 #include <iostream>
 #include <cstdint>
+#include <atomic>
 
 #include "tDefs.h"
+#include "runContext.h"
 
 namespace BaseSimulator {
+class SnapshotWriter;
+class SnapshotReader;
+
+namespace utils {
+class StatsCollector;
+}
+
+//!< The statistics of a simulation start from zero, whatever those of the process
+template<>
+struct RunLocalInit<utils::StatsCollector> {
+    static utils::StatsCollector* create(const utils::StatsCollector&);
+};
+
 namespace utils {
 
 //!< Singleton-based global statistics collection class
@@ -23,14 +38,17 @@ class StatsCollector {
  *                   Module Description
  ************************************************************/    
 public:
-    //<! @brief Used to get the singleton instance of StatsCollector.
+    //<! @brief Used to get the singleton instance of StatsCollector of the simulation.
     //!< Allocate it on first call, return existing instance on all subsequent calls
     //<! @return singleton instance of StatsCollector
     static StatsCollector& getInstance() {
-        static StatsCollector instance;
-        return instance;
+        return instance.get();
     };
 private:
+    static RunLocal<StatsCollector> instance; //!< Statistics of each simulation (see BatchRunner)
+    friend class RunLocal<StatsCollector>;
+    friend struct RunLocalInit<StatsCollector>;
+
     StatsCollector() {};        //!< Constructor. Nothing to be done.
     StatsCollector(StatsCollector const&); //<! Disable copy constructor. (Copying instance is not allowed)
     void operator=(StatsCollector const&); //<! Disable assignment operator. (Copying instance is not allowed)
@@ -39,42 +57,72 @@ private:
  *             Collected Statistics Description 
  ************************************************************/
 private:
-    // Messages
-    uint64_t messagesProcessed = 0; //!< Total number of messages processed by VisibleSim
+    // Messages and motions are counted by the block codes, possibly from several threads (see ParallelScheduler)
+    std::atomic<uint64_t> messagesProcessed{0}; //!< Total number of messages processed by VisibleSim
     uint64_t nbLivingMessages = 0; //!< Total number of messages still in memory at scheduler end
     // uint64_t maxiMessageQueueDepth = 0; //!< Total number of messages processed by VisibleSim
     // Motions
-    uint64_t motionsProcessed = 0; //!< Total number of motion events processed by VisibleSim
+    std::atomic<uint64_t> motionsProcessed{0}; //!< Total number of motion events processed by VisibleSim
     // Events
     uint64_t eventsProcessed = 0; //!< Total number of events processed by VisibleSim
     uint64_t nbLivingEvents = 0; //!< Total number of events still in memory at scheduler end
     uint64_t largestEventsQueueSize = 0; //!< Largest size of the scheduler's event
     uint64_t endEventsQueueSize = 0; //!< Size of the events queue at scheduler end
+    uint64_t nbEventSlabs = 0; //!< Number of slabs (i.e., mallocs) the event pool had to allocate
+    uint64_t eventPoolBytes = 0; //!< Memory reserved by the event pool (bytes)
+    uint64_t nbLargeEventAllocations = 0; //!< Number of events too large to be pooled, allocated with malloc
     // Time
     Time simulatedElapsedTime = 0; //!< Duration of simulation in discrete simulator time
     double realElapsedTime = 0; //!< Duration of simulation in real time (us)
+    // Completion of the task of the block codes
+    bool completed = false; //!< Set by the first call to notifyCompletion
+    Time completionDate = 0; //!< Simulated date of the completion
+    uint64_t completionMessages = 0; //!< Messages sent before the completion
 
     //!< @brief Returns the number of events processed per seconds, calculated from realElapsedTime (in microseconds)
     inline double computeEventPerSec() const {  return realElapsedTime ? eventsProcessed / (realElapsedTime / 1000000) : 0; };
 public:
     //!< Increments processed message count by 1
-    inline void incMsgCount() { messagesProcessed++; };
+    inline void incMsgCount() { messagesProcessed.fetch_add(1, std::memory_order_relaxed); };
+    //!< Returns the number of messages sent so far
+    inline uint64_t getMsgCount() const { return messagesProcessed.load(std::memory_order_relaxed); };
     //!< Increments processed motion count by 1
-    inline void incMotionCount() { motionsProcessed++; };
+    inline void incMotionCount() { motionsProcessed.fetch_add(1, std::memory_order_relaxed); };
     //!< Increments processed event count by 1
     inline void incEventsCount() { eventsProcessed++; };
+    //!< Returns the number of events processed so far
+    inline uint64_t getEventsCount() const { return eventsProcessed; };
     //!< Updates both elapsed times
     inline void updateElapsedTime(Time simTime, Time realTime)
         { simulatedElapsedTime = simTime; realElapsedTime = realTime; };
+    inline Time getSimulatedElapsedTime() const { return simulatedElapsedTime; };
+    inline double getRealElapsedTime() const { return realElapsedTime; };
+    /**
+     * @brief Called by the block code when its task is complete, such as the end of an assembly.
+     *  Only the first call is accounted, it may come from any of the threads of the ParallelScheduler.
+     * @param date simulated date of the completion
+     */
+    void notifyCompletion(Time date);
+    inline bool isCompleted() const { return completed; };
+    inline Time getCompletionDate() const { return completionDate; };
+    inline uint64_t getCompletionMsgCount() const { return completionMessages; };
     //!< Called before scheduler destruction to collect the state of important queues at end time
     inline void setLivingCounters(uint64_t livingEvents, uint64_t livingMessages)
         { nbLivingEvents = livingEvents; nbLivingMessages = livingMessages; };
+    //!< Called before scheduler destruction to collect the allocation counters of the event pool
+    inline void setEventPoolCounters(uint64_t slabs, uint64_t reservedBytes, uint64_t largeAllocations)
+        { nbEventSlabs = slabs; eventPoolBytes = reservedBytes; nbLargeEventAllocations = largeAllocations; };
     //!< Updates the max events queue size counter if new size is greater than previous size
     inline void updateLargestEventsQueueSize(uint64_t newSize) 
         {  largestEventsQueueSize = largestEventsQueueSize < newSize ? newSize : largestEventsQueueSize; };
     inline void setEndEventsQueueSize(uint64_t endSize) 
         {  endEventsQueueSize = endSize; };
 
+    //!< Writes the counters of the simulation so far to a snapshot
+    void save(SnapshotWriter &w) const;
+    //!< Reads back the counters written by save
+    void restore(SnapshotReader &r);
+
     //!< Prints collected statistics to an ouput stream
     friend std::ostream& operator<<(std::ostream& out,const StatsCollector &sc);
 };                              // class StatsCollector
@@ -9,6 +9,7 @@
 #include "statsIndividual.h"
 #include "buildingBlock.h"
 #include "world.h"
+#include "snapshot.h"
 
 using namespace std;
 
@@ -200,5 +201,17 @@ string StatsIndividual::getStats() {
   return s;
 }
 
+void StatsIndividual::save(SnapshotWriter &w) const {
+    w.write(sentMessages, receivedMessages, outgoingMessageQueueSize, incommingMessageQueueSize,
+            messageQueueSize, maxOutgoingMessageQueueSize, maxIncommingMessageQueueSize,
+            maxMessageQueueSize, motions);
+}
+
+void StatsIndividual::restore(SnapshotReader &r) {
+    r.read(sentMessages, receivedMessages, outgoingMessageQueueSize, incommingMessageQueueSize,
+           messageQueueSize, maxOutgoingMessageQueueSize, maxIncommingMessageQueueSize,
+           maxMessageQueueSize, motions);
+}
+
 }  
 }
@@ -14,6 +14,9 @@
 #include "tDefs.h"
 
 namespace BaseSimulator {
+class SnapshotWriter;
+class SnapshotReader;
+
 namespace utils {
   
 //!< StatsIndividual class.
@@ -57,6 +60,11 @@ public:
     
     //!< Returns a string that contains a summary of the module statistics
     static std::string getStats();
+
+    //!< Writes the statistics of the module to a snapshot
+    void save(SnapshotWriter &w) const;
+    //!< Reads back the statistics written by save
+    void restore(SnapshotReader &r);
  private:
 
     //!< Updates queue size statistics
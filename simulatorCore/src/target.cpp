@@ -16,8 +16,8 @@ namespace BaseSimulator {
 
 using namespace BaseSimulator::utils;
 
-TiXmlNode *Target::targetListNode = NULL;
-TiXmlNode *Target::targetNode = NULL;
+RunLocal<TiXmlNode*> Target::targetListNode;
+RunLocal<TiXmlNode*> Target::targetNode;
 
 Target *Target::loadNextTarget() {
     if (Target::targetListNode) {
@@ -41,6 +41,7 @@
 
 #include "color.h"
 #include "cell3DPosition.h"
+#include "runContext.h"
 #include "targetEncoding/CSG/csg.h"
 #include "vector3D.h"
 #include "exceptions.h"
@@ -99,8 +100,8 @@ protected:
     virtual void print(ostream& where) const {};
 
 public:
-    static TiXmlNode *targetListNode; //!< pointer to the target list node from the XML configuration file
-    static TiXmlNode *targetNode; //!< pointer to the current target node from the XML configuration file
+    static RunLocal<TiXmlNode*> targetListNode; //!< pointer to the target list node from the XML configuration file
+    static RunLocal<TiXmlNode*> targetNode; //!< pointer to the current target node from the XML configuration file
 
     /**
      * @brief Parse next target from the configuration file's Target List, and return a pointer to the instantiated object
@@ -373,7 +373,7 @@ bool CSGDifference::isInBorder(const Vector3D &p, Color &color, double border) c
     if (children.size() > 0 and isInside(p, color)) {
         if (children[0]->isInBorder(p, color, border)) return true;
         else if (children[0]->isInside(p, color)) {
-            const Cell3DPosition pPos = static_cast<TargetCSG*>(BlockCode::target)->
+            const Cell3DPosition pPos = static_cast<TargetCSG*>(BlockCode::target.get())->
                 CSGToGridPosition(p);
             
             // cout << "\t" << pPos << " - p: " << p << endl;
@@ -46,6 +46,10 @@ void TeleportationStartEvent::consume() {
     EVENT_CONSUME_INFO();
     Scheduler *scheduler = getScheduler();
     BuildingBlock *bb = concernedBlock;
+    if (bb->motionsStuck) {
+        // The motion never starts, nor ends (see FaultInjector)
+        return;
+    }
     World::getWorld()->disconnectBlock(bb, false);
 
     Time t = scheduler->now() + ANIMATION_DELAY;
@@ -11,6 +11,6 @@
 std::ofstream log_file{};
 
 void ConsoleStream::flush() {
-    scheduler->trace(stream.str(),blockId);
+    scheduler->trace(stream.str(),blockId,WHITE,BaseSimulator::TraceCategory::Console);
     stream.str("");
 };
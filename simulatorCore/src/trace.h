@@ -14,6 +14,7 @@
 #include <cstring>
 
 #include "tDefs.h"
+#include "traceSink.h"
 
 #define LOGFILE
 
@@ -47,6 +48,8 @@ public:
     void flush();
 	
     ConsoleStream& operator<<(const char* value ) {
+        if (not BaseSimulator::TraceSink::isEnabled(BaseSimulator::TraceCategory::Console))
+            return *this;
         int l=strlen(value);
         if (value[l-1]=='\n') {
             string s(value);
@@ -61,7 +64,8 @@ public:
 
     template<typename T>
     ConsoleStream& operator<<( T const& value ) {
-        stream << value;
+        if (BaseSimulator::TraceSink::isEnabled(BaseSimulator::TraceCategory::Console))
+            stream << value;
         return *this;
     }
 };
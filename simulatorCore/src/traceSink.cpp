@@ -0,0 +1,346 @@
+/*! @file traceSink.cpp
+ * @brief Asynchronous binary sink for the simulation traces and logs.
+ * @date 17/10/2026
+ */
+
+#include "traceSink.h"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <vector>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+#include "trace.h"
+#include "scheduler.h"
+
+using namespace std;
+
+namespace BaseSimulator {
+
+uint32_t TraceSink::categoriesFilter = TraceSink::allCategories;
+uint32_t TraceSink::enabledCategories = TraceSink::allCategories;
+
+namespace {
+
+const int headerWords = 3;
+const size_t maxPendingLog = 4096; //!< Bytes of a Log record above which it is sent without waiting for a flush
+
+/**
+ * @brief Ring buffer of 64 bits words, with multiple producers and a single consumer.
+ *  A record is made of headerWords words followed by its payload, padded to a whole word:
+ *  - word 0: (nbWords << 40) | (length << 8) | (category + 1), 0 until the record is published
+ *  - word 1: date
+ *  - word 2: blockId
+ *  The consumer zeroes the words of the records it consumes, before releasing them.
+ */
+class TraceRing {
+    vector<uint64_t> words;
+    uint64_t mask;
+    atomic<uint64_t> head{0};   //!< Total number of words reserved by the producers
+    atomic<uint64_t> tail{0};   //!< Total number of words released by the consumer
+public:
+    TraceRing(size_t nbWords) : words(nbWords, 0), mask(nbWords - 1) {};
+
+    size_t capacity() const { return words.size(); }
+
+    //!< @brief Returns true if more than half of the ring is used
+    bool isFilling() const {
+        return head.load(memory_order_relaxed) - tail.load(memory_order_relaxed) > words.size() / 2;
+    }
+
+    bool empty() const {
+        return head.load(memory_order_acquire) == tail.load(memory_order_acquire);
+    }
+
+    /**
+     * @brief Reserves nbWords words
+     * @return index of the first reserved word, or false if the ring is currently full
+     */
+    bool reserve(uint64_t nbWords, uint64_t &index) {
+        uint64_t h = head.load(memory_order_relaxed);
+        do {
+            if (h + nbWords - tail.load(memory_order_acquire) > words.size()) return false;
+        } while (not head.compare_exchange_weak(h, h + nbWords, memory_order_relaxed));
+
+        index = h;
+        return true;
+    }
+
+    void fill(uint64_t index, TraceCategory category, Time date, bID blockId,
+              const char *payload, size_t length, uint64_t nbWords) {
+        words[(index + 1) & mask] = date;
+        words[(index + 2) & mask] = blockId;
+        for (uint64_t i = 0; i < nbWords - headerWords; i++) {
+            uint64_t w = 0;
+            memcpy(&w, payload + 8 * i, min((size_t)8, length - 8 * i));
+            words[(index + headerWords + i) & mask] = w;
+        }
+
+        // Publication
+        __atomic_store_n(&words[index & mask],
+                         nbWords << 40 | (uint64_t)length << 8 | ((uint64_t)category + 1),
+                         __ATOMIC_RELEASE);
+    }
+
+    /**
+     * @brief Appends the published records to out, in the file format, and releases them
+     * @return true if at least one record has been consumed
+     */
+    bool consume(vector<char> &out);
+};
+
+//!< @brief Appends v in LEB128 format: 7 bits per byte, least significant first, high bit set on all but the last byte
+inline void appendVarint(vector<char> &out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((char)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((char)v);
+}
+
+inline bool readVarint(istream &in, uint64_t &v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const int c = in.get();
+        if (c == EOF) return false;
+        v |= (uint64_t)(c & 0x7F) << shift;
+        if (not (c & 0x80)) return true;
+    }
+
+    return false;
+}
+
+bool TraceRing::consume(vector<char> &out) {
+    uint64_t t = tail.load(memory_order_relaxed);
+    const uint64_t h = head.load(memory_order_acquire);
+    const uint64_t first = t;
+
+    while (t < h) {
+        const uint64_t w0 = __atomic_load_n(&words[t & mask], __ATOMIC_ACQUIRE);
+        if (w0 == 0) break; // Reserved but not published yet
+
+        const uint64_t nbWords = w0 >> 40;
+        const size_t length = (w0 >> 8) & 0xFFFFFFFF;
+        out.push_back((char)((w0 & 0xFF) - 1));
+        appendVarint(out, words[(t + 1) & mask]);
+        appendVarint(out, words[(t + 2) & mask]);
+        appendVarint(out, length);
+        for (uint64_t i = 0; i < nbWords - headerWords; i++) {
+            const char *w = reinterpret_cast<const char*>(&words[(t + headerWords + i) & mask]);
+            out.insert(out.end(), w, w + min((size_t)8, length - 8 * i));
+        }
+
+        for (uint64_t i = 0; i < nbWords; i++) words[(t + i) & mask] = 0;
+        t += nbWords;
+    }
+
+    tail.store(t, memory_order_release);
+    return t != first;
+}
+
+/**
+ * @brief Stream buffer of OUTPUT / ERRPUT while the sink is open.
+ *  Text is gathered per thread and sent as a Log record when the stream is flushed, or when
+ *  the thread exits.
+ */
+class LogBuffer : public streambuf {
+    //!< Text of a thread not sent yet
+    struct Pending {
+        string text;
+        ~Pending() { send(text); }
+    };
+    static thread_local Pending pending;
+
+    static void send(string &text) {
+        if (text.empty()) return;
+        if (TraceSink::isOpen() and TraceSink::isEnabled(TraceCategory::Log))
+            TraceSink::write(TraceCategory::Log, Scheduler::getDate(), 0,
+                             text.data(), text.size());
+        text.clear();
+    }
+protected:
+    int_type overflow(int_type c) override {
+        if (c != traits_type::eof()) {
+            pending.text += traits_type::to_char_type(c);
+            if (pending.text.size() >= maxPendingLog) send(pending.text);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    streamsize xsputn(const char *s, streamsize n) override {
+        pending.text.append(s, n);
+        if (pending.text.size() >= maxPendingLog) send(pending.text);
+        return n;
+    }
+
+    int sync() override {
+        send(pending.text);
+        return 0;
+    }
+public:
+    //!< Sends the text of the calling thread, before one of its records of another category
+    static void flushThread() { send(pending.text); }
+};
+
+thread_local LogBuffer::Pending LogBuffer::pending;
+
+//!< State of the open sink
+struct Sink {
+    TraceRing ring;
+    FILE *file;
+    thread writer;
+    mutex writerMutex;
+    condition_variable writerCV;    //!< Notified when the ring fills up, or when closing
+    bool closing = false;
+    LogBuffer logBuffer;
+    streambuf *logFileBuffer = NULL; //!< Buffer of log_file before it was redirected to the sink
+
+    Sink(size_t nbWords, FILE *f) : ring(nbWords), file(f) {};
+
+    void run() {
+        vector<char> out;
+        for (;;) {
+            bool stop;
+            {
+                unique_lock<mutex> lock(writerMutex);
+                if (not closing) writerCV.wait_for(lock, chrono::milliseconds(10));
+                stop = closing;
+            }
+
+            while (ring.consume(out)) {
+                fwrite(out.data(), 1, out.size(), file);
+                out.clear();
+            }
+
+            if (stop and ring.empty()) break;
+        }
+    }
+};
+
+Sink *sink = NULL;
+
+} // anonymous namespace
+
+void TraceSink::setCategories(uint32_t mask, bool hasOutput) {
+    categoriesFilter = mask & allCategories;
+    enabledCategories = hasOutput ? categoriesFilter : 0;
+}
+
+bool TraceSink::parseCategories(const string &list, uint32_t &mask) {
+    static const char *names[] = { "log", "trace", "motion", "message", "console" };
+    uint32_t m = 0;
+    stringstream ss(list);
+    string name;
+
+    while (getline(ss, name, ',')) {
+        if (name == "all") m = allCategories;
+        else if (name == "none") continue;
+        else {
+            int c = 0;
+            while (c < (int)TraceCategory::NbCategories and name != names[c]) c++;
+            if (c == (int)TraceCategory::NbCategories) return false;
+            m |= 1u << c;
+        }
+    }
+
+    mask = m;
+    return true;
+}
+
+bool TraceSink::open(const string &filename, size_t ringSize) {
+    if (sink) return false;
+
+    FILE *file = fopen(filename.c_str(), "wb");
+    if (not file) return false;
+    fwrite(fileMagic, 1, strlen(fileMagic), file);
+
+    size_t nbWords = 64;
+    while (nbWords * 8 < ringSize) nbWords *= 2;
+    sink = new Sink(nbWords, file);
+    sink->writer = thread(&Sink::run, sink);
+
+    // OUTPUT and ERRPUT now produce Log records
+    sink->logFileBuffer = static_cast<ostream&>(log_file).rdbuf(&sink->logBuffer);
+
+    static bool atExitRegistered = false;
+    if (not atExitRegistered) {
+        atexit(TraceSink::close);
+        atExitRegistered = true;
+    }
+
+    return true;
+}
+
+void TraceSink::close() {
+    if (not sink) return;
+
+    log_file.flush();
+    static_cast<ostream&>(log_file).rdbuf(sink->logFileBuffer);
+
+    {
+        lock_guard<mutex> lock(sink->writerMutex);
+        sink->closing = true;
+    }
+    sink->writerCV.notify_one();
+    sink->writer.join();
+    fclose(sink->file);
+
+    delete sink;
+    sink = NULL;
+}
+
+bool TraceSink::isOpen() {
+    return sink != NULL;
+}
+
+void TraceSink::write(TraceCategory category, Time date, bID blockId,
+                      const char *payload, size_t length) {
+    // Records must fit in half of the ring, longer payloads are truncated
+    if (category != TraceCategory::Log) LogBuffer::flushThread();
+    length = min(length, (sink->ring.capacity() / 2 - headerWords) * 8);
+    const uint64_t nbWords = headerWords + (length + 7) / 8;
+
+    uint64_t index;
+    while (not sink->ring.reserve(nbWords, index)) {
+        sink->writerCV.notify_one();
+        this_thread::yield();
+    }
+
+    sink->ring.fill(index, category, date, blockId, payload, length, nbWords);
+    if (sink->ring.isFilling()) sink->writerCV.notify_one();
+}
+
+bool TraceSink::decode(istream &in, ostream &out) {
+    const size_t magicLength = strlen(fileMagic);
+    string magic(magicLength, '\0');
+    if (not in.read(&magic[0], magicLength) or magic != fileMagic) return false;
+
+    string payload;
+    int c;
+    while ((c = in.get()) != EOF) {
+        const TraceCategory category = (TraceCategory)c;
+        uint64_t date, blockId, length;
+        if (not (readVarint(in, date) and readVarint(in, blockId) and readVarint(in, length)))
+            return false;
+        payload.resize(length);
+        if (not in.read(&payload[0], length)) return false;
+
+        if (category == TraceCategory::Log) {
+            out << payload;
+        } else {
+            // Same format as Scheduler::trace
+            out.precision(6);
+            out << fixed << (double)(date)/1000000 << " #" << blockId << ": " << payload << endl;
+        }
+    }
+
+    return true;
+}
+
+} // BaseSimulator namespace
@@ -0,0 +1,104 @@
+/*! @file traceSink.h
+ * @brief Asynchronous binary sink for the simulation traces and logs (-b command line option).
+ *  Producers append compact binary records to a lock-free ring buffer, which a background
+ *  thread writes to the trace file. The file is turned back into the text of simulation.log
+ *  by TraceSink::decode (see utilities/traceDecoder).
+ * @date 17/10/2026
+ */
+
+#ifndef TRACESINK_H_
+#define TRACESINK_H_
+
+#include <string>
+#include <iostream>
+#include <cstdint>
+
+#include "tDefs.h"
+
+namespace BaseSimulator {
+
+//!< Kinds of trace records, each of which can be filtered out at runtime (-T command line option)
+enum class TraceCategory : uint8_t {
+    Log,                        //!< Text written to OUTPUT / ERRPUT
+    Trace,                      //!< Scheduler::trace messages not belonging to another category
+    Motion,                     //!< Motions of the modules, traced by the motion events
+    Message,                    //!< Messages sent and received, traced by the network
+    Console,                    //!< Output of the block codes console
+    NbCategories
+};
+
+/**
+ * @brief Global sink of the trace records.
+ *
+ *  Record format: category (1 byte), date, blockId and payload length (LEB128 varints),
+ *  payload. The payload of Log records is raw text, the one of the other categories is the
+ *  message given to Scheduler::trace. The file starts with the 8 bytes of fileMagic.
+ *
+ *  The ring buffer accepts concurrent producers: each one reserves the space of its record
+ *  with a compare-and-swap on the head, fills it, then publishes it by writing its first word.
+ *  The writer thread consumes published records in order. Producers only wait when the
+ *  ring is full.
+ */
+class TraceSink {
+    static uint32_t categoriesFilter;   //!< Categories selected with -T
+    static uint32_t enabledCategories;  //!< categoriesFilter, or none if there is no trace output
+public:
+    static constexpr const char *fileMagic = "VSTRACE1";
+    static const size_t defaultRingSize = 4 << 20; //!< Bytes, rounded up to a power of two
+    static const uint32_t allCategories = (1u << (int)TraceCategory::NbCategories) - 1;
+
+    /**
+     * @brief Returns true if records of category c are traced.
+     *  Call sites check it before formatting their message, so that disabled categories
+     *  cost a single test.
+     */
+    static inline bool isEnabled(TraceCategory c) {
+        return enabledCategories & (1u << (int)c);
+    }
+
+    /**
+     * @brief Sets the traced categories
+     * @param mask bitmask of the enabled categories, indexed by TraceCategory
+     * @param hasOutput false if traces are neither displayed nor written anywhere, which disables all categories
+     */
+    static void setCategories(uint32_t mask, bool hasOutput);
+    static uint32_t getCategoriesFilter() { return categoriesFilter; }
+
+    /**
+     * @brief Converts a comma separated list of category names into a mask
+     * @param list names among log, trace, motion, message, console, or one of all, none
+     * @param mask set to the mask of the listed categories if list is valid
+     * @return true if list is valid, false otherwise
+     */
+    static bool parseCategories(const std::string &list, uint32_t &mask);
+
+    /**
+     * @brief Starts the writer thread and redirects OUTPUT / ERRPUT to the sink
+     * @param filename trace file, truncated
+     * @param ringSize size of the ring buffer in bytes
+     * @return true if the file could be opened, false otherwise
+     */
+    static bool open(const std::string &filename, size_t ringSize = defaultRingSize);
+    //!< @brief Writes all pending records and stops the writer thread. Called at exit.
+    static void close();
+    static bool isOpen();
+
+    /**
+     * @brief Appends a record to the ring buffer, waits if it is full. Safe from any thread.
+     *  Log text of the calling thread not sent yet is appended first, so that its records
+     *  keep their order.
+     * @attention the sink must be open
+     */
+    static void write(TraceCategory category, Time date, bID blockId,
+                      const char *payload, size_t length);
+
+    /**
+     * @brief Turns a trace file back into the text the simulator writes to simulation.log
+     * @return false if in is not a trace file or is truncated
+     */
+    static bool decode(std::istream &in, std::ostream &out);
+};
+
+} // BaseSimulator namespace
+
+#endif /* TRACESINK_H_ */
@@ -42,6 +42,10 @@ void TranslationStartEvent::consume() {
     EVENT_CONSUME_INFO();
     Scheduler *scheduler = getScheduler();
     BuildingBlock *bb = concernedBlock;
+    if (bb->motionsStuck) {
+        // The motion never starts, nor ends (see FaultInjector)
+        return;
+    }
     World::getWorld()->disconnectBlock(bb, false);
     bb->setColor(DARKGREY);
 
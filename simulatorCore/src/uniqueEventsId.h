@@ -19,6 +19,10 @@
 #define EVENT_END_SIMULATION      9
 #define BLOCKEVENT_GENERIC       10
 #define EVENT_SAVE_SCREEN                           11
+#define EVENT_NI_DELIVER       12
+#define EVENT_FAULT       13
+#define EVENT_CAMPAIGN_FORK       14
+#define EVENT_WORLD_ACTION       15
 
 #define EVENT_VM_START_COMPUTATION     1001
 #define EVENT_VM_END_COMPUTATION     1002
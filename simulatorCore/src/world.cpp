@@ -15,9 +15,7 @@ using namespace std;
 
 namespace BaseSimulator {
 
-World *World::world = NULL;
-map<bID, BuildingBlock*>World::buildingBlocksMap;
-unordered_map <bID, GlBlock*>World::mapGlBlocks;
+RunLocal<World*> World::world;
 
 World::World(int argc, char *argv[]) {
 #ifdef DEBUG_OBJECT_LIFECYCLE
@@ -136,7 +134,8 @@ void World::linkBlocks() {
 }
 
 void World::linkNeighbors(const Cell3DPosition &pos) {
-    vector<Cell3DPosition> nCells = lattice->getActiveNeighborCells(pos);
+    CellNeighborhood nCells;
+    lattice->getActiveNeighborCells(pos, nCells);
 
     // Check neighbors for each interface
     for (Cell3DPosition nPos : nCells) {
@@ -182,6 +181,9 @@ void World::disconnectBlock(BuildingBlock *block, bool count) {
 }
 
 void World::deleteBlock(BuildingBlock *bb) {
+    if (getScheduler()->deferWorldAction([=]() { deleteBlock(bb); }))
+        return;
+
     if (bb->getState() >= BuildingBlock::ALIVE ) {
         // cut links between bb and others and remove it from the grid
         disconnectBlock(bb);
@@ -39,10 +39,10 @@ public:
     /************************************************************
      *   Global variable
      ************************************************************/
-    static World *world;        //!< Global variable to access the single simulation instance of World
+    static RunLocal<World*> world; //!< Global variable to access the single instance of World of the simulation
     // static vector<GlBlock*>tabGlBlocks; //!< A vector containing pointers to all graphical blocks
-    static unordered_map<bID, GlBlock*>mapGlBlocks; //!< A hash map containing pointers to all graphical blocks, indexed by block id
-    static map<bID, BuildingBlock*>buildingBlocksMap; //!< A map containing all BuildingBlocks in the world, indexed by their blockId
+    unordered_map<bID, GlBlock*>mapGlBlocks; //!< A hash map containing pointers to all graphical blocks, indexed by block id
+    map<bID, BuildingBlock*>buildingBlocksMap; //!< A map containing all BuildingBlocks in the world, indexed by their blockId
 
     /************************************************************
      *   Graphical / UI Attributes
@@ -0,0 +1,78 @@
+/*! @file broadcastBench.cpp
+ * @brief Measures the copies of a broadcast MessageOf (see simulatorCore/src/network.h)
+ *
+ *  Usage: broadcastBench [nbBroadcasts] [payloadSize]
+ *
+ *  A message carrying a vector of payloadSize integers is sent to 12 neighbors, as done by
+ *  BlockCode::sendMessageToAllNeighbors, either by deep copying its payload for each neighbor,
+ *  as MessageOf::clone used to do, or by cloning it. Clones must share the payload of the
+ *  original message, and a clone modifying it through getData() must get its own copy.
+ * @date 17/10/2026
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+
+#include "network.h"
+
+using namespace std;
+using get_time = chrono::steady_clock;
+
+typedef vector<int> Payload;
+
+const int nbNeighbors = 12;
+
+int main(int argc, char **argv) {
+    size_t nbBroadcasts = argc > 1 ? atol(argv[1]) : 200000;
+    size_t payloadSize = argc > 2 ? atol(argv[2]) : 64;
+    Message *copies[nbNeighbors];
+    size_t nbErrors = 0;
+
+    auto start = get_time::now();
+    for (size_t i = 0; i < nbBroadcasts; i++) {
+        MessageOf<Payload> *msg = new MessageOf<Payload>(1, Payload(payloadSize, i));
+        for (int n = 0; n < nbNeighbors; n++) copies[n] = new MessageOf<Payload>(1, *msg->getData());
+        delete msg;
+        for (int n = 0; n < nbNeighbors; n++) delete copies[n];
+    }
+    double nsCopy = chrono::duration_cast<chrono::nanoseconds>(get_time::now() - start).count();
+
+    start = get_time::now();
+    for (size_t i = 0; i < nbBroadcasts; i++) {
+        MessageOf<Payload> *msg = new MessageOf<Payload>(1, Payload(payloadSize, i));
+        for (int n = 0; n < nbNeighbors; n++) copies[n] = msg->clone();
+        for (int n = 0; n < nbNeighbors; n++) {
+            if (static_cast<MessageOf<Payload>*>(copies[n])->getConstData() != msg->getConstData())
+                nbErrors++;
+        }
+        delete msg;
+        for (int n = 0; n < nbNeighbors; n++) delete copies[n];
+    }
+    double nsShared = chrono::duration_cast<chrono::nanoseconds>(get_time::now() - start).count();
+
+    // Copy-on-write: only the modified clone sees the change
+    MessageOf<Payload> original(1, Payload(payloadSize, 1));
+    unique_ptr<Message> modified(original.clone()), unmodified(original.clone());
+    static_cast<MessageOf<Payload>*>(modified.get())->getData()->at(0) = 2;
+    if (static_cast<MessageOf<Payload>*>(modified.get())->getConstData()->at(0) != 2
+        or static_cast<MessageOf<Payload>*>(unmodified.get())->getConstData()->at(0) != 1
+        or original.getConstData()->at(0) != 1
+        or static_cast<MessageOf<Payload>*>(unmodified.get())->getConstData() != original.getConstData()) {
+        cout << "COPY-ON-WRITE FAILED" << endl;
+        nbErrors++;
+    }
+
+    cout << nbBroadcasts << " broadcasts to " << nbNeighbors << " neighbors, payload of "
+         << payloadSize << " integers" << endl;
+    cout << "  " << setw(10) << left << "copy" << setw(10) << right << fixed << setprecision(1)
+         << nsCopy / nbBroadcasts << " ns/broadcast" << endl;
+    cout << "  " << setw(10) << left << "shared" << setw(10) << right << fixed << setprecision(1)
+         << nsShared / nbBroadcasts << " ns/broadcast" << endl;
+    cout << (nbErrors ? "PAYLOAD NOT SHARED by " + to_string(nbErrors) + " clones" : "OK") << endl;
+
+    return nbErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+/*! @file eventQueueBench.cpp
+ * @brief Compares the scheduler event queue backends (see simulatorCore/src/eventQueue.h)
+ *
+ *  Usage: eventQueueBench [trace files...]
+ *
+ *  Each trace is replayed against every backend. Traces are recorded by running any
+ *  simulation with a simulator compiled with -DEVENT_QUEUE_TRACE (see top Makefile), which
+ *  writes eventQueue.trace in the working directory. Without argument, a synthetic hold
+ *  model workload is used instead.
+ *  The order in which events are dequeued is checked against the legacy multimap backend.
+ * @date 17/10/2026
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+
+#include "eventQueue.h"
+
+using namespace std;
+using namespace BaseSimulator;
+using get_time = chrono::steady_clock;
+
+//!< Event that does nothing, only its date and id matter here
+class BenchEvent : public Event {
+public:
+    BenchEvent(Time t) : Event(t) {};
+    void consume() override {};
+};
+
+//!< A queue operation from a trace: push of an event at date, or pop if !isPush
+struct QueueOp {
+    bool isPush;
+    Time date;
+};
+
+static const vector<EventQueueType> backends = {
+    EventQueueType::Multimap, EventQueueType::BinaryHeap,
+    EventQueueType::QuaternaryHeap, EventQueueType::Calendar
+};
+
+static bool readTrace(const string &path, vector<QueueOp> &ops) {
+    ifstream in(path);
+    if (!in.is_open()) return false;
+
+    string op;
+    while (in >> op) {
+        if (op == "+") {
+            Time date;
+            in >> date;
+            ops.push_back({true, date});
+        } else if (op == "-") {
+            ops.push_back({false, 0});
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Replays a trace on a queue of the given type
+ * @param checksum order-dependent hash of the ids of the popped events
+ * @return elapsed time in ns
+ */
+static double replay(EventQueueType type, const vector<QueueOp> &ops, uint64_t &checksum) {
+    // Events are created beforehand, so that only the queue operations are measured
+    vector<EventPtr> events;
+    for (const QueueOp &op : ops)
+        if (op.isPush) events.push_back(EventPtr(new BenchEvent(op.date)));
+
+    EventQueue *queue = EventQueue::create(type);
+    size_t next = 0;
+    int firstId = events.empty() ? 0 : events.front()->id;
+    checksum = 0;
+
+    auto start = get_time::now();
+    for (const QueueOp &op : ops) {
+        if (op.isPush) {
+            queue->push(events[next++]);
+        } else {
+            checksum = checksum * 31 + (queue->top()->id - firstId);
+            queue->pop();
+        }
+    }
+    auto end = get_time::now();
+
+    delete queue;
+    return chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+}
+
+/**
+ * @brief Classic hold model: the queue is filled with size events, then each operation
+ *  pops the earliest event and reschedules it at an exponentially distributed date in its future.
+ *  Dates are quantized to 1000us, so that many events share the same date as in VisibleSim.
+ * @return elapsed time in ns for nbHolds hold operations
+ */
+static double hold(EventQueueType type, size_t size, size_t nbHolds, uint64_t &checksum) {
+    mt19937 rng(42);
+    exponential_distribution<double> increment(1.0 / 20000);
+
+    EventQueue *queue = EventQueue::create(type);
+    int firstId = Event::getNextId();
+    for (size_t i = 0; i < size; i++)
+        queue->push(EventPtr(new BenchEvent((Time)increment(rng) / 1000 * 1000)));
+
+    checksum = 0;
+    auto start = get_time::now();
+    for (size_t i = 0; i < nbHolds; i++) {
+        EventPtr ev = queue->top();
+        queue->pop();
+        checksum = checksum * 31 + (ev->id - firstId);
+        ev->date += (Time)increment(rng) / 1000 * 1000;
+        queue->push(std::move(ev));
+    }
+    auto end = get_time::now();
+
+    delete queue;
+    return chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+}
+
+static void printResult(EventQueueType type, double ns, size_t nbOps,
+                        uint64_t checksum, uint64_t reference) {
+    EventQueue *queue = EventQueue::create(type);
+    cout << "  " << setw(10) << left << queue->getName()
+         << setw(10) << right << fixed << setprecision(1) << ns / nbOps << " ns/op"
+         << (checksum == reference ? "" : "   ORDER MISMATCH") << endl;
+    delete queue;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            vector<QueueOp> ops;
+            if (!readTrace(argv[i], ops)) {
+                cerr << "error: cannot read trace " << argv[i] << endl;
+                return EXIT_FAILURE;
+            }
+
+            cout << argv[i] << " (" << ops.size() << " operations)" << endl;
+            uint64_t reference = 0;
+            for (EventQueueType type : backends) {
+                uint64_t checksum;
+                double ns = replay(type, ops, checksum);
+                if (type == EventQueueType::Multimap) reference = checksum;
+                printResult(type, ns, ops.size(), checksum, reference);
+            }
+        }
+    } else {
+        const size_t nbHolds = 1000000;
+        for (size_t size : { 100, 10000, 500000 }) {
+            cout << "hold model, " << size << " pending events" << endl;
+            uint64_t reference = 0;
+            for (EventQueueType type : backends) {
+                uint64_t checksum;
+                double ns = hold(type, size, nbHolds, checksum);
+                if (type == EventQueueType::Multimap) reference = checksum;
+                printResult(type, ns, nbHolds, checksum, reference);
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+/*! @file latticeBench.cpp
+ * @brief Measures the neighborhood queries of the lattice (see simulatorCore/src/lattice.h)
+ *
+ *  Usage: latticeBench [gridSize [fillRatio]]
+ *
+ *  Replays the inner loop of Catoms3DMotionEngine::getAllRotationsForModule on a SkewFCC
+ *  lattice randomly filled with modules: for each module and each free cell around it, the
+ *  modules adjacent to both cells are searched as candidate pivots. The vector-based API is
+ *  compared to the allocation-free one (CellNeighborhood), for both lattice storage backends.
+ *  Heap allocations are counted by replacing the global operator new.
+ * @date 17/10/2026
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <new>
+#include <cstdlib>
+
+#include "lattice.h"
+#include "utils.h"
+
+using namespace std;
+using namespace BaseSimulator;
+using get_time = chrono::steady_clock;
+
+static size_t nbAllocations = 0;
+
+void* operator new(size_t size) {
+    nbAllocations++;
+    void *p = malloc(size);
+    if (!p) throw bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+/**
+ * @brief Candidate pivots search as done before CellNeighborhood was introduced
+ * @return number of candidate pivots found
+ */
+static size_t vectorQuery(const Lattice *lattice, const Cell3DPosition &m) {
+    size_t nbPivots = 0;
+    for (const Cell3DPosition &tPos : lattice->getFreeNeighborCells(m)) {
+        vector<Cell3DPosition> mActiveCells = lattice->getActiveNeighborCells(m);
+        vector<Cell3DPosition> tPosActiveCells = lattice->getActiveNeighborCells(tPos);
+        nbPivots += utils::intersection(mActiveCells, tPosActiveCells).size();
+    }
+
+    return nbPivots;
+}
+
+//!< @brief Same search, through the allocation-free API used by the motion engine
+static size_t inlineQuery(const Lattice *lattice, const Cell3DPosition &m) {
+    size_t nbPivots = 0;
+    CellNeighborhood freeCells, adjacentCells;
+    lattice->getFreeNeighborCells(m, freeCells);
+    for (const Cell3DPosition &tPos : freeCells) {
+        lattice->getActiveNeighborCells(m, adjacentCells);
+        std::sort(adjacentCells.begin(), adjacentCells.end());
+        for (const Cell3DPosition &pPos : adjacentCells) {
+            if (lattice->cellsAreAdjacent(tPos, pPos)) nbPivots++;
+        }
+    }
+
+    return nbPivots;
+}
+
+static void run(const string &name, size_t (*query)(const Lattice*, const Cell3DPosition&),
+                const Lattice *lattice, const vector<Cell3DPosition> &modules) {
+    size_t nbPivots = 0;
+    size_t allocationsBefore = nbAllocations;
+    auto start = get_time::now();
+    for (const Cell3DPosition &m : modules) nbPivots += query(lattice, m);
+    auto end = get_time::now();
+    size_t allocations = nbAllocations - allocationsBefore;
+
+    double ns = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+    cout << "  " << setw(10) << left << name
+         << setw(10) << right << fixed << setprecision(1) << ns / modules.size() << " ns/module"
+         << setw(10) << right << setprecision(2) << (double)allocations / modules.size()
+         << " alloc/module   (" << nbPivots << " pivots)" << endl;
+}
+
+int main(int argc, char **argv) {
+    int size = argc > 1 ? atoi(argv[1]) : 64;
+    double fillRatio = argc > 2 ? atof(argv[2]) : 0.3;
+    // The lattice only stores block pointers and never dereferences them
+    static char marker;
+    BuildingBlock *dummy = reinterpret_cast<BuildingBlock*>(&marker);
+
+    for (LatticeStorageType type : { LatticeStorageType::Dense, LatticeStorageType::Sparse }) {
+        Lattice::storageType = type;
+        SkewFCCLattice lattice(Cell3DPosition(size, size, size), Vector3D(1, 1, 1));
+
+        mt19937 rng(42);
+        uniform_real_distribution<double> uniform(0, 1);
+        vector<Cell3DPosition> modules;
+        for (int z = 0; z < size; z++) {
+            const Cell3DPosition lb = lattice.getGridLowerBounds(z),
+                ub = lattice.getGridUpperBounds(z);
+            for (int y = lb[1]; y <= ub[1]; y++) {
+                for (int x = lb[0]; x <= ub[0]; x++) {
+                    if (uniform(rng) < fillRatio) {
+                        Cell3DPosition p(x, y, z);
+                        lattice.insert(dummy, p);
+                        modules.push_back(p);
+                    }
+                }
+            }
+        }
+
+        cout << size << "^3 SkewFCC lattice, " << lattice.grid->getName() << " storage ("
+             << lattice.grid->getMemoryUsage() / 1024 << " KB), "
+             << modules.size() << " modules" << endl;
+        run("vector", vectorQuery, &lattice, modules);
+        run("inline", inlineQuery, &lattice, modules);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,181 @@
+/*! @file latticeTest.cpp
+ * @brief Checks the lattice storage backends and neighborhood queries (see simulatorCore/src/lattice.h
+ *  and simulatorCore/src/latticeStorage.h)
+ *
+ *  Usage: latticeTest
+ *
+ *  Modules are randomly inserted into and removed from FCC, SkewFCC and SC lattices, with dense
+ *  and sparse storage, and compared to a map of the occupied cells: the block of every cell of
+ *  the grid, and the active, free and whole neighborhoods of cells, through the vector and the
+ *  allocation-free (CellNeighborhood) APIs. Locked cells of FCC lattices are compared to a set
+ *  of the locked cells. Sparse storage must release its bricks once the lattice is empty.
+ *  Exits with a failure status if a check fails.
+ * @date 18/10/2026
+ */
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <cstdlib>
+
+#include "lattice.h"
+
+using namespace std;
+using namespace BaseSimulator;
+
+static int nbFailures = 0;
+
+#define CHECK(cond) do { \
+        if (not (cond)) { \
+            cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #cond << endl; \
+            nbFailures++; \
+        } \
+    } while (0)
+
+// The lattice only stores block pointers and never dereferences them
+static char markers[4096];
+static BuildingBlock* getDummy(size_t i) { return reinterpret_cast<BuildingBlock*>(&markers[i % sizeof(markers)]); }
+
+//!< Cells of the grid of a lattice
+static vector<Cell3DPosition> getCells(const Lattice &lattice) {
+    vector<Cell3DPosition> cells;
+    for (int z = 0; z < lattice.gridSize[2]; z++) {
+        const Cell3DPosition lb = lattice.getGridLowerBounds(z), ub = lattice.getGridUpperBounds(z);
+        for (int y = lb[1]; y <= ub[1]; y++)
+            for (int x = lb[0]; x <= ub[0]; x++) {
+                Cell3DPosition p(x, y, z);
+                if (lattice.isInGrid(p)) cells.push_back(p);
+            }
+    }
+    return cells;
+}
+
+static bool sameCells(const vector<Cell3DPosition> &v, const CellNeighborhood &n) {
+    return v.size() == n.size() and equal(v.begin(), v.end(), n.begin());
+}
+
+static void checkNeighborhood(const Lattice &lattice, const map<Cell3DPosition, BuildingBlock*> &blocks,
+                              const Cell3DPosition &p) {
+    vector<Cell3DPosition> active, free, all;
+    for (const Cell3DPosition &r : lattice.getRelativeConnectivity(p)) {
+        const Cell3DPosition n = p + r;
+        if (not lattice.isInGrid(n)) continue;
+        all.push_back(n);
+        if (blocks.count(n)) active.push_back(n);
+        else free.push_back(n);
+    }
+
+    CHECK(lattice.getActiveNeighborCells(p) == active);
+    CHECK(lattice.getFreeNeighborCells(p) == free);
+    CHECK(lattice.getNeighborhood(p) == all);
+
+    CellNeighborhood n;
+    lattice.getActiveNeighborCells(p, n);
+    CHECK(sameCells(active, n));
+    lattice.getFreeNeighborCells(p, n);
+    CHECK(sameCells(free, n));
+    lattice.getNeighborhood(p, n);
+    CHECK(sameCells(all, n));
+}
+
+static void checkLattice(Lattice &lattice, const string &name) {
+    const vector<Cell3DPosition> cells = getCells(lattice);
+    const size_t emptyMemory = lattice.grid->getMemoryUsage();
+    map<Cell3DPosition, BuildingBlock*> blocks;
+    mt19937 rng(42);
+
+    // Fills the grid up to about a half, then empties it
+    for (int phase = 0; phase < 2; phase++) {
+        for (size_t i = 0; i < cells.size(); i++) {
+            const Cell3DPosition &p = cells[rng() % cells.size()];
+            const bool filling = phase == 0 ? rng() % 3 != 0 : rng() % 3 == 0;
+            if (filling and not blocks.count(p)) {
+                BuildingBlock *bb = getDummy(i);
+                lattice.insert(bb, p);
+                blocks[p] = bb;
+            } else if (not filling and blocks.count(p)) {
+                lattice.remove(p);
+                blocks.erase(p);
+            }
+        }
+
+        size_t nbMismatches = 0;
+        for (const Cell3DPosition &p : cells) {
+            auto it = blocks.find(p);
+            BuildingBlock *expected = it == blocks.end() ? NULL : it->second;
+            if (lattice.getBlock(p) != expected or lattice.cellHasBlock(p) != (expected != NULL)
+                or lattice.isFree(p) != (expected == NULL))
+                nbMismatches++;
+        }
+        CHECK(nbMismatches == 0);
+        CHECK(lattice.getBlock(Cell3DPosition(-1, 0, 0)) == NULL);
+        CHECK(lattice.getBlock(lattice.gridSize) == NULL);
+
+        for (size_t i = 0; i < 500; i++) checkNeighborhood(lattice, blocks, cells[rng() % cells.size()]);
+    }
+
+    for (auto &b : blocks) lattice.remove(b.first);
+    for (const Cell3DPosition &p : cells) CHECK(lattice.getBlock(p) == NULL);
+    if (lattice.grid->getName() == "sparse") CHECK(lattice.grid->getMemoryUsage() == emptyMemory);
+
+    if (nbFailures) cerr << "  in " << name << " lattice, " << lattice.grid->getName() << " storage" << endl;
+}
+
+static void checkLockedCells(FCCLattice &lattice) {
+    const vector<Cell3DPosition> cells = getCells(lattice);
+    set<Cell3DPosition> locked;
+    mt19937 rng(7);
+
+    const Cell3DPosition occupied = cells[cells.size() / 2];
+    lattice.insert(getDummy(0), occupied);
+    CHECK(not lattice.lockCell(occupied));
+
+    for (size_t i = 0; i < 4 * cells.size(); i++) {
+        const Cell3DPosition &p = cells[rng() % cells.size()];
+        if (p == occupied) continue;
+        if (rng() % 2) {
+            CHECK(lattice.lockCell(p) == (locked.count(p) == 0));
+            locked.insert(p);
+        } else {
+            CHECK(lattice.unlockCell(p) == (locked.count(p) != 0));
+            locked.erase(p);
+        }
+    }
+    // Cells out of the grid are never locked
+    CHECK(lattice.lockCell(Cell3DPosition(-1, 0, 0)));
+    CHECK(lattice.unlockCell(Cell3DPosition(-1, 0, 0)));
+    lattice.remove(occupied);
+}
+
+int main() {
+    const Cell3DPosition size(20, 20, 20);
+    const Vector3D scale(1, 1, 1);
+
+    for (LatticeStorageType type : { LatticeStorageType::Dense, LatticeStorageType::Sparse }) {
+        Lattice::storageType = type;
+        {
+            FCCLattice lattice(size, scale);
+            checkLattice(lattice, "FCC");
+            checkLockedCells(lattice);
+        }
+        {
+            SkewFCCLattice lattice(size, scale);
+            checkLattice(lattice, "SkewFCC");
+            checkLockedCells(lattice);
+        }
+        {
+            SCLattice lattice(size, scale);
+            checkLattice(lattice, "SC");
+        }
+    }
+
+    if (nbFailures) {
+        cerr << nbFailures << " failed check(s)" << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "Lattice: OK" << endl;
+    return EXIT_SUCCESS;
+}
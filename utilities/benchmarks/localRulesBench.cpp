@@ -0,0 +1,105 @@
+/*! @file localRulesBench.cpp
+ * @brief Checks and measures the local motion rules table of the scaffolding application
+ *  (see applicationsSrc/scaffolding_pyramid_async/localRulesTable.hpp)
+ *
+ *  Usage: localRulesBench
+ *
+ *  The rules of a B variant (b6 by default, LOCAL_RULES_DIR in the Makefile) are inserted into
+ *  a std::map ordered as the former LRKeyTuple::operator<, which is how they used to be
+ *  stored. Every local neighborhood is then looked up for each target position and step
+ *  appearing in the rules, for their adjacent target positions, and for out of range keys.
+ *  Both containers must return the same rule for every key.
+ * @date 17/10/2026
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <map>
+#include <set>
+#include <vector>
+#include <cstdlib>
+
+#include "utils.h" // declares the BaseSimulator namespace used by the rules header
+#include "meshAssemblyLocalRules.hpp"
+
+using namespace std;
+using get_time = chrono::steady_clock;
+
+//!< Key of the former std::map
+struct ReferenceKey {
+    unsigned long ln;
+    Cell3DPosition tPos;
+    short step;
+
+    bool operator<(const ReferenceKey &k) const {
+        if (ln != k.ln) return ln < k.ln;
+        if (step != k.step) return step < k.step;
+        return tPos < k.tPos;
+    }
+};
+
+int main(int argc, char **argv) {
+    map<ReferenceKey, Cell3DPosition> reference;
+    set<pair<Cell3DPosition, short>> targets;
+    for (const LocalMotionRule &rule : localMotionRuleList) {
+        const Cell3DPosition &tPos = rule.key.getTargetPosition();
+        const short step = rule.key.getStep();
+        // std::map keeps the first of duplicate keys, as did its initializer list
+        reference.insert({ { rule.key.getNeighborhood(), tPos, step }, rule.nextPos });
+
+        for (int d = 0; d < 3; d++) {
+            for (short delta : { -1, 0, 1 }) {
+                Cell3DPosition adj = tPos;
+                adj.pt[d] += delta;
+                targets.insert({ adj, step });
+            }
+        }
+        targets.insert({ tPos, (short)(step + 1) });
+    }
+    // Keys which cannot be packed
+    targets.insert({ Cell3DPosition(40, 0, 0), 1 });
+    targets.insert({ Cell3DPosition(0, -17, 0), 1 });
+    targets.insert({ Cell3DPosition(0, 0, 0), 16 });
+
+    vector<ReferenceKey> queries;
+    for (const auto &target : targets) {
+        for (unsigned long ln = 0; ln < 4096; ln++)
+            queries.push_back({ ln, target.first, target.second });
+    }
+
+    size_t nbMatches = 0, nbMismatches = 0;
+    vector<const Cell3DPosition*> referenceResults(queries.size());
+    auto start = get_time::now();
+    for (size_t i = 0; i < queries.size(); i++) {
+        auto match = reference.find(queries[i]);
+        referenceResults[i] = match != reference.end() ? &match->second : NULL;
+    }
+    double nsMap = chrono::duration_cast<chrono::nanoseconds>(get_time::now() - start).count();
+
+    vector<const LocalMotionRule*> tableResults(queries.size());
+    start = get_time::now();
+    for (size_t i = 0; i < queries.size(); i++) {
+        tableResults[i] = localMotionRules.find(LRKeyTuple(bitset<12>(queries[i].ln),
+                                                           queries[i].tPos, queries[i].step));
+    }
+    double nsTable = chrono::duration_cast<chrono::nanoseconds>(get_time::now() - start).count();
+
+    for (size_t i = 0; i < queries.size(); i++) {
+        if (referenceResults[i]) nbMatches++;
+        if ((referenceResults[i] == NULL) != (tableResults[i] == NULL)
+            or (referenceResults[i] and not (*referenceResults[i] == tableResults[i]->nextPos)))
+            nbMismatches++;
+    }
+
+    cout << sizeof(localMotionRuleList) / sizeof(LocalMotionRule) << " rules ("
+         << reference.size() << " distinct keys), " << queries.size() << " lookups, "
+         << nbMatches << " matching" << endl;
+    cout << "  " << setw(10) << left << "map" << setw(10) << right << fixed << setprecision(1)
+         << nsMap / queries.size() << " ns/lookup" << endl;
+    cout << "  " << setw(10) << left << "table" << setw(10) << right << fixed << setprecision(1)
+         << nsTable / queries.size() << " ns/lookup" << endl;
+    cout << (nbMismatches ? "MISMATCH on " + to_string(nbMismatches) + " lookups" : "OK") << endl;
+
+    return nbMismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+/*! @file meldArenaBench.cpp
+ * @brief Compares malloc with the tuple arenas of the Meld interpreter VM
+ *  (see simulatorCore/src/meldInterpretArena.h)
+ *
+ *  Usage: meldArenaBench
+ *
+ *  Each VM of a world derives and retracts small tuples, each one held by a queue entry, in a
+ *  random order. The live set of each VM stays small, as in Meld programs, where tuples churn.
+ *  The contents of the blocks are checked when they are released. The time to tear the world
+ *  down is measured too: each block is freed with malloc, arenas are released at once.
+ * @date 18/10/2026
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
+
+#include "meldInterpretArena.h"
+
+using namespace std;
+using namespace MeldInterpret;
+using get_time = chrono::steady_clock;
+
+static const size_t entrySize = 32;     //!< sizeof(tuple_entry) on 64 bits platforms
+static const size_t maxLiveTuples = 64; //!< Per VM
+
+//!< A tuple and the queue entry holding it
+struct Live {
+    void *tuple;
+    void *entry;
+    size_t size;
+};
+
+//!< Allocates and releases blocks from malloc
+struct MallocVM {
+    vector<Live> live;
+
+    void* allocate(size_t size) { return malloc(size); }
+    void deallocate(void *p, size_t) { free(p); }
+    void teardown() {
+        for (Live &l : live) { free(l.tuple); free(l.entry); }
+        live.clear();
+    }
+};
+
+//!< Allocates and releases blocks from its arena
+struct ArenaVM {
+    vector<Live> live;
+    TupleArena arena;
+
+    void* allocate(size_t size) { return arena.allocate(size); }
+    void deallocate(void *p, size_t size) { arena.deallocate(p, size); }
+    void teardown() { live.clear(); arena.release(); }
+};
+
+/**
+ * @brief Runs nbOps derivations or retractions on random VMs of a world of nbVMs
+ * @param errors incremented for each block whose content was overwritten
+ * @return elapsed time in ns of the operations, and of the teardown in teardownNs
+ */
+template<typename VM>
+static double churn(size_t nbVMs, size_t nbOps, double &teardownNs, size_t &errors) {
+    mt19937 rng(42);
+    uniform_int_distribution<size_t> pickVM(0, nbVMs - 1);
+    uniform_int_distribution<size_t> pickSize(9, 17);   // Tuples fit in MELD_MESSAGE_DEFAULT_SIZE
+    vector<unique_ptr<VM>> vms;
+    for (size_t i = 0; i < nbVMs; i++) vms.emplace_back(new VM());
+
+    auto start = get_time::now();
+    for (size_t i = 0; i < nbOps; i++) {
+        VM &vm = *vms[pickVM(rng)];
+        const bool derive = vm.live.empty() or (vm.live.size() < maxLiveTuples and rng() % 2);
+        if (derive) {
+            Live l;
+            l.size = pickSize(rng);
+            l.tuple = vm.allocate(l.size);
+            l.entry = vm.allocate(entrySize);
+            memset(l.tuple, (int)(l.size), l.size);
+            vm.live.push_back(l);
+        } else {
+            const size_t k = rng() % vm.live.size();
+            Live l = vm.live[k];
+            vm.live[k] = vm.live.back();
+            vm.live.pop_back();
+            for (size_t b = 0; b < l.size; b++)
+                if (((unsigned char*)l.tuple)[b] != l.size) { errors++; break; }
+            vm.deallocate(l.entry, entrySize);
+            vm.deallocate(l.tuple, l.size);
+        }
+    }
+    auto end = get_time::now();
+
+    for (auto &vm : vms) {
+        for (Live &l : vm->live)
+            for (size_t b = 0; b < l.size; b++)
+                if (((unsigned char*)l.tuple)[b] != l.size) { errors++; break; }
+    }
+
+    auto teardownStart = get_time::now();
+    for (auto &vm : vms) vm->teardown();
+    teardownNs = chrono::duration_cast<chrono::nanoseconds>(get_time::now() - teardownStart).count();
+
+    return chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+}
+
+int main() {
+    const size_t nbOps = 10000000;
+
+    for (size_t nbVMs : { 100, 10000 }) {
+        cout << nbVMs << " VMs, " << nbOps << " derivations or retractions" << endl;
+        double teardownNs;
+        size_t errors = 0;
+
+        double ns = churn<MallocVM>(nbVMs, nbOps, teardownNs, errors);
+        cout << "  " << setw(8) << left << "malloc" << right << fixed << setprecision(1)
+             << setw(8) << ns / nbOps << " ns/op, teardown " << setw(8) << teardownNs / 1e6 << " ms" << endl;
+
+        ns = churn<ArenaVM>(nbVMs, nbOps, teardownNs, errors);
+        cout << "  " << setw(8) << left << "arena" << right << fixed << setprecision(1)
+             << setw(8) << ns / nbOps << " ns/op, teardown " << setw(8) << teardownNs / 1e6 << " ms" << endl;
+
+        if (errors) {
+            cerr << "error: " << errors << " corrupted blocks" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
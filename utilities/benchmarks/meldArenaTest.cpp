@@ -0,0 +1,176 @@
+/*! @file meldArenaTest.cpp
+ * @brief Checks the tuple arena of the Meld interpreter VM (see simulatorCore/src/meldInterpretArena.h)
+ *
+ *  Usage: meldArenaTest
+ *
+ *  Checks the alignment, the contents and the recycling of the pooled blocks of every size
+ *  class, the statistics of the arena, and that large blocks are freed when they are returned,
+ *  when the arena is released and when it is destroyed. Exits with a failure status if a check
+ *  fails.
+ * @date 18/10/2026
+ */
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+
+#include "meldInterpretArena.h"
+
+using namespace std;
+using namespace MeldInterpret;
+
+static int nbFailures = 0;
+
+#define CHECK(cond) do { \
+        if (not (cond)) { \
+            cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #cond << endl; \
+            nbFailures++; \
+        } \
+    } while (0)
+
+//!< @brief Fills a block with a pattern derived from its address
+static void fill(void *p, size_t size) {
+    memset(p, (int)((uintptr_t)p >> 3 & 0xFF), size);
+}
+
+static bool isFilled(const void *p, size_t size) {
+    const unsigned char *c = static_cast<const unsigned char*>(p);
+    for (size_t i = 0; i < size; i++)
+        if (c[i] != ((uintptr_t)p >> 3 & 0xFF)) return false;
+    return true;
+}
+
+// Blocks allocated with malloc and not freed yet, while counting. malloc and free are replaced
+// by wrappers of the functions of the C library, as the allocation statistics of glibc count
+// the blocks kept in its thread caches as allocated.
+#ifdef __GLIBC__
+static bool counting = false;
+static long nbMallocBlocks = 0;
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void __libc_free(void *p);
+
+void* malloc(size_t size) {
+    void *p = __libc_malloc(size);
+    if (counting and p) nbMallocBlocks++;
+    return p;
+}
+
+void free(void *p) {
+    if (counting and p) nbMallocBlocks--;
+    __libc_free(p);
+}
+}
+#endif
+
+static void checkPooledBlocks() {
+    TupleArena arena;
+    vector<pair<void*,size_t>> blocks;
+
+    for (int round = 0; round < 3; round++) {
+        for (size_t size = 1; size <= TupleArena::maxPooledSize; size++) {
+            void *p = arena.allocate(size);
+            CHECK(p != NULL);
+            CHECK((uintptr_t)p % TupleArena::granularity == 0);
+            fill(p, size);
+            blocks.push_back(make_pair(p, size));
+        }
+    }
+
+    // Blocks do not overlap
+    for (auto &b : blocks) CHECK(isFilled(b.first, b.second));
+
+    const TupleArena::Stats &s = arena.getStats();
+    CHECK(s.nbAllocations == blocks.size());
+    CHECK(s.nbLargeAllocations == 0);
+    CHECK(s.liveBytes == s.peakLiveBytes);
+    CHECK(s.liveBytes <= s.reservedBytes);
+
+    // The last returned block of a size class is the next one allocated
+    void *p = blocks.back().first;
+    const size_t size = blocks.back().second;
+    arena.deallocate(p, size);
+    CHECK(arena.allocate(size) == p);
+
+    for (auto &b : blocks) arena.deallocate(b.first, b.second);
+    CHECK(s.nbDeallocations == s.nbAllocations);
+    CHECK(s.liveBytes == 0);
+    CHECK(s.peakLiveBytes > 0);
+
+    arena.release();
+    CHECK(s.nbSlabs == 0);
+    CHECK(s.reservedBytes == 0);
+
+    // The arena is usable again once released
+    p = arena.allocate(24);
+    fill(p, 24);
+    CHECK(isFilled(p, 24));
+    CHECK(s.nbSlabs == 1);
+}
+
+static void checkLargeBlocks() {
+    TupleArena arena;
+    const TupleArena::Stats &s = arena.getStats();
+    const size_t sizes[] = { TupleArena::maxPooledSize + 1, 1000, 4096, 100000 };
+
+    vector<void*> blocks;
+    for (size_t size : sizes) {
+        void *p = arena.allocate(size);
+        CHECK(p != NULL);
+        CHECK((uintptr_t)p % 16 == 0);
+        fill(p, size);
+        blocks.push_back(p);
+    }
+    for (size_t i = 0; i < blocks.size(); i++) CHECK(isFilled(blocks[i], sizes[i]));
+    CHECK(s.nbLargeAllocations == 4);
+    CHECK(s.nbLargeBlocks == 4);
+    CHECK(s.nbSlabs == 0);
+
+    // Returned in an order that unlinks the middle, the head and the tail of the list
+    arena.deallocate(blocks[1], sizes[1]);
+    arena.deallocate(blocks[3], sizes[3]);
+    arena.deallocate(blocks[0], sizes[0]);
+    CHECK(s.nbLargeBlocks == 1);
+    CHECK(isFilled(blocks[2], sizes[2]));
+
+    arena.release();
+    CHECK(s.nbLargeBlocks == 0);
+    CHECK(s.nbLargeAllocations == 4);
+}
+
+static void checkNoLeak() {
+#ifdef __GLIBC__
+    counting = true;
+    {
+        TupleArena arena;
+        for (int i = 0; i < 100; i++) {
+            arena.allocate(TupleArena::maxPooledSize + 1 + i);
+            arena.allocate(8 + i % 200);
+        }
+        CHECK(nbMallocBlocks > 100);
+        arena.release();
+        for (int i = 0; i < 100; i++) arena.allocate(TupleArena::maxPooledSize + 1 + i);
+        // Destroyed with large blocks still allocated
+    }
+    counting = false;
+    CHECK(nbMallocBlocks == 0);
+#else
+    cout << "malloc cannot be counted, leak check skipped" << endl;
+#endif
+}
+
+int main() {
+    checkPooledBlocks();
+    checkLargeBlocks();
+    checkNoLeak();
+
+    if (nbFailures) {
+        cerr << nbFailures << " failed check(s)" << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "TupleArena: OK" << endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,231 @@
+/*! @file meldDispatchBench.cpp
+ * @brief Checks and measures the execution of the Meld interpreter VM from the threaded form of
+ *  its program, against the switch over the byte code (see MeldInterpretVM::process_bytecode)
+ *
+ *  Usage: meldDispatchBench [nbTuples [configuration]]
+ *
+ *  A Meld program is loaded with MeldInterpretVM::readProgram: a single predicate, with an input
+ *  and an output int field, whose byte code computes the output from the input with moves
+ *  between registers and fields, int and float operations, comparisons and conditionals. A VM
+ *  is created on a module of a configuration (default: the final 4x4 pyramid of the b6
+ *  scaffolding application, as exported for its regression tests), and processes nbTuples
+ *  tuples of the predicate with each dispatch, as it processes a derived tuple. The outputs are
+ *  compared to each other and to the same computation in C++, the program exits with a failure
+ *  status if they differ.
+ *
+ *  Meld byte code only jumps forward, so that each tuple executes a few tens of instructions.
+ *  The times include the entry into process_bytecode.
+ * @date 18/10/2026
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+
+#include "meldInterpretVM.h"
+#include "catoms3DSimulator.h"
+#include "catoms3DBlockCode.h"
+#include "catoms3DWorld.h"
+
+using namespace std;
+using namespace Catoms3D;
+using MeldInterpret::MeldInterpretVM;
+using get_time = chrono::steady_clock;
+
+// Names used by the macros of meldInterpretVM.h reading the program
+static const unsigned char *&meld_prog = MeldInterpretVM::meld_prog;
+static unsigned char *&arguments = MeldInterpretVM::arguments;
+
+//!< Modules of the configuration do not run any code
+class IdleBlockCode : public Catoms3DBlockCode {
+public:
+    IdleBlockCode(Catoms3DBlock *host) : Catoms3DBlockCode(host) {}
+    void startup() override {}
+    static BlockCode *buildNewBlockCode(BuildingBlock *host) { return new IdleBlockCode((Catoms3DBlock*)host); }
+};
+
+//!< Loads a configuration without starting the simulation
+class ConfigurationLoader : public Catoms3DSimulator {
+public:
+    ConfigurationLoader(int argc, char *argv[]) : Catoms3DSimulator(argc, argv, IdleBlockCode::buildNewBlockCode) {
+        parseConfiguration(argc, argv);
+    }
+};
+
+static const int nbRounds = 4;  //!< Repetitions of the computation in the byte code
+static const int32_t factor = 7, increment = 3, divisor = 5, wrap = 1000;
+static const int32_t maxInput = 100000;
+
+//!< Byte code writer, operands are stored unaligned as in Meld programs
+struct Program {
+    vector<unsigned char> code;
+    int nbInstructions = 0;
+
+    void op(unsigned char o) { code.push_back(o); nbInstructions++; }
+    void bytes(const void *p, size_t n) { code.insert(code.end(), (const unsigned char*)p, (const unsigned char*)p + n); }
+    void mvIntReg(int32_t v, unsigned char dst) { op(MVINTREG_INSTR); bytes(&v, 4); code.push_back(dst); }
+    void mvFloatReg(double v, unsigned char dst) { op(MVFLOATREG_INSTR); bytes(&v, 8); code.push_back(dst); }
+    void mvFieldReg(unsigned char field, unsigned char tuple, unsigned char dst) {
+        op(MVFIELDREG_INSTR); code.push_back(field); code.push_back(tuple); code.push_back(dst);
+    }
+    void mvRegField(unsigned char src, unsigned char field, unsigned char tuple) {
+        op(MVREGFIELD_INSTR); code.push_back(src); code.push_back(field); code.push_back(tuple);
+    }
+    void binary(unsigned char o, unsigned char r1, unsigned char r2, unsigned char dst) {
+        op(o); code.push_back(r1); code.push_back(r2); code.push_back(dst);
+    }
+    //!< Skips to the offset stored at the returned position when the register is false
+    size_t ifTrue(unsigned char reg) { op(IF_INSTR); code.push_back(reg); uint32_t o = 0; bytes(&o, 4); return code.size() - 4; }
+    void endIf(size_t jump) {
+        const uint32_t o = code.size() - (jump - 2);
+        memcpy(&code[jump], &o, 4);
+    }
+};
+
+/**
+ * Predicate 0, with int fields in and out, from register 0:
+ *   r1 = in; r9 = 0
+ *   nbRounds times:
+ *     r4 = r1 * factor + increment; r5 = r4 % divisor; r6 = r4 - r5
+ *     if (r5 < increment) { r6 = r6 + factor; r9 = r9 + increment }
+ *     r9 = r9 + r6; r1 = r6 % wrap
+ *   r9 = r9 + (int)(1.5 * 1.5); out = r9
+ */
+static Program makeProgram() {
+    Program p;
+    // Header: 1 predicate, no rule, offset of its descriptor
+    p.code = { 1, 0, 4, 0 };
+    // Descriptor: start of its byte code, properties, aggregate, stratification, 2 int fields
+    p.code.insert(p.code.end(), { 12, 0, 0, 0, 0, 2, FIELD_INT, FIELD_INT });
+
+    p.op(RULE_INSTR); p.code.insert(p.code.end(), 4, 0);
+    p.mvFieldReg(0, 0, 1);
+    p.mvIntReg(factor, 2);
+    p.mvIntReg(increment, 3);
+    p.mvIntReg(0, 9);
+    p.mvIntReg(wrap, 10);
+    p.mvIntReg(divisor, 14);
+    for (int round = 0; round < nbRounds; round++) {
+        p.binary(INTMUL_INSTR, 1, 2, 4);
+        p.binary(INTPLUS_INSTR, 4, 3, 4);
+        p.binary(INTMOD_INSTR, 4, 14, 5);
+        p.binary(INTMINUS_INSTR, 4, 5, 6);
+        p.binary(INTLESSER_INSTR, 5, 3, 7);
+        size_t jump = p.ifTrue(7);
+        p.binary(INTPLUS_INSTR, 6, 2, 6);
+        p.binary(INTPLUS_INSTR, 9, 3, 9);
+        p.endIf(jump);
+        p.binary(INTPLUS_INSTR, 9, 6, 9);
+        p.binary(INTMOD_INSTR, 6, 10, 1);
+    }
+    p.mvFloatReg(1.5, 11);
+    p.binary(FLOATMUL_INSTR, 11, 11, 12);
+    p.binary(INTPLUS_INSTR, 9, 12, 9);
+    p.mvRegField(9, 1, 0);
+    p.op(RULE_DONE_INSTR);
+    p.op(RETURN_INSTR);
+    return p;
+}
+
+//!< The computation of the program, with the number of instructions it executes
+static int32_t reference(int32_t in, uint64_t &nbInstructions) {
+    int32_t r1 = in, r9 = 0;
+    nbInstructions += 7 + 6;
+    for (int round = 0; round < nbRounds; round++) {
+        int32_t r4 = r1 * factor + increment;
+        int32_t r5 = r4 % divisor;
+        int32_t r6 = r4 - r5;
+        nbInstructions += 8;
+        if (r5 < increment) {
+            r6 += factor;
+            r9 += increment;
+            nbInstructions += 2;
+        }
+        r9 += r6;
+        r1 = r6 % wrap;
+    }
+    return r9 + 2;
+}
+
+//!< Writes the program in the format read by MeldInterpretVM::readProgram
+static void writeProgram(const Program &p, const string &file) {
+    ofstream out(file);
+    out << "{";
+    for (size_t i = 0; i < p.code.size(); i++)
+        out << (i ? "," : "") << "0x" << hex << setw(2) << setfill('0') << (int)p.code[i];
+    out << "}\n{\"bench\",}\n{\"rule\",}\n";
+}
+
+//!< Processes nbTuples tuples, returns the sum of their outputs
+static uint64_t __attribute__((noinline)) run(MeldInterpretVM *vm, tuple_t tuple, size_t nbTuples) {
+    Register reg[32] = {};
+    uint64_t sum = 0;
+    for (size_t i = 0; i < nbTuples; i++) {
+        const meld_int in = i % maxInput;
+        memcpy(GET_TUPLE_FIELD(tuple, 0), &in, sizeof(in));
+        vm->process_bytecode(tuple, TYPE_START(0), 1, NOT_LINEAR, reg, PROCESS_TUPLE);
+        sum += MELD_INT(GET_TUPLE_FIELD(tuple, 1));
+    }
+    return sum;
+}
+
+int main(int argc, char **argv) {
+    const long nbTuples = argc > 1 ? atol(argv[1]) : 2000000;
+    string configuration = argc > 2 ? argv[2]
+        : "../../applicationsBin/scaffolding_pyramid_async/.controlConf_scaffold4x4.xml";
+    if (nbTuples <= 0) {
+        cerr << "usage: meldDispatchBench [nbTuples [configuration]]" << endl;
+        return EXIT_FAILURE;
+    }
+
+    char *simulatorArgs[] = { argv[0], (char*)"-c", (char*)configuration.c_str(), (char*)"-t", NULL };
+    new ConfigurationLoader(4, simulatorArgs);
+    BuildingBlock *host = Catoms3DWorld::getWorld()->getMap().begin()->second;
+
+    const Program p = makeProgram();
+    const string file = "meldDispatchBench.bb";
+    writeProgram(p, file);
+    MeldInterpretVM::readProgram(file);
+    remove(file.c_str());
+    MeldInterpretVM *vm = new MeldInterpretVM(host);
+
+    tuple_t tuple = calloc(1, TYPE_SIZE(0));
+    TUPLE_TYPE(tuple) = 0;
+
+    uint64_t expected = 0, nbInstructions = 0;
+    for (long i = 0; i < nbTuples; i++) expected += (uint32_t)reference(i % maxInput, nbInstructions);
+
+    double best[2] = { 0, 0 };
+    for (int r = 0; r < 5; r++) {
+        for (int threaded = 0; threaded < 2; threaded++) {
+            MeldInterpretVM::setThreadedDispatch(threaded);
+            auto start = get_time::now();
+            const uint64_t sum = run(vm, tuple, nbTuples);
+            const double d = chrono::duration<double, nano>(get_time::now() - start).count();
+            if (r == 0 or d < best[threaded]) best[threaded] = d;
+
+            if (sum != expected) {
+                cerr << (threaded ? "threaded" : "switch") << " dispatch computes " << sum
+                     << " instead of " << expected << endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    MeldInterpretVM::setThreadedDispatch(true);
+
+    cout << nbTuples << " tuples, " << nbInstructions << " instructions, best of 5 runs" << endl;
+    cout << fixed << setprecision(3);
+    cout << "switch:   " << best[0] / nbInstructions << " ns/instruction, "
+         << setprecision(1) << best[0] / nbTuples << " ns/tuple" << endl;
+    cout << setprecision(3) << "threaded: " << best[1] / nbInstructions << " ns/instruction, "
+         << setprecision(1) << best[1] / nbTuples << " ns/tuple ("
+         << 100.0 * (best[0] - best[1]) / best[0] << "% faster)" << endl;
+    free(tuple);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,311 @@
+/*! @file motionRulesBench.cpp
+ * @brief Checks and measures the Catoms3D surface links lookup table (see simulatorCore/src/catoms3DMotionRules.h)
+ *
+ *  Usage: motionRulesBench [nbSamples [configuration]]
+ *
+ *  Random neighborhoods of a pivot are drawn, as masks of the connectors whose adjacent cell
+ *  is occupied or out of the lattice. For each of them, the set of valid surface links given by
+ *  the lookup table is compared to the one obtained by walking every link and the connectors of
+ *  the face it goes through, as Catoms3DMotionRules::getValidSurfaceLinksOnCatom used to do.
+ *
+ *  The modules of a configuration (default: the final 4x4 pyramid of the b6 scaffolding
+ *  application, as exported for its regression tests) are then used as pivots, while modules are removed from the
+ *  lattice in a random order. For each pivot, getConnectorsOccupancy is compared to the cells
+ *  of the lattice, and getValidSurfaceLinksOnCatom and getValidMotionListFromPivot, for every
+ *  source connector, to the former implementations walking the lattice for each link.
+ *  These did not check whether a connector has an adjacent cell (Catoms3DBlock::getNeighborPos
+ *  fails below the floor), and then read the cell of the previous connector instead. Links whose
+ *  result depends on such a cell are counted apart, the lookup table handling them as out of
+ *  the lattice.
+ * @date 17/10/2026
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#include "catoms3DMotionRules.h"
+#include "catoms3DSimulator.h"
+#include "catoms3DBlockCode.h"
+#include "catoms3DWorld.h"
+#include "openglViewer.h"
+
+using namespace std;
+using namespace Catoms3D;
+using get_time = chrono::steady_clock;
+
+namespace Catoms3D {
+// Connectors of the faces of a catom, defined in catoms3DMotionRules.cpp
+const int *findTab3(int id1,int id2);
+const int *findTab4(int id1,int id2);
+}
+
+//!< Modules of the configuration do not run any code
+class IdleBlockCode : public Catoms3DBlockCode {
+public:
+    IdleBlockCode(Catoms3DBlock *host) : Catoms3DBlockCode(host) {}
+    void startup() override {}
+    static BlockCode *buildNewBlockCode(BuildingBlock *host) { return new IdleBlockCode((Catoms3DBlock*)host); }
+};
+
+//!< Loads a configuration without starting the simulation
+class ConfigurationLoader : public Catoms3DSimulator {
+public:
+    ConfigurationLoader(int argc, char *argv[]) : Catoms3DSimulator(argc, argv, IdleBlockCode::buildNewBlockCode) {
+        parseConfiguration(argc, argv);
+    }
+};
+
+//!< Catoms3DMotionRules::getValidSurfaceLinksOnCatom, as it was before the lookup table
+static void referenceSurfaceLinks(Catoms3DMotionRules &rules, const Catoms3DBlock* catom,
+                                  vector<Catoms3DMotionRulesLink*>& links) {
+    Lattice *lattice = Catoms3DWorld::getWorld()->lattice;
+
+    for (short from = 0; from < 12; from++) {
+        for (Catoms3DMotionRulesLink *link : rules.getMotionRulesLinksForConnector(from)) {
+            int conTo = link->getConToID();
+            bool isOk = false;
+            Cell3DPosition pos;
+
+            // Destination must be in lattice and free
+            catom->getNeighborPos(conTo,pos);
+            isOk = lattice->isInGrid(pos) && !lattice->cellHasBlock(pos);
+
+            // list of cells that must be free
+            const int *ptr = link->isOctaFace() ? findTab4(from,conTo) : findTab3(from,conTo);
+            const int n = link->isOctaFace() ? 4 : 3;
+            int i=0;
+            while (isOk && i<n) {
+                if (ptr[i]!=from && ptr[i]!=conTo) {
+                    catom->getNeighborPos(ptr[i],pos);
+                    isOk = !lattice->cellHasBlock(pos);
+                }
+                i++;
+            }
+
+            if (isOk) links.push_back(link);
+        }
+    }
+}
+
+//!< Catoms3DMotionRules::getValidMotionListFromPivot, as it was before the lookup table
+static bool referenceMotionList(Catoms3DMotionRules &rules, const Catoms3DBlock* pivot, int from,
+                                vector<Catoms3DMotionRulesLink*>&vec, const FCCLattice *lattice) {
+    bool notEmpty=false;
+    bool isOk;
+    Cell3DPosition pos,pos2;
+
+    // source must be free (no target)
+    pivot->getNeighborPos(from,pos);
+    pos2 = pos + pos - pivot->position;
+    if (lattice->cellHasBlock(pos2)) return false;
+
+    for (Catoms3DMotionRulesLink *link : rules.getMotionRulesLinksForConnector(from)) {
+        int to = link->getConToID();
+        // destination must be in lattice and free
+        pivot->getNeighborPos(to,pos);
+        isOk = lattice->isInGrid(pos) && !lattice->cellHasBlock(pos);
+        // opposite cell must be free
+        pos2 = 2*pos - pivot->position;
+        isOk = isOk && !lattice->cellHasBlock(pos2);
+
+        // list of cells that must be free
+        const int *ptr = link->isOctaFace() ? findTab4(from,to) : findTab3(from,to);
+        const int n = link->isOctaFace() ? 4 : 3;
+        int i=0;
+        while (isOk && i<n) {
+            if (ptr[i]!=from && ptr[i]!=to) {
+                pivot->getNeighborPos(ptr[i],pos);
+                isOk = !lattice->cellHasBlock(pos);
+            }
+            i++;
+        }
+
+        if (isOk) {
+            vec.push_back(link);
+            notEmpty=true;
+        }
+    }
+
+    return notEmpty;
+}
+
+//!< @brief Tells whether the reference reads the cell of a connector of the face of link which has none
+static bool readsMissingCell(const Catoms3DBlock *pivot, const Catoms3DMotionRulesLink *link) {
+    const int from = link->getConFromID(), to = link->getConToID();
+    const int *ptr = link->isOctaFace() ? findTab4(from,to) : findTab3(from,to);
+    Cell3DPosition pos;
+    for (int i = 0; i < (link->isOctaFace() ? 4 : 3); i++) {
+        if (ptr[i] != from && !pivot->getNeighborPos(ptr[i], pos)) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Compares two lists of links, ignoring the links whose reference result is undefined
+ * @return true if the lists only differ by such links, which are counted in nbUndefined
+ */
+static bool sameLinks(const Catoms3DBlock *pivot, const vector<Catoms3DMotionRulesLink*> &links,
+                      const vector<Catoms3DMotionRulesLink*> &reference, size_t &nbUndefined) {
+    vector<Catoms3DMotionRulesLink*> a, b;
+    for (Catoms3DMotionRulesLink *l : links) {
+        if (readsMissingCell(pivot, l)) continue;
+        a.push_back(l);
+    }
+    for (Catoms3DMotionRulesLink *l : reference) {
+        if (readsMissingCell(pivot, l)) nbUndefined++;
+        else b.push_back(l);
+    }
+    return a == b;
+}
+
+/**
+ * @brief Compares the motion rules queries of every module of the lattice to their reference
+ * @return number of mismatches
+ */
+static size_t checkPivots(Catoms3DMotionRules &rules, const FCCLattice *lattice,
+                          const vector<Catoms3DBlock*> &modules, size_t &nbLinks,
+                          size_t &nbUndefined, double &nsReference, double &nsTable) {
+    size_t nbMismatches = 0;
+    vector<Catoms3DMotionRulesLink*> reference, links;
+    Cell3DPosition pos;
+
+    for (const Catoms3DBlock *pivot : modules) {
+        unsigned short occupied, unreachable, oppositeOccupied;
+        rules.getConnectorsOccupancy(pivot, occupied, unreachable, &oppositeOccupied);
+        for (short c = 0; c < 12; c++) {
+            bool inGrid = pivot->getNeighborPos(c, pos) && lattice->isInGrid(pos);
+            bool opposite = inGrid && lattice->cellHasBlock(2*pos - pivot->position);
+            if (((unreachable >> c) & 1) != !inGrid
+                or ((occupied >> c) & 1) != (inGrid && lattice->cellHasBlock(pos))
+                or ((oppositeOccupied >> c) & 1) != opposite) {
+                nbMismatches++;
+            }
+        }
+
+        reference.clear();
+        links.clear();
+        auto start = get_time::now();
+        referenceSurfaceLinks(rules, pivot, reference);
+        auto middle = get_time::now();
+        rules.getValidSurfaceLinksOnCatom(pivot, links);
+        auto end = get_time::now();
+        nsReference += chrono::duration_cast<chrono::nanoseconds>(middle - start).count();
+        nsTable += chrono::duration_cast<chrono::nanoseconds>(end - middle).count();
+        if (!sameLinks(pivot, links, reference, nbUndefined)) nbMismatches++;
+        nbLinks += links.size();
+
+        for (int from = 0; from < 12; from++) {
+            reference.clear();
+            links.clear();
+            start = get_time::now();
+            bool referenceFound = referenceMotionList(rules, pivot, from, reference, lattice);
+            middle = get_time::now();
+            bool found = rules.getValidMotionListFromPivot(pivot, from, links, lattice, NULL);
+            end = get_time::now();
+            nsReference += chrono::duration_cast<chrono::nanoseconds>(middle - start).count();
+            nsTable += chrono::duration_cast<chrono::nanoseconds>(end - middle).count();
+            if (found == links.empty() or referenceFound == reference.empty()
+                or !sameLinks(pivot, links, reference, nbUndefined)) nbMismatches++;
+            nbLinks += links.size();
+        }
+    }
+
+    return nbMismatches;
+}
+
+struct Neighborhood {
+    unsigned short occupied;
+    unsigned short unreachable;
+};
+
+int main(int argc, char **argv) {
+    size_t nbSamples = argc > 1 ? atol(argv[1]) : 1000000;
+    string configuration = argc > 2 ? argv[2]
+        : "../../applicationsBin/scaffolding_pyramid_async/.controlConf_scaffold4x4.xml";
+    // Links are defined relative to the lattice of the world, which is loaded with the modules
+    //  of the configuration
+    char *simulatorArgs[] = { argv[0], (char*)"-c", (char*)configuration.c_str(), (char*)"-t", NULL };
+    new ConfigurationLoader(4, simulatorArgs);
+    Catoms3DWorld *world = Catoms3DWorld::getWorld();
+    Catoms3DMotionRules &rules = *world->getMotionRules();
+
+    // Neighborhoods with a varying density, one in four having cells out of the lattice
+    mt19937 rng(42);
+    uniform_real_distribution<double> uniform(0, 1);
+    vector<Neighborhood> samples(nbSamples);
+    for (Neighborhood &n : samples) {
+        double density = uniform(rng);
+        bool border = uniform(rng) < 0.25;
+        n.occupied = n.unreachable = 0;
+        for (int c = 0; c < 12; c++) {
+            if (border and uniform(rng) < 0.25) n.unreachable |= 1 << c;
+            else if (uniform(rng) < density) n.occupied |= 1 << c;
+        }
+    }
+
+    // Reference: every link checked on its own
+    vector<Catoms3DMotionRules::LinkSet> reference(nbSamples);
+    auto start = get_time::now();
+    for (size_t i = 0; i < nbSamples; i++) {
+        for (int l = 0; l < Catoms3DMotionRules::nbLinks; l++) {
+            if (Catoms3DMotionRules::isValidSurfaceLink(rules.getLink(l), samples[i].occupied,
+                                                        samples[i].unreachable))
+                reference[i].set(l);
+        }
+    }
+    double nsReference = chrono::duration_cast<chrono::nanoseconds>(get_time::now() - start).count();
+
+    size_t nbMismatches = 0, nbValidLinks = 0;
+    start = get_time::now();
+    for (size_t i = 0; i < nbSamples; i++) {
+        Catoms3DMotionRules::LinkSet links =
+            rules.getValidSurfaceLinks(samples[i].occupied, samples[i].unreachable);
+        nbValidLinks += links.count();
+        if (links != reference[i]) nbMismatches++;
+    }
+    double nsTable = chrono::duration_cast<chrono::nanoseconds>(get_time::now() - start).count();
+
+    cout << nbSamples << " random neighborhoods, " << (double)nbValidLinks / nbSamples
+         << " valid links on average" << endl;
+    cout << "  " << setw(10) << left << "walk" << setw(10) << right << fixed << setprecision(1)
+         << nsReference / nbSamples << " ns/neighborhood" << endl;
+    cout << "  " << setw(10) << left << "table" << setw(10) << right << fixed << setprecision(1)
+         << nsTable / nbSamples << " ns/neighborhood" << endl;
+    cout << (nbMismatches ? "MISMATCH on " + to_string(nbMismatches) + " neighborhoods" : "OK") << endl;
+
+    // Pivots of the configuration, modules being removed by tenths in a random order
+    FCCLattice *lattice = static_cast<FCCLattice*>(world->lattice);
+    vector<Catoms3DBlock*> modules;
+    for (const auto &pair : world->buildingBlocksMap)
+        modules.push_back(static_cast<Catoms3DBlock*>(pair.second));
+    shuffle(modules.begin(), modules.end(), rng);
+    const size_t nbModules = modules.size();
+
+    size_t nbPivotMismatches = 0, nbPivots = 0, nbLinks = 0, nbUndefined = 0;
+    double nsPivotReference = 0, nsPivotTable = 0;
+    while (!modules.empty()) {
+        nbPivotMismatches += checkPivots(rules, lattice, modules, nbLinks, nbUndefined,
+                                         nsPivotReference, nsPivotTable);
+        nbPivots += modules.size();
+        for (size_t i = 0; i < (nbModules + 9) / 10 && !modules.empty(); i++) {
+            lattice->remove(modules.back()->position);
+            modules.pop_back();
+        }
+    }
+
+    cout << nbModules << " modules of " << configuration << ", " << nbPivots << " pivots checked, "
+         << (double)nbLinks / nbPivots << " valid links on average, " << nbUndefined
+         << " links of the reference through connectors without cell" << endl;
+    cout << "  " << setw(10) << left << "walk" << setw(10) << right << fixed << setprecision(1)
+         << nsPivotReference / nbPivots << " ns/pivot" << endl;
+    cout << "  " << setw(10) << left << "table" << setw(10) << right << fixed << setprecision(1)
+         << nsPivotTable / nbPivots << " ns/pivot" << endl;
+    cout << (nbPivotMismatches ? "MISMATCH on " + to_string(nbPivotMismatches) + " queries" : "OK") << endl;
+
+    return nbMismatches or nbPivotMismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,332 @@
+/*! @file networkTest.cpp
+ * @brief Checks the messages and the links between modules (see simulatorCore/src/network.h,
+ *  simulatorCore/src/messageCodec.h and simulatorCore/src/linkModel.h)
+ *
+ *  Usage: networkTest
+ *
+ *  - Payloads of MessageOf and SharedPayload: clones share the payload until one of them is
+ *    modified, which then no longer affects the others, as when each clone had its own copy.
+ *  - OutgoingMessageQueue: random pushes and pops, wrapping around and growing the ring buffer,
+ *    compared to a deque.
+ *  - Wire format: encodings of reference values, and size() of messages equal to the number of
+ *    bytes serialize() writes.
+ *  - Wire decoding: values read back equal to the ones written, including the containers and
+ *    random generators of snapshots (see simulatorCore/src/snapshot.h), and truncated encodings
+ *    rejected.
+ *  - Link models: outage lists, delivery dates, and loss rate of the Gilbert-Elliott model.
+ *  Exits with a failure status if a check fails.
+ * @date 18/10/2026
+ */
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <deque>
+#include <array>
+#include <set>
+#include <map>
+#include <bitset>
+#include <stdexcept>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+
+#include "network.h"
+#include "messageCodec.h"
+#include "linkModel.h"
+#include "snapshot.h"
+
+using namespace std;
+using namespace BaseSimulator;
+
+static int nbFailures = 0;
+
+#define CHECK(cond) do { \
+        if (not (cond)) { \
+            cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #cond << endl; \
+            nbFailures++; \
+        } \
+    } while (0)
+
+static void checkSharedPayloads() {
+    const vector<int> data = { 1, 2, 3 };
+    MessageOf<vector<int>> *m = new MessageOf<vector<int>>(7, data);
+    vector<MessageOf<vector<int>>*> clones;
+    for (int i = 0; i < 3; i++) clones.push_back(static_cast<MessageOf<vector<int>>*>(m->clone()));
+
+    // Clones share the payload of the message
+    for (auto c : clones) {
+        CHECK(c->type == 7);
+        CHECK(c->getConstData() == m->getConstData());
+    }
+    CHECK(m->getSharedData().use_count() == 4);
+
+    // A modified clone gets its own copy, the others are unchanged
+    clones[1]->getData()->push_back(4);
+    CHECK(*clones[1]->getConstData() == vector<int>({ 1, 2, 3, 4 }));
+    CHECK(*m->getConstData() == data);
+    CHECK(*clones[0]->getConstData() == data);
+    CHECK(clones[1]->getConstData() != m->getConstData());
+    CHECK(m->getSharedData().use_count() == 3);
+
+    // A payload that is not shared is modified in place
+    const vector<int> *p = clones[1]->getConstData();
+    clones[1]->getData()->push_back(5);
+    CHECK(clones[1]->getConstData() == p);
+
+    delete m;
+    CHECK(*clones[0]->getConstData() == data);
+    for (auto c : clones) delete c;
+
+    // Members of handleable messages
+    SharedPayload<string> a(string("payload"));
+    SharedPayload<string> b(a);
+    CHECK(&a.get() == &b.get());
+    b.getMutable()->append("!");
+    CHECK(a.get() == "payload");
+    CHECK(b.get() == "payload!");
+}
+
+static void checkOutgoingQueue() {
+    OutgoingMessageQueue queue;
+    deque<MessagePtr> reference;
+    mt19937 rng(42);
+
+    for (int i = 0; i < 20000; i++) {
+        // Bursts of pushes, so that the ring buffer wraps around and grows while wrapped
+        const bool push = reference.empty() or rng() % 100 < (i % 2000 < 1000 ? 60 : 40);
+        if (push) {
+            MessagePtr msg(new Message());
+            queue.push_back(msg);
+            reference.push_back(msg);
+        } else {
+            CHECK(queue.front().message == reference.front());
+            queue.pop_front();
+            reference.pop_front();
+        }
+
+        CHECK(queue.size() == reference.size());
+        if (not reference.empty()) {
+            CHECK(queue.back().message == reference.back());
+            const size_t j = rng() % reference.size();
+            CHECK(queue[j].message == reference[j]);
+        }
+    }
+
+    // Popped and cleared messages are released by the queue
+    CHECK(queue.size() > 0);
+    queue.clear();
+    CHECK(queue.empty());
+    for (MessagePtr &msg : reference) CHECK(msg.use_count() == 1);
+}
+
+static bool hasBytes(const WireBuffer &b, const vector<uint8_t> &bytes) {
+    return b.getBytes() == bytes;
+}
+
+template<class... Ts>
+static WireBuffer encode(const Ts&... values) {
+    WireBuffer b;
+    b.write(values...);
+    CHECK(b.size() == WireBuffer::sizeOf(values...));
+    return b;
+}
+
+//!< Message declaring its fields, as the messages of the block codes
+class PositionMessage : public HandleableMessage {
+public:
+    Cell3DPosition position;
+    uint16_t hops;
+    bool flag;
+
+    PositionMessage(const Cell3DPosition &p, uint16_t h, bool f) : position(p), hops(h), flag(f) { type = 1000; };
+    void handle(BlockCode*) override {};
+    string getName() const override { return "PositionMessage"; }
+    Message* clone() const override { return new PositionMessage(*this); }
+    MESSAGE_WIRE_FIELDS(position, hops, flag)
+};
+
+struct Opaque {
+    int a[5];
+};
+
+static void checkSize(const Message &msg, size_t expectedSize) {
+    WireBuffer b;
+    msg.serialize(b);
+    CHECK(msg.size() == expectedSize);
+    CHECK(b.size() == expectedSize);
+    // Header: type and length of the fields, little endian
+    CHECK(b.getBytes()[0] == (msg.type & 0xFF) and b.getBytes()[1] == ((msg.type >> 8) & 0xFF));
+    CHECK(b.getBytes()[2] + 256u * b.getBytes()[3] == expectedSize - Message::headerSize);
+}
+
+static void checkWireFormat() {
+    CHECK(hasBytes(encode((uint32_t)0), { 0x00 }));
+    CHECK(hasBytes(encode((uint32_t)127), { 0x7F }));
+    CHECK(hasBytes(encode((uint32_t)128), { 0x80, 0x01 }));
+    CHECK(hasBytes(encode((uint32_t)300), { 0xAC, 0x02 }));
+    CHECK(hasBytes(encode((int)-1), { 0x01 }));
+    CHECK(hasBytes(encode((int)1), { 0x02 }));
+    CHECK(hasBytes(encode((int64_t)numeric_limits<int64_t>::min()),
+                   { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 }));
+    CHECK(hasBytes(encode((uint8_t)200, (int8_t)-1, true), { 200, 0xFF, 1 }));
+    CHECK(hasBytes(encode(Cell3DPosition(1, -1, 300)), { 0x02, 0x01, 0xD8, 0x04 }));
+    CHECK(hasBytes(encode(bitset<12>(0xA05)), { 0x05, 0x0A }));
+    CHECK(hasBytes(encode(string("ab")), { 0x02, 'a', 'b' }));
+    CHECK(hasBytes(encode(vector<short>({ 1, -2 })), { 0x02, 0x02, 0x03 }));
+    CHECK(hasBytes(encode(1.5f), { 0x00, 0x00, 0xC0, 0x3F }));
+
+    checkSize(Message(3), Message::headerSize);
+    checkSize(MessageOf<int>(4, 1000), Message::headerSize + 2);
+    checkSize(MessageOf<Cell3DPosition>(5, Cell3DPosition(2, 3, 4)), Message::headerSize + 3);
+    // Payloads without a wire format count for their size in memory, padded with zeros
+    checkSize(MessageOf<Opaque>(6, Opaque()), Message::headerSize + sizeof(Opaque));
+    PositionMessage pm(Cell3DPosition(10, 0, -3), 1000, true);
+    checkSize(pm, Message::headerSize + 3 + 2 + 1);
+    WireBuffer b;
+    pm.serialize(b);
+    CHECK(hasBytes(b, { 0xE8, 0x03, 6, 0, 0x14, 0x00, 0x05, 0xE8, 0x07, 0x01 }));
+}
+
+template<class T>
+static bool roundTrips(const T &value) {
+    WireBuffer b;
+    b.write(value);
+    WireReader r(b.getBytes());
+    T read;
+    r.read(read);
+    return read == value and r.remaining() == 0;
+}
+
+static void checkWireReader() {
+    CHECK(roundTrips((uint32_t)300));
+    CHECK(roundTrips((int)-1));
+    CHECK(roundTrips(numeric_limits<int64_t>::min()));
+    CHECK(roundTrips(numeric_limits<uint64_t>::max()));
+    CHECK(roundTrips((uint8_t)200));
+    CHECK(roundTrips((int8_t)-1));
+    CHECK(roundTrips(true));
+    CHECK(roundTrips(1.5f));
+    CHECK(roundTrips(-2.25));
+    CHECK(roundTrips(Cell3DPosition(1, -1, 300)));
+    CHECK(roundTrips(bitset<12>(0xA05)));
+    CHECK(roundTrips(string("ab")));
+    CHECK(roundTrips(vector<short>({ 1, -2 })));
+    CHECK(roundTrips(deque<Cell3DPosition>({ Cell3DPosition(0, 1, 2), Cell3DPosition(-3, 4, 5) })));
+    CHECK(roundTrips(array<bool, 3>({ true, false, true })));
+    CHECK(roundTrips(make_pair(7, string("seven"))));
+    CHECK(roundTrips(set<int>({ -5, 0, 12 })));
+    CHECK(roundTrips(map<int, uint64_t>({ { 1, 10 }, { 2, 1ull << 40 } })));
+
+    // Several values, read in the order they were written
+    const int a[3] = { 1, -2, 3 };
+    WireBuffer b;
+    b.write(a, string("end"));
+    WireReader r(b.getBytes());
+    int c[3];
+    string s;
+    r.read(c, s);
+    CHECK(c[0] == 1 and c[1] == -2 and c[2] == 3 and s == "end");
+
+    // Generators draw the same numbers once restored
+    uintRNG g(42);
+    for (int i = 0; i < 1000; i++) g();
+    WireBuffer gb;
+    gb.write(g);
+    CHECK(gb.size() == WireBuffer::sizeOf(g));
+    WireReader gr(gb.getBytes());
+    uintRNG restored;
+    gr.read(restored);
+    CHECK(restored == g);
+    CHECK(restored() == g());
+
+    // Truncated encodings
+    bool thrown = false;
+    try {
+        WireReader(vector<uint8_t>({ 0x80 })).readVarint();
+    } catch (const out_of_range&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    thrown = false;
+    try {
+        string t;
+        WireReader(vector<uint8_t>({ 0x05, 'a' })).read(t);
+    } catch (const out_of_range&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+static void checkLinkModels() {
+    LinkModel m;
+    CHECK(m.isConstant());
+    CHECK(not m.isDown(0));
+    CHECK(m.parseOutages("500-;200-300"));
+    CHECK(not m.isConstant());
+    CHECK(not m.isDown(199));
+    CHECK(m.isDown(200));
+    CHECK(m.isDown(299));
+    CHECK(not m.isDown(300));
+    CHECK(not m.isDown(499));
+    CHECK(m.isDown(500));
+    CHECK(m.isDown(numeric_limits<Time>::max() - 1));
+    // Rejected lists leave the outages unchanged
+    CHECK(not m.parseOutages("100-300;200-400"));
+    CHECK(not m.parseOutages("300-200"));
+    CHECK(not m.parseOutages("abc"));
+    CHECK(m.isDown(200) and not m.isDown(300));
+
+    // Constant latency
+    LinkModel constant;
+    constant.latency = 100;
+    LinkState s1(&constant, 1);
+    CHECK(s1.getDeliveryDate(1000) == 1100);
+    CHECK(not s1.isLost(1000));
+
+    // Gaussian latencies never reorder messages, and only depend on the seed
+    LinkModel jitter;
+    jitter.latency = 100;
+    jitter.latencyStdDev = 50;
+    LinkState s2(&jitter, 2), s3(&jitter, 2);
+    Time last = 0;
+    for (Time t = 0; t < 100000; t += 10) {
+        const Time d = s2.getDeliveryDate(t);
+        CHECK(d >= t and d >= last);
+        CHECK(s3.getDeliveryDate(t) == d);
+        last = d;
+    }
+
+    // Gilbert-Elliott: long run loss rate of the stationary distribution of the chain
+    LinkModel ge;
+    ge.lossType = LinkLossType::GilbertElliott;
+    ge.pGoodToBad = 0.05;
+    ge.pBadToGood = 0.2;
+    ge.lossGood = 0.01;
+    ge.lossBad = 0.6;
+    CHECK(ge.parseOutages("1000000-2000000"));
+    LinkState s4(&ge, 3);
+    const int nbMessages = 200000;
+    int nbLost = 0;
+    for (int i = 0; i < nbMessages; i++) nbLost += s4.isLost(i);
+    const double pBad = ge.pGoodToBad / (ge.pGoodToBad + ge.pBadToGood);
+    const double expected = pBad * ge.lossBad + (1 - pBad) * ge.lossGood;
+    CHECK(fabs((double)nbLost / nbMessages - expected) < 0.01);
+    CHECK(s4.isLost(1500000));
+}
+
+int main() {
+    checkSharedPayloads();
+    checkOutgoingQueue();
+    checkWireFormat();
+    checkWireReader();
+    checkLinkModels();
+
+    if (nbFailures) {
+        cerr << nbFailures << " failed check(s)" << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "Network: OK" << endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,285 @@
+/*! @file vmTransportBench.cpp
+ * @brief Compares the transports of the VM commands of MeldProcess: a TCP connection per VM, and
+ *  the shared memory rings (see simulatorCore/src/meldProcessShm.h)
+ *
+ *  Usage: vmTransportBench
+ *
+ *  Child processes stand for the VMs and echo the commands they receive, as a VM answers a
+ *  command with another one. In each round, the simulator sends a window of commands to each
+ *  VM, then waits for all the echoes, checking their content. Throughput is in commands/s, each
+ *  command going to a VM and back. A window of 1 measures the round trip latency.
+ * @date 18/10/2026
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+
+#include "meldProcessShm.h"
+#include "meldProcessShmClient.h"
+
+using namespace std;
+using namespace MeldProcess;
+using get_time = chrono::steady_clock;
+
+static const uint64_t setColorCommand = 8;  //!< VM_COMMAND_SET_COLOR
+static const uint64_t stopCommand = 4;      //!< VM_COMMAND_STOP
+static const size_t commandWords = 8;       //!< <size> <command> <timestamp> <src> <red> <blue> <green> <intensity>
+
+static void makeCommand(uint64_t *c, uint64_t type, uint64_t seq, uint64_t vm) {
+    c[0] = (commandWords - 1) * sizeof(uint64_t);
+    c[1] = type;
+    c[2] = seq;
+    c[3] = vm;
+    for (size_t i = 4; i < commandWords; i++) c[i] = seq ^ i;
+}
+
+static bool checkCommand(const uint64_t *c, uint64_t seq, uint64_t vm) {
+    uint64_t expected[commandWords];
+    makeCommand(expected, setColorCommand, seq, vm);
+    return memcmp(c, expected, sizeof(expected)) == 0;
+}
+
+//!< Transport of the simulator end, and of the VM processes
+class Transport {
+public:
+    virtual ~Transport() {}
+    virtual const char* getName() const = 0;
+    //!< Forks the VM processes
+    virtual void start(size_t nbVMs) = 0;
+    virtual void send(size_t vm, const uint64_t *command) = 0;
+    //!< Receives one command from each of the VMs in vms, removing them from the list
+    virtual void receive(vector<size_t> &vms, vector<vector<uint64_t>> &commands) = 0;
+    virtual void stop() = 0;
+};
+
+class ShmTransport : public Transport {
+    ShmRegion *region = NULL;
+    vector<pid_t> pids;
+    vector<uint32_t> readySlots;
+public:
+    const char* getName() const override { return "shm"; }
+
+    void start(size_t nbVMs) override {
+        region = ShmRegion::create(nbVMs);
+        if (region == NULL) { perror("shm"); exit(EXIT_FAILURE); }
+        for (size_t vm = 0; vm < nbVMs; vm++) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                // Attaches as a VM does, its mapping of the region is not used
+                setenv(ShmRegion::nameVariable, region->getName().c_str(), 1);
+                setenv(ShmRegion::slotVariable, to_string(vm).c_str(), 1);
+                if (meldShmAttach() != 1) _exit(EXIT_FAILURE);
+                uint64_t c[ShmRing::maxCommandWords];
+                for (;;) {
+                    meldShmReceive(c);
+                    if (c[1] == stopCommand) _exit(EXIT_SUCCESS);
+                    meldShmSend(c);
+                }
+            }
+            pids.push_back(pid);
+            while (not region->getSlot(vm).attached.load()) usleep(100);
+        }
+    }
+
+    void send(size_t vm, const uint64_t *command) override {
+        while (not region->trySendToVM(vm, command))
+            region->getSlot(vm).toVM.waitForSpace(1);
+    }
+
+    void receive(vector<size_t> &vms, vector<vector<uint64_t>> &commands) override {
+        size_t remaining = vms.size();
+        while (remaining) {
+            readySlots.clear();
+            region->getReadySlots(readySlots);
+            if (readySlots.empty()) { region->waitForVMs(-1); continue; }
+            for (uint32_t s : readySlots) {
+                uint64_t c[ShmRing::maxCommandWords];
+                while (region->tryReceiveFromVM(s, c)) {
+                    commands[s].insert(commands[s].end(), c, c + commandWords);
+                    remaining--;
+                }
+            }
+        }
+        vms.clear();
+    }
+
+    void stop() override {
+        uint64_t c[commandWords];
+        for (size_t vm = 0; vm < pids.size(); vm++) {
+            makeCommand(c, stopCommand, 0, vm);
+            send(vm, c);
+        }
+        for (pid_t pid : pids) waitpid(pid, NULL, 0);
+        pids.clear();
+        delete region;
+        region = NULL;
+    }
+};
+
+//!< Loopback connection per VM, messages read as MeldProcessVM does: size, then content
+class TcpTransport : public Transport {
+    int listener = -1;
+    vector<int> sockets;
+    vector<pid_t> pids;
+
+    static bool readAll(int fd, void *buffer, size_t n) {
+        char *p = static_cast<char*>(buffer);
+        while (n) {
+            ssize_t r = read(fd, p, n);
+            if (r <= 0) return false;
+            p += r; n -= r;
+        }
+        return true;
+    }
+
+    static bool writeAll(int fd, const void *buffer, size_t n) {
+        const char *p = static_cast<const char*>(buffer);
+        while (n) {
+            ssize_t w = write(fd, p, n);
+            if (w <= 0) return false;
+            p += w; n -= w;
+        }
+        return true;
+    }
+
+    //!< Without Nagle's algorithm, echoes of a window would wait for delayed acknowledgements
+    static int noDelay(int fd) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        return fd;
+    }
+
+    static bool readCommand(int fd, uint64_t *c) {
+        return readAll(fd, c, sizeof(uint64_t)) and readAll(fd, c + 1, c[0]);
+    }
+public:
+    const char* getName() const override { return "tcp"; }
+
+    void start(size_t nbVMs) override {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        socklen_t len = sizeof(addr);
+        if (bind(listener, (struct sockaddr*)&addr, sizeof(addr)) or listen(listener, nbVMs)
+            or getsockname(listener, (struct sockaddr*)&addr, &len)) {
+            perror("tcp"); exit(EXIT_FAILURE);
+        }
+
+        for (size_t vm = 0; vm < nbVMs; vm++) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                int fd = noDelay(socket(AF_INET, SOCK_STREAM, 0));
+                if (connect(fd, (struct sockaddr*)&addr, sizeof(addr))) _exit(EXIT_FAILURE);
+                uint64_t c[ShmRing::maxCommandWords];
+                while (readCommand(fd, c) and c[1] != stopCommand)
+                    if (not writeAll(fd, c, c[0] + sizeof(uint64_t))) break;
+                _exit(EXIT_SUCCESS);
+            }
+            pids.push_back(pid);
+            sockets.push_back(noDelay(accept(listener, NULL, NULL)));
+        }
+    }
+
+    void send(size_t vm, const uint64_t *command) override {
+        writeAll(sockets[vm], command, command[0] + sizeof(uint64_t));
+    }
+
+    void receive(vector<size_t> &vms, vector<vector<uint64_t>> &commands) override {
+        uint64_t c[ShmRing::maxCommandWords];
+        for (size_t vm : vms) {
+            if (not readCommand(sockets[vm], c)) { cerr << "error: connection lost" << endl; exit(EXIT_FAILURE); }
+            commands[vm].insert(commands[vm].end(), c, c + commandWords);
+        }
+        vms.clear();
+    }
+
+    void stop() override {
+        uint64_t c[commandWords];
+        for (size_t vm = 0; vm < sockets.size(); vm++) {
+            makeCommand(c, stopCommand, 0, vm);
+            send(vm, c);
+        }
+        for (pid_t pid : pids) waitpid(pid, NULL, 0);
+        for (int fd : sockets) close(fd);
+        close(listener);
+        sockets.clear();
+        pids.clear();
+    }
+};
+
+/**
+ * @brief Exchanges nbCommands commands with nbVMs VMs, window commands per VM and round
+ * @param errors incremented for each echo which differs from its command
+ * @return commands per second
+ */
+static double exchange(Transport &t, size_t nbVMs, size_t window, size_t nbCommands, size_t &errors) {
+    t.start(nbVMs);
+    const size_t nbRounds = nbCommands / (nbVMs * window);
+    vector<vector<uint64_t>> echoes(nbVMs);
+    vector<size_t> expected;
+    uint64_t c[commandWords];
+    uint64_t seq = 0;
+
+    auto start = get_time::now();
+    for (size_t r = 0; r < nbRounds; r++) {
+        for (size_t vm = 0; vm < nbVMs; vm++) {
+            echoes[vm].clear();
+            for (size_t w = 0; w < window; w++) {
+                makeCommand(c, setColorCommand, seq + w, vm);
+                t.send(vm, c);
+                expected.push_back(vm);
+            }
+        }
+        t.receive(expected, echoes);
+        for (size_t vm = 0; vm < nbVMs; vm++) {
+            if (echoes[vm].size() != window * commandWords) { errors++; continue; }
+            for (size_t w = 0; w < window; w++)
+                if (not checkCommand(&echoes[vm][w * commandWords], seq + w, vm)) errors++;
+        }
+        seq += window;
+    }
+    auto end = get_time::now();
+
+    t.stop();
+    return nbRounds * nbVMs * window / chrono::duration<double>(end - start).count();
+}
+
+int main() {
+    const size_t nbCommands = 400000;
+    signal(SIGPIPE, SIG_IGN);
+
+    ShmTransport shm;
+    TcpTransport tcp;
+    size_t errors = 0;
+    for (size_t nbVMs : { 1, 16 }) {
+        for (size_t window : { 1, 32 }) {
+            cout << nbVMs << " VMs, " << window << " commands per VM and round trip" << endl;
+            for (Transport *t : { (Transport*)&tcp, (Transport*)&shm }) {
+                const double rate = exchange(*t, nbVMs, window, nbCommands, errors);
+                cout << "  " << setw(6) << left << t->getName() << right << fixed << setprecision(0)
+                     << setw(12) << rate << " commands/s" << endl;
+            }
+        }
+    }
+
+    if (errors) {
+        cerr << "error: " << errors << " corrupted commands" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
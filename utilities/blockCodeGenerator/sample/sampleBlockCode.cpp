@@ -7,10 +7,10 @@ using namespace <<moduleName>>;
     //  for command line parsing
     if (not host) return;
 
-    // Registers a callback (handleSampleMessage) to the message of type SAMPLE_MSG_ID
-    addMessageEventFunc2(SAMPLE_MSG_ID,
-                         std::bind(&<<appName>>BlockCode::handleSampleMessage, this,
-                                   std::placeholders::_1, std::placeholders::_2));
+    // Registers a callback (handleSampleMessage) to the message of type SAMPLE_MSG_ID,
+    //  shared by all the modules
+    registerMessageHandler<<<appName>>BlockCode>(SAMPLE_MSG_ID,
+                                                 &<<appName>>BlockCode::handleSampleMessage);
 
     // Set the module pointer
     module = static_cast<<<moduleName>>Block*>(hostBlock);
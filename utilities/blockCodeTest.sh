@@ -1,9 +1,10 @@
 #!/bin/bash
 
 usage() {
-    echo "Usage: $0 <test-ID> <path-to-blockCode-binary> <VisibleSim-arguments>"
+    echo "Usage: $0 [-C <control-ID>] <test-ID> <path-to-blockCode-binary> <VisibleSim-arguments>"
     echo "Example: $0 bbCycle ../applicationsBin/bbCycle -c config123.xml -s 9000000"
     echo "Test-ID can be used to distinguish between 2 control XML files from the same directory"
+    echo "Control-ID names the control files of another test expected to give the same result (default: test-ID)"
     exit 1
 }
 
@@ -15,17 +16,28 @@ print_result() {
     if [ $size -lt 7 ]; then
         echo -ne "\t"
     fi
-    
+
     if [ $2 == true ]; then
         echo -e "\t\t\t[\033[33;32mPASS\x1B[0m]"
+        exit 0
     else
         echo -e "\t\t\t[\033[33;31mFAILED\x1B[0m]"
+        exit 1
     fi
-   
-    exit 0
+}
+
+# Simulated end date and numbers of processed events, messages and motions printed by the run,
+# which change with the timing of the simulation even when its final configuration does not
+extract_stats() {
+    sed 's/\x1B\[[0-9;]*m//g' "$1" | grep "^Simulator elapsed time:\|^Number of .* processed:"
 }
 
 # Check parameters and parse potential arguments
+controlID=""
+if [ "$1" == "-C" ]; then
+    controlID="$2"
+    shift 2
+fi
 [ $# -lt 2 ] && usage
 
 # Check BlockCode
@@ -37,12 +49,19 @@ fi
 # Save Test ID
 testID="$1"
 shift                           # Shift past Test-ID
+[ -z "$controlID" ] && controlID="$testID"
 
 # Save work directory
 bcDir="$(dirname $1)"
 bcID="$(basename $bcDir)"
+bc="./$(basename $1)"           # BlockCode, run from its directory
+shift
 check="$bcDir/.confCheck.xml"
-control="$bcDir/.controlConf_$testID.xml"
+control="$bcDir/.controlConf_$controlID.xml"
+output="$bcDir/.outputCheck.txt"
+# Statistics are specific to the test when its run processes other events than the control's
+stats="$bcDir/.controlStats_$testID.txt"
+[ -r "$stats" ] || stats="$bcDir/.controlStats_$controlID.txt"
 
 # Check that a control output has been generated
 if [ ! -r "$control" ]; then
@@ -50,7 +69,8 @@ if [ ! -r "$control" ]; then
     while true; do
         read -n 1 -rep $'Do you wish to export it now? (y/n) ' yn
         case $yn in
-            [Yy]* ) (cd "$bcDir" && ./"$@" -t -g &>/dev/null; mv "$check" "$control" 2>/dev/null); break;;
+            [Yy]* ) (cd "$bcDir" && "$bc" "$@" -t -g &>"$(basename $output)"; mv "$check" "$control" 2>/dev/null)
+                    extract_stats "$output" > "$stats"; rm -f "$output"; break;;
             [Nn]* ) print_result "$testID" false;;
             * ) echo "Please answer yes or no.";;
         esac
@@ -58,20 +78,26 @@ if [ ! -r "$control" ]; then
 fi
 
 # Execute BlockCode in test mode
-(cd "$bcDir" && ./"$@" -t -g &>/dev/null)
+(cd "$bcDir" && "$bc" "$@" -t -g &>"$(basename $output)")
 
 # Check simulation status (FAIL if != EXIT_SUCCESS (0))
 status=$?
 
 if [ $status != 0 ]; then
+    rm -f $check $output
     print_result "$testID" false
 fi
 
 # Compare output and expected output
 DIFF=$(echo `diff "$check" "$control" 2> /dev/null`)
 
+# Compare statistics to the expected ones, if any
+if [ -r "$stats" ]; then
+    DIFF="$DIFF$(echo `extract_stats "$output" | diff - "$stats"`)"
+fi
+
 # Clean outputs
-rm -f $check
+rm -f $check $output
 
 # Interpret diff result (test succeeds if both output and control are identical)
 if [ "$DIFF" == "" ]; then
@@ -0,0 +1,46 @@
+/*! @file traceDecoder.cpp
+ * @brief Converts a binary trace file written by the simulator (-b option) into the text it
+ *  would have written to simulation.log (-l option).
+ *
+ *  Usage: traceDecoder <trace file> [<output file>]
+ *  The text is written to the standard output if no output file is given.
+ * @date 17/10/2026
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+
+#include "traceSink.h"
+
+using namespace std;
+using namespace BaseSimulator;
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <trace file> [<output file>]" << endl;
+        return EXIT_FAILURE;
+    }
+
+    ifstream in(argv[1], ios::binary);
+    if (not in) {
+        cerr << "error: cannot open " << argv[1] << endl;
+        return EXIT_FAILURE;
+    }
+
+    ofstream file;
+    if (argc > 2) {
+        file.open(argv[2]);
+        if (not file) {
+            cerr << "error: cannot open " << argv[2] << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (not TraceSink::decode(in, argc > 2 ? file : cout)) {
+        cerr << "error: " << argv[1] << " is not a trace file, or is truncated" << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}